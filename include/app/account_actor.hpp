@@ -0,0 +1,142 @@
+/**
+ * @file account_actor.hpp
+ * @brief 账户/持仓状态的单写者线程与只读视图
+ *
+ * 默认情况下，工作线程（下单风控）、撮合线程（回报、行情盯市）和查询都直接调用
+ * AccountManager / PositionManager，在各自的互斥锁上竞争。开启单写者模式后：
+ * - 所有账户、持仓、保证金状态的读写都作为任务投递到 AccountActor 的唯一线程串行执行，
+ *   管理器的锁只会被这一个线程获取，不再发生竞争；
+ * - 每个任务结束后，被修改账户的资金与持仓发布为不可变的 AccountView，
+ *   查询（U1/U3）直接读取已发布的视图，不进入写线程、不竞争管理器的锁
+ *   （视图读取的加锁情况见 AccountViewTable）。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "base/blockingconcurrentqueue.h"
+#include "base/published_ptr.hpp"
+#include "app/model/account.hpp"
+#include "app/model/position.hpp"
+
+namespace fix40 {
+
+/**
+ * @struct AccountView
+ * @brief 账户在某一时刻的不可变快照（资金 + 全部持仓）
+ */
+struct AccountView {
+    Account account;                   ///< 资金
+    std::vector<Position> positions;   ///< 持仓
+};
+
+/**
+ * @class AccountViewTable
+ * @brief 已发布账户视图的索引
+ *
+ * 两级结构：账户集合变化时以写时复制替换整个索引，单个账户更新时只替换该账户槽位中的视图。
+ * 索引与槽位都通过 PublishedPtr 发布，读者持有返回的 shared_ptr 期间视图不会被释放。
+ *
+ * @par 加锁保证
+ * - 索引：账户集合不变时读取不加锁；
+ * - 槽位：同一线程连续读取同一账户且该账户未重新发布时不加锁；否则进入该账户槽位的互斥锁一次，
+ *   只与发布同一账户的写线程、读取同一账户的其他线程竞争，不同账户之间互不影响。
+ *
+ * @note publish() 只能由单个写线程调用；get() 可从任意线程调用。
+ */
+class AccountViewTable {
+public:
+    AccountViewTable();
+
+    /**
+     * @brief 读取账户最新发布的视图
+     * @return 账户尚未发布过视图时返回 nullptr
+     */
+    std::shared_ptr<const AccountView> get(const std::string& accountId) const;
+
+    /**
+     * @brief 发布账户视图（替换该账户之前的视图）
+     */
+    void publish(std::shared_ptr<const AccountView> view);
+
+    /// 已发布视图的账户数
+    size_t size() const;
+
+private:
+    /// 单个账户的视图槽位（槽位本身在索引中共享，只替换其中的视图）
+    struct Slot {
+        explicit Slot(std::shared_ptr<const AccountView> initial) : view(std::move(initial)) {}
+        PublishedPtr<AccountView> view;
+    };
+    using Index = std::unordered_map<std::string, std::shared_ptr<Slot>>;
+
+    PublishedPtr<Index> index_;
+};
+
+/**
+ * @class AccountActor
+ * @brief 串行执行账户/持仓任务的单写者线程
+ *
+ * - start() 之后，post() 的任务入队，由写线程按投递顺序逐个执行；
+ * - 未启动（或已停止）时，post() 在调用线程上同步执行，多个调用线程之间互斥，
+ *   保持“同一时刻只有一个任务在修改状态”的约定；
+ * - 任务内部再次 post() 时直接嵌套执行，与未开启单写者模式时的同步调用语义一致；
+ * - 每个顶层任务结束后调用 afterTask 钩子（用于发布视图）；
+ * - 任务或钩子抛出的异常被捕获并记录日志，不会终止写线程。
+ */
+class AccountActor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief 构造
+     * @param afterTask 每个顶层任务执行后调用（在写线程上），可为空
+     */
+    explicit AccountActor(Task afterTask = nullptr);
+
+    ~AccountActor();
+
+    AccountActor(const AccountActor&) = delete;
+    AccountActor& operator=(const AccountActor&) = delete;
+
+    /// 启动写线程
+    void start();
+
+    /// 停止写线程（先执行完已投递的任务）
+    void stop();
+
+    /// 写线程是否在运行
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 投递任务
+     */
+    void post(Task task);
+
+    /// 已执行的顶层任务数
+    uint64_t processedCount() const { return processed_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    /// 执行队列中剩余的任务（stop() 之后调用）
+    void drain();
+    /// 执行一个顶层任务（调用方持有 execMutex_）
+    void execute(Task& task);
+
+    moodycamel::BlockingConcurrentQueue<Task> queue_;
+    Task afterTask_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> processed_{0};
+    std::mutex execMutex_;     ///< 串行化写线程、同步执行与停止后排空
+};
+
+} // namespace fix40
@@ -0,0 +1,172 @@
+/**
+ * @file engine_journal.hpp
+ * @brief 撮合引擎输入日志（二进制）
+ *
+ * 按引擎实际处理的顺序记录每个分片消费的全部输入（OrderEvent 与 MarketData，
+ * 含处理时刻），同时记录引擎发出的 ExecutionReport（FIX 消息体字节），
+ * 用于事后重放复现问题、回归比对与真实流量下的吞吐基准。
+ *
+ * @par 文件格式（本机字节序）
+ * @code
+ * 文件头:  magic "FIX40JNL" | u32 version | u32 shardCount | u32 sizeof(MarketData)
+ * 记录:    u8 kind | u8 reserved | u16 shard | u32 payloadLen | i64 timestampNs | payload
+ * 字符串:  u32 len | bytes
+ * @endcode
+ * - MARKET_DATA:      MarketData 原始字节（引擎合并后的行情，即实际处理的那一笔）
+ * - ORDER_EVENT:      u8 type | sender | target | userId | 事件数据
+ * - EXECUTION_REPORT: sender | target | FIX 消息体（FixCodec::encode_body）
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include "app/engine/order_event.hpp"
+#include "app/model/order.hpp"
+#include "market/market_data.hpp"
+
+namespace fix40 {
+
+/**
+ * @enum JournalRecordKind
+ * @brief 日志记录类型
+ */
+enum class JournalRecordKind : uint8_t {
+    MARKET_DATA = 1,       ///< 行情输入
+    ORDER_EVENT = 2,       ///< 订单/会话事件输入
+    EXECUTION_REPORT = 3   ///< 引擎输出的执行报告
+};
+
+/**
+ * @struct JournalRecord
+ * @brief 解析后的一条日志记录
+ */
+struct JournalRecord {
+    JournalRecordKind kind = JournalRecordKind::MARKET_DATA;  ///< 记录类型
+    uint16_t shard = 0;          ///< 处理该记录的分片
+    int64_t timestampNs = 0;     ///< 处理时刻（system_clock 纪元纳秒）
+
+    MarketData marketData;       ///< MARKET_DATA 有效
+    OrderEvent event;            ///< ORDER_EVENT 有效
+    SessionID sessionID;         ///< EXECUTION_REPORT 目标会话
+    std::string reportBody;      ///< EXECUTION_REPORT 的 FIX 消息体
+
+    /// 处理时刻
+    std::chrono::system_clock::time_point time() const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(timestampNs)));
+    }
+};
+
+/**
+ * @class EngineJournal
+ * @brief 日志写入端
+ *
+ * 各分片线程在处理输入前调用 record*，记录追加到同一输出流（内部加锁，
+ * 同一分片内的记录保持处理顺序）。序列化使用复用的缓冲区，稳态下不分配内存。
+ *
+ * @note 仅在 MatchingEngine::start() 之前挂接，停止后再关闭
+ */
+class EngineJournal {
+public:
+    static constexpr char kMagic[8] = {'F', 'I', 'X', '4', '0', 'J', 'N', 'L'};
+    static constexpr uint32_t kVersion = 1;
+
+    EngineJournal() = default;
+    EngineJournal(const EngineJournal&) = delete;
+    EngineJournal& operator=(const EngineJournal&) = delete;
+
+    /**
+     * @brief 创建（截断）日志文件并写入文件头
+     * @param path 文件路径
+     * @param shardCount 引擎分片数
+     * @return 打开失败返回 false
+     */
+    bool open(const std::string& path, size_t shardCount);
+
+    /**
+     * @brief 写入到外部输出流（如内存流）
+     * @param out 输出流，生命周期需覆盖本对象
+     * @param shardCount 引擎分片数
+     */
+    void attach(std::ostream& out, size_t shardCount);
+
+    /// 是否可写
+    bool isOpen() const { return out_ != nullptr; }
+
+    /// 刷新缓冲
+    void flush();
+
+    /// 刷新并关闭
+    void close();
+
+    void recordMarketData(size_t shard, std::chrono::system_clock::time_point time, const MarketData& md);
+    void recordOrderEvent(size_t shard, std::chrono::system_clock::time_point time, const OrderEvent& event);
+
+    /**
+     * @brief 记录引擎发出的 ExecutionReport
+     *
+     * 保存与线上发送一致的 FIX 消息体字节，重放时逐字节比对。
+     */
+    void recordExecutionReport(size_t shard, std::chrono::system_clock::time_point time,
+                               const SessionID& sessionID, const ExecutionReport& report);
+
+    /// 已写入的记录数
+    uint64_t recordCount() const;
+
+private:
+    void writeHeader(size_t shardCount);
+    void writeRecord(JournalRecordKind kind, size_t shard, std::chrono::system_clock::time_point time);
+
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    std::ostream* out_ = nullptr;
+    std::string scratch_;        ///< 负载序列化缓冲（复用）
+    uint64_t records_ = 0;
+};
+
+/**
+ * @class EngineJournalReader
+ * @brief 日志读取端
+ */
+class EngineJournalReader {
+public:
+    /**
+     * @brief 打开日志文件并校验文件头
+     * @return 文件不存在或格式不符返回 false（原因见 error()）
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 从外部输入流读取（如内存流）
+     */
+    bool attach(std::istream& in);
+
+    /**
+     * @brief 读取下一条记录
+     * @return 到达末尾或记录损坏返回 false（损坏时 error() 非空）
+     */
+    bool next(JournalRecord& record);
+
+    /// 记录时的引擎分片数
+    uint32_t shardCount() const { return shardCount_; }
+
+    /// 最近一次错误
+    const std::string& error() const { return error_; }
+
+private:
+    bool readHeader();
+
+    std::ifstream file_;
+    std::istream* in_ = nullptr;
+    std::string payload_;
+    uint32_t shardCount_ = 0;
+    std::string error_;
+};
+
+} // namespace fix40
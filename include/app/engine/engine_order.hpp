@@ -0,0 +1,179 @@
+/**
+ * @file engine_order.hpp
+ * @brief 撮合引擎内部的紧凑订单记录
+ *
+ * 公共 Order 结构携带多个 std::string（clOrdID、orderID、symbol、SessionID），
+ * 每次挂入/取出都伴随堆分配与拷贝。撮合引擎内部改用定长的 EngineOrder：
+ * - 合约以驻留后的整数 ID 表示（SymbolTable）；
+ * - orderID 以序号保存，报告时再格式化为 "ORD-xxxxxxxxxx"；
+ * - clOrdID 存放在定长缓冲区中，超长时才引用外部存储；
+ * - 方向/价格/数量等撮合热字段与池节点链接共处第一条缓存行。
+ *
+ * 公共 Order 只在边界（回报、查询、持久化）物化。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "app/model/order.hpp"
+
+namespace fix40 {
+
+/**
+ * @class SymbolTable
+ * @brief 合约代码驻留表：symbol <-> 紧凑整数 ID
+ *
+ * @note 非线程安全，每个撮合分片持有一份
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief 获取合约 ID，不存在时分配新 ID
+     */
+    uint32_t intern(const std::string& symbol) {
+        auto it = ids_.find(symbol);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        const uint32_t id = static_cast<uint32_t>(names_.size());
+        names_.push_back(symbol);
+        ids_.emplace(symbol, id);
+        return id;
+    }
+
+    /// 按 ID 取合约代码（ID 须由 intern 返回）
+    const std::string& name(uint32_t id) const { return names_[id]; }
+
+    /// 已驻留的合约数
+    size_t size() const { return names_.size(); }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
+};
+
+/**
+ * @brief 按引擎订单序号格式化 orderID
+ */
+inline std::string formatOrderID(uint64_t orderSeq) {
+    std::ostringstream oss;
+    oss << "ORD-" << std::setfill('0') << std::setw(10) << orderSeq;
+    return oss.str();
+}
+
+/**
+ * @struct EngineOrder
+ * @brief 引擎内部订单记录
+ *
+ * 作为 OrderPool 负载时，节点 = 8 字节链接 + 本结构，恰好两条缓存行：
+ * 第一条为链接、撮合热字段与内部订单号，第二条为 clOrdID。
+ */
+struct EngineOrder {
+    static constexpr size_t kClOrdIDCapacity = 56;  ///< 内联 clOrdID 最大长度
+
+    // ---- 撮合热字段 ----
+    double price = 0.0;       ///< 限价（市价单为 0）
+    double avgPx = 0.0;       ///< 平均成交价
+    int64_t orderQty = 0;     ///< 委托数量
+    int64_t cumQty = 0;       ///< 累计成交数量
+    uint64_t orderSeq = 0;    ///< 服务端订单序号（orderID 由此生成）
+    uint32_t symbolId = 0;    ///< 驻留后的合约 ID
+    uint8_t side = 0;         ///< OrderSide
+    uint8_t ordType = 0;      ///< OrderType
+    uint8_t timeInForce = 0;  ///< TimeInForce
+    uint8_t status = 0;       ///< OrderStatus
+
+    // ---- 标识 ----
+    uint32_t orderRef = 0;              ///< 内部订单号（OrderTable 槽位）
+    uint16_t clOrdIDLen = 0;            ///< clOrdID 长度
+    const char* longClOrdID = nullptr;  ///< 超长 clOrdID 的外部存储，否则为空
+    char clOrdIDBuf[kClOrdIDCapacity] = {};
+
+    OrderSide getSide() const { return static_cast<OrderSide>(side); }
+    OrderType getOrdType() const { return static_cast<OrderType>(ordType); }
+    TimeInForce getTimeInForce() const { return static_cast<TimeInForce>(timeInForce); }
+    OrderStatus getStatus() const { return static_cast<OrderStatus>(status); }
+    void setStatus(OrderStatus s) { status = static_cast<uint8_t>(s); }
+
+    /// 剩余未成交数量
+    int64_t leavesQty() const { return orderQty - cumQty; }
+
+    /// 客户订单ID
+    std::string_view clOrdID() const {
+        return longClOrdID ? std::string_view(longClOrdID, clOrdIDLen)
+                           : std::string_view(clOrdIDBuf, clOrdIDLen);
+    }
+
+    /// clOrdID 是否超出内联容量
+    static bool isLongClOrdID(std::string_view id) { return id.size() > kClOrdIDCapacity; }
+
+    /**
+     * @brief 设置 clOrdID
+     *
+     * 不超过 kClOrdIDCapacity 时复制进内联缓冲区；否则仅引用 id 的存储，
+     * 调用方需保证其生命周期覆盖本记录。
+     */
+    void setClOrdID(std::string_view id) {
+        clOrdIDLen = static_cast<uint16_t>(id.size());
+        if (isLongClOrdID(id)) {
+            longClOrdID = id.data();
+        } else {
+            longClOrdID = nullptr;
+            std::memcpy(clOrdIDBuf, id.data(), id.size());
+        }
+    }
+
+    /**
+     * @brief 由公共 Order 构造
+     * @param order 来源订单（超长 clOrdID 时其存储须比记录活得久）
+     * @param symbolId 驻留后的合约 ID
+     * @param orderSeq 服务端订单序号
+     */
+    static EngineOrder fromOrder(const Order& order, uint32_t symbolId, uint64_t orderSeq) {
+        EngineOrder record;
+        record.price = order.price;
+        record.avgPx = order.avgPx;
+        record.orderQty = order.orderQty;
+        record.cumQty = order.cumQty;
+        record.orderSeq = orderSeq;
+        record.symbolId = symbolId;
+        record.orderRef = order.orderRef;
+        record.side = static_cast<uint8_t>(order.side);
+        record.ordType = static_cast<uint8_t>(order.ordType);
+        record.timeInForce = static_cast<uint8_t>(order.timeInForce);
+        record.status = static_cast<uint8_t>(order.status);
+        record.setClOrdID(order.clOrdID);
+        return record;
+    }
+
+    /**
+     * @brief 物化为公共 Order
+     * @param symbol symbolId 对应的合约代码
+     */
+    Order toOrder(const std::string& symbol) const {
+        Order order;
+        order.clOrdID = std::string(clOrdID());
+        order.orderID = formatOrderID(orderSeq);
+        order.orderRef = orderRef;
+        order.symbol = symbol;
+        order.side = getSide();
+        order.ordType = getOrdType();
+        order.timeInForce = getTimeInForce();
+        order.price = price;
+        order.orderQty = orderQty;
+        order.cumQty = cumQty;
+        order.leavesQty = leavesQty();
+        order.avgPx = avgPx;
+        order.status = getStatus();
+        return order;
+    }
+};
+
+} // namespace fix40
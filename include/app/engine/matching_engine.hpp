@@ -14,9 +14,14 @@
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <optional>
+#include <vector>
 #include "base/blockingconcurrentqueue.h"
+#include "app/engine/engine_order.hpp"
 #include "app/engine/order_event.hpp"
-#include "app/engine/order_book.hpp"
+#include "app/engine/order_table.hpp"
+#include "app/engine/pending_order_book.hpp"
+#include "app/engine/snapshot_table.hpp"
 #include "app/model/market_data_snapshot.hpp"
 #include "market/market_data.hpp"
 
@@ -24,6 +29,8 @@ namespace fix40 {
 
 // 前向声明
 class InstrumentManager;
+class EngineJournal;
+struct JournalRecord;
 
 /**
  * @brief ExecutionReport 回调类型
@@ -57,10 +64,21 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
  * - 工作线程不会因业务逻辑阻塞
  * - 支持行情驱动的被动撮合
  *
+ * @par 分片模式
+ * 构造时可指定分片数 N：每个分片一个引擎线程，拥有独立的订单事件队列与行情队列，
+ * 以及互不相交的合约集合（按合约代码哈希，或通过 pinInstrument() 显式指定）。
+ * submit()/submitMarketData() 按合约路由到所属分片，同一订单的事件与回报始终在同一线程内串行，
+ * 因此单个订单的 ExecutionReport 回调保持有序；不同分片的回调可能并发，回调方需自行保证线程安全。
+ * N = 1 时行为与单线程引擎完全一致。
+ *
  * @par 撮合规则
  * - 买单成交条件：买价 >= CTP卖一价
  * - 卖单成交条件：卖价 <= CTP买一价
  * - 成交价格：取CTP对手盘价格
+ * - 成交数量：对手方 1-5 档逐档成交，每档不超过该档挂单量；同一笔行情内已被
+ *   其他订单消耗的量不再重复使用，新行情到达时重置
+ * - 未成交部分：限价 DAY/GTC 挂单等待后续行情，市价单与 IOC/FAK 撤销剩余，
+ *   FOK 在五档剩余量不足时整单撤销
  *
  * @par 使用示例
  * @code
@@ -84,8 +102,9 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
 	public:
     /**
      * @brief 构造撮合引擎
+     * @param shardCount 分片（引擎线程）数量，0 按 1 处理
      */
-    MatchingEngine();
+    explicit MatchingEngine(size_t shardCount = 1);
 
     /**
      * @brief 析构函数
@@ -110,12 +129,33 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
      */
     void stop();
 
+    /**
+     * @brief 将合约固定到指定分片
+     * @param symbol 合约代码
+     * @param shardIndex 分片下标（按分片数取模）
+     *
+     * 必须在 start() 之前调用；未固定的合约按哈希分配。
+     */
+    void pinInstrument(const std::string& symbol, size_t shardIndex);
+
+    /**
+     * @brief 获取分片数量
+     */
+    size_t getShardCount() const { return shards_.size(); }
+
+    /**
+     * @brief 获取合约所属分片下标
+     * @param symbol 合约代码
+     */
+    size_t shardFor(const std::string& symbol) const;
+
     /**
      * @brief 提交订单事件
      * @param event 订单事件
      *
      * 线程安全，可从任意线程调用。
-     * 事件会被放入无锁队列，由引擎线程异步处理。
+     * 事件按合约路由到所属分片的无锁队列，由该分片线程异步处理；
+     * 会话登录/登出事件广播到全部分片。
      */
     void submit(const OrderEvent& event);
 
@@ -135,11 +175,15 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
     /**
      * @brief 设置 ExecutionReport 回调
      * @param callback 回调函数
+     * @param releasesOrders 回调收到终态回报时是否对 orderRef 调用 orderTable().release()。
+     *        为 true 时，引擎为未携带订单号的订单（重放、直接 submit）分配槽位时
+     *        多计一个持有者，与上层受理时分配的订单一致（SimulationApp 传入 true）。
      * 
      * 必须在 start() 之前调用。
      */
-    void setExecutionReportCallback(ExecutionReportCallback callback) {
+    void setExecutionReportCallback(ExecutionReportCallback callback, bool releasesOrders = false) {
         execReportCallback_ = std::move(callback);
+        callbackReleasesOrders_ = releasesOrders;
     }
 
     /**
@@ -153,13 +197,6 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
         marketDataUpdateCallback_ = std::move(callback);
     }
 
-    /**
-     * @brief 获取订单簿（只读）
-     * @param symbol 合约代码
-     * @return const OrderBook* 订单簿指针，不存在返回 nullptr
-     */
-    const OrderBook* getOrderBook(const std::string& symbol) const;
-
     // =========================================================================
     // 行情驱动撮合接口
     // =========================================================================
@@ -177,18 +214,30 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
     /**
      * @brief 获取行情快照
      *
+     * 线程安全，可从任意线程调用：返回撮合线程通过 seqlock 发布的一致副本，不加锁。
+     *
      * @param instrumentId 合约代码
-     * @return const MarketDataSnapshot* 行情快照指针，不存在返回 nullptr
+     * @return 行情快照副本（深度各档已消耗量为 0），尚无行情或快照槽位已满时返回 nullopt
      */
-    const MarketDataSnapshot* getMarketSnapshot(const std::string& instrumentId) const;
+    std::optional<MarketDataSnapshot> getMarketSnapshot(const std::string& instrumentId) const;
 
     /**
-     * @brief 获取挂单列表（只读）
+     * @brief 获取挂单簿（只读）
      *
      * @param instrumentId 合约代码
-     * @return const std::list<Order>* 挂单列表指针，不存在返回 nullptr
+     * @return const PendingOrderBook* 挂单簿指针，不存在返回 nullptr
+     */
+    const PendingOrderBook* getPendingOrders(const std::string& instrumentId) const;
+
+    /**
+     * @brief 订单状态表
+     *
+     * 上层在提交新订单前分配槽位（持有者数 2：上层 + 引擎）并把订单号写入 Order::orderRef；
+     * 未携带订单号的订单由引擎自行分配（持有者数 1）。
+     * 引擎在订单终态回报发出后释放自己的持有，回报中携带订单号供上层按下标访问。
      */
-    const std::list<Order>* getPendingOrders(const std::string& instrumentId) const;
+    OrderTable& orderTable() { return orderTable_; }
+    const OrderTable& orderTable() const { return orderTable_; }
 
     /**
      * @brief 获取所有挂单数量
@@ -197,6 +246,47 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
      */
     size_t getTotalPendingOrderCount() const;
 
+    /**
+     * @brief 设置行情合并阈值
+     * @param threshold 分片行情队列积压达到该值时启用合并，0 表示关闭
+     *
+     * 积压时同一合约只保留最新一笔行情送入撮合与盈亏计算，
+     * 最高/最低价取合并区间内见到的极值，累计成交量/成交额取最新值。
+     * 必须在 start() 之前调用。
+     */
+    void setConflationThreshold(size_t threshold) { conflationThreshold_ = threshold; }
+
+    /**
+     * @brief 获取被合并（未单独处理）的行情条数
+     */
+    uint64_t getConflatedTickCount() const;
+
+    // =========================================================================
+    // 输入日志与重放
+    // =========================================================================
+
+    /**
+     * @brief 挂接输入日志
+     * @param journal 日志写入端（不接管所有权，nullptr 表示关闭）
+     *
+     * 各分片按处理顺序记录消费的每个 OrderEvent/MarketData（含处理时刻），
+     * 以及发出的每个 ExecutionReport。必须在 start() 之前调用。
+     */
+    void setJournal(EngineJournal* journal) { journal_ = journal; }
+
+    /**
+     * @brief 在调用线程上同步处理一条日志输入
+     * @param record 日志记录（EXECUTION_REPORT 记录被忽略）
+     *
+     * 输入交给记录时的分片处理，处理时刻取记录中的时间戳，
+     * 因此同一份日志在全新引擎上重放得到相同的 ExecutionReport。
+     * 仅在引擎未启动时可用。
+     *
+     * @note 订单号与 ExecID 为跨分片全局计数，多分片时其分配顺序不在日志中，
+     *       逐字节一致只对单分片日志保证。
+     */
+    void replay(const JournalRecord& record);
+
     // =========================================================================
     // 管理器设置（用于提供撮合所需的只读信息）
     // =========================================================================
@@ -238,59 +328,132 @@ using MarketDataUpdateCallback = std::function<void(const std::string&, double)>
      */
     bool canMatchSellOrder(const Order& order, const MarketDataSnapshot& snapshot) const;
 
+    /// @copydoc canMatchBuyOrder(const Order&, const MarketDataSnapshot&) const
+    bool canMatchBuyOrder(const EngineOrder& order, const MarketDataSnapshot& snapshot) const;
+
+    /// @copydoc canMatchSellOrder(const Order&, const MarketDataSnapshot&) const
+    bool canMatchSellOrder(const EngineOrder& order, const MarketDataSnapshot& snapshot) const;
+
 private:
     /**
-     * @brief 引擎主循环
+     * @struct Shard
+     * @brief 引擎分片：一个线程及其独占的队列与撮合状态
+     *
+     * 分片内状态只由本分片线程访问，无需加锁。
+     */
+    struct Shard {
+        size_t index = 0;  ///< 分片下标
+        std::thread thread;  ///< 分片线程
+
+        /// 订单事件队列（无锁队列）
+        moodycamel::ConcurrentQueue<OrderEvent> eventQueue;
+        /// 行情数据队列（无锁队列）
+        moodycamel::ConcurrentQueue<MarketData> marketDataQueue;
+        /// 统一唤醒信号：两个队列每入队一项 signal 一次，计数即待处理项数
+        moodycamel::LightweightSemaphore wakeup;
+        /// 被合并的行情条数
+        std::atomic<uint64_t> conflatedTicks{0};
+        /// 行情合并缓冲：按合约首次出现的顺序保存合并结果（复用，避免反复分配）
+        std::vector<MarketData> conflationBuffer;
+        /// 合约 -> conflationBuffer 下标
+        std::unordered_map<std::string, size_t> conflationIndex;
+
+        /// 挂单位置：OrderRef -> 挂单簿与句柄（撤单时 O(1) 定位）
+        std::vector<OrderLocation> orderLocations;
+        /// 行情快照：instrumentId -> snapshot
+        std::unordered_map<std::string, MarketDataSnapshot> marketSnapshots;
+        /// 虚拟订单簿（价格索引挂单簿）：instrumentId -> 挂单簿
+        std::unordered_map<std::string, PendingOrderBook> pendingOrders;
+        /// 合约驻留表：EngineOrder 以 symbolId 引用合约
+        SymbolTable symbols;
+        /// 当前输入的处理时刻：回报与快照时间戳取此值，重放时为日志记录的时刻
+        std::chrono::system_clock::time_point now;
+    };
+
+    /// 每批从单个队列批量取出的最大条数
+    static constexpr size_t kMaxBatch = 64;
+
+    /**
+     * @brief 分片主循环
+     * @param shard 所属分片
+     *
+     * 阻塞在统一唤醒信号上，醒来后按批量取出行情与订单事件：
+     * 每轮先处理至多 kMaxBatch 条行情，再处理至多 kMaxBatch 个订单事件，
+     * 两类都有积压时交替进行，任何一方都不会饿死另一方。
+     */
+    void run(Shard& shard);
+
+    /**
+     * @brief 积压时合并行情并处理
+     * @param shard 所属分片
+     * @param ticks 已取出的行情批次（作为继续取数的缓冲区复用）
+     * @param tickCount 批次中的行情条数
+     * @param pending 持有的唤醒计数，超额取出的行情会在此补领计数
+     *
+     * 继续从行情队列取出至多 conflationThreshold_ 条积压行情，
+     * 按合约合并后每个合约只处理一笔。
+     */
+    void conflateAndDispatch(Shard& shard, std::vector<MarketData>& ticks, size_t tickCount,
+                             std::ptrdiff_t& pending);
+
+    /**
+     * @brief 处理单条行情（写入日志，捕获并记录异常）
+     * @param now 处理时刻
+     */
+    void dispatchMarketData(Shard& shard, const MarketData& md, std::chrono::system_clock::time_point now);
+
+    /**
+     * @brief 处理单个订单事件（写入日志，捕获并记录异常）
+     * @param now 处理时刻
      */
-    void run();
+    void dispatchEvent(Shard& shard, const OrderEvent& event, std::chrono::system_clock::time_point now);
 
     /**
      * @brief 处理单个订单事件
+     * @param shard 所属分片
      * @param event 订单事件
      */
-    void process_event(const OrderEvent& event);
+    void process_event(Shard& shard, const OrderEvent& event);
 
     /**
      * @brief 处理新订单（行情驱动模式）
+     * @param shard 所属分片
      * @param event 订单事件
      *
      * 流程：
      * 1. 尝试立即撮合（与当前行情比对）
      * 2. 未成交部分挂入虚拟订单簿等待行情触发
      */
-    void handle_new_order(const OrderEvent& event);
+    void handle_new_order(Shard& shard, const OrderEvent& event);
 
     /**
      * @brief 处理撤单请求
+     * @param shard 所属分片
      * @param event 订单事件
      */
-    void handle_cancel_request(const OrderEvent& event);
+    void handle_cancel_request(Shard& shard, const OrderEvent& event);
 
     /**
      * @brief 处理会话登录
+     * @param shard 所属分片
      * @param event 事件
      */
-    void handle_session_logon(const OrderEvent& event);
+    void handle_session_logon(Shard& shard, const OrderEvent& event);
 
     /**
      * @brief 处理会话登出
+     * @param shard 所属分片
      * @param event 事件
      */
-    void handle_session_logout(const OrderEvent& event);
-
-    /**
-     * @brief 获取或创建订单簿
-     * @param symbol 合约代码
-     * @return OrderBook& 订单簿引用
-     */
-    OrderBook& getOrCreateOrderBook(const std::string& symbol);
+    void handle_session_logout(Shard& shard, const OrderEvent& event);
 
     /**
      * @brief 发送 ExecutionReport
+     * @param shard 产生回报的分片
      * @param sessionID 目标会话
      * @param report 执行报告
      */
-    void sendExecutionReport(const SessionID& sessionID, const ExecutionReport& report);
+    void sendExecutionReport(Shard& shard, const SessionID& sessionID, const ExecutionReport& report);
 
     /**
      * @brief 生成 ExecID
@@ -298,9 +461,9 @@ private:
     std::string generateExecID();
 
     /**
-     * @brief 生成 OrderID
+     * @brief 分配服务端订单序号（orderID 由 formatOrderID 生成）
      */
-    std::string generateOrderID();
+    uint64_t nextOrderSeq();
 
     // =========================================================================
     // 行情驱动撮合内部方法
@@ -308,90 +471,124 @@ private:
 
     /**
      * @brief 处理行情更新
+     * @param shard 所属分片
      *
      * 1. 更新行情快照
-     * 2. 遍历该合约的挂单
-     * 3. 检查是否满足成交条件
-     * 4. 触发成交
+     * 2. 从最优价开始访问可成交的买单（价格 >= 卖一）与卖单（价格 <= 买一）
+     * 3. 按五档深度逐档成交，遇到第一个不可成交的价位即停止
      *
      * @param md 行情数据
      */
-    void handleMarketData(const MarketData& md);
+    void handleMarketData(Shard& shard, const MarketData& md);
 
     /**
      * @brief 尝试撮合订单（行情驱动）
+     * @param shard 所属分片
      *
      * @param order 待撮合订单
+     * @param snapshot 当前行情快照（逐档消耗量会被更新）
+     * @return 是否已全部成交
+     */
+    bool tryMatch(Shard& shard, EngineOrder& order, MarketDataSnapshot& snapshot);
+
+    /**
+     * @brief 按对手方五档深度成交
+     * @param shard 所属分片
+     *
+     * @param order 待成交订单
      * @param snapshot 当前行情快照
-     * @return 是否成交
+     * @return int64_t 本次成交的总数量
+     *
+     * 从一档开始逐档成交，每档最多成交其剩余量（挂单量 - 本笔行情内已消耗量），
+     * 遇到不可成交的价位或空档即停止。同一笔行情内后续订单不会重复使用已消耗的量。
      */
-    bool tryMatch(Order& order, const MarketDataSnapshot& snapshot);
+    int64_t fillFromDepth(Shard& shard, EngineOrder& order, MarketDataSnapshot& snapshot);
+
+    /**
+     * @brief 撤销订单剩余部分（市价单、IOC/FAK、FOK）并发送 CANCELED 回报
+     * @param shard 所属分片
+     *
+     * @param order 订单记录
+     * @param sessionID 回报目标会话
+     * @param reason 撤销原因
+     */
+    void expireRemainder(Shard& shard, EngineOrder& order, const SessionID& sessionID, const char* reason);
 
     /**
      * @brief 执行成交
+     * @param shard 所属分片
      *
      * @param order 成交的订单
      * @param fillPrice 成交价格
      * @param fillQty 成交数量
+     *
+     * 更新订单记录并物化 ExecutionReport 发出。
      */
-    void executeFill(Order& order, double fillPrice, int64_t fillQty);
+    void executeFill(Shard& shard, EngineOrder& order, double fillPrice, int64_t fillQty);
 
     /**
      * @brief 将订单添加到挂单列表
+     * @param shard 所属分片
      *
-     * @param order 待挂单的订单
+     * @param order 待挂单的订单记录
      */
-    void addToPendingOrders(const Order& order);
+    void addToPendingOrders(Shard& shard, const EngineOrder& order);
 
     /**
      * @brief 从挂单列表移除订单
+     * @param shard 所属分片
      *
-     * @param instrumentId 合约代码
-     * @param clOrdID 客户订单ID
-     * @return 被移除的订单，不存在返回 nullopt
+     * @param req 撤单请求：携带原订单号时只按分片位置表直接定位，否则按 origClOrdID 查找
+     * @param accountId 撤单用户；按 origClOrdID 查找时只移除属于该账户的订单
+     * @return 被移除的订单，不存在或不属于该账户返回 nullopt
      */
-    std::optional<Order> removeFromPendingOrders(const std::string& instrumentId, 
-                                                   const std::string& clOrdID);
+    std::optional<Order> removeFromPendingOrders(Shard& shard, const CancelRequest& req,
+                                                 const std::string& accountId);
 
-    std::atomic<bool> running_{false};  ///< 运行状态
-    std::thread worker_thread_;          ///< 工作线程
-    
-    /// 订单事件队列（无锁阻塞队列）
-    moodycamel::BlockingConcurrentQueue<OrderEvent> event_queue_;
+    /**
+     * @brief 订单离开引擎：清除挂单位置并释放引擎对槽位的持有
+     * @param shard 所属分片
+     * @param ref 内部订单号（kNoOrderRef 时忽略）
+     *
+     * 须在订单终态回报发出之后调用。
+     */
+    void releaseOrder(Shard& shard, OrderRef ref);
 
-    /// 订单簿映射：symbol -> OrderBook（保留用于兼容）
-    std::unordered_map<std::string, std::unique_ptr<OrderBook>> orderBooks_;
+    std::atomic<bool> running_{false};  ///< 运行状态
 
-	    /// 订单到会话的映射：clOrdID -> SessionID（用于成交通知）
-	    std::unordered_map<std::string, SessionID> orderSessionMap_;
+    /// 引擎分片（构造后数量固定）
+    std::vector<std::unique_ptr<Shard>> shards_;
 
-	    /// 订单到用户ID的映射：clOrdID -> userId（用于日志/追踪，业务处理由上层负责）
-	    std::unordered_map<std::string, std::string> orderUserMap_;
+    /// 显式固定的合约分片：symbol -> shard index（仅在 start() 之前修改）
+    std::unordered_map<std::string, size_t> pinnedShards_;
 
     /// ExecutionReport 回调
     ExecutionReportCallback execReportCallback_;
+    bool callbackReleasesOrders_ = false;  ///< 回报回调是否持有（并释放）订单槽位
 
     /// 行情更新回调
     MarketDataUpdateCallback marketDataUpdateCallback_;
 
-    /// ExecID 计数器
-    uint64_t nextExecID_ = 1;
+    /// ExecID 计数器（跨分片全局唯一）
+    std::atomic<uint64_t> nextExecID_{1};
 
-    /// OrderID 计数器
-    uint64_t nextOrderID_ = 1;
+    /// OrderID 计数器（跨分片全局唯一）
+    std::atomic<uint64_t> nextOrderID_{1};
 
-    // =========================================================================
-    // 行情驱动撮合相关成员
-    // =========================================================================
+    /// 行情合并阈值（0 表示关闭）
+    size_t conflationThreshold_ = 0;
+
+    /// 输入日志（可为 nullptr）
+    EngineJournal* journal_ = nullptr;
 
-    /// 行情快照：instrumentId -> snapshot
-    std::unordered_map<std::string, MarketDataSnapshot> marketSnapshots_;
+    /// 未在 InstrumentManager 中登记的合约可用的快照槽位数
+    static constexpr size_t kSpareSnapshotSlots = 1024;
 
-    /// 虚拟订单簿（挂单列表）：instrumentId -> 挂单列表
-    std::unordered_map<std::string, std::list<Order>> pendingOrders_;
+    /// 跨线程发布的行情快照（start() 时按合约预分配槽位）
+    SnapshotTable publishedSnapshots_{kSpareSnapshotSlots};
 
-    /// 行情数据队列（无锁阻塞队列）
-	    moodycamel::BlockingConcurrentQueue<MarketData> marketDataQueue_;
+    /// 订单状态表（内部订单号 -> 会话/账户/保证金）
+    OrderTable orderTable_;
 
 	    // =========================================================================
 	    // 管理器指针（用于提供撮合所需的只读信息）
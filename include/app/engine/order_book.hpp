@@ -13,6 +13,8 @@
 #include <vector>
 #include <functional>
 #include <optional>
+#include "app/engine/order_pool.hpp"
+#include "app/engine/price_ladder.hpp"
 #include "app/model/order.hpp"
 
 namespace fix40 {
@@ -67,6 +69,7 @@ struct Trade {
  * @brief 价格档位
  *
  * 同一价格的所有订单，按时间顺序排列。
+ * 作为深度查询结果返回，订单簿内部以 OrderPool 句柄链表存储。
  */
 struct PriceLevel {
     double price;                  ///< 价格
@@ -89,6 +92,14 @@ struct PriceLevel {
  * - 时间优先：同价位先到者优先成交
  * - 成交价格：取被动方（挂单方）价格
  *
+ * @par 价位存储
+ * - 默认以 std::map<double, Level> 按价格排序；
+ * - 构造时给出最小变动价位（priceTick > 0）则使用整数价位阶梯（PriceLadder）：
+ *   价格换算为整数 tick，价位存放在稠密数组窗口中并以位图标记非空价位，
+ *   此时不在 tick 网格上的限价单会被拒绝。
+ * - MatchingEngine 为行情驱动撮合，挂单存放在 PendingOrderBook 中，不经过 OrderBook，
+ *   价位阶梯只在直接构造带 priceTick 的 OrderBook 时生效。
+ *
  * @par 线程安全
  * OrderBook 本身不是线程安全的，应由 MatchingEngine 在单线程中调用。
  *
@@ -112,14 +123,20 @@ public:
     /**
      * @brief 构造订单簿
      * @param symbol 合约代码
+     * @param priceTick 最小变动价位；大于 0 时使用整数价位阶梯存储
      */
-    explicit OrderBook(const std::string& symbol);
+    explicit OrderBook(const std::string& symbol, double priceTick = 0.0);
 
     /**
      * @brief 获取合约代码
      */
     const std::string& getSymbol() const { return symbol_; }
 
+    /**
+     * @brief 是否使用整数价位阶梯
+     */
+    bool usesTickLadder() const { return bidLadder_.has_value(); }
+
     // =========================================================================
     // 订单操作
     // =========================================================================
@@ -141,6 +158,8 @@ public:
      * @brief 撤销订单
      * @param clOrdID 客户订单ID
      * @return std::optional<Order> 被撤销的订单，不存在返回 nullopt
+     *
+     * 通过 clOrdID -> 句柄索引 O(1) 定位并解链，与价位队列深度无关。
      */
     std::optional<Order> cancelOrder(const std::string& clOrdID);
 
@@ -194,7 +213,7 @@ public:
     /**
      * @brief 检查订单簿是否为空
      */
-    bool empty() const { return bids_.empty() && asks_.empty(); }
+    bool empty() const { return bidOrderCount_ == 0 && askOrderCount_ == 0; }
 
 private:
     /**
@@ -209,17 +228,21 @@ private:
 
     /**
      * @brief 撮合买单
+     * @param asks 卖盘价位
      * @param order 买单
      * @return std::vector<Trade> 成交记录
      */
-    std::vector<Trade> matchBuyOrder(Order& order);
+    template <typename Levels>
+    std::vector<Trade> matchBuyOrder(Levels& asks, Order& order);
 
     /**
      * @brief 撮合卖单
+     * @param bids 买盘价位
      * @param order 卖单
      * @return std::vector<Trade> 成交记录
      */
-    std::vector<Trade> matchSellOrder(Order& order);
+    template <typename Levels>
+    std::vector<Trade> matchSellOrder(Levels& bids, Order& order);
 
     /**
      * @brief 将订单挂入买盘
@@ -231,13 +254,67 @@ private:
      */
     void addToAsks(const Order& order);
 
+    /**
+     * @brief 将订单挂入指定一侧的价位队列
+     */
+    template <typename Levels>
+    void insertOrder(Levels& levels, const Order& order);
+
+    /**
+     * @brief 以实际使用的买盘存储（map 或价位阶梯）调用 fn
+     */
+    template <typename Fn>
+    decltype(auto) withBids(Fn&& fn) { return bidLadder_ ? fn(*bidLadder_) : fn(bids_); }
+    template <typename Fn>
+    decltype(auto) withBids(Fn&& fn) const { return bidLadder_ ? fn(*bidLadder_) : fn(bids_); }
+
+    /**
+     * @brief 以实际使用的卖盘存储（map 或价位阶梯）调用 fn
+     */
+    template <typename Fn>
+    decltype(auto) withAsks(Fn&& fn) { return askLadder_ ? fn(*askLadder_) : fn(asks_); }
+    template <typename Fn>
+    decltype(auto) withAsks(Fn&& fn) const { return askLadder_ ? fn(*askLadder_) : fn(asks_); }
+
+    /**
+     * @struct Level
+     * @brief 内部价位：侵入式订单队列（节点位于 pool_）
+     */
+    struct Level {
+        double price = 0.0;   ///< 价格
+        OrderQueue queue;     ///< 订单队列（时间优先）
+        int64_t totalQty = 0; ///< 该价位总数量
+    };
+
     /**
      * @brief 从订单簿移除订单
-     * @param clOrdID 客户订单ID
-     * @param side 买卖方向
+     * @param handle 订单句柄
      * @return std::optional<Order> 被移除的订单
      */
-    std::optional<Order> removeOrder(const std::string& clOrdID, OrderSide side);
+    std::optional<Order> removeOrder(OrderHandle handle);
+
+    /**
+     * @brief 从价位队列摘除订单并释放节点，价位清空时删除价位
+     */
+    template <typename Levels>
+    Order unlinkFromLevel(Levels& levels, OrderHandle handle);
+
+    /**
+     * @brief 将内部价位转换为对外的 PriceLevel
+     */
+    PriceLevel materialize(const Level& level) const;
+
+    /**
+     * @brief 按最优价优先收集前 levels 档
+     */
+    template <typename Levels>
+    std::vector<PriceLevel> collectLevels(const Levels& book, size_t levels) const;
+
+    /**
+     * @brief 累计对手方可成交数量，达到 order.orderQty 即停止
+     */
+    template <typename Levels>
+    int64_t sumMatchableQty(const Levels& book, const Order& order) const;
 
     /**
      * @brief 计算订单可成交数量（用于 FOK 预检查）
@@ -249,17 +326,20 @@ private:
     std::string symbol_;  ///< 合约代码
 
     /// 买盘：价格降序（greater 使 map 按价格从高到低排列）
-    std::map<double, PriceLevel, std::greater<double>> bids_;
+    std::map<double, Level, std::greater<double>> bids_;
     
     /// 卖盘：价格升序（less 使 map 按价格从低到高排列）
-    std::map<double, PriceLevel, std::less<double>> asks_;
+    std::map<double, Level, std::less<double>> asks_;
 
-    /// 订单索引：ClOrdID -> (Side, Price) 用于快速查找
-    struct OrderLocation {
-        OrderSide side;
-        double price;
-    };
-    std::unordered_map<std::string, OrderLocation> orderIndex_;
+    /// 整数价位阶梯（priceTick > 0 时启用，替代 bids_/asks_）
+    std::optional<PriceLadder<Level>> bidLadder_;
+    std::optional<PriceLadder<Level>> askLadder_;
+
+    /// 挂单节点池（订单以句柄引用，同价位通过侵入式链表串联）
+    OrderPool<Order> pool_;
+
+    /// 订单索引：ClOrdID -> 句柄，撤单/查找 O(1)
+    std::unordered_map<std::string, OrderHandle> orderIndex_;
 
     size_t bidOrderCount_ = 0;   ///< 买盘订单数
     size_t askOrderCount_ = 0;   ///< 卖盘订单数
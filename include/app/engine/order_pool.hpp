@@ -0,0 +1,186 @@
+/**
+ * @file order_pool.hpp
+ * @brief 挂单对象池与侵入式价位队列
+ *
+ * 挂单节点分配在分块对象池中，地址稳定，以 32 位下标（OrderHandle）引用；
+ * 节点内嵌前驱/后继下标，同价位订单构成侵入式双向链表。
+ * 配合 clOrdID -> OrderHandle 的索引，撤单/改单只需 O(1) 解链，与价位深度无关。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fix40 {
+
+/// 挂单句柄：对象池内下标
+using OrderHandle = uint32_t;
+
+/// 无效句柄
+constexpr OrderHandle kInvalidOrderHandle = UINT32_MAX;
+
+/**
+ * @struct OrderQueue
+ * @brief 侵入式 FIFO 队列（同一价位的订单）
+ *
+ * 只保存首尾句柄与长度，链接信息存放在对象池节点中。
+ */
+struct OrderQueue {
+    OrderHandle head = kInvalidOrderHandle;  ///< 队首（最早到达）
+    OrderHandle tail = kInvalidOrderHandle;  ///< 队尾（最晚到达）
+    size_t count = 0;                        ///< 订单数
+
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * @class OrderPool
+ * @brief 分块对象池
+ *
+ * - 以 kChunkSize 为单位批量分配节点，扩容不移动已有节点；
+ * - 释放的节点进入空闲链表复用，稳态下不再向系统申请内存；
+ * - 提供侵入式链表操作，把节点挂到 / 摘出某个 OrderQueue。
+ *
+ * @tparam T 节点负载类型
+ *
+ * @note 非线程安全，仅由撮合线程访问
+ */
+template <typename T>
+class OrderPool {
+public:
+    static constexpr size_t kChunkSize = 256;
+
+    OrderPool() = default;
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+    OrderPool(OrderPool&&) = default;
+    OrderPool& operator=(OrderPool&&) = default;
+
+    /**
+     * @brief 分配一个节点并写入负载
+     * @return OrderHandle 新节点句柄
+     */
+    OrderHandle allocate(T value) {
+        if (freeHead_ == kInvalidOrderHandle) {
+            grow();
+        }
+        const OrderHandle handle = freeHead_;
+        Node& node = at(handle);
+        freeHead_ = node.next;
+        node.value = std::move(value);
+        node.prev = node.next = kInvalidOrderHandle;
+        ++size_;
+        return handle;
+    }
+
+    /**
+     * @brief 释放节点（调用方需先将其从所在队列摘除）
+     */
+    void release(OrderHandle handle) {
+        Node& node = at(handle);
+        node.value = T{};
+        node.prev = kInvalidOrderHandle;
+        node.next = freeHead_;
+        freeHead_ = handle;
+        --size_;
+    }
+
+    T& get(OrderHandle handle) { return at(handle).value; }
+    const T& get(OrderHandle handle) const { return at(handle).value; }
+
+    /// 队列中的后继节点
+    OrderHandle next(OrderHandle handle) const { return at(handle).next; }
+
+    /// 已分配节点数
+    size_t size() const { return size_; }
+
+    /// 单个节点占用的字节数（链接 + 负载，按缓存行对齐）
+    static constexpr size_t nodeSize() { return sizeof(Node); }
+
+    /// 池容量（含空闲节点）
+    size_t capacity() const { return chunks_.size() * kChunkSize; }
+
+    /**
+     * @brief 预分配节点
+     * @param count 期望的最小容量
+     */
+    void reserve(size_t count) {
+        while (capacity() < count) {
+            grow();
+        }
+    }
+
+    /**
+     * @brief 将节点追加到队尾
+     */
+    void pushBack(OrderQueue& queue, OrderHandle handle) {
+        Node& node = at(handle);
+        node.prev = queue.tail;
+        node.next = kInvalidOrderHandle;
+        if (queue.tail != kInvalidOrderHandle) {
+            at(queue.tail).next = handle;
+        } else {
+            queue.head = handle;
+        }
+        queue.tail = handle;
+        ++queue.count;
+    }
+
+    /**
+     * @brief 将节点从队列中摘除（O(1)）
+     * @return OrderHandle 原后继节点，便于遍历时删除
+     */
+    OrderHandle unlink(OrderQueue& queue, OrderHandle handle) {
+        Node& node = at(handle);
+        const OrderHandle next = node.next;
+        if (node.prev != kInvalidOrderHandle) {
+            at(node.prev).next = node.next;
+        } else {
+            queue.head = node.next;
+        }
+        if (node.next != kInvalidOrderHandle) {
+            at(node.next).prev = node.prev;
+        } else {
+            queue.tail = node.prev;
+        }
+        node.prev = node.next = kInvalidOrderHandle;
+        --queue.count;
+        return next;
+    }
+
+private:
+    // 链接放在节点头部，与负载的前部字段共处第一条缓存行
+    struct alignas(64) Node {
+        OrderHandle prev = kInvalidOrderHandle;  ///< 队列前驱
+        OrderHandle next = kInvalidOrderHandle;  ///< 队列后继 / 空闲链表后继
+        T value{};
+    };
+
+    Node& at(OrderHandle handle) {
+        return chunks_[handle / kChunkSize][handle % kChunkSize];
+    }
+    const Node& at(OrderHandle handle) const {
+        return chunks_[handle / kChunkSize][handle % kChunkSize];
+    }
+
+    void grow() {
+        const OrderHandle base = static_cast<OrderHandle>(capacity());
+        chunks_.push_back(std::make_unique<Node[]>(kChunkSize));
+        Node* chunk = chunks_.back().get();
+        // 新节点按下标顺序串入空闲链表，保持分配的局部性
+        for (size_t i = 0; i < kChunkSize; ++i) {
+            chunk[i].next = (i + 1 < kChunkSize) ? base + static_cast<OrderHandle>(i + 1) : freeHead_;
+        }
+        freeHead_ = base;
+    }
+
+    std::vector<std::unique_ptr<Node[]>> chunks_;
+    OrderHandle freeHead_ = kInvalidOrderHandle;
+    size_t size_ = 0;
+};
+
+} // namespace fix40
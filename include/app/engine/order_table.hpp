@@ -0,0 +1,204 @@
+/**
+ * @file order_table.hpp
+ * @brief 以内部订单号索引的订单状态表
+ *
+ * 一笔订单在生命周期内需要被多处按订单查找：撮合引擎找来源会话发送回报，
+ * SimulationApp 找所属账户与冻结保证金，撤单时找挂单位置。
+ * 原先各处分别维护以 clOrdID 为键的哈希表，每条回报都要做多次字符串哈希。
+ *
+ * OrderTable 在受理新订单时分配一个稠密的内部订单号（OrderRef），
+ * 订单的会话、账户、保证金信息集中存放在该号对应的槽位中，撮合分片以同一订单号记录挂单位置；
+ * Order / ExecutionReport / EngineOrder 携带 OrderRef，下游直接按下标访问。
+ * (账户, clOrdID) -> OrderRef 的索引只在撤单请求（客户端以 clOrdID 指定原订单）时使用；
+ * clOrdID 只在账户内唯一，不同账户可以使用相同的 clOrdID。
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "app/engine/order_pool.hpp"
+#include "fix/application.hpp"
+
+namespace fix40 {
+
+class PendingOrderBook;
+
+/// 内部订单号：OrderTable 槽位下标
+using OrderRef = uint32_t;
+
+/// 无内部订单号（0 号槽位保留不用）
+constexpr OrderRef kNoOrderRef = 0;
+
+/**
+ * @struct OrderMarginInfo
+ * @brief 订单保证金信息
+ *
+ * 用于正确处理部分成交时的保证金计算。
+ * 存储原始总冻结保证金和订单总数量，避免累计误差。
+ */
+struct OrderMarginInfo {
+    double originalFrozenMargin;  ///< 原始总冻结保证金
+    int64_t originalOrderQty;     ///< 原始订单总数量
+    double releasedMargin;        ///< 已释放的保证金（累计）
+
+    OrderMarginInfo()
+        : originalFrozenMargin(0.0)
+        , originalOrderQty(0)
+        , releasedMargin(0.0) {}
+
+    OrderMarginInfo(double frozen, int64_t qty)
+        : originalFrozenMargin(frozen)
+        , originalOrderQty(qty)
+        , releasedMargin(0.0) {}
+
+    /// 计算本次成交应释放的冻结保证金
+    double calculateReleaseAmount(int64_t fillQty) {
+        if (originalOrderQty <= 0) return 0.0;
+        double amount = originalFrozenMargin * fillQty / originalOrderQty;
+        releasedMargin += amount;
+        return amount;
+    }
+
+    /// 获取剩余未释放的冻结保证金
+    double getRemainingFrozen() const {
+        return originalFrozenMargin - releasedMargin;
+    }
+};
+
+/**
+ * @struct OrderEntry
+ * @brief 单笔订单的状态槽位
+ *
+ * 标识字段（clOrdID / accountId / symbol / sessionID）在分配时写入，此后只读；
+ * 保证金信息只由处理该订单回报的线程修改。
+ * 订单号随订单事件、回报跨线程传递，队列本身保证了槽位写入对接收方可见。
+ */
+struct OrderEntry {
+    std::string clOrdID;     ///< 客户订单ID
+    std::string accountId;   ///< 所属账户
+    std::string symbol;      ///< 合约代码（撤单按此路由到持有订单的撮合分片）
+    SessionID sessionID;     ///< 来源会话（回报路由）
+    OrderMarginInfo margin;  ///< 开仓冻结保证金（平仓单为空）
+
+    /// 持有者计数：每个持有者用完后 release()，归零时槽位回收
+    std::atomic<uint8_t> holders{0};
+};
+
+/**
+ * @struct OrderLocation
+ * @brief 订单在挂单簿中的位置
+ *
+ * 挂单位置只在撮合分片内有意义，由各分片以 OrderRef 为下标单独保存（见 MatchingEngine::Shard），
+ * 不放进共享槽位：撤单请求携带的订单号可能已过期并被其他线程重新分配，
+ * 分片只读写自己的位置表，校验 clOrdID 后再使用。
+ */
+struct OrderLocation {
+    PendingOrderBook* book = nullptr;              ///< 所在挂单簿（未挂单为空）
+    OrderHandle handle = kInvalidOrderHandle;      ///< 挂单句柄
+
+    /// 是否在挂单簿中
+    bool resting() const { return book != nullptr; }
+};
+
+/**
+ * @class OrderTable
+ * @brief 内部订单号 -> 订单状态槽位
+ *
+ * - 槽位分块分配、地址稳定，at() 为纯下标访问，不加锁；
+ * - 回收的槽位进入空闲链表，订单号保持稠密；
+ * - 槽位由多方共同持有（SimulationApp 受理的订单：应用层 + 撮合引擎），
+ *   各方处理完终态后 release()，最后一个持有者释放时回收，
+ *   避免一方回收后另一方仍在访问。
+ *
+ * @note allocate() / release() / find() 加锁，可从任意线程调用。
+ */
+class OrderTable {
+public:
+    static constexpr size_t kChunkSize = 4096;   ///< 每块槽位数
+    static constexpr size_t kMaxChunks = 1024;   ///< 最大块数（同时存活订单上限约 400 万）
+
+    OrderTable() = default;
+    OrderTable(const OrderTable&) = delete;
+    OrderTable& operator=(const OrderTable&) = delete;
+
+    /**
+     * @brief 分配订单槽位
+     * @param clOrdID 客户订单ID（同一账户重复分配同一 clOrdID 时索引指向最新订单）
+     * @param accountId 所属账户
+     * @param symbol 合约代码
+     * @param sessionID 来源会话
+     * @param holders 持有者数量（>= 1）
+     * @return 内部订单号，容量耗尽时返回 kNoOrderRef
+     */
+    OrderRef allocate(const std::string& clOrdID, const std::string& accountId,
+                      const std::string& symbol, const SessionID& sessionID, uint8_t holders);
+
+    /**
+     * @brief 访问槽位（ref 须由 allocate 返回且仍被调用方持有）
+     */
+    OrderEntry& at(OrderRef ref) {
+        return chunks_[ref / kChunkSize][ref % kChunkSize];
+    }
+    const OrderEntry& at(OrderRef ref) const {
+        return chunks_[ref / kChunkSize][ref % kChunkSize];
+    }
+
+    /**
+     * @brief 释放一个持有者，最后一个持有者释放时回收槽位
+     */
+    void release(OrderRef ref);
+
+    /**
+     * @brief 按账户与 clOrdID 查找存活订单
+     * @param accountId 发起查找的账户（只能找到该账户自己的订单）
+     * @param clOrdID 客户订单ID
+     * @param symbol 非空时在锁内取出合约代码（调用方未持有槽位时不能再直接读取）
+     * @return 内部订单号，不存在返回 kNoOrderRef
+     */
+    OrderRef find(const std::string& accountId, const std::string& clOrdID,
+                  std::string* symbol = nullptr) const;
+
+    /// 存活订单数
+    size_t size() const;
+
+    /// 已分配的槽位容量
+    size_t capacity() const;
+
+private:
+    /// 索引键：clOrdID 只在账户内唯一
+    struct IndexKey {
+        std::string accountId;
+        std::string clOrdID;
+
+        bool operator==(const IndexKey& other) const {
+            return accountId == other.accountId && clOrdID == other.clOrdID;
+        }
+    };
+
+    struct IndexKeyHash {
+        size_t operator()(const IndexKey& key) const {
+            return std::hash<std::string>()(key.accountId) ^
+                   (std::hash<std::string>()(key.clOrdID) << 1);
+        }
+    };
+
+    void grow();
+
+    std::array<std::unique_ptr<OrderEntry[]>, kMaxChunks> chunks_;
+    size_t chunkCount_ = 0;
+    std::vector<OrderRef> free_;
+    std::unordered_map<IndexKey, OrderRef, IndexKeyHash> index_;
+    size_t live_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace fix40
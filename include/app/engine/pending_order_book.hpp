@@ -0,0 +1,211 @@
+/**
+ * @file pending_order_book.hpp
+ * @brief 行情驱动撮合的价格索引挂单簿
+ *
+ * 按合约维护用户挂单，买卖两侧各自按价格排序：
+ * 买单价格从高到低、卖单价格从低到高，同价位按到达顺序（FIFO）。
+ * 行情到达时只需从最优价开始访问可成交的前缀，遇到第一个不可成交的价位即停止。
+ *
+ * 订单以紧凑的 EngineOrder 记录存放在 OrderPool 中，以 OrderHandle 引用，
+ * 同价位通过侵入式链表串联；公共 Order 仅在移出挂单簿时物化。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "app/engine/engine_order.hpp"
+#include "app/engine/order_pool.hpp"
+#include "app/model/order.hpp"
+
+namespace fix40 {
+
+/**
+ * @class PendingOrderBook
+ * @brief 单个合约的挂单簿（行情驱动模式）
+ *
+ * @par 复杂度
+ * - add: O(log L)，L 为价位数
+ * - remove: O(1) 定位与解链（句柄索引 + 侵入式链表），价位清空时 O(log L) 删除价位
+ * - 行情触发: O(可成交订单数 + 1)，不再随挂单总数线性增长
+ *
+ * @note 非线程安全，仅由撮合引擎线程访问
+ */
+class PendingOrderBook {
+public:
+    /**
+     * @brief 构造挂单簿
+     * @param symbol 合约代码（物化 Order 时使用）
+     * @param symbolId 合约在 SymbolTable 中的 ID
+     */
+    explicit PendingOrderBook(std::string symbol = "", uint32_t symbolId = 0)
+        : symbol_(std::move(symbol)), symbolId_(symbolId) {}
+
+    /**
+     * @brief 添加挂单
+     * @param order 订单记录（clOrdID 需在本合约内唯一；超长 clOrdID 会被复制保存）
+     * @return OrderHandle 挂单句柄
+     */
+    OrderHandle add(const EngineOrder& order);
+
+    /**
+     * @brief 按 clOrdID 移除挂单
+     * @param clOrdID 客户订单ID
+     * @return 被移除的订单（已物化），不存在返回 nullopt
+     */
+    std::optional<Order> remove(const std::string& clOrdID);
+
+    /**
+     * @brief 按 clOrdID 查找挂单
+     * @return 订单记录指针，不存在返回 nullptr
+     */
+    const EngineOrder* find(const std::string& clOrdID) const;
+
+    /**
+     * @brief 将订单记录物化为公共 Order
+     */
+    Order materialize(const EngineOrder& order) const { return order.toOrder(symbol_); }
+
+    /// 合约代码
+    const std::string& symbol() const { return symbol_; }
+
+    /// 合约 ID
+    uint32_t symbolId() const { return symbolId_; }
+
+    /**
+     * @brief 按 clOrdID 获取挂单句柄
+     * @return OrderHandle 句柄，不存在返回 kInvalidOrderHandle
+     *
+     * 句柄在订单移出挂单簿前保持有效，可用于后续的 O(1) 撤单/改单。
+     */
+    OrderHandle handleOf(const std::string& clOrdID) const;
+
+    /**
+     * @brief 按句柄访问挂单记录
+     * @param handle 有效的挂单句柄
+     */
+    const EngineOrder& at(OrderHandle handle) const { return pool_.get(handle); }
+
+    /**
+     * @brief 按句柄移除挂单（O(1) 解链）
+     * @param handle 有效的挂单句柄
+     * @return 被移除的订单（已物化）
+     */
+    Order removeByHandle(OrderHandle handle);
+
+    /**
+     * @brief 预分配挂单节点
+     */
+    void reserve(size_t count) { pool_.reserve(count); }
+
+    /// 挂单总数（重复 clOrdID 的订单各自计数）
+    size_t size() const { return count_; }
+
+    /// 是否无挂单
+    bool empty() const { return count_ == 0; }
+
+    /// 买方价位数
+    size_t bidLevelCount() const { return bids_.size(); }
+
+    /// 卖方价位数
+    size_t askLevelCount() const { return asks_.size(); }
+
+    /**
+     * @brief 访问价格 >= askPrice 的买单（最优价优先、同价 FIFO）
+     * @param askPrice 对手方卖一价
+     * @param fn 回调 bool(EngineOrder&, bool& exhausted)，返回 true 表示订单已完结需移出挂单簿；
+     *           将 exhausted 置为 true 表示对手方流动性已耗尽，访问完该订单后停止
+     * @return size_t 访问的订单数
+     *
+     * 遇到第一个低于 askPrice 的价位即停止。
+     */
+    template <typename Fn>
+    size_t matchBuys(double askPrice, Fn&& fn) {
+        return matchSide(bids_, [askPrice](double price) { return price >= askPrice; },
+                         std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief 访问价格 <= bidPrice 的卖单（最优价优先、同价 FIFO）
+     * @param bidPrice 对手方买一价
+     * @param fn 回调 bool(EngineOrder&, bool& exhausted)，语义同 matchBuys()
+     * @return size_t 访问的订单数
+     */
+    template <typename Fn>
+    size_t matchSells(double bidPrice, Fn&& fn) {
+        return matchSide(asks_, [bidPrice](double price) { return price <= bidPrice; },
+                         std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief 按优先级遍历全部挂单（先买后卖）
+     * @param fn 回调 void(const EngineOrder&)
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& [price, queue] : bids_) {
+            for (OrderHandle h = queue.head; h != kInvalidOrderHandle; h = pool_.next(h)) fn(pool_.get(h));
+        }
+        for (const auto& [price, queue] : asks_) {
+            for (OrderHandle h = queue.head; h != kInvalidOrderHandle; h = pool_.next(h)) fn(pool_.get(h));
+        }
+    }
+
+private:
+    using BidLevels = std::map<double, OrderQueue, std::greater<double>>;
+    using AskLevels = std::map<double, OrderQueue>;
+
+    /// 挂单在价格索引中的键；市价单排在所有限价之前
+    static double levelPrice(const EngineOrder& order);
+
+    /// 释放节点及其超长 clOrdID 存储（须已从价位队列摘除），索引仍指向该节点时一并删除
+    void releaseNode(OrderHandle handle);
+
+    template <typename Levels, typename Crosses, typename Fn>
+    size_t matchSide(Levels& levels, Crosses crosses, Fn&& fn) {
+        size_t visited = 0;
+        bool exhausted = false;
+        auto levelIt = levels.begin();
+        while (!exhausted && levelIt != levels.end() && crosses(levelIt->first)) {
+            auto& queue = levelIt->second;
+            OrderHandle h = queue.head;
+            while (!exhausted && h != kInvalidOrderHandle) {
+                ++visited;
+                EngineOrder& order = pool_.get(h);
+                if (fn(order, exhausted)) {
+                    const OrderHandle next = pool_.unlink(queue, h);
+                    releaseNode(h);
+                    h = next;
+                } else {
+                    h = pool_.next(h);
+                }
+            }
+            if (queue.empty()) {
+                levelIt = levels.erase(levelIt);
+            } else {
+                ++levelIt;
+            }
+        }
+        return visited;
+    }
+
+    std::string symbol_;    ///< 合约代码
+    uint32_t symbolId_ = 0; ///< 合约 ID
+    BidLevels bids_;        ///< 买方价位：价格从高到低
+    AskLevels asks_;        ///< 卖方价位：价格从低到高
+    OrderPool<EngineOrder> pool_;  ///< 挂单节点池
+    size_t count_ = 0;             ///< 挂单总数
+
+    /// clOrdID -> 挂单句柄（重复时指向最新订单）；键引用节点内的 clOrdID（节点地址稳定，先删索引再释放节点）
+    std::unordered_map<std::string_view, OrderHandle> index_;
+
+    /// 超出内联容量的 clOrdID 存储
+    std::unordered_map<OrderHandle, std::string> longClOrdIDs_;
+};
+
+} // namespace fix40
@@ -0,0 +1,278 @@
+/**
+ * @file price_ladder.hpp
+ * @brief 整数价位阶梯：按最小变动价位离散化的稠密价位窗口
+ *
+ * 价格先换算为整数 tick，价位存放在以 tick 为下标的连续数组窗口中，
+ * 另用位图记录非空价位。相比 std::map<double, Level>：
+ * - 不再以浮点数作为键比较相等；
+ * - 新价位不分配树节点；
+ * - 最优价 O(1)（缓存的最高/最低非空槽位），逐档遍历按 64 槽一字扫描位图。
+ *
+ * 价格超出窗口时按需扩容或重新居中；窗口大小有上限（kMaxSlots）。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fix40 {
+
+/**
+ * @class PriceLadder
+ * @brief 单边价位阶梯
+ *
+ * 提供与 std::map<double, Level> 相同的常用子集（begin/end/find/erase/operator[]），
+ * 迭代顺序为最优价优先：买方（descending）从高到低，卖方从低到高。
+ *
+ * @tparam Level 价位负载类型（需可默认构造与移动）
+ *
+ * @note 非线程安全
+ */
+template <typename Level>
+class PriceLadder {
+    static constexpr size_t kNoSlot = SIZE_MAX;
+
+public:
+    static constexpr size_t kInitialSlots = 256;       ///< 初始窗口槽位数
+    static constexpr size_t kMaxSlots = size_t(1) << 20;  ///< 窗口槽位上限
+
+    /**
+     * @brief 价位迭代器（最优价优先）
+     *
+     * 解引用得到 pair<价格, Level&>，与 map 迭代器的 first/second 用法一致。
+     */
+    template <bool Const>
+    class Iter {
+        using LadderPtr = std::conditional_t<Const, const PriceLadder*, PriceLadder*>;
+        using LevelRef = std::conditional_t<Const, const Level&, Level&>;
+
+    public:
+        using value_type = std::pair<double, LevelRef>;
+
+        struct Arrow {
+            value_type value;
+            const value_type* operator->() const { return &value; }
+        };
+
+        Iter() = default;
+        Iter(LadderPtr ladder, size_t slot) : ladder_(ladder), slot_(slot) {}
+        template <bool C = Const, typename = std::enable_if_t<!C>>
+        operator Iter<true>() const { return Iter<true>(ladder_, slot_); }
+
+        value_type operator*() const {
+            return value_type(ladder_->slotPrice(slot_), ladder_->slots_[slot_]);
+        }
+        Arrow operator->() const { return Arrow{**this}; }
+
+        Iter& operator++() {
+            slot_ = ladder_->nextSlot(slot_);
+            return *this;
+        }
+
+        bool operator==(const Iter& other) const { return slot_ == other.slot_; }
+        bool operator!=(const Iter& other) const { return slot_ != other.slot_; }
+
+    private:
+        friend class PriceLadder;
+        LadderPtr ladder_ = nullptr;
+        size_t slot_ = kNoSlot;
+    };
+
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    /**
+     * @param tick 最小变动价位（> 0）
+     * @param descending true 为买方（高价优先），false 为卖方（低价优先）
+     */
+    PriceLadder(double tick, bool descending)
+        : tick_(tick), descending_(descending) {}
+
+    /// 价格换算为整数 tick
+    int64_t toTicks(double price) const { return std::llround(price / tick_); }
+
+    /// 价格是否落在 tick 网格上
+    bool isOnTick(double price) const {
+        return std::fabs(static_cast<double>(toTicks(price)) * tick_ - price) < 1e-9;
+    }
+
+    /**
+     * @brief 窗口能否容纳该价格（必要时扩容后不超过 kMaxSlots）
+     */
+    bool fits(double price) const {
+        const int64_t ticks = toTicks(price);
+        if (size_ == 0 || inWindow(ticks)) {
+            return true;
+        }
+        const int64_t lo = std::min(ticks, base_ + static_cast<int64_t>(lowSlot_));
+        const int64_t hi = std::max(ticks, base_ + static_cast<int64_t>(highSlot_));
+        return static_cast<uint64_t>(hi - lo) < kMaxSlots;
+    }
+
+    iterator begin() { return iterator(this, bestSlot()); }
+    iterator end() { return iterator(this, kNoSlot); }
+    const_iterator begin() const { return const_iterator(this, bestSlot()); }
+    const_iterator end() const { return const_iterator(this, kNoSlot); }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    /// 当前窗口槽位数
+    size_t windowSize() const { return slots_.size(); }
+
+    /**
+     * @brief 取价位，不存在时创建（调用方需先用 fits() 检查）
+     */
+    Level& operator[](double price) {
+        const int64_t ticks = toTicks(price);
+        if (!inWindow(ticks)) {
+            reposition(ticks);
+        }
+        const size_t slot = static_cast<size_t>(ticks - base_);
+        if (!testBit(slot)) {
+            setBit(slot);
+            slots_[slot] = Level{};
+            ++size_;
+            if (lowSlot_ == kNoSlot || slot < lowSlot_) lowSlot_ = slot;
+            if (highSlot_ == kNoSlot || slot > highSlot_) highSlot_ = slot;
+        }
+        return slots_[slot];
+    }
+
+    iterator find(double price) {
+        return iterator(this, findSlot(price));
+    }
+    const_iterator find(double price) const {
+        return const_iterator(this, findSlot(price));
+    }
+
+    /**
+     * @brief 删除价位
+     * @return 下一个（更差价格的）价位
+     */
+    iterator erase(iterator it) {
+        const size_t slot = it.slot_;
+        const size_t next = nextSlot(slot);
+        clearBit(slot);
+        slots_[slot] = Level{};
+        --size_;
+        if (size_ == 0) {
+            lowSlot_ = highSlot_ = kNoSlot;
+        } else if (slot == lowSlot_) {
+            lowSlot_ = scanUp(slot + 1);
+        } else if (slot == highSlot_) {
+            highSlot_ = scanDown(slot - 1);
+        }
+        return iterator(this, next);
+    }
+
+private:
+    bool inWindow(int64_t ticks) const {
+        return !slots_.empty() && ticks >= base_ &&
+               ticks < base_ + static_cast<int64_t>(slots_.size());
+    }
+
+    double slotPrice(size_t slot) const {
+        return static_cast<double>(base_ + static_cast<int64_t>(slot)) * tick_;
+    }
+
+    size_t findSlot(double price) const {
+        const int64_t ticks = toTicks(price);
+        if (!inWindow(ticks)) {
+            return kNoSlot;
+        }
+        const size_t slot = static_cast<size_t>(ticks - base_);
+        return testBit(slot) ? slot : kNoSlot;
+    }
+
+    size_t bestSlot() const { return descending_ ? highSlot_ : lowSlot_; }
+
+    size_t nextSlot(size_t slot) const {
+        if (descending_) {
+            return slot == 0 ? kNoSlot : scanDown(slot - 1);
+        }
+        return scanUp(slot + 1);
+    }
+
+    bool testBit(size_t slot) const { return (bits_[slot >> 6] >> (slot & 63)) & 1; }
+    void setBit(size_t slot) { bits_[slot >> 6] |= uint64_t(1) << (slot & 63); }
+    void clearBit(size_t slot) { bits_[slot >> 6] &= ~(uint64_t(1) << (slot & 63)); }
+
+    /// 从 slot（含）向高处找第一个非空槽位
+    size_t scanUp(size_t slot) const {
+        if (slot >= slots_.size()) return kNoSlot;
+        size_t word = slot >> 6;
+        uint64_t bits = bits_[word] & (~uint64_t(0) << (slot & 63));
+        while (bits == 0) {
+            if (++word == bits_.size()) return kNoSlot;
+            bits = bits_[word];
+        }
+        return (word << 6) + static_cast<size_t>(__builtin_ctzll(bits));
+    }
+
+    /// 从 slot（含）向低处找第一个非空槽位
+    size_t scanDown(size_t slot) const {
+        if (slot >= slots_.size()) return kNoSlot;
+        size_t word = slot >> 6;
+        const unsigned shift = 63 - static_cast<unsigned>(slot & 63);
+        uint64_t bits = bits_[word] & (~uint64_t(0) >> shift);
+        while (bits == 0) {
+            if (word == 0) return kNoSlot;
+            bits = bits_[--word];
+        }
+        return (word << 6) + 63 - static_cast<size_t>(__builtin_clzll(bits));
+    }
+
+    /**
+     * @brief 扩容或重新居中，使窗口覆盖 ticks 与全部现有价位
+     */
+    void reposition(int64_t ticks) {
+        int64_t lo = ticks;
+        int64_t hi = ticks;
+        if (size_ > 0) {
+            lo = std::min(lo, base_ + static_cast<int64_t>(lowSlot_));
+            hi = std::max(hi, base_ + static_cast<int64_t>(highSlot_));
+        }
+        const size_t span = static_cast<size_t>(hi - lo) + 1;
+        size_t capacity = std::max(slots_.size(), kInitialSlots);
+        while (capacity < span * 2 && capacity < kMaxSlots) {
+            capacity *= 2;
+        }
+        // 新窗口居中放置现有区间，两侧留出余量
+        const int64_t newBase = lo - static_cast<int64_t>((capacity - std::min(span, capacity)) / 2);
+
+        std::vector<Level> slots(capacity);
+        std::vector<uint64_t> bits((capacity + 63) / 64, 0);
+        size_t newLow = kNoSlot;
+        size_t newHigh = kNoSlot;
+        for (size_t slot = lowSlot_; slot != kNoSlot; slot = scanUp(slot + 1)) {
+            const size_t moved = static_cast<size_t>(base_ + static_cast<int64_t>(slot) - newBase);
+            slots[moved] = std::move(slots_[slot]);
+            bits[moved >> 6] |= uint64_t(1) << (moved & 63);
+            if (newLow == kNoSlot) newLow = moved;
+            newHigh = moved;
+        }
+        slots_ = std::move(slots);
+        bits_ = std::move(bits);
+        base_ = newBase;
+        lowSlot_ = newLow;
+        highSlot_ = newHigh;
+    }
+
+    double tick_;
+    bool descending_;
+    int64_t base_ = 0;             ///< 槽位 0 对应的 tick
+    std::vector<Level> slots_;     ///< 价位窗口
+    std::vector<uint64_t> bits_;   ///< 非空价位位图
+    size_t size_ = 0;              ///< 非空价位数
+    size_t lowSlot_ = kNoSlot;     ///< 最低非空槽位
+    size_t highSlot_ = kNoSlot;    ///< 最高非空槽位
+};
+
+} // namespace fix40
@@ -0,0 +1,251 @@
+/**
+ * @file snapshot_table.hpp
+ * @brief 跨线程发布的行情快照表（seqlock）
+ *
+ * 撮合线程维护的行情快照只能由撮合线程访问；其他线程（如 SimulationApp 的工作线程
+ * 做风控检查）需要读取时，通过本表获取一致的副本：
+ * - 每个合约一个固定槽位，槽位在启动时按 InstrumentManager 中的合约预分配，
+ *   运行中出现的新合约从预留槽位中无锁追加；槽位地址此后不再变化；
+ * - 写入方（合约所属的撮合分片，单写者）以 seqlock 发布：序号置奇数 → 写数据 → 序号置偶数；
+ * - 读取方不加锁，读到奇数序号或前后序号不一致时重试；
+ * - 负载按 64 位字以 relaxed 原子读写，读写并发时不构成数据竞争。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "app/model/market_data_snapshot.hpp"
+
+namespace fix40 {
+
+/**
+ * @class SnapshotTable
+ * @brief 固定槽位、seqlock 发布的行情快照表
+ *
+ * @note publish() 对同一合约只能由一个线程调用（合约所属分片）；
+ *       不同合约可由不同线程并发发布。read() 可从任意线程调用。
+ *       reset() 不能与 publish()/read() 并发。
+ */
+class SnapshotTable {
+public:
+    static constexpr size_t kMaxKeyLength = 31;  ///< 合约代码最大长度（与 CTP 行情一致）
+
+    /**
+     * @brief 构造快照表
+     * @param capacity 槽位数（合约数上限）
+     */
+    explicit SnapshotTable(size_t capacity = 0) { reset(capacity); }
+
+    SnapshotTable(const SnapshotTable&) = delete;
+    SnapshotTable& operator=(const SnapshotTable&) = delete;
+
+    /**
+     * @brief 重建为指定容量的空表（不能与读写并发）
+     */
+    void reset(size_t capacity) {
+        capacity_ = capacity;
+        used_.store(0, std::memory_order_relaxed);
+        slots_ = capacity ? std::make_unique<Slot[]>(capacity) : nullptr;
+        size_t buckets = 16;
+        while (buckets < capacity * 2) {
+            buckets *= 2;
+        }
+        bucketMask_ = buckets - 1;
+        buckets_ = std::make_unique<std::atomic<Slot*>[]>(buckets);
+        for (size_t i = 0; i < buckets; ++i) {
+            buckets_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /// 槽位容量
+    size_t capacity() const { return capacity_; }
+
+    /// 已分配的槽位数
+    size_t size() const { return std::min(used_.load(std::memory_order_acquire), capacity_); }
+
+    /**
+     * @brief 预分配合约槽位
+     * @return 槽位已满或代码过长时返回 false
+     */
+    bool reserve(std::string_view instrumentId) { return findOrInsert(instrumentId) != nullptr; }
+
+    /**
+     * @brief 发布合约的最新快照
+     * @return 槽位已满（合约无法发布）时返回 false
+     */
+    bool publish(std::string_view instrumentId, const MarketDataSnapshot& snapshot) {
+        Slot* slot = findOrInsert(instrumentId);
+        if (!slot) {
+            return false;
+        }
+        Quote quote;
+        toQuote(snapshot, quote);
+        uint64_t words[kWords];
+        std::memcpy(words, &quote, sizeof(Quote));
+
+        const uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+        slot->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            slot->words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot->seq.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 读取合约快照的一致副本（无锁）
+     * @param instrumentId 合约代码
+     * @param out 输出快照（深度各档的已消耗量为 0）
+     * @return 合约尚未发布过行情时返回 false
+     */
+    bool read(std::string_view instrumentId, MarketDataSnapshot& out) const {
+        const Slot* slot = find(instrumentId);
+        if (!slot) {
+            return false;
+        }
+        uint64_t words[kWords];
+        for (;;) {
+            const uint32_t before = slot->seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // 写入中
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = slot->words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == before) {
+                if (before == 0) {
+                    return false;  // 已预分配但尚未发布
+                }
+                break;
+            }
+        }
+        Quote quote;
+        std::memcpy(&quote, words, sizeof(Quote));
+        fromQuote(quote, out);
+        out.instrumentId.assign(instrumentId.data(), instrumentId.size());
+        return true;
+    }
+
+private:
+    /// 发布的快照负载（可平凡复制，按 64 位字读写）
+    struct Quote {
+        double lastPrice;
+        double bidPrice1;
+        double askPrice1;
+        double upperLimitPrice;
+        double lowerLimitPrice;
+        int64_t updateTimeNs;
+        int32_t bidVolume1;
+        int32_t askVolume1;
+        double bidDepthPrice[MarketDataSnapshot::kDepthLevels];
+        double askDepthPrice[MarketDataSnapshot::kDepthLevels];
+        int32_t bidDepthVolume[MarketDataSnapshot::kDepthLevels];
+        int32_t askDepthVolume[MarketDataSnapshot::kDepthLevels];
+    };
+    static_assert(sizeof(Quote) % sizeof(uint64_t) == 0, "Quote must be a whole number of words");
+    static constexpr size_t kWords = sizeof(Quote) / sizeof(uint64_t);
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> seq{0};     ///< seqlock 序号：奇数表示写入中，0 表示未发布
+        uint8_t keyLength = 0;
+        char key[kMaxKeyLength] = {};
+        std::atomic<uint64_t> words[kWords] = {};
+    };
+
+    static void toQuote(const MarketDataSnapshot& s, Quote& q) {
+        q.lastPrice = s.lastPrice;
+        q.bidPrice1 = s.bidPrice1;
+        q.askPrice1 = s.askPrice1;
+        q.upperLimitPrice = s.upperLimitPrice;
+        q.lowerLimitPrice = s.lowerLimitPrice;
+        q.updateTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             s.updateTime.time_since_epoch()).count();
+        q.bidVolume1 = s.bidVolume1;
+        q.askVolume1 = s.askVolume1;
+        for (size_t i = 0; i < MarketDataSnapshot::kDepthLevels; ++i) {
+            q.bidDepthPrice[i] = s.bidDepth[i].price;
+            q.askDepthPrice[i] = s.askDepth[i].price;
+            q.bidDepthVolume[i] = s.bidDepth[i].volume;
+            q.askDepthVolume[i] = s.askDepth[i].volume;
+        }
+    }
+
+    static void fromQuote(const Quote& q, MarketDataSnapshot& s) {
+        s.lastPrice = q.lastPrice;
+        s.bidPrice1 = q.bidPrice1;
+        s.askPrice1 = q.askPrice1;
+        s.upperLimitPrice = q.upperLimitPrice;
+        s.lowerLimitPrice = q.lowerLimitPrice;
+        s.updateTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(q.updateTimeNs)));
+        s.bidVolume1 = q.bidVolume1;
+        s.askVolume1 = q.askVolume1;
+        for (size_t i = 0; i < MarketDataSnapshot::kDepthLevels; ++i) {
+            s.bidDepth[i] = {q.bidDepthPrice[i], q.bidDepthVolume[i], 0};
+            s.askDepth[i] = {q.askDepthPrice[i], q.askDepthVolume[i], 0};
+        }
+    }
+
+    static bool matches(const Slot& slot, std::string_view key) {
+        return slot.keyLength == key.size() && std::memcmp(slot.key, key.data(), key.size()) == 0;
+    }
+
+    size_t bucketOf(std::string_view key) const { return std::hash<std::string_view>()(key) & bucketMask_; }
+
+    const Slot* find(std::string_view key) const {
+        for (size_t i = bucketOf(key);; i = (i + 1) & bucketMask_) {
+            const Slot* slot = buckets_[i].load(std::memory_order_acquire);
+            if (!slot) return nullptr;
+            if (matches(*slot, key)) return slot;
+        }
+    }
+
+    /// 查找槽位，不存在时从预分配池中取一个插入（写入方调用）
+    Slot* findOrInsert(std::string_view key) {
+        if (key.empty() || key.size() > kMaxKeyLength) {
+            return nullptr;
+        }
+        Slot* fresh = nullptr;
+        for (size_t i = bucketOf(key);; i = (i + 1) & bucketMask_) {
+            Slot* slot = buckets_[i].load(std::memory_order_acquire);
+            if (!slot) {
+                if (!fresh) {
+                    const size_t index = used_.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= capacity_) {
+                        return nullptr;  // 槽位耗尽
+                    }
+                    fresh = &slots_[index];
+                    fresh->keyLength = static_cast<uint8_t>(key.size());
+                    std::memcpy(fresh->key, key.data(), key.size());
+                }
+                // 其他分片可能同时插入别的合约，CAS 失败则继续探测
+                if (buckets_[i].compare_exchange_strong(slot, fresh, std::memory_order_acq_rel)) {
+                    return fresh;
+                }
+            }
+            if (matches(*slot, key)) {
+                return slot;
+            }
+        }
+    }
+
+    size_t capacity_ = 0;
+    std::atomic<size_t> used_{0};
+    std::unique_ptr<Slot[]> slots_;
+    size_t bucketMask_ = 0;
+    std::unique_ptr<std::atomic<Slot*>[]> buckets_;
+};
+
+} // namespace fix40
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <mutex>
 #include <vector>
@@ -36,6 +37,10 @@ class IStore;
  * 3. 撤单/拒绝时：unfreezeMargin() - 释放冻结
  * 4. 平仓时：releaseMargin() - 释放占用
  *
+ * @par 持久化
+ * 资金变动（冻结/释放/占用/平仓盈亏）立即持久化；行情驱动的浮动盈亏更新每跳都会发生，
+ * 只标记账户为脏，由调用方定期调用 flushDirty() 批量落盘。
+ *
  * @par 使用示例
  * @code
  * AccountManager mgr;
@@ -110,6 +115,14 @@ public:
      */
     std::optional<Account> getAccount(const std::string& accountId) const;
 
+    /**
+     * @brief 获取账户可用资金（不复制整个账户，供下单风控使用）
+     *
+     * @param accountId 账户ID
+     * @return 可用资金，账户不存在时返回 std::nullopt
+     */
+    std::optional<double> getAvailable(const std::string& accountId) const;
+
     /**
      * @brief 检查账户是否存在
      *
@@ -206,6 +219,7 @@ public:
      * @brief 更新持仓盈亏
      *
      * 更新账户的浮动盈亏，同时更新可用资金。
+     * 不立即持久化，只将账户标记为脏，由 flushDirty() 落盘。
      *
      * @param accountId 账户ID
      * @param profit 新的持仓盈亏值（不是增量）
@@ -229,6 +243,24 @@ public:
      */
     bool addCloseProfit(const std::string& accountId, double profit);
 
+    // -------------------------------------------------------------------------
+    // 持久化
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief 持久化所有脏账户
+     *
+     * 每个脏账户只写入一次当前状态，两次 flush 之间的多次盈亏变化合并为一次写入。
+     *
+     * @return 本次持久化的账户数
+     */
+    size_t flushDirty();
+
+    /**
+     * @brief 待持久化的脏账户数
+     */
+    size_t dirtyCount() const;
+
     // -------------------------------------------------------------------------
     // 清理方法
     // -------------------------------------------------------------------------
@@ -249,10 +281,13 @@ private:
     /// 账户映射表：accountId -> Account
     std::unordered_map<std::string, Account> accounts_;
 
+    /// 浮动盈亏已变化、尚未持久化的账户
+    std::unordered_set<std::string> dirty_;
+
     /// 存储接口（可为nullptr）
     IStore* store_;
 
-    /// 互斥锁，保护 accounts_
+    /// 互斥锁，保护 accounts_ 和 dirty_
     mutable std::mutex mutex_;
 };
 
@@ -0,0 +1,92 @@
+/**
+ * @file instrument_batch.hpp
+ * @brief 合约分批发布缓冲
+ *
+ * CTP 合约查询逐条回调，合约表整体替换，逐条 addInstrument 会反复复制整张表。
+ * InstrumentBatchLoader 先缓存回调的合约，攒满一批再一次性发布；
+ * 查询超时未收到最后一条时由等待方调用 flush() 发布剩余部分，已收到的合约不会丢失。
+ */
+
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "app/manager/instrument_manager.hpp"
+#include "app/model/instrument.hpp"
+
+namespace fix40 {
+
+/**
+ * @class InstrumentBatchLoader
+ * @brief 按批发布合约到 InstrumentManager
+ *
+ * @note 线程安全：查询回调线程调用 add()，等待线程在超时后调用 flush()。
+ */
+class InstrumentBatchLoader {
+public:
+    /// 默认每批发布的合约数
+    static constexpr size_t kDefaultBatchSize = 500;
+
+    /**
+     * @brief 构造
+     * @param batchSize 每批发布的合约数（0 表示只在 flush() 时发布）
+     */
+    explicit InstrumentBatchLoader(size_t batchSize = kDefaultBatchSize)
+        : batchSize_(batchSize) {}
+
+    /**
+     * @brief 缓存一个合约，攒满一批时发布
+     * @param manager 目标合约管理器
+     * @param instrument 合约信息
+     */
+    void add(InstrumentManager& manager, Instrument instrument) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(instrument));
+        if (batchSize_ > 0 && pending_.size() >= batchSize_) {
+            publishLocked(manager);
+        }
+    }
+
+    /**
+     * @brief 发布剩余缓存的合约（查询结束或超时时调用）
+     * @param manager 目标合约管理器
+     * @return 本次发布的合约数
+     */
+    size_t flush(InstrumentManager& manager) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return publishLocked(manager);
+    }
+
+    /**
+     * @brief 丢弃缓存（开始新一轮查询时调用）
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+    }
+
+    /**
+     * @brief 当前缓存、尚未发布的合约数
+     */
+    size_t pendingCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+private:
+    size_t publishLocked(InstrumentManager& manager) {
+        const size_t count = pending_.size();
+        if (count > 0) {
+            manager.addInstruments(pending_);
+            pending_.clear();
+        }
+        return count;
+    }
+
+    size_t batchSize_;
+    mutable std::mutex mutex_;
+    std::vector<Instrument> pending_;
+};
+
+} // namespace fix40
@@ -0,0 +1,101 @@
+/**
+ * @file instrument_catalog.hpp
+ * @brief 合约目录缓存（二进制，可 mmap）
+ *
+ * 盘中重启时重新向 CTP 查询全量合约需要逐条回调，耗时较长。
+ * 成功查询（或加载 JSON）后把合约写成紧凑的二进制目录，下次启动直接映射读取。
+ *
+ * @par 文件格式（本机字节序）
+ * @code
+ * 文件头:  magic "FIX40ICT" | u32 version | u32 count | u32 recordSize | u32 stringBytes
+ *          | i64 createdAtNs | u64 checksum | 24 字节保留
+ * 记录:    count × CatalogRecord（定长 64 字节，见 instrument_catalog.cpp）
+ * 字符串:  stringBytes 字节的字符串池，记录以 偏移 + 长度 引用
+ * @endcode
+ * - 校验和为记录区与字符串池的 FNV-1a 64，截断或损坏的文件不会被加载；
+ * - 版本号或记录大小不符时拒绝加载，由调用方回退到 CTP / JSON 并重写目录；
+ * - 写入先写临时文件再 rename，进程中途退出不会留下半个目录。
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "app/model/instrument.hpp"
+
+namespace fix40 {
+
+/**
+ * @class InstrumentCatalog
+ * @brief 合约目录的只读映射
+ *
+ * open() 以只读方式 mmap 整个文件并校验，instrument(i) 按下标直接读取记录。
+ */
+class InstrumentCatalog {
+public:
+    static constexpr char kMagic[8] = {'F', 'I', 'X', '4', '0', 'I', 'C', 'T'};
+    static constexpr uint32_t kVersion = 1;
+
+    InstrumentCatalog() = default;
+    ~InstrumentCatalog();
+    InstrumentCatalog(const InstrumentCatalog&) = delete;
+    InstrumentCatalog& operator=(const InstrumentCatalog&) = delete;
+
+    /**
+     * @brief 写入合约目录
+     * @param path 文件路径
+     * @param instruments 合约列表
+     * @param error 失败时的原因，可为空
+     * @return 写入失败返回 false
+     */
+    static bool write(const std::string& path, const std::vector<Instrument>& instruments,
+                      std::string* error = nullptr);
+
+    /**
+     * @brief 映射并校验合约目录
+     * @return 文件不存在或格式不符返回 false（原因见 error()）
+     */
+    bool open(const std::string& path);
+
+    /// 解除映射
+    void close();
+
+    /// 是否已打开
+    bool isOpen() const { return data_ != nullptr; }
+
+    /// 合约数量
+    size_t size() const { return count_; }
+
+    /// 第 index 个合约
+    Instrument instrument(size_t index) const;
+
+    /// 全部合约
+    std::vector<Instrument> instruments() const;
+
+    /// 目录写入时刻
+    std::chrono::system_clock::time_point createdAt() const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(createdAtNs_)));
+    }
+
+    /// 最近一次错误
+    const std::string& error() const { return error_; }
+
+private:
+    bool fail(const std::string& reason);
+
+    const char* data_ = nullptr;   ///< 映射首地址
+    size_t mappedSize_ = 0;
+    size_t count_ = 0;
+    const char* records_ = nullptr;
+    const char* strings_ = nullptr;
+    size_t stringBytes_ = 0;
+    int64_t createdAtNs_ = 0;
+    std::string error_;
+};
+
+} // namespace fix40
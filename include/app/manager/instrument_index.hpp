@@ -0,0 +1,96 @@
+/**
+ * @file instrument_index.hpp
+ * @brief 合约代码检索索引
+ *
+ * 客户端搜索框每敲一个字符就发一次合约搜索请求（U7），加载 CTP 全量合约后
+ * 合约数可达数千，逐个比较前缀再整体排序代价过高。
+ * InstrumentSearchIndex 在合约集合变化后整体重建一次：合约代码有序存放，
+ * 前缀搜索为两次二分定位区间 O(log n + k)；品种、交易所二级索引直接给出有序结果。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "app/model/instrument.hpp"
+
+namespace fix40 {
+
+/**
+ * @class InstrumentSearchIndex
+ * @brief 有序合约代码表 + 品种 / 交易所二级索引
+ *
+ * @note 构建后不可变，可从任意线程读取。
+ */
+class InstrumentSearchIndex {
+public:
+    InstrumentSearchIndex() = default;
+
+    /**
+     * @brief 由当前全部合约构建
+     * @param instruments 合约映射表（instrumentId -> Instrument）
+     */
+    explicit InstrumentSearchIndex(const std::unordered_map<std::string, Instrument>& instruments) {
+        ids_.reserve(instruments.size());
+        for (const auto& [instrumentId, instrument] : instruments) {
+            ids_.push_back(instrumentId);
+        }
+        std::sort(ids_.begin(), ids_.end());
+
+        // 按有序代码依次追加，二级索引内部天然有序
+        for (const auto& instrumentId : ids_) {
+            const Instrument& instrument = instruments.at(instrumentId);
+            byProduct_[instrument.productId].push_back(instrumentId);
+            byExchange_[instrument.exchangeId].push_back(instrumentId);
+        }
+    }
+
+    /**
+     * @brief 按前缀搜索
+     * @param prefix 合约代码前缀（空前缀不匹配任何合约）
+     * @param limit 返回结果数量上限
+     * @return 匹配的合约代码（按字母排序）
+     */
+    std::vector<std::string> searchByPrefix(const std::string& prefix, size_t limit) const {
+        std::vector<std::string> results;
+        if (prefix.empty()) {
+            return results;
+        }
+        auto it = std::lower_bound(ids_.begin(), ids_.end(), prefix);
+        while (it != ids_.end() && results.size() < limit &&
+               it->compare(0, prefix.size(), prefix) == 0) {
+            results.push_back(*it++);
+        }
+        return results;
+    }
+
+    /// 某品种的全部合约代码（有序），品种不存在时返回空
+    const std::vector<std::string>& byProduct(const std::string& productId) const {
+        return lookup(byProduct_, productId);
+    }
+
+    /// 某交易所的全部合约代码（有序），交易所不存在时返回空
+    const std::vector<std::string>& byExchange(const std::string& exchangeId) const {
+        return lookup(byExchange_, exchangeId);
+    }
+
+    /// 全部合约代码（有序）
+    const std::vector<std::string>& ids() const { return ids_; }
+
+private:
+    using SecondaryIndex = std::unordered_map<std::string, std::vector<std::string>>;
+
+    static const std::vector<std::string>& lookup(const SecondaryIndex& index, const std::string& key) {
+        static const std::vector<std::string> kEmpty;
+        auto it = index.find(key);
+        return it != index.end() ? it->second : kEmpty;
+    }
+
+    std::vector<std::string> ids_;
+    SecondaryIndex byProduct_;
+    SecondaryIndex byExchange_;
+};
+
+} // namespace fix40
@@ -8,12 +8,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <optional>
 #include <mutex>
 #include <vector>
 #include "app/model/instrument.hpp"
+#include "app/manager/instrument_index.hpp"
+#include "app/manager/instrument_table.hpp"
+#include "app/manager/risk_params.hpp"
+#include "base/published_ptr.hpp"
 
 namespace fix40 {
 
@@ -25,7 +32,9 @@ namespace fix40 {
  * 系统启动时从配置文件加载合约静态信息，运行时从行情更新涨跌停价格。
  *
  * @par 线程安全
- * 所有公共方法都是线程安全的，使用互斥锁保护内部数据。
+ * 所有公共方法都是线程安全的。合约表不可变，加载/添加合约时在写锁内构建新表后整体替换，
+ * 通过 PublishedPtr 发布：查询和涨跌停价、昨结算价的更新只在合约表替换后的第一次读取时
+ * 加一次锁刷新线程本地缓存，此后不加锁（见 published_ptr.hpp、instrument_table.hpp）。
  *
  * @par 使用示例
  * @code
@@ -35,7 +44,7 @@ namespace fix40 {
  * mgr.loadFromConfig("config/instruments.json");
  * 
  * // 查询合约信息
- * const Instrument* inst = mgr.getInstrument("IF2601");
+ * auto inst = mgr.getInstrument("IF2601");
  * if (inst) {
  *     double margin = inst->calculateMargin(4000.0, 2);
  * }
@@ -94,6 +103,27 @@ public:
      */
     bool loadFromConfig(const std::string& configPath);
 
+    /**
+     * @brief 从二进制合约目录加载
+     *
+     * 目录由 saveCatalog() 在成功查询 CTP 或加载 JSON 后写入（格式见 instrument_catalog.hpp），
+     * 盘中重启时直接映射读取，跳过逐条查询与文本解析。
+     *
+     * @param catalogPath 目录文件路径
+     * @param maxAge 目录最长有效期，超过视为过期不加载；0 表示不限
+     * @return 加载成功返回 true；文件不存在、损坏、版本不符或过期返回 false
+     */
+    bool loadFromCatalog(const std::string& catalogPath,
+                         std::chrono::seconds maxAge = std::chrono::seconds(0));
+
+    /**
+     * @brief 把当前全部合约（含当前涨跌停价、昨结算价）写入二进制合约目录
+     *
+     * @param catalogPath 目录文件路径
+     * @return 写入成功返回 true
+     */
+    bool saveCatalog(const std::string& catalogPath) const;
+
     /**
      * @brief 添加单个合约
      *
@@ -122,21 +152,38 @@ public:
     /**
      * @brief 获取合约信息
      *
-     * @param instrumentId 合约代码
-     * @return 合约信息指针，不存在时返回 nullptr
+     * 返回调用时刻的完整合约信息（含当前涨跌停价、昨结算价），合约被覆盖或清空后仍然有效；
+     * 之后的价格更新不会反映到已返回的对象上。
+     * 热路径上只需要合约乘数、保证金率等静态字段时，用 getTable() 取条目的 info，避免复制。
      *
-     * @note 返回的指针在下次修改操作前有效
+     * @param instrumentId 合约代码
+     * @return 合约信息，不存在时返回空
      */
-    const Instrument* getInstrument(const std::string& instrumentId) const;
+    std::shared_ptr<const Instrument> getInstrument(const std::string& instrumentId) const;
 
     /**
      * @brief 获取合约信息（可选类型）
      *
      * @param instrumentId 合约代码
-     * @return 合约信息的副本，不存在时返回 std::nullopt
+     * @return 合约信息的副本（含当前涨跌停价、昨结算价），不存在时返回 std::nullopt
      */
     std::optional<Instrument> getInstrumentCopy(const std::string& instrumentId) const;
 
+    /**
+     * @brief 获取合约当前的涨跌停价、昨结算价（无锁）
+     *
+     * @param instrumentId 合约代码
+     * @return 价格的一致副本，合约不存在时返回 std::nullopt
+     */
+    std::optional<InstrumentPrices> getPrices(const std::string& instrumentId) const;
+
+    /**
+     * @brief 获取当前合约表
+     *
+     * @return 不可变的合约表，调用方可长期持有
+     */
+    std::shared_ptr<const InstrumentTable> getTable() const;
+
     /**
      * @brief 检查合约是否存在
      *
@@ -163,6 +210,7 @@ public:
      * @brief 按前缀搜索合约
      *
      * 用于实现合约代码的自动补全功能。
+     * 在有序代码索引上二分定位，复杂度 O(log n + k)，不持有管理器锁。
      *
      * @param prefix 合约代码前缀（如 "IF"）
      * @param limit 返回结果数量上限（默认 10）
@@ -180,7 +228,7 @@ public:
      * @brief 按品种获取所有合约
      *
      * @param productId 品种代码（如 "IF"）
-     * @return 该品种的所有合约代码列表
+     * @return 该品种的所有合约代码列表（按字母排序）
      */
     std::vector<std::string> getInstrumentsByProduct(const std::string& productId) const;
 
@@ -188,10 +236,31 @@ public:
      * @brief 按交易所获取所有合约
      *
      * @param exchangeId 交易所代码（如 "CFFEX"）
-     * @return 该交易所的所有合约代码列表
+     * @return 该交易所的所有合约代码列表（按字母排序）
      */
     std::vector<std::string> getInstrumentsByExchange(const std::string& exchangeId) const;
 
+    /**
+     * @brief 获取风控参数表
+     *
+     * 合约登记、昨结算价更新时由写入方在写锁内重建并发布，本方法只读取已发布的表，
+     * 加锁情况见 PublishedPtr。涨跌停价随行情频繁变化，不在表内，
+     * 风控从行情快照读取。
+     *
+     * @return 不可变的参数表，调用方可长期持有
+     */
+    std::shared_ptr<const RiskParamTable> getRiskParams() const;
+
+    /**
+     * @brief 获取合约检索索引
+     *
+     * 合约集合变化后，下次调用时整体重建一次；连续多次 addInstrument
+     * 也只在之后的第一次检索重建，不会每条合约重建一次。
+     *
+     * @return 不可变的检索索引，调用方可长期持有
+     */
+    std::shared_ptr<const InstrumentSearchIndex> getSearchIndex() const;
+
     // -------------------------------------------------------------------------
     // 更新方法
     // -------------------------------------------------------------------------
@@ -229,10 +298,24 @@ public:
     void clear();
 
 private:
-    /// 合约映射表：instrumentId -> Instrument
-    std::unordered_map<std::string, Instrument> instruments_;
+    /**
+     * @brief 在当前表基础上覆盖/追加合约并发布新表（调用方持有 mutex_）
+     */
+    void publishLocked(const Instrument* first, size_t count);
+
+    /// 当前合约表（替换时在 mutex_ 内；读取见 PublishedPtr 的加锁保证）
+    PublishedPtr<InstrumentTable> table_{std::make_shared<const InstrumentTable>()};
+
+    /// 风控参数表（写入方在 mutex_ 内随合约表一起重建）
+    PublishedPtr<RiskParamTable> riskParams_{std::make_shared<const RiskParamTable>()};
+
+    /// 合约检索索引（惰性重建）
+    mutable PublishedPtr<InstrumentSearchIndex> searchIndex_;
+
+    /// 合约检索索引是否需要重建（合约集合变化时在锁内置位）
+    mutable std::atomic<bool> searchIndexDirty_{true};
 
-    /// 互斥锁，保护 instruments_
+    /// 写锁：串行化合约表替换及派生表重建
     mutable std::mutex mutex_;
 };
 
@@ -0,0 +1,221 @@
+/**
+ * @file instrument_table.hpp
+ * @brief 不可变合约表与价格槽位
+ *
+ * 合约静态信息（代码、交易所、合约乘数、保证金率等）只在加载时变化，
+ * 涨跌停价每个 tick 都由撮合线程写入，二者放在一起用同一把锁保护时，
+ * 行情和下单两条热路径都要争用这把锁，且 getInstrument 返回的裸指针在锁外被读取。
+ *
+ * 现在拆成两部分：
+ * - InstrumentTable：合约代码 -> 合约条目，构建后不可变，加载/添加合约时整体替换（RCU），
+ *   通过 PublishedPtr 发布（表未替换时读取不加锁），持有 shared_ptr 期间条目不会释放；
+ * - InstrumentPriceSlot：每个条目内的涨跌停价、昨结算价，以 seqlock 发布，
+ *   在表替换之间保持（未被覆盖的合约沿用原条目），读写都不加锁。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "app/model/instrument.hpp"
+
+namespace fix40 {
+
+/**
+ * @struct InstrumentPrices
+ * @brief 合约的可变价格字段
+ */
+struct InstrumentPrices {
+    double upperLimitPrice = 0.0;     ///< 涨停价
+    double lowerLimitPrice = 0.0;     ///< 跌停价
+    double preSettlementPrice = 0.0;  ///< 昨结算价
+};
+
+/**
+ * @class InstrumentPriceSlot
+ * @brief seqlock 保护的价格槽位
+ *
+ * 写入方以 CAS 把序号置为奇数后写入（涨跌停价由合约所属的撮合分片写入，
+ * 昨结算价可能来自其他线程，需要互斥），读取方读到奇数序号或前后序号不一致时重试。
+ * 负载按 64 位字以 relaxed 原子读写，读写并发时不构成数据竞争。
+ */
+class InstrumentPriceSlot {
+public:
+    explicit InstrumentPriceSlot(const InstrumentPrices& initial = {}) {
+        uint64_t words[kWords];
+        std::memcpy(words, &initial, sizeof(InstrumentPrices));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    InstrumentPriceSlot(const InstrumentPriceSlot&) = delete;
+    InstrumentPriceSlot& operator=(const InstrumentPriceSlot&) = delete;
+
+    /// 读取一致的价格副本（无锁）
+    InstrumentPrices load() const {
+        uint64_t words[kWords];
+        for (;;) {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // 写入中
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        InstrumentPrices prices;
+        std::memcpy(&prices, words, sizeof(InstrumentPrices));
+        return prices;
+    }
+
+    /// 更新涨跌停价（价格未变化时不写，避免读取方所在缓存行失效）
+    void updateLimitPrices(double upper, double lower) {
+        InstrumentPrices prices = load();
+        if (prices.upperLimitPrice == upper && prices.lowerLimitPrice == lower) {
+            return;
+        }
+        modify([upper, lower](InstrumentPrices& p) {
+            p.upperLimitPrice = upper;
+            p.lowerLimitPrice = lower;
+        });
+    }
+
+    /// 更新昨结算价
+    void updatePreSettlementPrice(double preSettlementPrice) {
+        modify([preSettlementPrice](InstrumentPrices& p) {
+            p.preSettlementPrice = preSettlementPrice;
+        });
+    }
+
+private:
+    static_assert(sizeof(InstrumentPrices) % sizeof(uint64_t) == 0,
+                  "InstrumentPrices must be a whole number of words");
+    static constexpr size_t kWords = sizeof(InstrumentPrices) / sizeof(uint64_t);
+
+    template<typename Fn>
+    void modify(Fn&& fn) {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (!(seq & 1) &&
+                seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+                break;
+            }
+            seq = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        InstrumentPrices prices;
+        std::memcpy(&prices, words, sizeof(InstrumentPrices));
+        fn(prices);
+        std::memcpy(words, &prices, sizeof(InstrumentPrices));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t> seq_{0};  ///< seqlock 序号：奇数表示写入中
+    std::atomic<uint64_t> words_[kWords];
+};
+
+/**
+ * @struct InstrumentEntry
+ * @brief 合约条目：不可变的静态信息 + 价格槽位
+ */
+struct InstrumentEntry {
+    /// 静态信息；其中的涨跌停价、昨结算价为登记时的值，当前值见 prices
+    const Instrument info;
+
+    /// 涨跌停价、昨结算价的当前值
+    InstrumentPriceSlot prices;
+
+    explicit InstrumentEntry(const Instrument& instrument)
+        : info(instrument)
+        , prices(InstrumentPrices{instrument.upperLimitPrice, instrument.lowerLimitPrice,
+                                  instrument.preSettlementPrice}) {}
+
+    /// 合并当前价格后的完整合约信息
+    Instrument current() const {
+        Instrument instrument = info;
+        const InstrumentPrices p = prices.load();
+        instrument.upperLimitPrice = p.upperLimitPrice;
+        instrument.lowerLimitPrice = p.lowerLimitPrice;
+        instrument.preSettlementPrice = p.preSettlementPrice;
+        return instrument;
+    }
+};
+
+/**
+ * @class InstrumentTable
+ * @brief 合约代码 -> 合约条目（不可变）
+ *
+ * 新表由旧表复制条目指针后覆盖/追加得到，未变化的合约与旧表共享条目（及其价格槽位）。
+ *
+ * @note 构建后不可变，可从任意线程读取。
+ */
+class InstrumentTable {
+public:
+    using EntryMap = std::unordered_map<std::string, std::shared_ptr<InstrumentEntry>>;
+
+    InstrumentTable() = default;
+
+    /**
+     * @brief 在旧表基础上覆盖/追加合约
+     * @param previous 旧表（共享其条目），可为空
+     * @param first 新合约数组首地址
+     * @param count 新合约数量（同一代码以后出现者为准，与逐个覆盖一致）
+     */
+    InstrumentTable(const InstrumentTable* previous, const Instrument* first, size_t count) {
+        if (previous) {
+            entries_ = previous->entries_;
+        }
+        entries_.reserve(entries_.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            entries_[first[i].instrumentId] = std::make_shared<InstrumentEntry>(first[i]);
+        }
+    }
+
+    /**
+     * @brief 查找合约条目
+     * @return 不存在时返回 nullptr；指针在调用方持有本表期间有效
+     */
+    InstrumentEntry* find(const std::string& instrumentId) const {
+        auto it = entries_.find(instrumentId);
+        return it != entries_.end() ? it->second.get() : nullptr;
+    }
+
+    /// 合约数量
+    size_t size() const { return entries_.size(); }
+
+    /// 全部条目
+    const EntryMap& entries() const { return entries_; }
+
+    /// 合并当前价格后的全部合约（用于重建派生索引）
+    std::unordered_map<std::string, Instrument> materialize() const {
+        std::unordered_map<std::string, Instrument> instruments;
+        instruments.reserve(entries_.size());
+        for (const auto& [instrumentId, entry] : entries_) {
+            instruments.emplace(instrumentId, entry->current());
+        }
+        return instruments;
+    }
+
+private:
+    EntryMap entries_;
+};
+
+} // namespace fix40
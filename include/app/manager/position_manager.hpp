@@ -37,6 +37,11 @@ class IStore;
  * - 平仓：减少持仓量，计算平仓盈亏
  * - 浮动盈亏：根据最新价实时计算
  *
+ * @par 行情索引
+ * 除按 accountId_instrumentId 索引外，还维护合约 → 持仓、账户 → 持仓的索引和按账户汇总的浮动盈亏，
+ * 每跳行情只遍历该合约的持仓（markToMarket），账户总盈亏增量维护，getTotalProfit 为 O(1)。
+ * 持仓记录创建后不会删除（平仓后数量清零），索引中的指针始终有效。
+ *
  * @par 使用示例
  * @code
  * PositionManager mgr;
@@ -55,6 +60,15 @@ class IStore;
  */
 class PositionManager {
 public:
+    /**
+     * @struct AccountProfit
+     * @brief 一次盯市后受影响账户的总浮动盈亏
+     */
+    struct AccountProfit {
+        std::string accountId;   ///< 账户ID
+        double totalProfit;      ///< 账户全部持仓的浮动盈亏合计
+    };
+
     // -------------------------------------------------------------------------
     // 构造函数
     // -------------------------------------------------------------------------
@@ -105,6 +119,18 @@ public:
      */
     std::vector<Position> getPositionsByAccount(const std::string& accountId) const;
 
+    /**
+     * @brief 获取持仓数量（不复制持仓、不构造复合键，供下单风控使用）
+     *
+     * @param accountId 账户ID
+     * @param instrumentId 合约代码
+     * @param[out] longPosition 多头持仓，无持仓时为 0
+     * @param[out] shortPosition 空头持仓，无持仓时为 0
+     * @return 有持仓记录返回 true
+     */
+    bool getPositionQty(const std::string& accountId, const std::string& instrumentId,
+                        int64_t& longPosition, int64_t& shortPosition) const;
+
     /**
      * @brief 获取所有持仓
      *
@@ -194,6 +220,22 @@ public:
      */
     void updateAllProfits(const MarketDataSnapshot& snapshot, int volumeMultiple);
 
+    /**
+     * @brief 按最新价盯市指定合约的全部持仓
+     *
+     * 只遍历该合约的持仓，不复制持仓、不拼接键。
+     *
+     * @param instrumentId 合约代码
+     * @param lastPrice 最新价
+     * @param volumeMultiple 合约乘数
+     * @param[out] affected 有持仓的账户及其更新后的总浮动盈亏（先清空）
+     * @return 更新的持仓数
+     */
+    size_t markToMarket(const std::string& instrumentId,
+                        double lastPrice,
+                        int volumeMultiple,
+                        std::vector<AccountProfit>& affected);
+
     /**
      * @brief 更新指定持仓的浮动盈亏
      *
@@ -235,6 +277,25 @@ private:
      */
     static std::string makeKey(const std::string& accountId, const std::string& instrumentId);
 
+    /**
+     * @brief 合约索引项
+     */
+    struct IndexedPosition {
+        Position* position;      ///< 指向 positions_ 中的持仓
+        double* accountProfit;   ///< 指向 accountProfits_ 中所属账户的汇总盈亏
+    };
+
+    /**
+     * @brief 插入新持仓并登记索引（调用方持有锁）
+     */
+    Position& insertPosition(const std::string& key, Position position);
+
+    /**
+     * @brief 按最新价更新持仓盈亏，并把变化量计入账户汇总（调用方持有锁）
+     */
+    static void applyProfit(Position& position, double& accountProfit,
+                            double lastPrice, int volumeMultiple);
+
     /**
      * @brief 持久化持仓（内部方法）
      *
@@ -248,7 +309,16 @@ private:
     /// 存储接口（可为nullptr）
     IStore* store_;
 
-    /// 互斥锁，保护 positions_
+    /// 合约索引：instrumentId -> 该合约的全部持仓
+    std::unordered_map<std::string, std::vector<IndexedPosition>> byInstrument_;
+
+    /// 账户索引：accountId -> 该账户的全部持仓
+    std::unordered_map<std::string, std::vector<Position*>> byAccount_;
+
+    /// 账户汇总浮动盈亏：accountId -> 全部持仓浮动盈亏合计
+    std::unordered_map<std::string, double> accountProfits_;
+
+    /// 互斥锁，保护 positions_ 及索引
     mutable std::mutex mutex_;
 };
 
@@ -15,6 +15,7 @@
 #include "app/model/position.hpp"
 #include "app/model/instrument.hpp"
 #include "app/model/market_data_snapshot.hpp"
+#include "app/manager/risk_params.hpp"
 
 namespace fix40 {
 
@@ -109,6 +110,46 @@ enum class OffsetFlag {
     CLOSE = 1   ///< 平仓
 };
 
+// ============================================================================
+// 快速检查的输入与结果
+// ============================================================================
+
+/**
+ * @struct RiskCheckInput
+ * @brief 快速风控检查的输入
+ *
+ * 只包含检查用到的标量：调用方从账户、持仓、行情中取出这几个值即可，
+ * 不必复制 Account / Position / Instrument 整体。
+ */
+struct RiskCheckInput {
+    OrderSide side = OrderSide::BUY;     ///< 买卖方向
+    OrderType ordType = OrderType::LIMIT; ///< 订单类型
+    double price = 0.0;                  ///< 委托价（市价单为 0）
+    int64_t orderQty = 0;                ///< 委托数量
+    double available = 0.0;              ///< 账户可用资金
+    int64_t longPosition = 0;            ///< 该合约多头持仓
+    int64_t shortPosition = 0;           ///< 该合约空头持仓
+    double upperLimitPrice = 0.0;        ///< 涨停价（0 表示未设置）
+    double lowerLimitPrice = 0.0;        ///< 跌停价（0 表示未设置）
+    bool hasBid = false;                 ///< 行情是否有买盘
+    bool hasAsk = false;                 ///< 行情是否有卖盘
+};
+
+/**
+ * @struct RiskDecision
+ * @brief 快速风控检查的结果
+ *
+ * 只有代码与数值；拒绝文本由 RiskManager::describeReject() 在真正发送拒绝回报时生成。
+ */
+struct RiskDecision {
+    RejectReason reason = RejectReason::NONE;  ///< 拒绝原因（NONE 表示通过）
+    OffsetFlag offsetFlag = OffsetFlag::OPEN;  ///< 推断的开平标志
+    double requiredMargin = 0.0;               ///< 开仓所需保证金（平仓为 0）
+
+    /// 是否通过
+    bool passed() const { return reason == RejectReason::NONE; }
+};
+
 // ============================================================================
 // 风控管理器
 // ============================================================================
@@ -284,6 +325,36 @@ public:
         const Order& order,
         const Instrument& instrument
     ) const;
+
+    // -------------------------------------------------------------------------
+    // 快速路径（下单热路径使用）
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief 快速风控检查
+     *
+     * 与 checkOrder() 检查项、顺序相同，区别在于：
+     * - 开平标志由持仓推断（买单有空头持仓、卖单有多头持仓时为平仓）；
+     * - 输入为预计算的合约参数与标量，各检查项先全部求值再按优先级选出拒绝原因，
+     *   不分配内存、不拼接字符串；
+     * - 同时给出开仓所需保证金，调用方无需再计算一次。
+     *
+     * @param params 合约风控参数
+     * @param input 订单、资金、持仓与行情标量
+     * @return 检查结果（拒绝原因代码、开平标志、所需保证金）
+     */
+    RiskDecision precheck(const InstrumentRiskParams& params, const RiskCheckInput& input) const;
+
+    /**
+     * @brief 生成拒绝文本
+     *
+     * 文本与 checkOrder() 各子检查给出的 rejectText 一致。
+     *
+     * @param decision precheck() 的结果
+     * @param input 同一次检查的输入
+     * @return 拒绝文本，通过时返回空串
+     */
+    std::string describeReject(const RiskDecision& decision, const RiskCheckInput& input) const;
 };
 
 } // namespace fix40
@@ -0,0 +1,156 @@
+/**
+ * @file risk_params.hpp
+ * @brief 预计算的合约风控参数表
+ *
+ * 下单风控只用到合约的少数几个数值参数（合约乘数、保证金率、昨结算价），
+ * 没有必要每笔订单都在 InstrumentManager 的锁内查找并复制整个 Instrument（含三个字符串）。
+ * RiskParamTable 把这些参数按驻留后的合约下标连续存放，构建后不可变，
+ * 读取方持有 shared_ptr 即可无锁访问。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "app/model/instrument.hpp"
+
+namespace fix40 {
+
+/**
+ * @struct InstrumentRiskParams
+ * @brief 单个合约的风控参数（32 字节，一条缓存行容纳两个合约）
+ */
+struct InstrumentRiskParams {
+    double marginRate = 0.0;          ///< 保证金率
+    double preSettlementPrice = 0.0;  ///< 昨结算价（市价单无涨跌停价时的计保证金价格）
+    double priceTick = 0.0;           ///< 最小变动价位
+    int32_t volumeMultiple = 0;       ///< 合约乘数
+
+    static InstrumentRiskParams fromInstrument(const Instrument& instrument) {
+        InstrumentRiskParams params;
+        params.marginRate = instrument.marginRate;
+        params.preSettlementPrice = instrument.preSettlementPrice;
+        params.priceTick = instrument.priceTick;
+        params.volumeMultiple = instrument.volumeMultiple;
+        return params;
+    }
+
+    /// 保证金 = 价格 × 数量 × 合约乘数 × 保证金率（与 Instrument::calculateMargin 相同的运算顺序）
+    double calculateMargin(double price, int64_t volume) const {
+        return price * volume * volumeMultiple * marginRate;
+    }
+};
+
+/**
+ * @class RiskParamTable
+ * @brief 合约代码 -> 驻留下标 -> 风控参数
+ *
+ * 下标按合约首次登记的顺序分配，重建时沿用上一张表的下标，
+ * 因此下标在合约集合清空前保持稳定。合约集合不变时（如只更新昨结算价）
+ * 新表与上一张表共享代码 -> 下标映射，只复制参数数组。
+ *
+ * @note 构建后不可变，可从任意线程读取。
+ */
+class RiskParamTable {
+public:
+    RiskParamTable() = default;
+
+    /**
+     * @brief 在上一张表的基础上构建
+     * @param previous 上一张表（沿用其下标），可为空
+     * @param instruments 当前全部合约
+     */
+    RiskParamTable(const RiskParamTable* previous,
+                   const std::unordered_map<std::string, Instrument>& instruments)
+        : RiskParamTable(previous) {
+        for (const auto& [instrumentId, instrument] : instruments) {
+            assign(instrument);
+        }
+    }
+
+    /**
+     * @brief 在上一张表的基础上覆盖/追加合约
+     * @param previous 上一张表（沿用其下标与其余合约的参数），可为空
+     * @param first 新合约数组首地址
+     * @param count 新合约数量
+     */
+    RiskParamTable(const RiskParamTable* previous, const Instrument* first, size_t count)
+        : RiskParamTable(previous) {
+        for (size_t i = 0; i < count; ++i) {
+            assign(first[i]);
+        }
+    }
+
+    /**
+     * @brief 复制上一张表并更新一个合约的昨结算价
+     * @param previous 上一张表
+     * @param index 合约下标（须由 previous.indexOf 返回）
+     * @param preSettlementPrice 昨结算价
+     */
+    RiskParamTable(const RiskParamTable& previous, uint32_t index, double preSettlementPrice)
+        : ids_(previous.ids_)
+        , params_(previous.params_) {
+        params_[index].preSettlementPrice = preSettlementPrice;
+    }
+
+    /**
+     * @brief 合约的驻留下标
+     * @return 合约未登记时返回 nullopt
+     */
+    std::optional<uint32_t> indexOf(const std::string& instrumentId) const {
+        auto it = ids_->find(instrumentId);
+        if (it == ids_->end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// 按下标取参数（下标须由 indexOf 返回）
+    const InstrumentRiskParams& at(uint32_t index) const { return params_[index]; }
+
+    /**
+     * @brief 按合约代码取参数
+     * @return 合约未登记时返回 nullptr
+     */
+    const InstrumentRiskParams* find(const std::string& instrumentId) const {
+        auto it = ids_->find(instrumentId);
+        return it != ids_->end() ? &params_[it->second] : nullptr;
+    }
+
+    /// 已登记的合约数
+    size_t size() const { return params_.size(); }
+
+private:
+    using IdMap = std::unordered_map<std::string, uint32_t>;
+
+    explicit RiskParamTable(const RiskParamTable* previous)
+        : ids_(previous ? previous->ids_ : std::make_shared<const IdMap>()) {
+        if (previous) {
+            params_ = previous->params_;
+        }
+    }
+
+    void assign(const Instrument& instrument) {
+        auto it = ids_->find(instrument.instrumentId);
+        if (it == ids_->end()) {
+            // 新合约：代码 -> 下标映射写时复制（与上一张表共享时先复制一份）
+            if (!ownIds_) {
+                ownIds_ = std::make_shared<IdMap>(*ids_);
+                ids_ = ownIds_;
+            }
+            it = ownIds_->emplace(instrument.instrumentId, static_cast<uint32_t>(params_.size())).first;
+            params_.emplace_back();
+        }
+        params_[it->second] = InstrumentRiskParams::fromInstrument(instrument);
+    }
+
+    std::shared_ptr<const IdMap> ids_ = std::make_shared<const IdMap>();
+    std::shared_ptr<IdMap> ownIds_;  ///< 构建期间自有的映射（构建后不再修改）
+    std::vector<InstrumentRiskParams> params_;
+};
+
+} // namespace fix40
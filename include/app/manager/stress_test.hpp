@@ -0,0 +1,236 @@
+/**
+ * @file stress_test.hpp
+ * @brief 全账户压力测试（情景分析）
+ *
+ * 行情驱动的盈亏只按当前最新价计算，无法回答"各品种再走 N 个涨跌停时，
+ * 哪些账户会穿仓"。压力测试在某一时刻对全部账户、持仓做一次快照，
+ * 在一组价格冲击情景下重新估值，给出每个账户的最差权益与风险度。
+ *
+ * - StressSnapshot：按账户分组的 SoA 持仓数组（CSR 布局），与实时状态完全脱离；
+ * - StressGrid：情景 × 品种的冲击矩阵（单位为一个涨跌停幅度），按品种连续存放；
+ * - StressTestEngine：在独立线程池上按账户分块并行估值，不占用撮合/账户线程。
+ *
+ * @par 估值模型
+ * 期货盈亏对价格线性：情景 s 下账户 a 的权益为
+ * @code
+ * equity(a, s) = baseEquity[a] + Σ sensitivity[j] × shock(product[j], s)
+ * sensitivity[j] = 净持仓 × 合约乘数 × 一个涨跌停幅度
+ * @endcode
+ * 内层循环沿情景连续访问冲击矩阵，可被编译器向量化。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "app/model/account.hpp"
+#include "app/model/position.hpp"
+
+namespace fix40 {
+
+class ThreadPool;
+
+/**
+ * @struct StressSnapshot
+ * @brief 压力测试用的账户/持仓快照（结构体数组拆分为数组结构体）
+ *
+ * 账户 a 的持仓为下标 [positionBegin[a], positionBegin[a + 1])。
+ *
+ * @note 构建后只读，可在多个线程间共享。
+ */
+struct StressSnapshot {
+    // 按账户
+    std::vector<std::string> accountIds;   ///< 账户ID
+    std::vector<double> baseEquity;        ///< 按标记价计算的动态权益
+    std::vector<double> usedMargin;        ///< 占用保证金
+    std::vector<uint32_t> positionBegin;   ///< 持仓区间起点（长度 = 账户数 + 1）
+
+    // 按持仓
+    std::vector<uint32_t> product;         ///< 品种下标（productIds）
+    std::vector<double> sensitivity;       ///< 价格变动一个涨跌停幅度时的盈亏
+
+    /// 品种代码（有序）
+    std::vector<std::string> productIds;
+
+    size_t accountCount() const { return accountIds.size(); }
+    size_t positionCount() const { return sensitivity.size(); }
+};
+
+/**
+ * @class StressSnapshotBuilder
+ * @brief 由账户、持仓逐条构建 StressSnapshot
+ *
+ * 没有对应账户的持仓在 build() 时丢弃；净持仓为 0 的持仓只计入基准权益。
+ */
+class StressSnapshotBuilder {
+public:
+    /// 登记账户（同一账户重复登记以后者为准）
+    void addAccount(const Account& account);
+
+    /**
+     * @brief 登记持仓
+     * @param position 持仓
+     * @param productId 品种代码（同一品种的合约受同一冲击）
+     * @param volumeMultiple 合约乘数
+     * @param markPrice 标记价（按此价格计算基准浮动盈亏）
+     * @param limitMove 一个涨跌停幅度（价格单位）
+     */
+    void addPosition(const Position& position, const std::string& productId,
+                     int volumeMultiple, double markPrice, double limitMove);
+
+    /// 按账户分组生成快照
+    StressSnapshot build() const;
+
+private:
+    struct PendingPosition {
+        std::string accountId;
+        std::string productId;
+        double profit;
+        double sensitivity;
+    };
+
+    std::vector<Account> accounts_;
+    std::unordered_map<std::string, size_t> accountIndex_;
+    std::vector<PendingPosition> positions_;
+};
+
+/**
+ * @class StressGrid
+ * @brief 情景 × 品种的价格冲击矩阵
+ *
+ * shock(p, s) 表示情景 s 下品种 p 的价格变动（以涨跌停幅度为单位，正数为上涨）。
+ * 同一品种的各情景连续存放。
+ */
+class StressGrid {
+public:
+    /// @param productCount 品种数（与快照的 productIds 一致）
+    explicit StressGrid(size_t productCount = 0) : productCount_(productCount) {}
+
+    /**
+     * @brief 涨跌停冲击网格
+     *
+     * 情景依次为：
+     * - base：无冲击；
+     * - ALL+k / ALL-k（k = 1..steps）：全部品种同向变动 k 个涨跌停；
+     * - P+k / P-k（k = 1..steps）：单个品种变动 k 个涨跌停，其它品种不变。
+     *
+     * 共 1 + 2 × steps × (1 + 品种数) 个情景。
+     */
+    static StressGrid limitMoves(const std::vector<std::string>& productIds, int steps);
+
+    /// 追加一个情景，shocks 按 productIds 顺序给出各品种的冲击
+    void addScenario(const std::string& name, const std::vector<double>& shocks);
+
+    size_t scenarioCount() const { return names_.size(); }
+    size_t productCount() const { return productCount_; }
+    const std::string& scenarioName(size_t scenario) const { return names_[scenario]; }
+
+    /// 品种 product 在全部情景下的冲击（长度 scenarioCount()）
+    const double* productShocks(size_t product) const {
+        return shocks_.data() + product * names_.size();
+    }
+
+    double shock(size_t product, size_t scenario) const {
+        return productShocks(product)[scenario];
+    }
+
+private:
+    size_t productCount_ = 0;
+    std::vector<std::string> names_;
+    std::vector<double> shocks_;   ///< productCount_ × scenarioCount()
+};
+
+/**
+ * @struct StressAccountResult
+ * @brief 单个账户的压力测试结果
+ */
+struct StressAccountResult {
+    std::string accountId;
+    double equity = 0.0;          ///< 基准权益
+    double worstEquity = 0.0;     ///< 最差情景下的权益
+    double worstRiskRatio = 0.0;  ///< 最差情景下的风险度（权益 <= 0 且有保证金时为无穷大）
+    std::string worstScenario;    ///< 最差情景名称
+};
+
+/**
+ * @struct StressReport
+ * @brief 一次压力测试的结果
+ */
+struct StressReport {
+    std::vector<StressAccountResult> accounts;  ///< 按最差风险度从高到低排列
+    size_t scenarioCount = 0;
+    size_t positionCount = 0;
+    double elapsedMs = 0.0;                     ///< 估值耗时
+    std::string error;                          ///< 异步执行失败的原因（为空表示成功）
+};
+
+/**
+ * @brief 格式化单个账户结果
+ *
+ * 格式：account=.. equity=.. worst_equity=.. worst_risk=.. scenario=..
+ */
+std::string format_stress_result(const StressAccountResult& result);
+
+/**
+ * @class StressTestEngine
+ * @brief 并行压力测试引擎
+ *
+ * 工作线程池与调度线程在首次使用时创建：submit() 把任务交给调度线程，
+ * 调度线程再把账户分块分发到工作线程池并等待合并，调用方（账户线程、FIX 工作线程）
+ * 不会被估值阻塞，也不会出现线程池任务等待同一线程池的情况。
+ *
+ * @note 同一时刻只有一个压力测试在执行，后续请求在调度线程上排队。
+ */
+class StressTestEngine {
+public:
+    using Callback = std::function<void(const StressReport&)>;
+
+    /// @param threads 工作线程数，0 表示 CPU 核数
+    explicit StressTestEngine(size_t threads = 0);
+    ~StressTestEngine();
+
+    StressTestEngine(const StressTestEngine&) = delete;
+    StressTestEngine& operator=(const StressTestEngine&) = delete;
+
+    /**
+     * @brief 同步执行压力测试
+     *
+     * @throws std::invalid_argument 网格品种数与快照不一致
+     * @note 不得在本引擎的工作线程内调用。
+     */
+    StressReport run(const StressSnapshot& snapshot, const StressGrid& grid);
+
+    /**
+     * @brief 异步执行涨跌停冲击网格（StressGrid::limitMoves）
+     *
+     * 完成后在调度线程上调用 callback；估值抛出异常时也会调用，此时 report.error 非空。
+     * callback 抛出的异常被记录日志，不会终止调度线程。
+     *
+     * @return 已接受返回 true；stop() 之后提交的任务被丢弃并返回 false，callback 不会被调用
+     */
+    bool submit(std::shared_ptr<const StressSnapshot> snapshot, int steps, Callback callback);
+
+    /// 执行完已排队的任务后停止全部线程
+    void stop();
+
+    /// 工作线程数
+    size_t threadCount() const { return threads_; }
+
+private:
+    /// 工作线程池（按需创建；单线程或已停止且未创建时返回 nullptr）
+    ThreadPool* workers();
+
+    size_t threads_;
+    std::mutex mutex_;
+    bool stopped_ = false;
+    std::unique_ptr<ThreadPool> workers_;      ///< 估值线程
+    std::unique_ptr<ThreadPool> coordinator_;  ///< 调度线程（单线程）
+};
+
+} // namespace fix40
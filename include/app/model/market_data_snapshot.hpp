@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <string>
 #include <cstdint>
 #include <chrono>
@@ -59,6 +61,27 @@ struct MarketDataSnapshot {
     double askPrice1;           ///< 卖一价（最低卖价）
     int32_t askVolume1;         ///< 卖一量
 
+    // -------------------------------------------------------------------------
+    // 五档深度（第 0 档与上面的一档字段一致）
+    // -------------------------------------------------------------------------
+    static constexpr size_t kDepthLevels = 5;  ///< 深度档数
+
+    /**
+     * @struct DepthLevel
+     * @brief 单档报价及本笔行情内已被模拟成交消耗的数量
+     */
+    struct DepthLevel {
+        double price = 0.0;    ///< 价格
+        int32_t volume = 0;    ///< 挂单量
+        int32_t consumed = 0;  ///< 本笔行情内已消耗量（新行情到达时清零）
+
+        /// 剩余可成交量
+        int32_t available() const { return volume > consumed ? volume - consumed : 0; }
+    };
+
+    std::array<DepthLevel, kDepthLevels> bidDepth{};  ///< 买盘 1-5 档（价格从高到低）
+    std::array<DepthLevel, kDepthLevels> askDepth{};  ///< 卖盘 1-5 档（价格从低到高）
+
     // -------------------------------------------------------------------------
     // 涨跌停价格
     // -------------------------------------------------------------------------
@@ -93,6 +93,7 @@ struct Order {
     // -------------------------------------------------------------------------
     std::string clOrdID;       ///< 客户端订单ID（客户端生成）
     std::string orderID;       ///< 服务端订单ID（撮合引擎生成）
+    uint32_t orderRef;         ///< 内部订单号（OrderTable 槽位，0 表示未分配）
     SessionID sessionID;       ///< 来源会话
 
     // -------------------------------------------------------------------------
@@ -127,7 +128,8 @@ struct Order {
      * @brief 默认构造函数
      */
     Order()
-        : side(OrderSide::BUY)
+        : orderRef(0)
+        , side(OrderSide::BUY)
         , ordType(OrderType::LIMIT)
         , timeInForce(TimeInForce::DAY)
         , orderQty(0)
@@ -176,6 +178,7 @@ struct Order {
 struct CancelRequest {
     std::string clOrdID;       ///< 本次撤单请求的ID
     std::string origClOrdID;   ///< 要撤销的原订单ID
+    uint32_t origOrderRef = 0; ///< 原订单的内部订单号（0 表示未知，按 origClOrdID 查找）
     std::string symbol;        ///< 标的代码
     SessionID sessionID;       ///< 来源会话
 
@@ -198,6 +201,7 @@ struct ExecutionReport {
     std::string clOrdID;       ///< 客户端订单ID
     std::string execID;        ///< 执行ID（每次报告唯一）
     std::string origClOrdID;   ///< 原订单ID（撤单时使用）
+    uint32_t orderRef;         ///< 内部订单号（下游按此访问 OrderTable，0 表示无）
 
     // 订单信息
     std::string symbol;        ///< 标的代码
@@ -229,7 +233,8 @@ struct ExecutionReport {
      * @brief 默认构造函数
      */
     ExecutionReport()
-        : side(OrderSide::BUY)
+        : orderRef(0)
+        , side(OrderSide::BUY)
         , ordType(OrderType::LIMIT)
         , orderQty(0)
         , price(0.0)
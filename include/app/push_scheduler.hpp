@@ -0,0 +1,146 @@
+/**
+ * @file push_scheduler.hpp
+ * @brief 账户/持仓推送（U5/U6）合并与限频
+ *
+ * 行情每跳都会改变持仓账户的浮动盈亏，逐跳推送会让持有多个合约的客户端
+ * 每轮行情收到几十条 U5/U6。PushScheduler 按 (账户) 与 (账户, 合约) 限频：
+ * - 间隔内首次请求立即推送，之后的请求只标记为脏；
+ * - 间隔到期后由调用方取出脏项，以最新值补发一次（reason=1）；
+ * - 成交触发的推送（reason=2）始终立即发送，并清除对应脏标记。
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fix40 {
+
+/**
+ * @class PushScheduler
+ * @brief U5/U6 推送调度器
+ *
+ * 只负责决定“何时推送”，推送内容由调用方在发送时读取最新状态。
+ *
+ * @par 计数
+ * 每次行情触发的请求要么立即推送，要么被合并（suppressed）进随后的一次推送，
+ * 要么仍处于待补发状态。
+ *
+ * @par 线程安全
+ * 所有公共方法都是线程安全的。
+ */
+class PushScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Stats
+     * @brief 推送计数
+     */
+    struct Stats {
+        uint64_t accountRequests = 0;     ///< 行情触发的 U5 请求数
+        uint64_t positionRequests = 0;    ///< 行情触发的 U6 请求数
+        uint64_t accountPushes = 0;       ///< 实际发出的 U5 数（含成交触发）
+        uint64_t positionPushes = 0;      ///< 实际发出的 U6 数（含成交触发）
+        uint64_t accountSuppressed = 0;   ///< 被合并的 U5 请求数
+        uint64_t positionSuppressed = 0;  ///< 被合并的 U6 请求数
+    };
+
+    /// 待补发的持仓推送：(accountId, instrumentId)
+    using PositionKey = std::pair<std::string, std::string>;
+
+    /**
+     * @brief 构造调度器
+     * @param interval 同一账户/持仓两次推送的最小间隔，0 表示不限频
+     */
+    explicit PushScheduler(std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+
+    PushScheduler(const PushScheduler&) = delete;
+    PushScheduler& operator=(const PushScheduler&) = delete;
+
+    /// 设置推送间隔（0 表示不限频）
+    void setInterval(std::chrono::milliseconds interval);
+
+    /// 推送间隔
+    std::chrono::milliseconds interval() const;
+
+    /**
+     * @brief 行情触发的 U5 请求
+     * @return true 表示应立即推送；false 表示已标记为脏，等待 collectDue() 补发
+     */
+    bool requestAccount(const std::string& accountId, Clock::time_point now);
+
+    /**
+     * @brief 行情触发的 U6 请求
+     * @return true 表示应立即推送；false 表示已标记为脏，等待 collectDue() 补发
+     */
+    bool requestPosition(const std::string& accountId, const std::string& instrumentId,
+                         Clock::time_point now);
+
+    /**
+     * @brief 登记一次立即发送的 U5（成交触发）
+     *
+     * 重新开始该账户的推送间隔；待补发的行情推送已被这次推送覆盖，计为合并。
+     */
+    void sentAccount(const std::string& accountId, Clock::time_point now);
+
+    /**
+     * @brief 登记一次立即发送的 U6（成交触发）
+     */
+    void sentPosition(const std::string& accountId, const std::string& instrumentId,
+                      Clock::time_point now);
+
+    /**
+     * @brief 取出间隔已到期的脏项，并登记为已推送
+     *
+     * @param now 当前时刻
+     * @param[out] accounts 需要补发 U5 的账户（先清空）
+     * @param[out] positions 需要补发 U6 的持仓（先清空）
+     */
+    void collectDue(Clock::time_point now,
+                    std::vector<std::string>& accounts,
+                    std::vector<PositionKey>& positions);
+
+    /// 待补发的推送数（U5 + U6）
+    size_t pendingCount() const;
+
+    /// 推送计数快照
+    Stats stats() const;
+
+private:
+    /// 单个推送目标的限频状态
+    struct Slot {
+        Clock::time_point lastSent{};   ///< 上次推送时刻
+        bool sentOnce = false;          ///< 是否推送过
+        bool dirty = false;             ///< 是否有待补发的更新
+    };
+
+    /// 一个账户的 U5 状态及其各合约的 U6 状态
+    struct AccountSlots {
+        Slot account;
+        std::unordered_map<std::string, Slot> positions;
+    };
+
+    /// 请求推送：间隔已到返回 true 并登记发送，否则标记为脏（调用方持有锁）
+    bool request(Slot& slot, Clock::time_point now, uint64_t& pushes, uint64_t& suppressed);
+
+    /// 登记立即发送（调用方持有锁）
+    void sent(Slot& slot, Clock::time_point now, uint64_t& pushes, uint64_t& suppressed);
+
+    bool due(const Slot& slot, Clock::time_point now) const {
+        return !slot.sentOnce || now - slot.lastSent >= interval_;
+    }
+
+    Clock::duration interval_;
+    std::unordered_map<std::string, AccountSlots> accounts_;
+    size_t pending_ = 0;
+    Stats stats_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace fix40
@@ -18,24 +18,35 @@
  * - F:  OrderCancelRequest (撤单请求)
  * - U1: BalanceQueryRequest (资金查询请求) - 自定义
  * - U3: PositionQueryRequest (持仓查询请求) - 自定义
+ * - U11: SessionStatsRequest (会话统计查询请求) - 自定义
+ * - U13: StressTestRequest (压力测试请求，仅管理员) - 自定义
  * 
  * @par 发送的消息类型
  * - 8:  ExecutionReport (执行报告)
  * - U2: BalanceQueryResponse (资金查询响应) - 自定义
  * - U4: PositionQueryResponse (持仓查询响应) - 自定义
+ * - U12: SessionStatsResponse (会话统计查询响应) - 自定义
+ * - U14: StressTestResponse (压力测试响应) - 自定义
  */
 
 #pragma once
 
 #include "fix/application.hpp"
 #include "fix/session_manager.hpp"
+#include "app/engine/engine_journal.hpp"
 #include "app/engine/matching_engine.hpp"
 #include "app/manager/account_manager.hpp"
 #include "app/manager/position_manager.hpp"
 #include "app/manager/instrument_manager.hpp"
 #include "app/manager/risk_manager.hpp"
+#include "app/manager/stress_test.hpp"
+#include "app/account_actor.hpp"
+#include "app/push_scheduler.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <memory>
-#include <unordered_map>
+#include <thread>
+#include <unordered_set>
 #include <mutex>
 
 namespace fix40 {
@@ -57,6 +68,11 @@ struct SimulationAppTestAccess;
  * - 所有订单处理在单线程中串行执行，无需加锁
  * - 异常隔离：撮合引擎的异常不会影响网络层
  *
+ * @par 单写者模式
+ * 开启后（[account] single_writer = 1 或 setSingleWriterMode(true)），账户、持仓、保证金
+ * 及订单映射的全部读写都在 AccountActor 的唯一线程上执行，工作线程和撮合线程只投递任务；
+ * 资金/持仓查询读取每个任务结束后发布的不可变 AccountView。
+ *
  * @par 集成模块
  * - AccountManager: 账户管理（资金冻结/释放）
  * - PositionManager: 持仓管理（开仓/平仓）
@@ -86,41 +102,8 @@ struct SimulationAppTestAccess;
  */
 class SimulationApp : public Application {
 public:
-    /**
-     * @struct OrderMarginInfo
-     * @brief 订单保证金信息
-     * 
-     * 用于正确处理部分成交时的保证金计算。
-     * 存储原始总冻结保证金和订单总数量，避免累计误差。
-     */
-    struct OrderMarginInfo {
-        double originalFrozenMargin;  ///< 原始总冻结保证金
-        int64_t originalOrderQty;     ///< 原始订单总数量
-        double releasedMargin;        ///< 已释放的保证金（累计）
-        
-        OrderMarginInfo() 
-            : originalFrozenMargin(0.0)
-            , originalOrderQty(0)
-            , releasedMargin(0.0) {}
-        
-        OrderMarginInfo(double frozen, int64_t qty)
-            : originalFrozenMargin(frozen)
-            , originalOrderQty(qty)
-            , releasedMargin(0.0) {}
-        
-        /// 计算本次成交应释放的冻结保证金
-        double calculateReleaseAmount(int64_t fillQty) {
-            if (originalOrderQty <= 0) return 0.0;
-            double amount = originalFrozenMargin * fillQty / originalOrderQty;
-            releasedMargin += amount;
-            return amount;
-        }
-        
-        /// 获取剩余未释放的冻结保证金
-        double getRemainingFrozen() const {
-            return originalFrozenMargin - releasedMargin;
-        }
-    };
+    /// 订单保证金信息（存放在撮合引擎订单状态表的槽位中）
+    using OrderMarginInfo = fix40::OrderMarginInfo;
 
     /**
      * @brief 默认构造函数（不带持久化）
@@ -155,6 +138,21 @@ public:
      */
     void stop();
 
+    /**
+     * @brief 开启/关闭账户状态单写者模式
+     *
+     * 必须在 start() 之前、开始处理消息之前调用。
+     */
+    void setSingleWriterMode(bool enabled);
+
+    /// 是否处于单写者模式
+    bool isSingleWriterMode() const { return actor_ != nullptr; }
+
+    /**
+     * @brief 获取已发布的账户视图（单写者模式下供查询使用）
+     */
+    const AccountViewTable& getAccountViews() const { return accountViews_; }
+
     // =========================================================================
     // Application 接口实现
     // =========================================================================
@@ -245,6 +243,11 @@ public:
      */
     MatchingEngine& getMatchingEngine() { return engine_; }
 
+    /**
+     * @brief 获取 U5/U6 推送调度器（推送间隔与合并计数）
+     */
+    PushScheduler& getPushScheduler() { return pushScheduler_; }
+
     // =========================================================================
     // 账户操作接口
     // =========================================================================
@@ -286,6 +289,43 @@ private:
      */
     void onExecutionReport(const SessionID& sessionID, const ExecutionReport& report);
 
+    /**
+     * @brief 按回报更新账户、持仓与订单映射（在账户线程上执行）
+     */
+    void applyExecutionReport(const SessionID& sessionID, const ExecutionReport& report);
+
+    /**
+     * @brief 风控检查、冻结保证金、分配订单槽位并提交撮合（在账户线程上执行）
+     */
+    void processNewOrder(Order order, const SessionID& sessionID, const std::string& userId);
+
+    /**
+     * @brief 在账户线程上执行任务
+     *
+     * 单写者模式下投递给 AccountActor，否则在当前线程同步执行。
+     */
+    void runOnAccountThread(AccountActor::Task task);
+
+    /**
+     * @brief 记录本任务修改过的账户，任务结束后发布其视图（仅单写者模式）
+     */
+    void touchAccount(const std::string& accountId);
+
+    /**
+     * @brief 发布本任务修改过的账户视图（AccountActor 的 afterTask 钩子）
+     */
+    void publishTouchedViews();
+
+    /**
+     * @brief 读取账户资金（单写者模式下读取已发布视图）
+     */
+    std::optional<Account> queryAccount(const std::string& accountId) const;
+
+    /**
+     * @brief 读取账户持仓（单写者模式下读取已发布视图）
+     */
+    std::vector<Position> queryPositions(const std::string& accountId) const;
+
     /**
      * @brief 处理订单成交
      * 
@@ -394,6 +434,53 @@ private:
      */
     void handleOrderHistoryQuery(const FixMessage& msg, const SessionID& sessionID, const std::string& userId);
 
+    /**
+     * @brief 处理会话统计查询请求 (MsgType = U11)
+     *
+     * 返回 U12 响应，Text(58) 中每行一个会话的统计（format_session_stats 格式）。
+     * config.ini [stats] admin_users 中列出的用户可查询全部会话，其它用户只返回自身会话。
+     *
+     * @param msg FIX 请求消息
+     * @param sessionID 会话标识
+     * @param userId 绑定的用户ID（从 Session 提取，非消息体）
+     */
+    void handleSessionStatsQuery(const FixMessage& msg, const SessionID& sessionID, const std::string& userId);
+
+    /**
+     * @brief 处理压力测试请求 (MsgType = U13)
+     *
+     * 仅 config.ini [stats] admin_users 中的用户可用（名单为空时功能关闭），其它用户收到
+     * BusinessMessageReject；同一用户上一次压力测试未完成时新请求同样被拒绝。
+     * 在账户线程上采集全部账户/持仓快照后交给 StressTestEngine 异步估值，
+     * 完成后回复 U14：ResultCount 为账户数，Text(58) 首行为汇总，之后每行一个账户
+     * （format_stress_result 格式，按最差风险度从高到低）。
+     *
+     * @param msg FIX 请求消息（ShockSteps 可选，默认 [stress] default_steps）
+     * @param sessionID 会话标识
+     * @param userId 绑定的用户ID（从 Session 提取，非消息体）
+     */
+    void handleStressTestRequest(const FixMessage& msg, const SessionID& sessionID, const std::string& userId);
+
+    /// 释放用户的压力测试占位，允许其发起下一次请求
+    void releaseStressInFlight(const std::string& userId);
+
+    /// 发送压力测试结果 (U14)
+    void sendStressTestResponse(const SessionID& sessionID, const std::string& requestId,
+                                int steps, const StressReport& report);
+
+    /**
+     * @brief 采集压力测试快照
+     *
+     * 标记价取最新行情，无行情时取昨结算价；一个涨跌停幅度取 (涨停价 - 跌停价) / 2，
+     * 涨跌停价未知时取标记价 × [stress] default_limit_pct。
+     *
+     * @note 单写者模式下需在账户线程上调用。
+     */
+    StressSnapshot captureStressSnapshot() const;
+
+    /// 是否为 config.ini [stats] admin_users 中列出的管理员（名单在构造时解析）
+    bool isAdminUser(const std::string& userId) const;
+
     /**
      * @brief 发送拒绝消息
      * 
@@ -420,6 +507,22 @@ private:
      */
     void onMarketDataUpdate(const std::string& instrumentId, double lastPrice);
 
+    /**
+     * @brief 距上次持久化超过间隔时，批量持久化浮动盈亏变化的账户
+     *
+     * 由行情更新与定时线程驱动（最后一笔行情之后的变化也会在一个间隔内落盘），
+     * 多个线程并发调用时只有一个线程执行持久化。
+     */
+    void maybeFlushDirtyAccounts();
+
+    /**
+     * @brief 定时线程主循环
+     *
+     * 按推送间隔与浮动盈亏持久化间隔中较短者唤醒：以最新值补发被限频延后的 U5/U6（reason=1），
+     * 并在账户线程上检查是否需要批量持久化浮动盈亏，不依赖新行情到达。
+     */
+    void timerLoop();
+
     /**
      * @brief 向指定用户推送账户更新 (MsgType = U5)
      * 
@@ -444,6 +547,8 @@ private:
     /**
      * @brief 根据用户ID查找对应的 SessionID
      * 
+     * 使用 SessionManager 的 clientCompID 索引，复杂度 O(1)。
+     *
      * @param userId 用户ID
      * @return std::optional<SessionID> 找到返回 SessionID，否则返回 nullopt
      */
@@ -463,14 +568,42 @@ private:
     
     IStore* store_ = nullptr;            ///< 存储接口（可为nullptr）
 
-    /// 订单到账户的映射：clOrdID -> accountId
-    std::unordered_map<std::string, std::string> orderAccountMap_;
-    
-    /// 订单保证金信息映射：clOrdID -> OrderMarginInfo
-    std::unordered_map<std::string, OrderMarginInfo> orderMarginInfoMap_;
-    
-    /// 互斥锁，保护映射表
-    mutable std::mutex mapMutex_;
+    /// 撮合引擎输入日志（[matching_engine] journal_path 非空时在 start() 中打开）
+    std::unique_ptr<EngineJournal> journal_;
+
+    /// 浮动盈亏持久化间隔（毫秒，[storage] profit_persist_interval_ms）
+    int64_t profitPersistIntervalMs_ = 1000;
+
+    /// 上次批量持久化账户的时刻（steady_clock 毫秒）
+    std::atomic<int64_t> lastProfitFlushMs_{0};
+
+    /// 账户状态单写者线程（未开启单写者模式时为 nullptr）
+    std::unique_ptr<AccountActor> actor_;
+
+    /// 单写者模式下发布给查询的账户视图
+    AccountViewTable accountViews_;
+
+    /// 管理员用户（[stats] admin_users，为空表示不开放管理员功能）
+    std::unordered_set<std::string> adminUsers_;
+
+    /// 当前任务修改过的账户（只在账户线程上访问）
+    std::unordered_set<std::string> touchedAccounts_;
+
+    /// 行情触发的 U5/U6 推送限频（[push] interval_ms）
+    PushScheduler pushScheduler_;
+
+    /// 定时线程：推送补发与浮动盈亏持久化（任一间隔大于 0 时在 start() 中启动）
+    std::thread timerThread_;
+    std::mutex timerMutex_;
+    std::condition_variable timerCv_;
+    bool timerStopping_ = false;
+
+    /// 正在执行压力测试的用户（每个用户同时至多一个）
+    std::mutex stressMutex_;
+    std::unordered_set<std::string> stressInFlight_;
+
+    /// 压力测试引擎（析构时先于会话管理器等成员停止，排队的结果仍可发出）
+    StressTestEngine stressEngine_;
 };
 
 } // namespace fix40
@@ -0,0 +1,153 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief HDR 风格的对数分桶延迟直方图
+ *
+ * 以 2 的幂为量级、每个量级再线性细分 8 个子桶，相对误差不超过 12.5%。
+ * 记录路径无锁：桶计数、样本数、总和各一次 relaxed 原子加，
+ * 另以 CAS 更新最小/最大值——只有出现新的极值时才写入，稳定状态下各只是一次读取，
+ * 适合在会话热路径上常驻开启。
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace fix40 {
+
+/**
+ * @struct HistogramSnapshot
+ * @brief 直方图统计快照（单位与记录值一致，通常为纳秒）
+ */
+struct HistogramSnapshot {
+    uint64_t count = 0;  ///< 样本数
+    uint64_t min = 0;    ///< 最小值
+    uint64_t max = 0;    ///< 最大值
+    uint64_t mean = 0;   ///< 平均值
+    uint64_t p50 = 0;    ///< 50 分位
+    uint64_t p90 = 0;    ///< 90 分位
+    uint64_t p99 = 0;    ///< 99 分位
+    uint64_t p999 = 0;   ///< 99.9 分位
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief 无锁对数分桶直方图
+ *
+ * - 值 < 8 时每个值一个桶；
+ * - 值 >= 8 时按最高有效位 m 划分量级，每个量级 8 个子桶，桶宽 2^(m-3)；
+ * - 超过 2^kMaxMagnitude 的值计入最后一个桶（纳秒单位下约 18 分钟）。
+ *
+ * 分位数取所在桶的上界，与 HdrHistogram 的 "highest equivalent value" 一致。
+ *
+ * @par 线程安全
+ * record() 与 snapshot() 可并发调用；快照在并发写入时只保证近似一致。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxMagnitude = 40;
+    static constexpr size_t kBucketCount =
+        static_cast<size_t>((kMaxMagnitude - kSubBucketBits + 2) * kSubBuckets);
+
+    /**
+     * @brief 记录一个样本
+     * @param value 样本值
+     */
+    void record(uint64_t value) {
+        buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t cur = min_.load(std::memory_order_relaxed);
+        while (value < cur && !min_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+        cur = max_.load(std::memory_order_relaxed);
+        while (value > cur && !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * @brief 样本数
+     */
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 生成统计快照
+     */
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot s;
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) return s;
+
+        s.count = total;
+        s.min = min_.load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+        s.mean = sum_.load(std::memory_order_relaxed) / total;
+        s.p50 = percentile(counts, total, 0.50);
+        s.p90 = percentile(counts, total, 0.90);
+        s.p99 = percentile(counts, total, 0.99);
+        s.p999 = percentile(counts, total, 0.999);
+        return s;
+    }
+
+    /**
+     * @brief 计算值所在桶的下标
+     */
+    static size_t bucket_index(uint64_t value) {
+        if (value < static_cast<uint64_t>(kSubBuckets)) {
+            return static_cast<size_t>(value);
+        }
+        int magnitude = 63 - __builtin_clzll(value);
+        if (magnitude > kMaxMagnitude) {
+            return kBucketCount - 1;
+        }
+        const uint64_t sub = (value >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+        return static_cast<size_t>((magnitude - kSubBucketBits + 1) * kSubBuckets) + sub;
+    }
+
+    /**
+     * @brief 桶的上界（桶内最大可表示值）
+     */
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < static_cast<size_t>(kSubBuckets)) {
+            return index;
+        }
+        const int magnitude = static_cast<int>(index / kSubBuckets) + kSubBucketBits - 1;
+        const uint64_t sub = index % kSubBuckets;
+        const int shift = magnitude - kSubBucketBits;
+        const uint64_t lower = (static_cast<uint64_t>(kSubBuckets) + sub) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    uint64_t percentile(const std::array<uint64_t, kBucketCount>& counts,
+                        uint64_t total, double q) const {
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                // 桶上界可能超出实际最大值，用 max 收紧
+                const uint64_t upper = bucket_upper_bound(i);
+                const uint64_t max = max_.load(std::memory_order_relaxed);
+                return upper < max ? upper : max;
+            }
+        }
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace fix40
@@ -0,0 +1,93 @@
+/**
+ * @file published_ptr.hpp
+ * @brief 读多写少的不可变对象发布
+ *
+ * std::atomic_load / atomic_store 作用于 shared_ptr 时，libstdc++ 并不是无锁实现：
+ * 每次调用按指针地址哈希到全局 16 把互斥锁之一（_Sp_locker），
+ * 热路径上的每次读取都要加一次锁，且与哈希到同一把锁的无关 shared_ptr 互相争用。
+ *
+ * PublishedPtr 用版本号 + 线程本地缓存替代：写入方在互斥锁内替换对象并递增版本号；
+ * 读取方比较缓存的版本号，未变化时直接复制缓存的 shared_ptr（一次原子读 + 引用计数自增），
+ * 只有在发布后第一次读取时才进入互斥锁刷新缓存。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace fix40 {
+
+/**
+ * @class PublishedPtr
+ * @brief 以版本号发布的 shared_ptr<const T>
+ *
+ * @par 加锁保证
+ * - load()：版本号未变化且本线程最近一次读取的是同一个 PublishedPtr 时不加锁；
+ *   发布后的第一次读取，或同一线程交替读取多个同类型实例时，进入本实例的互斥锁一次；
+ * - store()：总是加本实例的互斥锁（写入方本就串行）。
+ *
+ * 每个线程对每种 T 缓存一个实例的最新对象，该对象在线程下次刷新缓存或退出前不会释放。
+ *
+ * @note load() / store() 可从任意线程调用。
+ */
+template<typename T>
+class PublishedPtr {
+public:
+    explicit PublishedPtr(std::shared_ptr<const T> initial = nullptr)
+        : ptr_(std::move(initial)) {}
+
+    PublishedPtr(const PublishedPtr&) = delete;
+    PublishedPtr& operator=(const PublishedPtr&) = delete;
+
+    /// 读取当前对象
+    std::shared_ptr<const T> load() const {
+        Cache& cache = threadCache();
+        if (cache.owner == id_ && cache.version == version_.load(std::memory_order_acquire)) {
+            return cache.ptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache.owner = id_;
+        cache.version = version_.load(std::memory_order_relaxed);
+        cache.ptr = ptr_;
+        return cache.ptr;
+    }
+
+    /// 发布新对象
+    void store(std::shared_ptr<const T> next) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ptr_ = std::move(next);
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    /// 当前版本号（每次 store() 加一）
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+private:
+    struct Cache {
+        uint64_t owner = 0;    ///< 缓存所属实例（0 表示空）
+        uint64_t version = 0;  ///< 缓存对象的版本号
+        std::shared_ptr<const T> ptr;
+    };
+
+    static Cache& threadCache() {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    /// 实例编号：地址会被复用，编号不会，销毁后残留的缓存不会被新实例误用
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const uint64_t id_ = nextId();
+    std::atomic<uint64_t> version_{1};
+    mutable std::mutex mutex_;
+    std::shared_ptr<const T> ptr_;
+};
+
+} // namespace fix40
@@ -1,6 +1,6 @@
 /**
  * @file timing_wheel.hpp
- * @brief 时间轮定时器实现
+ * @brief 分层时间轮定时器实现
  *
  * 提供高效的定时任务管理，支持一次性和周期性任务，
  * 适用于心跳检测、超时管理等场景。
@@ -9,13 +9,12 @@
 #pragma once
 
 #include <vector>
-#include <list>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 #include <atomic>
 #include <climits>
+#include <cstdint>
 
 namespace fix40 {
 
@@ -31,46 +30,71 @@ constexpr TimerTaskId INVALID_TIMER_ID = 0;
 
 /**
  * @class TimingWheel
- * @brief 支持周期性任务的时间轮定时器
+ * @brief 支持周期性任务的分层时间轮定时器
  *
- * 时间轮是一种高效的定时器实现，将时间划分为固定数量的槽位，
- * 每个槽位存储在该时刻到期的任务列表。
+ * 时间轮将时间划分为固定数量的槽位，每个槽位存储在该时刻到期的任务链表。
+ * 本实现采用多级（分层）结构：第 0 级每槽代表 1 个 tick，第 k 级每槽代表
+ * wheel_size^k 个 tick。远期任务先挂在高层槽位，随时间推进逐级下沉（cascade），
+ * 不再需要逐圈递减 remaining_laps。
  *
  * @par 特性
- * - O(1) 时间复杂度添加任务
+ * - O(1) 添加任务、O(1) 按句柄取消任务
+ * - 任务节点来自按块分配的对象池，以侵入式双向链表挂在槽位上，
+ *   稳态下添加/取消/触发均不产生堆分配
+ * - 任务 ID 即句柄：低 32 位为池内下标，高 32 位为代数（generation），
+ *   节点复用后旧 ID 自动失效
  * - 支持一次性任务和周期性任务
- * - 支持取消任务
- * - 线程安全
+ * - 线程安全（每个时间轮一把锁；按工作线程各持一个时间轮时该锁基本无竞争）
  *
  * @par 工作原理
- * 1. 时间轮由 N 个槽位组成，每个槽位代表一个时间间隔
- * 2. 指针每次 tick() 前进一格，执行当前槽位的到期任务
- * 3. 对于延迟超过一圈的任务，使用 remaining_laps 记录剩余圈数
+ * 1. 添加任务时计算绝对到期 tick，并按剩余 tick 数选择层级和槽位
+ * 2. tick() 前进一格；当低层走完一圈时，将上一层当前槽位的任务重新分配到低层
+ * 3. 执行第 0 级当前槽位的到期任务，周期性任务按间隔重新插入
+ * 4. 超出最高层覆盖范围的任务暂挂在最高层最远槽位，下沉时重新计算位置
  *
  * @par 使用示例
  * @code
- * TimingWheel wheel(60, 1000);  // 60 个槽，每槽 1 秒
- * 
+ * TimingWheel wheel(64, 100);  // 每级 64 个槽，每个 tick 100 毫秒
+ *
  * // 添加一次性任务，5 秒后执行
  * auto id = wheel.add_task(5000, []() { std::cout << "Timeout!" << std::endl; });
- * 
+ *
  * // 添加周期性任务，每 30 秒执行一次
  * wheel.add_periodic_task(30000, []() { send_heartbeat(); });
- * 
+ *
  * // 取消任务
  * wheel.cancel_task(id);
- * 
+ *
  * // 在定时器回调中驱动时间轮
- * reactor.add_timer(1000, [&wheel](int) { wheel.tick(); });
+ * reactor.add_timer(100, [&wheel](int) { wheel.tick(); });
  * @endcode
  */
 class TimingWheel {
 public:
-    TimingWheel(int wheel_size, int tick_interval_ms)
-        : wheel_size_(wheel_size),
-          tick_interval_ms_(tick_interval_ms),
-          wheel_(wheel_size),
-          next_task_id_(1) {}
+    /// 时间轮层级数
+    static constexpr int kLevels = 4;
+
+    /**
+     * @brief 构造时间轮
+     * @param wheel_size 每一级的槽位数量（小于 2 时按 2 处理）
+     * @param tick_interval_ms 每个 tick 代表的时间间隔（毫秒，小于 1 时按 1 处理）
+     * @param initial_capacity 预分配的任务节点数量，避免启动阶段扩容
+     */
+    TimingWheel(int wheel_size, int tick_interval_ms, size_t initial_capacity = 0)
+        : wheel_size_(wheel_size < 2 ? 2 : wheel_size),
+          tick_interval_ms_(tick_interval_ms < 1 ? 1 : tick_interval_ms),
+          slots_(static_cast<size_t>(kLevels) * static_cast<size_t>(wheel_size_), kNil) {
+        uint64_t span = 1;
+        for (int level = 0; level < kLevels; ++level) {
+            level_span_[level] = span;
+            span *= static_cast<uint64_t>(wheel_size_);
+        }
+        max_span_ = span;
+        reserve(initial_capacity);
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
 
     /**
      * @brief 添加一次性任务
@@ -100,17 +124,23 @@ public:
      * @brief 取消任务
      * @param id 要取消的任务 ID
      *
-     * 标记任务为已取消状态，任务将在下次 tick() 时被清理。
-     * 如果 id 为 INVALID_TIMER_ID 或任务不存在，则无操作。
+     * 根据句柄直接定位节点并从槽位链表摘除，节点立即归还对象池。
+     * 若任务正在执行（tick 已将其取出），则仅标记取消，执行结束后回收。
+     * 如果 id 为 INVALID_TIMER_ID、任务已结束或 ID 已过期，则无操作。
      */
     void cancel_task(TimerTaskId id) {
         if (id == INVALID_TIMER_ID) return;
 
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = task_map_.find(id);
-        if (it != task_map_.end()) {
-            it->second->cancelled = true;
+        TimerNode* node = resolve(id);
+        if (!node) return;
+
+        if (node->running) {
+            node->cancelled.store(true, std::memory_order_relaxed);
+            return;
         }
+        unlink(node);
+        release(node);
     }
 
     /**
@@ -119,91 +149,128 @@ public:
      * 该方法应由外部定时器周期性调用，调用间隔应等于 tick_interval_ms。
      *
      * @par 执行流程
-     * 1. 指针前进一格
-     * 2. 遍历当前槽位的任务列表
-     * 3. 跳过已取消的任务
-     * 4. 对于 remaining_laps > 0 的任务，减少圈数
-     * 5. 执行到期任务
-     * 6. 周期性任务重新调度到下一周期
+     * 1. 当前 tick 加一
+     * 2. 对走完一圈的层级，将上一层对应槽位的任务下沉重新分配
+     * 3. 摘下第 0 级当前槽位的全部任务（均已到期）
+     * 4. 在锁外执行任务
+     * 5. 周期性任务重新插入，一次性任务归还对象池
      *
-     * @note 任务回调在锁外执行，避免死锁
+     * @note 任务回调在锁外执行，避免死锁；回调中可安全地添加或取消任务
      */
     void tick() {
-        std::list<std::shared_ptr<TimerNode>> tasks_to_run;
-        std::list<std::shared_ptr<TimerNode>> tasks_to_reschedule;
+        std::vector<TimerNode*> expired;
+        uint64_t fired_tick;
 
         {
             std::lock_guard<std::mutex> lock(mutex_);
+            expired.swap(expired_buffer_);
 
-            current_tick_ = (current_tick_ + 1) % wheel_size_;
-            auto& slot = wheel_[current_tick_];
+            fired_tick = ++current_tick_;
 
-            for (auto it = slot.begin(); it != slot.end(); ) {
-                auto& node = *it;
-
-                // 已取消的任务，从映射中移除
-                if (node->cancelled) {
-                    task_map_.erase(node->id);
-                    it = slot.erase(it);
-                    continue;
+            // 高层先下沉：保证下沉到第 0 级的任务能在本次 tick 被执行
+            for (int level = kLevels - 1; level >= 1; --level) {
+                if (fired_tick % level_span_[level] == 0) {
+                    cascade(level, fired_tick);
                 }
+            }
 
-                if (node->remaining_laps > 0) {
-                    node->remaining_laps--;
-                    ++it;
-                } else {
-                    // 任务到期
-                    tasks_to_run.push_back(node);
-
-                    // 周期性任务需要重新调度
-                    if (node->is_periodic) {
-                        tasks_to_reschedule.push_back(node);
-                    } else {
-                        // 一次性任务，从映射中移除
-                        task_map_.erase(node->id);
-                    }
+            uint32_t& head = slot_head(0, static_cast<size_t>(fired_tick % wheel_size_));
+            uint32_t idx = head;
+            head = kNil;
+            while (idx != kNil) {
+                TimerNode* node = node_at(idx);
+                uint32_t next = node->next;
+                node->prev = node->next = kNil;
+                node->level = -1;
+                node->running = true;
+                expired.push_back(node);
+                idx = next;
+            }
+        }
 
-                    it = slot.erase(it);
-                }
+        // 在锁外执行任务。节点位于稳定地址的对象池中，且 running 期间不会被回收；
+        // 这里只使用锁内取得的节点指针，不访问可能被并发扩容的块索引。
+        for (TimerNode* node : expired) {
+            if (!node->cancelled.load(std::memory_order_relaxed) && node->task) {
+                node->task();
             }
+        }
 
-            // 重新调度周期性任务
-            for (auto& node : tasks_to_reschedule) {
-                if (!node->cancelled) {
-                    int target_slot = (current_tick_ + node->interval_ticks) % wheel_size_;
-                    node->remaining_laps = (node->interval_ticks - 1) / wheel_size_;
-                    wheel_[target_slot].push_back(node);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (TimerNode* node : expired) {
+                node->running = false;
+                if (node->is_periodic && !node->cancelled.load(std::memory_order_relaxed)) {
+                    uint64_t next_expire = fired_tick + node->interval_ticks;
+                    if (next_expire <= current_tick_) {
+                        next_expire = current_tick_ + 1;
+                    }
+                    node->expire_tick = next_expire;
+                    insert(node);
+                } else {
+                    release(node);
                 }
             }
+            expired.clear();
+            if (expired.capacity() > expired_buffer_.capacity()) {
+                expired_buffer_.swap(expired);
+            }
         }
+    }
 
-        // 在锁外执行任务，避免死锁
-        for (auto& node : tasks_to_run) {
-            if (!node->cancelled && node->task) {
-                node->task();
-            }
+    /**
+     * @brief 预分配任务节点
+     * @param capacity 期望的节点总数
+     */
+    void reserve(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (node_count_ < capacity) {
+            grow();
         }
     }
 
+    /**
+     * @brief 获取当前待执行（含正在执行）的任务数量
+     */
+    size_t active_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return active_;
+    }
+
+    /**
+     * @brief 获取每个 tick 的时间间隔（毫秒）
+     */
+    int tick_interval_ms() const { return tick_interval_ms_; }
+
+    /**
+     * @brief 获取每一级的槽位数量
+     */
+    int wheel_size() const { return wheel_size_; }
+
 private:
+    /// 空链接/空下标
+    static constexpr uint32_t kNil = UINT32_MAX;
+    /// 对象池每块的节点数量
+    static constexpr size_t kChunkSize = 256;
+
     /**
      * @struct TimerNode
-     * @brief 定时任务节点
+     * @brief 定时任务节点（对象池元素，侵入式链表节点）
      */
     struct TimerNode {
-        TimerTaskId id;       ///< 任务唯一标识符
-        int remaining_laps;   ///< 剩余圈数（用于延迟超过一圈的任务）
-        int interval_ticks;   ///< 周期间隔（tick 数），用于周期性任务重新调度
-        bool is_periodic;     ///< 是否为周期性任务
-        bool cancelled;       ///< 是否已取消
-        TimerTask task;       ///< 任务回调函数
-
-        /**
-         * @brief 构造定时任务节点
-         */
-        TimerNode(TimerTaskId id_, int laps, int interval, bool periodic, TimerTask t)
-            : id(id_), remaining_laps(laps), interval_ticks(interval),
-              is_periodic(periodic), cancelled(false), task(std::move(t)) {}
+        uint32_t self = kNil;         ///< 自身在池内的下标
+        uint32_t prev = kNil;         ///< 槽位链表前驱（池内下标）
+        uint32_t next = kNil;         ///< 槽位链表后继 / 空闲链表后继
+        uint32_t generation = 1;      ///< 节点代数，每次回收递增，用于使旧 ID 失效
+        int level = -1;               ///< 所在层级（-1 表示不在任何槽位）
+        uint32_t slot = 0;            ///< 所在槽位
+        uint64_t expire_tick = 0;     ///< 绝对到期 tick
+        uint64_t interval_ticks = 0;  ///< 周期间隔（tick 数），用于周期性任务重新调度
+        bool in_use = false;          ///< 是否已分配
+        bool is_periodic = false;     ///< 是否为周期性任务
+        bool running = false;         ///< 是否正在执行（已被 tick 取出）
+        std::atomic<bool> cancelled{false}; ///< 执行期间被取消的标记
+        TimerTask task;               ///< 任务回调函数
     };
 
     /**
@@ -222,36 +289,180 @@ private:
             return INVALID_TIMER_ID;
         }
 
-        int ticks_to_wait = (delay_ms + tick_interval_ms_ - 1) / tick_interval_ms_;
+        uint64_t ticks_to_wait =
+            static_cast<uint64_t>((delay_ms + tick_interval_ms_ - 1) / tick_interval_ms_);
 
         std::lock_guard<std::mutex> lock(mutex_);
 
-        TimerTaskId id = next_task_id_++;
-        int remaining_laps = (ticks_to_wait - 1) / wheel_size_;
-        int target_slot = (current_tick_ + ticks_to_wait) % wheel_size_;
+        TimerNode* node = acquire();
+        node->is_periodic = periodic;
+        node->interval_ticks = ticks_to_wait;
+        node->expire_tick = current_tick_ + ticks_to_wait;
+        node->task = std::move(task);
+        insert(node);
+
+        return make_id(index_of(node), node->generation);
+    }
+
+    /**
+     * @brief 按到期 tick 将节点挂到合适的层级与槽位
+     */
+    void insert(TimerNode* node) {
+        uint64_t delta = node->expire_tick - current_tick_;
+        uint64_t expire = node->expire_tick;
+
+        // 超出最高层覆盖范围：挂在最高层可达的最远位置，下沉时再重新计算
+        if (delta >= max_span_) {
+            expire = current_tick_ + max_span_ - 1;
+            delta = max_span_ - 1;
+        }
+
+        int level = 0;
+        while (level < kLevels - 1 && delta >= level_span_[level + 1]) {
+            ++level;
+        }
+
+        uint32_t slot = static_cast<uint32_t>((expire / level_span_[level]) % wheel_size_);
+        uint32_t& head = slot_head(level, slot);
+        uint32_t idx = index_of(node);
+
+        node->level = level;
+        node->slot = slot;
+        node->prev = kNil;
+        node->next = head;
+        if (head != kNil) {
+            node_at(head)->prev = idx;
+        }
+        head = idx;
+    }
+
+    /**
+     * @brief 将节点从所在槽位链表中摘除
+     */
+    void unlink(TimerNode* node) {
+        if (node->level < 0) return;
+        uint32_t& head = slot_head(node->level, node->slot);
+        if (node->prev != kNil) {
+            node_at(node->prev)->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next != kNil) {
+            node_at(node->next)->prev = node->prev;
+        }
+        node->prev = node->next = kNil;
+        node->level = -1;
+    }
+
+    /**
+     * @brief 将第 level 级当前槽位的任务下沉到低层
+     */
+    void cascade(int level, uint64_t now) {
+        uint32_t& head = slot_head(level, static_cast<size_t>((now / level_span_[level]) % wheel_size_));
+        uint32_t idx = head;
+        head = kNil;
+        while (idx != kNil) {
+            TimerNode* node = node_at(idx);
+            uint32_t next = node->next;
+            node->level = -1;
+            insert(node);
+            idx = next;
+        }
+    }
 
-        auto node = std::make_shared<TimerNode>(
-            id, remaining_laps, ticks_to_wait, periodic, std::move(task)
-        );
+    /**
+     * @brief 从对象池取出一个空闲节点
+     */
+    TimerNode* acquire() {
+        if (free_head_ == kNil) {
+            grow();
+        }
+        TimerNode* node = node_at(free_head_);
+        free_head_ = node->next;
+        node->next = kNil;
+        node->in_use = true;
+        node->running = false;
+        node->cancelled.store(false, std::memory_order_relaxed);
+        ++active_;
+        return node;
+    }
+
+    /**
+     * @brief 将节点归还对象池，并使其旧 ID 失效
+     */
+    void release(TimerNode* node) {
+        node->task = nullptr;
+        node->in_use = false;
+        node->level = -1;
+        node->prev = kNil;
+        ++node->generation;
+        node->next = free_head_;
+        free_head_ = index_of(node);
+        --active_;
+    }
+
+    /**
+     * @brief 对象池扩容一块
+     *
+     * 按块分配保证已有节点地址稳定，tick() 可在锁外直接访问节点。
+     */
+    void grow() {
+        auto chunk = std::make_unique<TimerNode[]>(kChunkSize);
+        const uint32_t base = static_cast<uint32_t>(node_count_);
+        for (size_t i = kChunkSize; i-- > 0; ) {
+            chunk[i].self = base + static_cast<uint32_t>(i);
+            chunk[i].next = free_head_;
+            free_head_ = base + static_cast<uint32_t>(i);
+        }
+        chunks_.push_back(std::move(chunk));
+        node_count_ += kChunkSize;
+    }
 
-        wheel_[target_slot].push_back(node);
-        task_map_[id] = node;
+    /**
+     * @brief 根据任务 ID 查找仍然有效的节点
+     * @return 节点指针；ID 无效或已过期时返回 nullptr
+     */
+    TimerNode* resolve(TimerTaskId id) {
+        uint32_t low = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        if (low == 0 || low > node_count_) return nullptr;
+        TimerNode* node = node_at(low - 1);
+        if (!node->in_use || node->generation != static_cast<uint32_t>(id >> 32)) {
+            return nullptr;
+        }
+        return node;
+    }
+
+    static TimerTaskId make_id(uint32_t index, uint32_t generation) {
+        return (static_cast<TimerTaskId>(generation) << 32) | (static_cast<TimerTaskId>(index) + 1);
+    }
 
-        return id;
+    TimerNode* node_at(uint32_t idx) const {
+        return &chunks_[idx / kChunkSize][idx % kChunkSize];
     }
 
-    const int wheel_size_;        ///< 时间轮槽位数量
-    const int tick_interval_ms_;  ///< 每个槽位代表的时间间隔（毫秒）
-    int current_tick_ = 0;        ///< 当前指针位置
+    static uint32_t index_of(const TimerNode* node) { return node->self; }
+
+    uint32_t& slot_head(int level, size_t slot) {
+        return slots_[static_cast<size_t>(level) * static_cast<size_t>(wheel_size_) + slot];
+    }
 
-    /// 时间轮槽位数组，每个槽位是一个任务链表
-    std::vector<std::list<std::shared_ptr<TimerNode>>> wheel_;
-    /// 任务 ID 到任务节点的映射，用于快速查找和取消
-    std::unordered_map<TimerTaskId, std::shared_ptr<TimerNode>> task_map_;
-    /// 下一个可用的任务 ID（原子递增）
-    std::atomic<TimerTaskId> next_task_id_;
+    const int wheel_size_;        ///< 每一级的槽位数量
+    const int tick_interval_ms_;  ///< 每个 tick 代表的时间间隔（毫秒）
+    uint64_t current_tick_ = 0;   ///< 已推进的 tick 总数
+    uint64_t level_span_[kLevels] = {}; ///< 各层级单个槽位覆盖的 tick 数
+    uint64_t max_span_ = 0;       ///< 整个时间轮覆盖的 tick 数
+
+    /// 所有层级的槽位链表头（池内下标），按 level * wheel_size + slot 排列
+    std::vector<uint32_t> slots_;
+    /// 节点对象池（按块分配，地址稳定）
+    std::vector<std::unique_ptr<TimerNode[]>> chunks_;
+    size_t node_count_ = 0;       ///< 对象池节点总数
+    uint32_t free_head_ = kNil;   ///< 空闲链表头
+    size_t active_ = 0;           ///< 已分配节点数
+    /// tick() 复用的到期任务缓冲区
+    std::vector<TimerNode*> expired_buffer_;
     /// 保护时间轮数据结构的互斥锁
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
 };
 
 } // namespace fix40
@@ -101,6 +101,15 @@ public:
      */
     void send(std::string_view data);
 
+    /**
+     * @brief 发送数据（移交所有权）
+     * @param data 要发送的数据
+     *
+     * 与 send(std::string_view) 语义相同，但直接接管报文缓冲区，
+     * 派发到绑定线程时不再额外拷贝一次。
+     */
+    void send(std::string&& data);
+
     /**
      * @brief 派发任务到绑定的工作线程执行
      * @param task 要执行的任务
@@ -140,48 +140,49 @@ public:
      * @note 自动计算并设置 BodyLength 和 CheckSum
      */
     std::string encode(FixMessage& msg) const {
-        // 1. 准备时间戳
-        char ts[32];
-        generate_utc_timestamp(ts, sizeof(ts));
-        msg.set(tags::SendingTime, ts);
+        const std::string body_str = build_body_from_message(msg);
+        return encode_with_body(msg, body_str, byte_sum(body_str));
+    }
 
-        // 2. 构造标准 Header（除 8= 和 9= 之外）
-        static constexpr std::array<int, 5> kStdHeaderOrder = {
-            tags::MsgType,       // 35
-            tags::SenderCompID,  // 49
-            tags::TargetCompID,  // 56
-            tags::MsgSeqNum,     // 34
-            tags::SendingTime    // 52
-        };
+    /**
+     * @struct EncodedBody
+     * @brief 预先序列化的消息体（不含标准头和尾）
+     *
+     * 用于同一消息发给多个接收方的场景：消息体只序列化一次，
+     * 每个接收方只需重新生成标准头（34/49/56/52）、BodyLength 和 CheckSum。
+     */
+    struct EncodedBody {
+        std::string msgType;   ///< MsgType (35)
+        std::string bytes;     ///< 已序列化的消息体字段（按 tag 升序，含 SOH）
+        uint32_t byteSum = 0;  ///< bytes 的字节和（用于增量计算 CheckSum）
+    };
 
-        std::ostringstream header_rest_ss;
-        for (int tag : kStdHeaderOrder) {
-            if (msg.has(tag)) {
-                header_rest_ss << tag << "=" << msg.get_string(tag) << SOH;
-            }
+    /**
+     * @brief 预先序列化消息体
+     * @param msg 消息对象（标准头字段会被忽略）
+     * @return EncodedBody 可复用的消息体
+     */
+    EncodedBody encode_body(const FixMessage& msg) const {
+        EncodedBody body;
+        if (msg.has(tags::MsgType)) {
+            body.msgType = msg.get_string(tags::MsgType);
         }
+        body.bytes = build_body_from_message(msg);
+        body.byteSum = byte_sum(body.bytes);
+        return body;
+    }
 
-        // 3. 构造报文体 (Body) —— 仅业务字段
-        std::string body_str = build_body_from_message(msg);
-
-        std::string header_rest = header_rest_ss.str();
-
-        // 4. 计算 BodyLength （从 35= 起始到 CheckSum 前一个 SOH）
-        std::size_t body_length_val = header_rest.size() + body_str.size();
-        msg.set(tags::BodyLength, static_cast<int>(body_length_val));
-
-        // 5. 构造最终前缀（8= & 9= + HeaderRest + Body）
-        std::ostringstream prefix_ss;
-        prefix_ss << tags::BeginString << "=" << "FIX.4.0" << SOH
-                  << tags::BodyLength << "=" << msg.get_string(tags::BodyLength) << SOH
-                  << header_rest
-                  << body_str; // 如果 body_str 非空，则其已包含 SOH 分隔符
-
-        std::string prefix = prefix_ss.str();
-
-        // 6. 计算并附加校验和
-        std::string checksum = calculate_checksum(prefix);
-        return prefix + std::to_string(tags::CheckSum) + "=" + checksum + SOH;
+    /**
+     * @brief 使用预先序列化的消息体编码完整消息
+     * @param header 标准头字段（需包含 49/56/34，35 取自 body.msgType）
+     * @param body 预先序列化的消息体
+     * @return std::string 编码后的 FIX 消息字符串
+     *
+     * 输出与对同等内容调用 encode() 完全一致。
+     */
+    std::string encode_prepared(FixMessage& header, const EncodedBody& body) const {
+        header.set(tags::MsgType, body.msgType);
+        return encode_with_body(header, body.bytes, body.byteSum);
     }
 
     /**
@@ -263,6 +264,91 @@ private:
         return body.str();
     }
 
+    /**
+     * @brief 将标准头与已序列化的消息体拼装为完整消息
+     * @param msg 消息对象（会被写入 SendingTime 与 BodyLength）
+     * @param body_str 已序列化的消息体
+     * @param body_sum body_str 的字节和
+     */
+    std::string encode_with_body(FixMessage& msg, const std::string& body_str, uint32_t body_sum) const {
+        // 1. 准备时间戳
+        char ts[32];
+        generate_utc_timestamp(ts, sizeof(ts));
+        msg.set(tags::SendingTime, ts);
+
+        // 2. 构造标准 Header（除 8= 和 9= 之外）
+        static constexpr std::array<int, 5> kStdHeaderOrder = {
+            tags::MsgType,       // 35
+            tags::SenderCompID,  // 49
+            tags::TargetCompID,  // 56
+            tags::MsgSeqNum,     // 34
+            tags::SendingTime    // 52
+        };
+
+        std::string header_rest;
+        header_rest.reserve(64);
+        const auto& fields = msg.get_fields();
+        for (int tag : kStdHeaderOrder) {
+            auto it = fields.find(tag);
+            if (it != fields.end()) {
+                header_rest += std::to_string(tag);
+                header_rest += '=';
+                header_rest += it->second;
+                header_rest += SOH;
+            }
+        }
+
+        // 3. 计算 BodyLength （从 35= 起始到 CheckSum 前一个 SOH）
+        const std::size_t body_length_val = header_rest.size() + body_str.size();
+        msg.set(tags::BodyLength, static_cast<int>(body_length_val));
+
+        // 4. 构造最终报文（8= & 9= + HeaderRest + Body + 10=）
+        std::string out;
+        out.reserve(body_length_val + 32);
+        out += std::to_string(tags::BeginString);
+        out += "=FIX.4.0";
+        out += SOH;
+        out += std::to_string(tags::BodyLength);
+        out += '=';
+        out += std::to_string(body_length_val);
+        out += SOH;
+        out += header_rest;
+
+        // 5. 校验和：前缀部分现算，消息体部分使用预先算好的字节和
+        const uint32_t sum = byte_sum(out) + body_sum;
+        out += body_str; // 如果 body_str 非空，则其已包含 SOH 分隔符
+
+        char checksum[4];
+        format_checksum(sum, checksum);
+        out += std::to_string(tags::CheckSum);
+        out += '=';
+        out.append(checksum, 3);
+        out += SOH;
+        return out;
+    }
+
+    /**
+     * @brief 计算字节和（按无符号字节累加）
+     */
+    static uint32_t byte_sum(const std::string& data) {
+        uint32_t sum = 0;
+        for (unsigned char c : data) {
+            sum += c;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief 将字节和格式化为 3 位校验和
+     */
+    static void format_checksum(uint32_t sum, char out[4]) {
+        const uint32_t v = sum % 256;
+        out[0] = static_cast<char>('0' + v / 100);
+        out[1] = static_cast<char>('0' + (v / 10) % 10);
+        out[2] = static_cast<char>('0' + v % 10);
+        out[3] = '\0';
+    }
+
     /**
      * @brief 计算 FIX 校验和
      * @param data 要计算校验和的数据
@@ -7,6 +7,7 @@
  * - Heartbeat (0) - 心跳
  * - TestRequest (1) - 测试请求
  * - Logout (5) - 登出
+ * - BusinessMessageReject (j) - 业务拒绝
  */
 
 #pragma once
@@ -199,6 +200,38 @@ inline FixMessage create_sequence_reset_message(const std::string& sender,
     return sr;
 }
 
+/**
+ * @brief 创建 BusinessMessageReject 消息
+ * @param sender 发送方 CompID
+ * @param target 接收方 CompID
+ * @param seq_num 消息序列号
+ * @param ref_msg_type 被拒绝消息的类型
+ * @param reason 拒绝原因
+ * @param ref_seq_num 被拒绝消息的序列号（<= 0 时不设置）
+ * @return FixMessage BusinessMessageReject 消息对象
+ *
+ * - MsgType (35) = "j"
+ * - RefSeqNum (45) = 被拒绝消息的序列号
+ * - Text (58) = 拒绝原因（RefMsgType 标准 Tag 为 372，FIX 4.0 无此字段，简化放在 Text 中）
+ */
+inline FixMessage create_business_reject_message(const std::string& sender,
+                                                 const std::string& target,
+                                                 int seq_num,
+                                                 const std::string& ref_msg_type,
+                                                 const std::string& reason,
+                                                 int ref_seq_num = 0) {
+    FixMessage rj;
+    rj.set(tags::MsgType, "j");
+    rj.set(tags::SenderCompID, sender);
+    rj.set(tags::TargetCompID, target);
+    rj.set(tags::MsgSeqNum, seq_num);
+    if (ref_seq_num > 0) {
+        rj.set(tags::RefSeqNum, ref_seq_num);
+    }
+    rj.set(tags::Text, ref_msg_type.empty() ? reason : ("[" + ref_msg_type + "] " + reason));
+    return rj;
+}
+
 /**
  * @brief 判断消息类型是否为管理消息
  * @param msg_type 消息类型
@@ -61,6 +61,9 @@ constexpr int ResetSeqNumFlag = 141;
 /// @brief 测试请求标识符
 constexpr int TestReqID = 112;
 
+/// @brief 被拒绝消息的序列号 (Reference Sequence Number)，用于 Reject / BusinessMessageReject
+constexpr int RefSeqNum = 45;
+
 /// @brief 文本消息（用于 Logout 原因等）
 constexpr int Text = 58;
 
@@ -288,5 +291,12 @@ constexpr int VolumeMultiple = 10029;
 /// @brief 保证金率
 constexpr int MarginRate = 10030;
 
+// ============================================================================
+// 压力测试相关自定义标签
+// ============================================================================
+
+/// @brief 冲击档数（各品种上下各变动 1..N 个涨跌停）
+constexpr int ShockSteps = 10031;
+
 } // namespace tags
 } // namespace fix40
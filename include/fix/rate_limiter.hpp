@@ -0,0 +1,244 @@
+/**
+ * @file rate_limiter.hpp
+ * @brief 入站消息令牌桶限流
+ *
+ * 按消息类别（报单/撤单/查询/其它）对每个会话、每个账户分别限流，
+ * 防止单个客户端刷单拖慢共享的撮合线程与风控路径。
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fix40 {
+
+/**
+ * @enum ThrottleClass
+ * @brief 限流的消息类别
+ */
+enum class ThrottleClass : uint8_t {
+    ORDER = 0,  ///< 报单类：D（NewOrderSingle）、G（OrderCancelReplaceRequest）
+    QUERY = 1,  ///< 查询类：U1/U3/U7/U9/U11/U13 等自定义查询
+    OTHER = 2,  ///< 其它业务消息
+    CANCEL = 3  ///< 撤单：F（OrderCancelRequest），单独计数，报单额度耗尽时仍可撤单
+};
+
+/// 消息类别数量
+constexpr size_t kThrottleClassCount = 4;
+
+/**
+ * @brief 根据 MsgType 判断限流类别
+ * @param msg_type 消息类型
+ * @return ThrottleClass 限流类别
+ */
+ThrottleClass classify_msg_type(const std::string& msg_type);
+
+/**
+ * @brief 获取限流类别名称（用于配置键与日志）
+ */
+const char* throttle_class_name(ThrottleClass cls);
+
+/**
+ * @class TokenBucket
+ * @brief 令牌桶
+ *
+ * 以 rate 个/秒的速度补充令牌，最多积累 burst 个。rate <= 0 表示不限流。
+ *
+ * @note 非线程安全，由调用方负责同步
+ */
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket() = default;
+
+    /**
+     * @brief 构造令牌桶
+     * @param rate 每秒补充的令牌数（<= 0 表示不限流）
+     * @param burst 桶容量（<= 0 时取 rate）
+     */
+    TokenBucket(double rate, double burst);
+
+    /**
+     * @brief 尝试消耗一个令牌
+     * @param now 当前时间
+     * @return true 令牌充足（已扣减）
+     * @return false 令牌不足，应限流
+     */
+    bool try_consume(Clock::time_point now);
+
+    /**
+     * @brief 归还一个令牌（用于多级限流中后一级拒绝时回滚前一级）
+     */
+    void refund();
+
+    /**
+     * @brief 是否启用限流
+     */
+    bool limited() const { return rate_ > 0.0; }
+
+private:
+    double rate_ = 0.0;    ///< 每秒补充的令牌数
+    double burst_ = 0.0;   ///< 桶容量
+    double tokens_ = 0.0;  ///< 当前令牌数
+    Clock::time_point last_{};  ///< 上次补充时间
+    bool started_ = false; ///< 是否已初始化 last_
+};
+
+/**
+ * @struct ThrottleLimits
+ * @brief 一组按类别的限流参数
+ */
+struct ThrottleLimits {
+    std::array<double, kThrottleClassCount> rate{};   ///< 每秒令牌数（0 表示不限流）
+    std::array<double, kThrottleClassCount> burst{};  ///< 桶容量
+};
+
+/**
+ * @struct ThrottleConfig
+ * @brief 限流配置
+ *
+ * 对应 config.ini 的 [throttle] 节：
+ * @code
+ * [throttle]
+ * enabled = 1
+ * session_order_rate = 50
+ * session_order_burst = 100
+ * account_order_rate = 100
+ * account_order_burst = 200
+ * ; 其余类别键名为 session_{query,other,cancel}_* / account_{query,other,cancel}_*
+ * @endcode
+ */
+struct ThrottleConfig {
+    bool enabled = false;     ///< 是否启用限流
+    ThrottleLimits session;   ///< 单会话限流参数
+    ThrottleLimits account;   ///< 单账户限流参数（同一账户的多个会话共享）
+
+    /**
+     * @brief 从全局 Config 读取 [throttle] 配置
+     */
+    static ThrottleConfig fromConfig();
+};
+
+/**
+ * @enum ThrottleResult
+ * @brief 限流判定结果
+ */
+enum class ThrottleResult {
+    ADMITTED,         ///< 放行
+    SESSION_LIMITED,  ///< 超出会话限额
+    ACCOUNT_LIMITED   ///< 超出账户限额
+};
+
+/**
+ * @struct ThrottleStats
+ * @brief 限流计数快照
+ */
+struct ThrottleStats {
+    uint64_t admitted = 0;  ///< 放行的消息数
+    std::array<uint64_t, kThrottleClassCount> sessionHits{};  ///< 各类别触发会话限流次数
+    std::array<uint64_t, kThrottleClassCount> accountHits{};  ///< 各类别触发账户限流次数
+
+    /// 限流总次数
+    uint64_t totalHits() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kThrottleClassCount; ++i) {
+            total += sessionHits[i] + accountHits[i];
+        }
+        return total;
+    }
+};
+
+/**
+ * @class SessionThrottle
+ * @brief 单个会话的限流状态
+ *
+ * 由 Session 持有，只在会话的状态锁内访问，因此令牌桶本身无需加锁；
+ * 计数器使用原子变量，便于其它线程读取统计。
+ */
+class SessionThrottle {
+public:
+    explicit SessionThrottle(const ThrottleLimits& limits);
+
+    /// 获取本会话的限流计数快照
+    ThrottleStats stats() const;
+
+private:
+    friend class RateLimiter;
+
+    std::array<TokenBucket, kThrottleClassCount> buckets_;  ///< 各类别令牌桶
+    std::atomic<uint64_t> admitted_{0};                      ///< 放行计数
+    std::array<std::atomic<uint64_t>, kThrottleClassCount> sessionHits_{};  ///< 会话限流计数
+    std::array<std::atomic<uint64_t>, kThrottleClassCount> accountHits_{};  ///< 账户限流计数
+};
+
+/**
+ * @class RateLimiter
+ * @brief 入站消息限流器（服务端共享一个实例）
+ *
+ * - 会话级令牌桶由 SessionThrottle 持有（无锁）
+ * - 账户级令牌桶按账户 ID 哈希分片，每片一把锁
+ * - 全局计数器记录放行数与各类别限流命中数
+ *
+ * @par 使用示例
+ * @code
+ * auto limiter = std::make_shared<RateLimiter>(ThrottleConfig::fromConfig());
+ * session->set_rate_limiter(limiter);
+ * @endcode
+ */
+class RateLimiter {
+public:
+    explicit RateLimiter(ThrottleConfig config);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief 为新会话创建限流状态
+     */
+    std::unique_ptr<SessionThrottle> createSessionThrottle() const;
+
+    /**
+     * @brief 判定一条入站消息是否放行
+     * @param session 会话限流状态
+     * @param accountId 账户 ID（为空时只做会话级限流）
+     * @param cls 消息类别
+     * @return ThrottleResult 判定结果
+     */
+    ThrottleResult admit(SessionThrottle& session, const std::string& accountId, ThrottleClass cls);
+
+    /**
+     * @brief 获取全局限流计数快照
+     */
+    ThrottleStats stats() const;
+
+    /**
+     * @brief 获取配置
+     */
+    const ThrottleConfig& config() const { return config_; }
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    struct AccountShard {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::array<TokenBucket, kThrottleClassCount>> buckets;
+    };
+
+    bool accountLimited(size_t cls) const { return config_.account.rate[cls] > 0.0; }
+
+    ThrottleConfig config_;
+    std::array<AccountShard, kShardCount> accountShards_;
+    std::atomic<uint64_t> admitted_{0};
+    std::array<std::atomic<uint64_t>, kThrottleClassCount> sessionHits_{};
+    std::array<std::atomic<uint64_t>, kThrottleClassCount> accountHits_{};
+};
+
+} // namespace fix40
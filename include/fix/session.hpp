@@ -21,6 +21,8 @@
 
 #include "fix/fix_codec.hpp"
 #include "fix/application.hpp"
+#include "fix/rate_limiter.hpp"
+#include "fix/session_stats.hpp"
 #include "base/concurrentqueue.h"
 #include "base/timing_wheel.hpp"
 
@@ -247,6 +249,18 @@ public:
      */
     void send(FixMessage& msg);
 
+    /**
+     * @brief 发送预先序列化消息体的业务消息
+     * @param body 由 FixCodec::encode_body() 生成的消息体
+     *
+     * 用于广播场景：消息体只序列化一次，本方法仅生成本会话的
+     * 标准头（34/49/56/52）、BodyLength 和 CheckSum，序列号分配与持久化
+     * 与 send() 一致。
+     *
+     * @note 不触发 Application::toApp()（消息体已固定，无法逐会话修改）
+     */
+    void send_prepared(const FixCodec::EncodedBody& body);
+
     /**
      * @brief 发送缓冲区中的数据
      */
@@ -304,8 +318,10 @@ public:
     /**
      * @brief 调度周期性定时任务
      * @param wheel 时间轮指针
+     * @param wheel_on_bound_thread 时间轮是否由本连接绑定的工作线程驱动。
+     *        为 true 时定时检查直接在 tick 线程执行；否则派发到连接绑定线程。
      */
-    void schedule_timer_tasks(TimingWheel* wheel);
+    void schedule_timer_tasks(TimingWheel* wheel, bool wheel_on_bound_thread = false);
 
 	    /**
 	     * @brief 切换会话状态
@@ -462,6 +478,55 @@ public:
      */
     void set_client_comp_id(const std::string& clientId) { clientCompID_ = clientId; }
 
+    // --- 入站限流 ---
+
+    /**
+     * @brief 设置入站限流器
+     * @param limiter 服务端共享的限流器；为 nullptr 时不限流
+     *
+     * 应在 start() 之前调用。
+     */
+    void set_rate_limiter(std::shared_ptr<RateLimiter> limiter);
+
+    /**
+     * @brief 对一条入站业务消息执行限流判定
+     * @param msg 入站业务消息
+     * @return true 放行，可继续交给应用层
+     * @return false 已被限流，并已向对端发送 BusinessReject
+     *
+     * 由 EstablishedState 在调用 Application::fromApp() 之前调用。
+     * 会话级额度按会话计算，账户级额度按 clientCompID 计算。
+     * 拒绝消息携带原消息的 RefSeqNum；报单/撤单类消息同时回带 ClOrdID / OrigClOrdID，
+     * 客户端据此结束对应请求的等待状态。
+     */
+    bool admit_inbound(const FixMessage& msg);
+
+    /**
+     * @brief 获取本会话的限流计数
+     */
+    ThrottleStats get_throttle_stats() const;
+
+    /**
+     * @brief 发送 BusinessMessageReject (MsgType = j)
+     * @param ref_msg_type 被拒绝消息的类型
+     * @param reason 拒绝原因
+     */
+    void send_business_reject(const std::string& ref_msg_type, const std::string& reason);
+
+    // --- 运行统计 ---
+
+    /**
+     * @brief 获取会话统计计数器
+     *
+     * 计数器线程安全，可由连接层与状态机直接累加。
+     */
+    SessionStatistics& stats() { return stats_; }
+
+    /**
+     * @brief 生成本会话的统计快照（含限流计数）
+     */
+    SessionStatsSnapshot get_stats_snapshot() const;
+
 private:
     std::atomic<bool> shutting_down_{false};   ///< 关闭中标志
     std::recursive_mutex state_mutex_;          ///< 状态保护锁
@@ -473,6 +538,20 @@ private:
      */
     void internal_send(const std::string& raw_msg);
 
+    /**
+     * @brief 内部发送实现（移交所有权，避免再次拷贝报文）
+     * @param raw_msg 原始消息字符串
+     */
+    void internal_send(std::string&& raw_msg);
+
+    /**
+     * @brief 持久化一条已编码的出站消息及会话状态
+     * @param seq_num 消息序列号
+     * @param msg_type 消息类型
+     * @param raw_msg 已编码的报文
+     */
+    void persist_outbound(int seq_num, const std::string& msg_type, const std::string& raw_msg);
+
     /**
      * @brief 按序处理暂存的入站消息
      *
@@ -511,6 +590,9 @@ private:
 	    IStore* store_ = nullptr;             ///< 存储接口指针（用于消息持久化）
 	    bool processingResend_ = false;       ///< 是否正在处理重传请求
 	    std::string clientCompID_;            ///< 客户端标识（从 Logon 消息提取）
+	    std::shared_ptr<RateLimiter> rate_limiter_;   ///< 入站限流器（可选）
+	    std::unique_ptr<SessionThrottle> throttle_;   ///< 本会话限流状态
+	    SessionStatistics stats_;                     ///< 运行统计
 	    EstablishedCallback established_callback_; ///< 会话建立回调
 	    std::atomic<bool> established_notified_{false}; ///< 会话建立回调触发标志（幂等）
 	};
@@ -8,9 +8,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include "fix/session.hpp"
 #include "fix/application.hpp"
@@ -34,6 +40,7 @@ struct SessionIDHash {
  * 线程安全地管理所有活跃的 FIX 会话，提供：
  * - 会话注册/注销
  * - 按 SessionID 查找会话
+ * - 按客户端 CompID（用户ID）O(1) 查找会话
  * - 向指定会话发送消息
  *
  * @par 使用场景
@@ -41,7 +48,9 @@ struct SessionIDHash {
  * 找到对应的 Session 并发送消息。
  *
  * @par 线程安全
- * 所有公共方法都是线程安全的。
+ * 所有公共方法都是线程安全的。会话表与 clientCompID 索引均按哈希分片，
+ * 每个分片使用独立的读写锁：findSession/sendMessage 只对目标分片加共享锁，
+ * 不同会话之间的查找与发送不会在同一把锁上串行化。
  *
  * @par 使用示例
  * @code
@@ -87,10 +96,12 @@ public:
     /**
      * @brief 注销会话
      * @param sessionID 会话标识符
+     * @param expected 非空时仅当当前登记的会话就是该对象才注销。
+     *        同一用户重连后 SessionID 相同，旧连接关闭时应传入自身，避免注销新会话。
      * @return true 成功注销
-     * @return false 会话不存在
+     * @return false 会话不存在或已被替换
      */
-    bool unregisterSession(const SessionID& sessionID);
+    bool unregisterSession(const SessionID& sessionID, const Session* expected = nullptr);
 
     /**
      * @brief 查找会话
@@ -111,6 +122,45 @@ public:
      */
     bool sendMessage(const SessionID& sessionID, FixMessage& msg);
 
+    /**
+     * @brief 向一组会话广播同一条业务消息
+     * @param targets 目标会话标识符列表
+     * @param msg 要广播的消息（标准头字段会被忽略）
+     * @return size_t 实际发送成功的会话数量
+     *
+     * 消息体只序列化一次（FixCodec::encode_body），每个接收方仅生成
+     * 34/49/56/52 标准头、BodyLength 和 CheckSum，再直接移交给连接的发送队列。
+     * 不存在或未运行的会话会被跳过。
+     *
+     * @note 广播不触发 Application::toApp()
+     */
+    size_t broadcast(const std::vector<SessionID>& targets, const FixMessage& msg);
+
+    /**
+     * @brief 向所有活跃会话广播同一条业务消息
+     * @param msg 要广播的消息（标准头字段会被忽略）
+     * @return size_t 实际发送成功的会话数量
+     *
+     * 适用于行情、合约状态、系统通知等对所有客户端内容一致的消息。
+     */
+    size_t broadcastAll(const FixMessage& msg);
+
+    /**
+     * @brief 按客户端 CompID 查找会话
+     * @param clientCompID 客户端标识（即用户ID，Logon 时的 SenderCompID）
+     * @return std::shared_ptr<Session> 会话对象，不存在返回 nullptr
+     *
+     * 通过注册时维护的二级索引直接定位，复杂度 O(1)，无需遍历所有会话。
+     */
+    std::shared_ptr<Session> findSessionByClientCompId(const std::string& clientCompID) const;
+
+    /**
+     * @brief 按客户端 CompID 查找会话标识
+     * @param clientCompID 客户端标识
+     * @return std::optional<SessionID> 会话标识，不存在返回 std::nullopt
+     */
+    std::optional<SessionID> findSessionIdByClientCompId(const std::string& clientCompID) const;
+
     /**
      * @brief 获取活跃会话数量
      */
@@ -128,9 +178,60 @@ public:
      */
     void forEachSession(std::function<void(const SessionID&, std::shared_ptr<Session>)> callback) const;
 
+    /**
+     * @brief 收集所有活跃会话的统计快照
+     * @return std::vector<SessionStatsSnapshot> 按 SessionID 字符串排序
+     */
+    std::vector<SessionStatsSnapshot> collectStats() const;
+
+    /**
+     * @brief 获取指定会话的统计快照
+     * @param sessionID 会话标识符
+     * @return std::optional<SessionStatsSnapshot> 会话不存在返回 std::nullopt
+     */
+    std::optional<SessionStatsSnapshot> getSessionStats(const SessionID& sessionID) const;
+
 private:
-    mutable std::mutex mutex_;  ///< 保护 sessions_ 的互斥锁
-    std::unordered_map<SessionID, std::shared_ptr<Session>, SessionIDHash> sessions_;
+    /// 分片数量（2 的幂）
+    static constexpr size_t kShardCount = 16;
+
+    /**
+     * @struct SessionShard
+     * @brief 会话表分片
+     */
+    struct SessionShard {
+        mutable std::shared_mutex mutex;  ///< 保护本分片 sessions 的读写锁
+        std::unordered_map<SessionID, std::shared_ptr<Session>, SessionIDHash> sessions;
+    };
+
+    /**
+     * @struct ClientIndexShard
+     * @brief clientCompID -> SessionID 索引分片
+     */
+    struct ClientIndexShard {
+        /// 索引条目；重连后 SessionID 不变，以会话对象区分新旧会话
+        struct Entry {
+            SessionID sessionID;
+            const Session* session = nullptr;
+        };
+
+        mutable std::shared_mutex mutex;  ///< 保护本分片 index 的读写锁
+        std::unordered_map<std::string, Entry> index;
+    };
+
+    SessionShard& shardFor(const SessionID& sessionID) const;
+    ClientIndexShard& clientShardFor(const std::string& clientCompID) const;
+
+    /// 登记 clientCompID 索引（空 clientCompID 不登记）
+    void indexClient(const std::string& clientCompID, const SessionID& sessionID, const Session* session);
+    /// 向单个会话发送预先序列化的消息体，返回是否成功
+    static bool sendPrepared(const std::shared_ptr<Session>& session, const FixCodec::EncodedBody& body);
+    /// 移除 clientCompID 索引（仅当索引仍指向该会话对象时移除）
+    void unindexClient(const std::string& clientCompID, const Session* session);
+
+    mutable std::array<SessionShard, kShardCount> shards_;               ///< 会话表分片
+    mutable std::array<ClientIndexShard, kShardCount> clientShards_;     ///< 客户端索引分片
+    std::atomic<size_t> sessionCount_{0};                                ///< 活跃会话总数
 };
 
 } // namespace fix40
@@ -0,0 +1,125 @@
+/**
+ * @file session_stats.hpp
+ * @brief FIX 会话运行统计
+ *
+ * 每个 Session 常驻一份计数器与延迟直方图，用于在线排查：
+ * 收发消息数/字节数、重传与序列号 gap、心跳往返时延（TestRequest -> Heartbeat）、
+ * 以及应用层按 MsgType 的处理耗时。
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/latency_histogram.hpp"
+#include "fix/rate_limiter.hpp"
+
+namespace fix40 {
+
+/**
+ * @struct SessionStatsSnapshot
+ * @brief 单个会话的统计快照（时延单位为纳秒）
+ */
+struct SessionStatsSnapshot {
+    std::string sessionId;       ///< SessionID 字符串
+    std::string clientCompID;    ///< 客户端标识
+
+    uint64_t msgsIn = 0;         ///< 收到的消息数
+    uint64_t msgsOut = 0;        ///< 发出的消息数
+    uint64_t bytesIn = 0;        ///< 收到的字节数
+    uint64_t bytesOut = 0;       ///< 发出的字节数
+
+    uint64_t gapEvents = 0;              ///< 检测到的入站序列号 gap 次数
+    uint64_t resendRequestsSent = 0;     ///< 发出的 ResendRequest 数
+    uint64_t resendRequestsReceived = 0; ///< 收到的 ResendRequest 数
+    uint64_t messagesResent = 0;         ///< 重传（PossDup）的业务消息数
+    uint64_t gapFillsSent = 0;           ///< 发出的 SequenceReset-GapFill 数
+
+    HistogramSnapshot heartbeatRtt;  ///< TestRequest -> Heartbeat 往返时延
+    /// 按 MsgType 的应用层处理耗时（仅含有样本的类型，未知类型合并为 "other"）
+    std::vector<std::pair<std::string, HistogramSnapshot>> appLatency;
+
+    ThrottleStats throttle;  ///< 入站限流计数
+};
+
+/**
+ * @class SessionStatistics
+ * @brief 会话统计计数器
+ *
+ * 计数器均为原子变量，可在会话线程写入、在其它线程读取快照。
+ * 应用层耗时按固定的 MsgType 列表分桶（kAppMsgTypes），其它类型计入 "other"，
+ * 客户端发送任意 MsgType 都不会增加内存；各桶的直方图首次使用时以 CAS 安装，记录全程无锁。
+ */
+class SessionStatistics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// 单独统计耗时的 MsgType；最后一个桶为 "other"
+    static constexpr std::array<const char*, 10> kAppMsgTypes = {
+        "D", "F", "G", "U1", "U3", "U7", "U9", "U11", "U13", "other"};
+
+    SessionStatistics() = default;
+    ~SessionStatistics();
+    SessionStatistics(const SessionStatistics&) = delete;
+    SessionStatistics& operator=(const SessionStatistics&) = delete;
+
+    void on_message_in() { msgsIn_.fetch_add(1, std::memory_order_relaxed); }
+    void on_bytes_in(size_t bytes) { bytesIn_.fetch_add(bytes, std::memory_order_relaxed); }
+    void on_message_out(size_t bytes) {
+        msgsOut_.fetch_add(1, std::memory_order_relaxed);
+        bytesOut_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void on_gap() { gapEvents_.fetch_add(1, std::memory_order_relaxed); }
+    void on_resend_request_sent() { resendRequestsSent_.fetch_add(1, std::memory_order_relaxed); }
+    void on_resend_request_received() { resendRequestsReceived_.fetch_add(1, std::memory_order_relaxed); }
+    void on_message_resent() { messagesResent_.fetch_add(1, std::memory_order_relaxed); }
+    void on_gap_fill_sent() { gapFillsSent_.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief 记录一次心跳往返时延
+     */
+    void record_heartbeat_rtt(Clock::duration rtt);
+
+    /**
+     * @brief 记录一次应用层处理耗时
+     * @param msg_type 消息类型
+     * @param elapsed 处理耗时
+     */
+    void record_app_latency(const std::string& msg_type, Clock::duration elapsed);
+
+    /**
+     * @brief 填充快照中的计数与直方图字段（不含会话标识与限流计数）
+     */
+    void fill(SessionStatsSnapshot& out) const;
+
+private:
+    std::atomic<uint64_t> msgsIn_{0};
+    std::atomic<uint64_t> msgsOut_{0};
+    std::atomic<uint64_t> bytesIn_{0};
+    std::atomic<uint64_t> bytesOut_{0};
+    std::atomic<uint64_t> gapEvents_{0};
+    std::atomic<uint64_t> resendRequestsSent_{0};
+    std::atomic<uint64_t> resendRequestsReceived_{0};
+    std::atomic<uint64_t> messagesResent_{0};
+    std::atomic<uint64_t> gapFillsSent_{0};
+
+    LatencyHistogram heartbeatRtt_;
+
+    /// 与 kAppMsgTypes 对应的直方图（未使用时为 nullptr）
+    std::array<std::atomic<LatencyHistogram*>, kAppMsgTypes.size()> appLatency_{};
+};
+
+/**
+ * @brief 将会话统计格式化为单行 key=value 文本（时延以微秒输出）
+ * @param stats 统计快照
+ * @return std::string 例如 "session=SERVER-USER001 client=USER001 msgs_in=10 ..."
+ */
+std::string format_session_stats(const SessionStatsSnapshot& stats);
+
+} // namespace fix40
@@ -19,6 +19,8 @@
 #include <vector>
 #include <functional>
 #include "ThostFtdcTraderApi.h"
+#include "app/manager/instrument_batch.hpp"
+#include "app/model/instrument.hpp"
 
 namespace fix40 {
 
@@ -175,7 +177,7 @@ public:
     /**
      * @brief 等待查询完成
      * @param timeoutSeconds 超时秒数
-     * @return 完成返回 true，超时返回 false
+     * @return 完成返回 true，超时返回 false（超时前已收到的合约仍会发布到合约管理器）
      */
     bool waitForQueryComplete(int timeoutSeconds);
 
@@ -237,6 +239,8 @@ private:
     std::string tradingDay_;
 
     InstrumentManager* instrumentManager_ = nullptr;
+    /// 本次查询已收到、尚未发布的合约（分批发布，超时时由 waitForQueryComplete 补发）
+    InstrumentBatchLoader pendingInstruments_;
     StateCallback stateCallback_;
     QueryCompleteCallback queryCompleteCallback_;
 };
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <unordered_map>
 #include <string>
 #include <mutex>
@@ -22,6 +23,7 @@ class ThreadPool;
 class TimingWheel;
 class Connection;
 class Application;
+class RateLimiter;
 
 /**
  * @class FixServer
@@ -37,6 +39,7 @@ class Application;
  * @par 线程模型
  * - Reactor 线程：负责 I/O 事件检测
  * - 工作线程池：负责消息处理，每个连接绑定到固定线程
+ * - 时间轮：每个工作线程一个，由 Reactor 定时器派发 tick 到对应线程驱动
  *
  * @par 使用示例
  * @code
@@ -62,6 +65,12 @@ public:
      */
     ~FixServer();
 
+    /**
+     * @brief 获取入站限流器
+     * @return 限流器指针；未启用限流时为 nullptr
+     */
+    const RateLimiter* rate_limiter() const { return rate_limiter_.get(); }
+
     /**
      * @brief 启动服务端
      *
@@ -93,8 +102,10 @@ private:
     int listen_fd_;     ///< 监听 socket 文件描述符
 
     std::unique_ptr<Reactor> reactor_;         ///< Reactor 事件循环
+    /// 每个工作线程一个时间轮（下标与线程索引一致），由对应工作线程 tick。
+    /// 声明在 worker_pool_ 之前：线程池先析构，排队中的 tick 任务不会访问已释放的时间轮。
+    std::vector<std::unique_ptr<TimingWheel>> timing_wheels_;
     std::unique_ptr<ThreadPool> worker_pool_;  ///< 工作线程池
-    std::unique_ptr<TimingWheel> timing_wheel_; ///< 时间轮定时器
 
     /// 连接映射：fd -> Connection
     std::unordered_map<int, std::shared_ptr<Connection>> connections_;
@@ -106,6 +117,7 @@ private:
     int signal_pipe_[2] = {-1, -1}; ///< self-pipe: [0]=read end, [1]=write end
 
     Application* application_ = nullptr;  ///< 应用层处理器指针
+    std::shared_ptr<RateLimiter> rate_limiter_; ///< 入站限流器（未启用时为空）
 };
 
 } // namespace fix40
@@ -0,0 +1,171 @@
+/**
+ * @file account_actor.cpp
+ * @brief 账户/持仓单写者线程实现
+ */
+
+#include "app/account_actor.hpp"
+#include "base/logger.hpp"
+
+namespace fix40 {
+
+namespace {
+
+/// 当前线程是否正在执行 AccountActor 任务（用于嵌套投递直接执行）
+thread_local bool tlsInActorTask = false;
+
+/// 任务执行期间置位 tlsInActorTask，离开作用域（含异常）时恢复
+class InActorTaskScope {
+public:
+    InActorTaskScope() : previous_(tlsInActorTask) { tlsInActorTask = true; }
+    ~InActorTaskScope() { tlsInActorTask = previous_; }
+
+    InActorTaskScope(const InActorTaskScope&) = delete;
+    InActorTaskScope& operator=(const InActorTaskScope&) = delete;
+
+private:
+    bool previous_;
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// AccountViewTable
+// =============================================================================
+
+AccountViewTable::AccountViewTable()
+    : index_(std::make_shared<const Index>())
+{}
+
+std::shared_ptr<const AccountView> AccountViewTable::get(const std::string& accountId) const {
+    const auto index = index_.load();
+    auto it = index->find(accountId);
+    if (it == index->end()) {
+        return nullptr;
+    }
+    return it->second->view.load();
+}
+
+void AccountViewTable::publish(std::shared_ptr<const AccountView> view) {
+    const std::string& accountId = view->account.accountId;
+    const auto index = index_.load();
+    auto it = index->find(accountId);
+    if (it != index->end()) {
+        it->second->view.store(std::move(view));
+        return;
+    }
+    // 新账户：复制索引并整体替换（账户集合很少变化）
+    auto next = std::make_shared<Index>(*index);
+    next->emplace(accountId, std::make_shared<Slot>(std::move(view)));
+    index_.store(std::move(next));
+}
+
+size_t AccountViewTable::size() const {
+    return index_.load()->size();
+}
+
+// =============================================================================
+// AccountActor
+// =============================================================================
+
+AccountActor::AccountActor(Task afterTask)
+    : afterTask_(std::move(afterTask))
+{}
+
+AccountActor::~AccountActor() {
+    stop();
+}
+
+void AccountActor::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+void AccountActor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // 与 post() 中的栅栏配对：post() 要么看到 running_ == false 自行排空，
+    // 要么它入队的任务对下面的排空可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    queue_.enqueue(Task());  // 唤醒写线程
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // 停止前后并发投递、尚未被写线程取走的任务
+    drain();
+}
+
+void AccountActor::drain() {
+    Task task;
+    while (queue_.try_dequeue(task)) {
+        if (task) {
+            std::lock_guard<std::mutex> lock(execMutex_);
+            execute(task);
+        }
+    }
+}
+
+void AccountActor::post(Task task) {
+    if (tlsInActorTask) {
+        task();  // 任务内嵌套投递：直接执行
+        return;
+    }
+    if (running_.load(std::memory_order_acquire)) {
+        queue_.enqueue(std::move(task));
+        // 入队后再检查一次：stop() 可能已在入队前完成排空，此时由投递方排空，任务不会滞留队列
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!running_.load(std::memory_order_relaxed)) {
+            drain();
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(execMutex_);
+    execute(task);
+}
+
+void AccountActor::run() {
+    constexpr size_t kMaxBatch = 64;
+    std::vector<Task> batch(kMaxBatch);
+    for (;;) {
+        const size_t count = queue_.wait_dequeue_bulk(batch.begin(), kMaxBatch);
+        {
+            // 按批加锁：运行期间只有写线程取锁；停止过程中与同步执行、排空互斥
+            std::lock_guard<std::mutex> lock(execMutex_);
+            for (size_t i = 0; i < count; ++i) {
+                if (batch[i]) {
+                    execute(batch[i]);
+                    batch[i] = nullptr;
+                }
+            }
+        }
+        if (!running_.load(std::memory_order_acquire) && queue_.size_approx() == 0) {
+            break;
+        }
+    }
+}
+
+void AccountActor::execute(Task& task) {
+    InActorTaskScope scope;
+    try {
+        task();
+    } catch (const std::exception& e) {
+        LOG() << "[AccountActor] Exception in task: " << e.what();
+    } catch (...) {
+        LOG() << "[AccountActor] Unknown exception in task";
+    }
+    // 任务抛出异常时状态可能已部分修改，仍然发布视图
+    if (afterTask_) {
+        try {
+            afterTask_();
+        } catch (const std::exception& e) {
+            LOG() << "[AccountActor] Exception in afterTask: " << e.what();
+        } catch (...) {
+            LOG() << "[AccountActor] Unknown exception in afterTask";
+        }
+    }
+    processed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace fix40
@@ -0,0 +1,330 @@
+/**
+ * @file engine_journal.cpp
+ * @brief 撮合引擎输入日志实现
+ */
+
+#include "app/engine/engine_journal.hpp"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include "base/logger.hpp"
+#include "fix/fix_codec.hpp"
+#include "fix/fix_message_builder.hpp"
+
+namespace fix40 {
+
+namespace {
+
+/// 记录头：kind | reserved | shard | payloadLen | timestampNs
+constexpr size_t kRecordHeaderSize = 1 + 1 + 2 + 4 + 8;
+
+/// 单条记录负载上限（防止损坏文件导致超大分配）
+constexpr uint32_t kMaxPayload = 16u << 20;
+
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void putString(std::string& out, const std::string& value) {
+    put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+/**
+ * @brief 负载的顺序读取游标，越界后 ok 置为 false
+ */
+struct Cursor {
+    const std::string& data;
+    size_t pos = 0;
+    bool ok = true;
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (pos + sizeof(T) > data.size()) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        const uint32_t len = get<uint32_t>();
+        if (!ok || pos + len > data.size()) {
+            ok = false;
+            return {};
+        }
+        std::string value = data.substr(pos, len);
+        pos += len;
+        return value;
+    }
+};
+
+int64_t toNanos(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// EngineJournal
+// =============================================================================
+
+bool EngineJournal::open(const std::string& path, size_t shardCount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        LOG() << "[EngineJournal] Failed to open " << path;
+        out_ = nullptr;
+        return false;
+    }
+    out_ = &file_;
+    writeHeader(shardCount);
+    LOG() << "[EngineJournal] Recording engine input to " << path;
+    return true;
+}
+
+void EngineJournal::attach(std::ostream& out, size_t shardCount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ = &out;
+    writeHeader(shardCount);
+}
+
+void EngineJournal::writeHeader(size_t shardCount) {
+    records_ = 0;
+    std::string header(kMagic, sizeof(kMagic));
+    put<uint32_t>(header, kVersion);
+    put<uint32_t>(header, static_cast<uint32_t>(shardCount));
+    put<uint32_t>(header, static_cast<uint32_t>(sizeof(MarketData)));
+    out_->write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+void EngineJournal::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (out_) {
+        out_->flush();
+    }
+}
+
+void EngineJournal::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (out_) {
+        out_->flush();
+    }
+    if (file_.is_open()) {
+        file_.close();
+    }
+    out_ = nullptr;
+}
+
+uint64_t EngineJournal::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+void EngineJournal::recordMarketData(size_t shard, std::chrono::system_clock::time_point time,
+                                     const MarketData& md) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_) return;
+    scratch_.clear();
+    scratch_.append(reinterpret_cast<const char*>(&md), sizeof(MarketData));
+    writeRecord(JournalRecordKind::MARKET_DATA, shard, time);
+}
+
+void EngineJournal::recordOrderEvent(size_t shard, std::chrono::system_clock::time_point time,
+                                     const OrderEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_) return;
+    scratch_.clear();
+    put<uint8_t>(scratch_, static_cast<uint8_t>(event.type));
+    putString(scratch_, event.sessionID.senderCompID);
+    putString(scratch_, event.sessionID.targetCompID);
+    putString(scratch_, event.userId);
+    if (const Order* order = event.getOrder()) {
+        putString(scratch_, order->clOrdID);
+        putString(scratch_, order->symbol);
+        put<uint8_t>(scratch_, static_cast<uint8_t>(order->side));
+        put<uint8_t>(scratch_, static_cast<uint8_t>(order->ordType));
+        put<uint8_t>(scratch_, static_cast<uint8_t>(order->timeInForce));
+        put<int64_t>(scratch_, order->orderQty);
+        put<double>(scratch_, order->price);
+    } else if (const CancelRequest* req = event.getCancelRequest()) {
+        putString(scratch_, req->clOrdID);
+        putString(scratch_, req->origClOrdID);
+        putString(scratch_, req->symbol);
+    }
+    writeRecord(JournalRecordKind::ORDER_EVENT, shard, time);
+}
+
+void EngineJournal::recordExecutionReport(size_t shard, std::chrono::system_clock::time_point time,
+                                          const SessionID& sessionID, const ExecutionReport& report) {
+    // 消息体在锁外序列化
+    const std::string body = FixCodec().encode_body(buildExecutionReport(report)).bytes;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_) return;
+    scratch_.clear();
+    putString(scratch_, sessionID.senderCompID);
+    putString(scratch_, sessionID.targetCompID);
+    putString(scratch_, body);
+    writeRecord(JournalRecordKind::EXECUTION_REPORT, shard, time);
+}
+
+void EngineJournal::writeRecord(JournalRecordKind kind, size_t shard, std::chrono::system_clock::time_point time) {
+    char header[kRecordHeaderSize];
+    const uint8_t kindByte = static_cast<uint8_t>(kind);
+    const uint8_t reserved = 0;
+    const uint16_t shardIndex = static_cast<uint16_t>(shard);
+    const uint32_t length = static_cast<uint32_t>(scratch_.size());
+    const int64_t nanos = toNanos(time);
+    std::memcpy(header, &kindByte, 1);
+    std::memcpy(header + 1, &reserved, 1);
+    std::memcpy(header + 2, &shardIndex, 2);
+    std::memcpy(header + 4, &length, 4);
+    std::memcpy(header + 8, &nanos, 8);
+    out_->write(header, sizeof(header));
+    out_->write(scratch_.data(), static_cast<std::streamsize>(scratch_.size()));
+    ++records_;
+}
+
+// =============================================================================
+// EngineJournalReader
+// =============================================================================
+
+bool EngineJournalReader::open(const std::string& path) {
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        error_ = "cannot open " + path;
+        return false;
+    }
+    in_ = &file_;
+    return readHeader();
+}
+
+bool EngineJournalReader::attach(std::istream& in) {
+    in_ = &in;
+    return readHeader();
+}
+
+bool EngineJournalReader::readHeader() {
+    char magic[sizeof(EngineJournal::kMagic)];
+    uint32_t fields[3] = {0, 0, 0};
+    in_->read(magic, sizeof(magic));
+    in_->read(reinterpret_cast<char*>(fields), sizeof(fields));
+    if (!*in_ || std::memcmp(magic, EngineJournal::kMagic, sizeof(magic)) != 0) {
+        error_ = "not an engine journal";
+        return false;
+    }
+    if (fields[0] != EngineJournal::kVersion) {
+        error_ = "unsupported journal version " + std::to_string(fields[0]);
+        return false;
+    }
+    if (fields[2] != sizeof(MarketData)) {
+        error_ = "MarketData layout mismatch (recorded " + std::to_string(fields[2]) + " bytes)";
+        return false;
+    }
+    shardCount_ = fields[1];
+    error_.clear();
+    return true;
+}
+
+bool EngineJournalReader::next(JournalRecord& record) {
+    if (!in_) return false;
+
+    char header[kRecordHeaderSize];
+    in_->read(header, sizeof(header));
+    if (in_->gcount() == 0) {
+        return false;  // 正常结束
+    }
+    if (in_->gcount() != static_cast<std::streamsize>(sizeof(header))) {
+        error_ = "truncated record header";
+        return false;
+    }
+
+    uint8_t kind = 0;
+    uint32_t length = 0;
+    std::memcpy(&kind, header, 1);
+    std::memcpy(&record.shard, header + 2, 2);
+    std::memcpy(&length, header + 4, 4);
+    std::memcpy(&record.timestampNs, header + 8, 8);
+    if (length > kMaxPayload) {
+        error_ = "record payload too large";
+        return false;
+    }
+
+    payload_.resize(length);
+    in_->read(payload_.data(), length);
+    if (in_->gcount() != static_cast<std::streamsize>(length)) {
+        error_ = "truncated record payload";
+        return false;
+    }
+
+    Cursor cursor{payload_};
+    switch (static_cast<JournalRecordKind>(kind)) {
+        case JournalRecordKind::MARKET_DATA:
+            if (length != sizeof(MarketData)) {
+                error_ = "bad market data record";
+                return false;
+            }
+            record.kind = JournalRecordKind::MARKET_DATA;
+            std::memcpy(&record.marketData, payload_.data(), sizeof(MarketData));
+            return true;
+
+        case JournalRecordKind::ORDER_EVENT: {
+            record.kind = JournalRecordKind::ORDER_EVENT;
+            OrderEvent event;
+            event.type = static_cast<OrderEventType>(cursor.get<uint8_t>());
+            event.sessionID.senderCompID = cursor.getString();
+            event.sessionID.targetCompID = cursor.getString();
+            event.userId = cursor.getString();
+            if (event.type == OrderEventType::NEW_ORDER) {
+                Order order;
+                order.clOrdID = cursor.getString();
+                order.symbol = cursor.getString();
+                order.side = static_cast<OrderSide>(cursor.get<uint8_t>());
+                order.ordType = static_cast<OrderType>(cursor.get<uint8_t>());
+                order.timeInForce = static_cast<TimeInForce>(cursor.get<uint8_t>());
+                order.orderQty = cursor.get<int64_t>();
+                order.price = cursor.get<double>();
+                order.leavesQty = order.orderQty;
+                order.sessionID = event.sessionID;
+                event.data = std::move(order);
+            } else if (event.type == OrderEventType::CANCEL_REQUEST) {
+                CancelRequest req;
+                req.clOrdID = cursor.getString();
+                req.origClOrdID = cursor.getString();
+                req.symbol = cursor.getString();
+                req.sessionID = event.sessionID;
+                event.data = std::move(req);
+            }
+            if (!cursor.ok) {
+                error_ = "bad order event record";
+                return false;
+            }
+            record.event = std::move(event);
+            return true;
+        }
+
+        case JournalRecordKind::EXECUTION_REPORT:
+            record.kind = JournalRecordKind::EXECUTION_REPORT;
+            record.sessionID.senderCompID = cursor.getString();
+            record.sessionID.targetCompID = cursor.getString();
+            record.reportBody = cursor.getString();
+            if (!cursor.ok) {
+                error_ = "bad execution report record";
+                return false;
+            }
+            return true;
+    }
+
+    error_ = "unknown record kind " + std::to_string(kind);
+    return false;
+}
+
+} // namespace fix40
@@ -6,12 +6,14 @@
  */
 
 #include "app/engine/matching_engine.hpp"
+#include "app/engine/engine_journal.hpp"
 #include "app/manager/risk_manager.hpp"
 #include "app/manager/instrument_manager.hpp"
 #include "base/logger.hpp"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <limits>
 
 namespace fix40 {
 
@@ -35,6 +37,86 @@ const char* tifToString(TimeInForce tif) {
     }
 }
 
+/// 有效价格（非 0、非 DBL_MAX）
+bool validPrice(double price) {
+    return price > 0 && price < std::numeric_limits<double>::max();
+}
+
+/**
+ * @brief 将较新的一笔行情合并进 into
+ *
+ * 结果以 next 为准；最高/最低价取两者见到的极值（含各自最新价），
+ * 累计成交量/成交额取较大值，避免合并丢失区间内的高低点。
+ */
+void mergeTick(MarketData& into, const MarketData& next) {
+    double high = 0.0;
+    double low = 0.0;
+    for (double price : {into.highestPrice, into.lowestPrice, into.lastPrice,
+                         next.highestPrice, next.lowestPrice, next.lastPrice}) {
+        if (!validPrice(price)) continue;
+        high = std::max(high, price);
+        low = (low == 0.0) ? price : std::min(low, price);
+    }
+
+    const int64_t volume = std::max(into.volume, next.volume);
+    const double turnover = std::max(into.turnover, next.turnover);
+
+    into = next;
+    into.highestPrice = high;
+    into.lowestPrice = low;
+    into.volume = volume;
+    into.turnover = turnover;
+}
+
+/// 买单成交条件：买价 >= 卖一价（市价单只要有卖盘）
+bool canMatchBuy(OrderType ordType, double price, const MarketDataSnapshot& snapshot) {
+    if (!snapshot.hasAsk()) {
+        return false;
+    }
+    return ordType == OrderType::MARKET || price >= snapshot.askPrice1;
+}
+
+/// 卖单成交条件：卖价 <= 买一价（市价单只要有买盘）
+bool canMatchSell(OrderType ordType, double price, const MarketDataSnapshot& snapshot) {
+    if (!snapshot.hasBid()) {
+        return false;
+    }
+    return ordType == OrderType::MARKET || price <= snapshot.bidPrice1;
+}
+
+/// 用行情五档刷新快照深度，并清零上一笔行情内的消耗量
+void loadDepth(MarketDataSnapshot& snapshot, const MarketData& md) {
+    using Level = MarketDataSnapshot::DepthLevel;
+    snapshot.bidDepth = {{Level{md.bidPrice1, md.bidVolume1, 0}, Level{md.bidPrice2, md.bidVolume2, 0},
+                          Level{md.bidPrice3, md.bidVolume3, 0}, Level{md.bidPrice4, md.bidVolume4, 0},
+                          Level{md.bidPrice5, md.bidVolume5, 0}}};
+    snapshot.askDepth = {{Level{md.askPrice1, md.askVolume1, 0}, Level{md.askPrice2, md.askVolume2, 0},
+                          Level{md.askPrice3, md.askVolume3, 0}, Level{md.askPrice4, md.askVolume4, 0},
+                          Level{md.askPrice5, md.askVolume5, 0}}};
+}
+
+/// 订单能否与对手方某一档成交（该档为空即视为盘口到此为止）
+bool crossesLevel(const EngineOrder& order, const MarketDataSnapshot::DepthLevel& level) {
+    if (level.price <= 0 || level.volume <= 0) {
+        return false;
+    }
+    if (order.getOrdType() == OrderType::MARKET) {
+        return true;
+    }
+    return order.getSide() == OrderSide::BUY ? order.price >= level.price : order.price <= level.price;
+}
+
+/// 订单当前可从对手方五档吃到的总量（扣除本笔行情内已消耗部分）
+int64_t availableDepth(const EngineOrder& order, const MarketDataSnapshot& snapshot) {
+    const auto& depth = order.getSide() == OrderSide::BUY ? snapshot.askDepth : snapshot.bidDepth;
+    int64_t total = 0;
+    for (const auto& level : depth) {
+        if (!crossesLevel(order, level)) break;
+        total += level.available();
+    }
+    return total;
+}
+
 } // anonymous namespace
 
 // =============================================================================
@@ -45,6 +127,7 @@ ExecutionReport buildRejectReport(const Order& order, RejectReason reason, const
     ExecutionReport report;
     report.orderID = order.orderID;
     report.clOrdID = order.clOrdID;
+    report.orderRef = order.orderRef;
     report.execID = "";  // 调用方需要设置
     report.symbol = order.symbol;
     report.side = order.side;
@@ -59,7 +142,17 @@ ExecutionReport buildRejectReport(const Order& order, RejectReason reason, const
     return report;
 }
 
-MatchingEngine::MatchingEngine() = default;
+MatchingEngine::MatchingEngine(size_t shardCount) {
+    if (shardCount == 0) {
+        shardCount = 1;
+    }
+    shards_.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        shards_.push_back(std::move(shard));
+    }
+}
 
 MatchingEngine::~MatchingEngine() {
     stop();
@@ -69,9 +162,24 @@ void MatchingEngine::start() {
     if (running_.exchange(true)) {
         return;  // 已经在运行
     }
+
+    // 按已登记的合约预分配快照槽位（线程尚未启动，此时重建不会与读写并发）
+    if (instrumentManager_) {
+        const auto instrumentIds = instrumentManager_->getAllInstrumentIds();
+        const size_t needed = instrumentIds.size() + kSpareSnapshotSlots;
+        if (publishedSnapshots_.capacity() < needed) {
+            publishedSnapshots_.reset(needed);
+        }
+        for (const auto& id : instrumentIds) {
+            publishedSnapshots_.reserve(id);
+        }
+    }
     
-    worker_thread_ = std::thread([this]() { run(); });
-    LOG() << "[MatchingEngine] Started";
+    for (auto& shard : shards_) {
+        Shard* s = shard.get();
+        s->thread = std::thread([this, s]() { run(*s); });
+    }
+    LOG() << "[MatchingEngine] Started with " << shards_.size() << " shard(s)";
 }
 
 void MatchingEngine::stop() {
@@ -79,68 +187,212 @@ void MatchingEngine::stop() {
         return;  // 已经停止
     }
     
-    // 提交一个空事件唤醒阻塞的 wait_dequeue
-    event_queue_.enqueue(OrderEvent{});
-    
-    if (worker_thread_.joinable()) {
-        worker_thread_.join();
+    // 唤醒阻塞在信号上的分片线程
+    for (auto& shard : shards_) {
+        shard->wakeup.signal();
+    }
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
     }
     
     LOG() << "[MatchingEngine] Stopped";
 }
 
+void MatchingEngine::pinInstrument(const std::string& symbol, size_t shardIndex) {
+    if (running_.load()) {
+        LOG() << "[MatchingEngine] pinInstrument ignored while running: " << symbol;
+        return;
+    }
+    pinnedShards_[symbol] = shardIndex % shards_.size();
+}
+
+size_t MatchingEngine::shardFor(const std::string& symbol) const {
+    if (shards_.size() == 1) {
+        return 0;
+    }
+    auto it = pinnedShards_.find(symbol);
+    if (it != pinnedShards_.end()) {
+        return it->second;
+    }
+    return std::hash<std::string>()(symbol) % shards_.size();
+}
+
 void MatchingEngine::submit(const OrderEvent& event) {
-    event_queue_.enqueue(event);
+    submit(OrderEvent(event));
 }
 
 void MatchingEngine::submit(OrderEvent&& event) {
-    event_queue_.enqueue(std::move(event));
+    // 订单与撤单按合约路由到所属分片，同一订单的所有事件在同一线程内串行处理，
+    // 因此其 ExecutionReport 回调保持有序；会话事件广播到全部分片。
+    std::string symbol;
+    if (const Order* order = event.getOrder()) {
+        symbol = order->symbol;
+    } else if (const CancelRequest* req = event.getCancelRequest()) {
+        symbol = req->symbol;
+    } else {
+        for (size_t i = 0; i + 1 < shards_.size(); ++i) {
+            shards_[i]->eventQueue.enqueue(event);
+            shards_[i]->wakeup.signal();
+        }
+        shards_.back()->eventQueue.enqueue(std::move(event));
+        shards_.back()->wakeup.signal();
+        return;
+    }
+    Shard& shard = *shards_[shardFor(symbol)];
+    shard.eventQueue.enqueue(std::move(event));
+    shard.wakeup.signal();
 }
 
-void MatchingEngine::run() {
+void MatchingEngine::run(Shard& shard) {
+    std::vector<MarketData> ticks(kMaxBatch);
+    std::vector<OrderEvent> events(kMaxBatch);
+
     while (running_.load()) {
-        // 先处理行情数据
-        MarketData md;
-        while (marketDataQueue_.try_dequeue(md)) {
-            if (!running_.load()) break;
-            try {
-                handleMarketData(md);
-            } catch (const std::exception& e) {
-                LOG() << "[MatchingEngine] Exception processing market data: " << e.what();
-            } catch (...) {
-                LOG() << "[MatchingEngine] Unknown exception processing market data";
+        // 阻塞直到任一队列有数据（或 stop 唤醒），一次领取多个计数
+        auto pending = shard.wakeup.waitMany(static_cast<std::ptrdiff_t>(2 * kMaxBatch));
+
+        // 领取的每个计数都对应一条已入队的数据，取满为止；
+        // 每轮先行情后订单，使订单看到最新行情，同时限制单类批量保证公平
+        while (pending > 0 && running_.load()) {
+            const size_t tickCount = shard.marketDataQueue.try_dequeue_bulk(
+                ticks.begin(), std::min<size_t>(static_cast<size_t>(pending), kMaxBatch));
+            pending -= static_cast<std::ptrdiff_t>(tickCount);
+            if (conflationThreshold_ > 0 && tickCount > 0 &&
+                shard.marketDataQueue.size_approx() + tickCount >= conflationThreshold_) {
+                conflateAndDispatch(shard, ticks, tickCount, pending);
+            } else {
+                for (size_t i = 0; i < tickCount; ++i) {
+                    dispatchMarketData(shard, ticks[i], std::chrono::system_clock::now());
+                }
             }
+
+            const size_t eventCount = shard.eventQueue.try_dequeue_bulk(
+                events.begin(), std::min<size_t>(static_cast<size_t>(pending), kMaxBatch));
+            for (size_t i = 0; i < eventCount; ++i) {
+                dispatchEvent(shard, events[i], std::chrono::system_clock::now());
+            }
+            pending -= static_cast<std::ptrdiff_t>(eventCount);
         }
+    }
+}
 
-        // 处理订单事件
-        OrderEvent event;
-        if (event_queue_.wait_dequeue_timed(event, std::chrono::milliseconds(10))) {
-            if (!running_.load()) break;
-            
-            try {
-                process_event(event);
-            } catch (const std::exception& e) {
-                LOG() << "[MatchingEngine] Exception processing event: " << e.what();
-            } catch (...) {
-                LOG() << "[MatchingEngine] Unknown exception processing event";
+void MatchingEngine::conflateAndDispatch(Shard& shard, std::vector<MarketData>& ticks, size_t tickCount,
+                                         std::ptrdiff_t& pending) {
+    auto& merged = shard.conflationBuffer;
+    auto& index = shard.conflationIndex;
+    merged.clear();
+    index.clear();
+
+    auto absorb = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            auto [it, inserted] = index.try_emplace(ticks[i].getInstrumentID(), merged.size());
+            if (inserted) {
+                merged.push_back(ticks[i]);
+            } else {
+                mergeTick(merged[it->second], ticks[i]);
             }
         }
+    };
+
+    size_t absorbed = tickCount;
+    absorb(tickCount);
+    // 继续取出积压，单次合并量以阈值为上限，之后让出给订单事件
+    while (absorbed < conflationThreshold_) {
+        const size_t count = shard.marketDataQueue.try_dequeue_bulk(
+            ticks.begin(), std::min(kMaxBatch, conflationThreshold_ - absorbed));
+        if (count == 0) break;
+        absorb(count);
+        absorbed += count;
+        pending -= static_cast<std::ptrdiff_t>(count);
+    }
+    // 超出已领计数取出的行情，其计数在入队后必然到达，补领以保持计数与数据一致
+    while (pending < 0) {
+        pending += shard.wakeup.waitMany(-pending);
+    }
+
+    const uint64_t conflated = absorbed - merged.size();
+    shard.conflatedTicks.fetch_add(conflated, std::memory_order_relaxed);
+    if (conflated > 0) {
+        LOG() << "[MatchingEngine] Shard " << shard.index << " conflated " << absorbed
+              << " ticks into " << merged.size() << " (backlog)";
+    }
+
+    for (const auto& md : merged) {
+        dispatchMarketData(shard, md, std::chrono::system_clock::now());
+    }
+}
+
+void MatchingEngine::replay(const JournalRecord& record) {
+    if (running_.load()) {
+        LOG() << "[MatchingEngine] replay ignored while running";
+        return;
+    }
+    Shard& shard = *shards_[record.shard % shards_.size()];
+    switch (record.kind) {
+        case JournalRecordKind::MARKET_DATA:
+            dispatchMarketData(shard, record.marketData, record.time());
+            break;
+        case JournalRecordKind::ORDER_EVENT:
+            dispatchEvent(shard, record.event, record.time());
+            break;
+        case JournalRecordKind::EXECUTION_REPORT:
+            break;
+    }
+}
+
+uint64_t MatchingEngine::getConflatedTickCount() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->conflatedTicks.load(std::memory_order_relaxed);
     }
+    return total;
 }
 
-void MatchingEngine::process_event(const OrderEvent& event) {
+void MatchingEngine::dispatchMarketData(Shard& shard, const MarketData& md,
+                                        std::chrono::system_clock::time_point now) {
+    shard.now = now;
+    if (journal_) {
+        journal_->recordMarketData(shard.index, now, md);
+    }
+    try {
+        handleMarketData(shard, md);
+    } catch (const std::exception& e) {
+        LOG() << "[MatchingEngine] Exception processing market data: " << e.what();
+    } catch (...) {
+        LOG() << "[MatchingEngine] Unknown exception processing market data";
+    }
+}
+
+void MatchingEngine::dispatchEvent(Shard& shard, const OrderEvent& event,
+                                   std::chrono::system_clock::time_point now) {
+    shard.now = now;
+    if (journal_) {
+        journal_->recordOrderEvent(shard.index, now, event);
+    }
+    try {
+        process_event(shard, event);
+    } catch (const std::exception& e) {
+        LOG() << "[MatchingEngine] Exception processing event: " << e.what();
+    } catch (...) {
+        LOG() << "[MatchingEngine] Unknown exception processing event";
+    }
+}
+
+void MatchingEngine::process_event(Shard& shard, const OrderEvent& event) {
     switch (event.type) {
         case OrderEventType::NEW_ORDER:
-            handle_new_order(event);
+            handle_new_order(shard, event);
             break;
         case OrderEventType::CANCEL_REQUEST:
-            handle_cancel_request(event);
+            handle_cancel_request(shard, event);
             break;
         case OrderEventType::SESSION_LOGON:
-            handle_session_logon(event);
+            handle_session_logon(shard, event);
             break;
         case OrderEventType::SESSION_LOGOUT:
-            handle_session_logout(event);
+            handle_session_logout(shard, event);
             break;
         default:
             LOG() << "[MatchingEngine] Unknown event type";
@@ -148,7 +400,7 @@ void MatchingEngine::process_event(const OrderEvent& event) {
     }
 }
 
-void MatchingEngine::handle_new_order(const OrderEvent& event) {
+void MatchingEngine::handle_new_order(Shard& shard, const OrderEvent& event) {
     const Order* orderPtr = event.getOrder();
     if (!orderPtr) {
         LOG() << "[MatchingEngine] Invalid NEW_ORDER event: no order data";
@@ -157,7 +409,8 @@ void MatchingEngine::handle_new_order(const OrderEvent& event) {
     
     // 复制订单
     Order order = *orderPtr;
-    order.orderID = generateOrderID();
+    const uint64_t orderSeq = nextOrderSeq();
+    order.orderID = formatOrderID(orderSeq);
     order.leavesQty = order.orderQty;
     order.status = OrderStatus::PENDING_NEW;
     
@@ -177,92 +430,91 @@ void MatchingEngine::handle_new_order(const OrderEvent& event) {
         order.status = OrderStatus::REJECTED;
         auto report = buildRejectReport(order, RejectReason::NONE, "Invalid user identity");
         report.execID = generateExecID();
-        sendExecutionReport(event.sessionID, report);
+        report.transactTime = shard.now;
+        sendExecutionReport(shard, event.sessionID, report);
+        releaseOrder(shard, order.orderRef);
         return;
     }
 
-    // 记录订单与会话的映射
-    orderSessionMap_[order.clOrdID] = event.sessionID;
-    // 记录订单与用户ID的映射（用于日志/追踪；资金与持仓更新由上层处理）
-    orderUserMap_[order.clOrdID] = event.userId;
-    
-    // 获取行情快照
-    auto snapshotIt = marketSnapshots_.find(order.symbol);
-    MarketDataSnapshot snapshot;
-    if (snapshotIt != marketSnapshots_.end()) {
-        snapshot = snapshotIt->second;
-    } else {
-        snapshot.instrumentId = order.symbol;
+    // 订单状态槽位：上层已分配时沿用，否则由引擎分配（回报路由用其中的会话）；
+    // 回报回调也会释放终态订单时，持有者为引擎 + 回调
+    if (order.orderRef == kNoOrderRef) {
+        const uint8_t holders = callbackReleasesOrders_ ? 2 : 1;
+        order.orderRef = orderTable_.allocate(order.clOrdID, event.userId, order.symbol, event.sessionID, holders);
+        if (order.orderRef == kNoOrderRef) {
+            LOG() << "[MatchingEngine] Order rejected: order table full";
+            order.status = OrderStatus::REJECTED;
+            auto report = buildRejectReport(order, RejectReason::NONE, "Order table full");
+            report.execID = generateExecID();
+            report.transactTime = shard.now;
+            sendExecutionReport(shard, event.sessionID, report);
+            return;
+        }
     }
     
-    // 尝试立即撮合
-    bool matched = false;
-    double fillPrice = 0.0;
+    // 获取行情快照：引用分片内的快照，逐档消耗量在同一笔行情内的后续订单间共享
+    MarketDataSnapshot emptySnapshot(order.symbol);
+    auto snapshotIt = shard.marketSnapshots.find(order.symbol);
+    MarketDataSnapshot& snapshot =
+        snapshotIt != shard.marketSnapshots.end() ? snapshotIt->second : emptySnapshot;
     
+    // 引擎内部记录：后续撮合与挂单都基于紧凑记录进行
+    EngineOrder record = EngineOrder::fromOrder(order, shard.symbols.intern(order.symbol), orderSeq);
+
     if (order.ordType == OrderType::MARKET) {
-        // 市价单处理
-        if (order.side == OrderSide::BUY) {
-            if (snapshot.hasAsk()) {
-                matched = true;
-                fillPrice = snapshot.askPrice1;
-            } else {
-                // 无对手盘，拒绝市价单
-                LOG() << "[MatchingEngine] Market order rejected: no ask side";
-                order.status = OrderStatus::REJECTED;
-                
-                auto report = buildRejectReport(order, RejectReason::NO_COUNTER_PARTY, "No counter party (ask side empty)");
-                report.execID = generateExecID();
-                
-                sendExecutionReport(event.sessionID, report);
-                orderSessionMap_.erase(order.clOrdID); orderUserMap_.erase(order.clOrdID);
-                return;
-            }
-        } else {
-            if (snapshot.hasBid()) {
-                matched = true;
-                fillPrice = snapshot.bidPrice1;
-            } else {
-                // 无对手盘，拒绝市价单
-                LOG() << "[MatchingEngine] Market order rejected: no bid side";
-                order.status = OrderStatus::REJECTED;
-                
-                auto report = buildRejectReport(order, RejectReason::NO_COUNTER_PARTY, "No counter party (bid side empty)");
-                report.execID = generateExecID();
-                
-                sendExecutionReport(event.sessionID, report);
-                orderSessionMap_.erase(order.clOrdID); orderUserMap_.erase(order.clOrdID);
-                return;
-            }
-        }
-    } else {
-        // 限价单处理
-        if (order.side == OrderSide::BUY) {
-            if (canMatchBuyOrder(order, snapshot)) {
-                matched = true;
-                fillPrice = snapshot.askPrice1;
-            }
-        } else {
-            if (canMatchSellOrder(order, snapshot)) {
-                matched = true;
-                fillPrice = snapshot.bidPrice1;
-            }
+        // 市价单：无对手盘直接拒绝
+        const bool hasCounterParty = order.side == OrderSide::BUY ? snapshot.hasAsk() : snapshot.hasBid();
+        if (!hasCounterParty) {
+            const bool isBuy = order.side == OrderSide::BUY;
+            LOG() << "[MatchingEngine] Market order rejected: no " << (isBuy ? "ask" : "bid") << " side";
+            order.status = OrderStatus::REJECTED;
+            
+            auto report = buildRejectReport(order, RejectReason::NO_COUNTER_PARTY,
+                                            isBuy ? "No counter party (ask side empty)"
+                                                  : "No counter party (bid side empty)");
+            report.execID = generateExecID();
+            report.transactTime = shard.now;
+            
+            sendExecutionReport(shard, event.sessionID, report);
+            releaseOrder(shard, order.orderRef);
+            return;
         }
     }
-    
-    if (matched) {
-        // 立即成交
-        order.status = OrderStatus::NEW;  // 先设为NEW，executeFill会更新为FILLED
-        executeFill(order, fillPrice, order.orderQty);
-        orderSessionMap_.erase(order.clOrdID); orderUserMap_.erase(order.clOrdID);
-    } else {
+
+    record.setStatus(OrderStatus::NEW);
+
+    // FOK：五档剩余量不足以全部成交时整单撤销，不产生任何成交
+    if (order.timeInForce == TimeInForce::FOK && availableDepth(record, snapshot) < record.orderQty) {
+        expireRemainder(shard, record, event.sessionID, "FOK order cannot be fully filled");
+        releaseOrder(shard, order.orderRef);
+        return;
+    }
+
+    // 逐档吃单，每档最多成交其剩余挂单量
+    const int64_t filled = fillFromDepth(shard, record, snapshot);
+    if (record.leavesQty() == 0) {
+        releaseOrder(shard, order.orderRef);
+        return;
+    }
+
+    // 市价单、IOC/FAK 的剩余部分不挂单，直接撤销
+    if (order.ordType == OrderType::MARKET || order.timeInForce == TimeInForce::IOC ||
+        order.timeInForce == TimeInForce::FOK) {
+        expireRemainder(shard, record, event.sessionID, "Remaining quantity canceled");
+        releaseOrder(shard, order.orderRef);
+        return;
+    }
+
+    if (filled == 0) {
         // 挂单等待
         order.status = OrderStatus::NEW;
-        order.updateTime = std::chrono::system_clock::now();
+        order.updateTime = shard.now;
         
         // 发送订单确认
         ExecutionReport report;
         report.orderID = order.orderID;
         report.clOrdID = order.clOrdID;
+        report.orderRef = order.orderRef;
         report.execID = generateExecID();
         report.symbol = order.symbol;
         report.side = order.side;
@@ -277,14 +529,14 @@ void MatchingEngine::handle_new_order(const OrderEvent& event) {
         report.execTransType = ExecTransType::NEW;
         
         LOG() << "[MatchingEngine] Order " << order.clOrdID << " acknowledged, pending for market data";
-        sendExecutionReport(event.sessionID, report);
-        
-        // 添加到挂单列表
-        addToPendingOrders(order);
+        sendExecutionReport(shard, event.sessionID, report);
     }
+
+    // 剩余部分挂单（部分成交的回报已同时起到确认作用）
+    addToPendingOrders(shard, record);
 }
 
-void MatchingEngine::handle_cancel_request(const OrderEvent& event) {
+void MatchingEngine::handle_cancel_request(Shard& shard, const OrderEvent& event) {
     const CancelRequest* req = event.getCancelRequest();
     if (!req) {
         LOG() << "[MatchingEngine] Invalid CANCEL_REQUEST event: no request data";
@@ -301,22 +553,15 @@ void MatchingEngine::handle_cancel_request(const OrderEvent& event) {
     report.origClOrdID = req->origClOrdID;
     report.execID = generateExecID();
     report.symbol = req->symbol;
-    report.transactTime = std::chrono::system_clock::now();
-    
-    // 首先尝试从挂单列表中撤单（行情驱动模式）
-    auto canceledOrder = removeFromPendingOrders(req->symbol, req->origClOrdID);
+    report.transactTime = shard.now;
     
-    if (!canceledOrder) {
-        // 如果挂单列表中没有，尝试从传统订单簿中撤单（兼容模式）
-        auto bookIt = orderBooks_.find(req->symbol);
-        if (bookIt != orderBooks_.end()) {
-            canceledOrder = bookIt->second->cancelOrder(req->origClOrdID);
-        }
-    }
+    // 从本分片的挂单簿中撤单
+    auto canceledOrder = removeFromPendingOrders(shard, *req, event.userId);
     
     if (canceledOrder) {
         // 撤单成功
         report.orderID = canceledOrder->orderID;
+        report.orderRef = canceledOrder->orderRef;
         report.side = canceledOrder->side;
         report.orderQty = canceledOrder->orderQty;
         report.price = canceledOrder->price;
@@ -328,9 +573,6 @@ void MatchingEngine::handle_cancel_request(const OrderEvent& event) {
         report.execTransType = ExecTransType::NEW;  // FIX 4.0: NEW + CANCELED status
         
         LOG() << "[MatchingEngine] Order " << req->origClOrdID << " canceled";
-        
-        // 清理映射
-        orderSessionMap_.erase(req->origClOrdID); orderUserMap_.erase(req->origClOrdID);
     } else {
         // 撤单失败（订单不存在或已成交）
         report.ordStatus = OrderStatus::REJECTED;
@@ -340,41 +582,30 @@ void MatchingEngine::handle_cancel_request(const OrderEvent& event) {
         LOG() << "[MatchingEngine] Cancel rejected: order " << req->origClOrdID << " not found";
     }
     
-    sendExecutionReport(event.sessionID, report);
+    sendExecutionReport(shard, event.sessionID, report);
+    if (canceledOrder) {
+        releaseOrder(shard, canceledOrder->orderRef);
+    }
 }
 
-void MatchingEngine::handle_session_logon(const OrderEvent& event) {
-    LOG() << "[MatchingEngine] Session logged on: " << event.sessionID.to_string();
+void MatchingEngine::handle_session_logon(Shard& shard, const OrderEvent& event) {
+    LOG() << "[MatchingEngine] Session logged on: " << event.sessionID.to_string()
+          << " (shard " << shard.index << ")";
     // 会话登录时可以初始化交易状态
 }
 
-void MatchingEngine::handle_session_logout(const OrderEvent& event) {
-    LOG() << "[MatchingEngine] Session logged out: " << event.sessionID.to_string();
+void MatchingEngine::handle_session_logout(Shard& shard, const OrderEvent& event) {
+    LOG() << "[MatchingEngine] Session logged out: " << event.sessionID.to_string()
+          << " (shard " << shard.index << ")";
     
     // 清理该会话的订单映射（可选：也可以保留用于重连恢复）
     // 这里简单处理，不主动撤单
 }
 
-OrderBook& MatchingEngine::getOrCreateOrderBook(const std::string& symbol) {
-    auto it = orderBooks_.find(symbol);
-    if (it == orderBooks_.end()) {
-        auto [newIt, inserted] = orderBooks_.emplace(
-            symbol, std::make_unique<OrderBook>(symbol));
-        LOG() << "[MatchingEngine] Created OrderBook for " << symbol;
-        return *newIt->second;
-    }
-    return *it->second;
-}
-
-const OrderBook* MatchingEngine::getOrderBook(const std::string& symbol) const {
-    auto it = orderBooks_.find(symbol);
-    if (it != orderBooks_.end()) {
-        return it->second.get();
+void MatchingEngine::sendExecutionReport(Shard& shard, const SessionID& sessionID, const ExecutionReport& report) {
+    if (journal_) {
+        journal_->recordExecutionReport(shard.index, shard.now, sessionID, report);
     }
-    return nullptr;
-}
-
-void MatchingEngine::sendExecutionReport(const SessionID& sessionID, const ExecutionReport& report) {
     if (execReportCallback_) {
         try {
             execReportCallback_(sessionID, report);
@@ -390,14 +621,13 @@ void MatchingEngine::sendExecutionReport(const SessionID& sessionID, const Execu
 
 std::string MatchingEngine::generateExecID() {
     std::ostringstream oss;
-    oss << "EXEC-" << std::setfill('0') << std::setw(10) << nextExecID_++;
+    oss << "EXEC-" << std::setfill('0') << std::setw(10)
+        << nextExecID_.fetch_add(1, std::memory_order_relaxed);
     return oss.str();
 }
 
-std::string MatchingEngine::generateOrderID() {
-    std::ostringstream oss;
-    oss << "ORD-" << std::setfill('0') << std::setw(10) << nextOrderID_++;
-    return oss.str();
+uint64_t MatchingEngine::nextOrderSeq() {
+    return nextOrderID_.fetch_add(1, std::memory_order_relaxed);
 }
 
 // =============================================================================
@@ -405,20 +635,23 @@ std::string MatchingEngine::generateOrderID() {
 // =============================================================================
 
 void MatchingEngine::submitMarketData(const MarketData& md) {
-    marketDataQueue_.enqueue(md);
+    Shard& shard = *shards_[shardFor(md.getInstrumentID())];
+    shard.marketDataQueue.enqueue(md);
+    shard.wakeup.signal();
 }
 
-const MarketDataSnapshot* MatchingEngine::getMarketSnapshot(const std::string& instrumentId) const {
-    auto it = marketSnapshots_.find(instrumentId);
-    if (it != marketSnapshots_.end()) {
-        return &it->second;
+std::optional<MarketDataSnapshot> MatchingEngine::getMarketSnapshot(const std::string& instrumentId) const {
+    MarketDataSnapshot snapshot;
+    if (!publishedSnapshots_.read(instrumentId, snapshot)) {
+        return std::nullopt;
     }
-    return nullptr;
+    return snapshot;
 }
 
-const std::list<Order>* MatchingEngine::getPendingOrders(const std::string& instrumentId) const {
-    auto it = pendingOrders_.find(instrumentId);
-    if (it != pendingOrders_.end()) {
+const PendingOrderBook* MatchingEngine::getPendingOrders(const std::string& instrumentId) const {
+    const Shard& shard = *shards_[shardFor(instrumentId)];
+    auto it = shard.pendingOrders.find(instrumentId);
+    if (it != shard.pendingOrders.end()) {
         return &it->second;
     }
     return nullptr;
@@ -426,26 +659,31 @@ const std::list<Order>* MatchingEngine::getPendingOrders(const std::string& inst
 
 size_t MatchingEngine::getTotalPendingOrderCount() const {
     size_t count = 0;
-    for (const auto& [instrumentId, orders] : pendingOrders_) {
-        count += orders.size();
+    for (const auto& shard : shards_) {
+        for (const auto& [instrumentId, orders] : shard->pendingOrders) {
+            count += orders.size();
+        }
     }
     return count;
 }
 
-void MatchingEngine::handleMarketData(const MarketData& md) {
+void MatchingEngine::handleMarketData(Shard& shard, const MarketData& md) {
     std::string instrumentId = md.getInstrumentID();
     
     // 1. 更新行情快照
-    MarketDataSnapshot& snapshot = marketSnapshots_[instrumentId];
+    MarketDataSnapshot& snapshot = shard.marketSnapshots[instrumentId];
     snapshot.instrumentId = instrumentId;
     snapshot.lastPrice = md.lastPrice;
     snapshot.bidPrice1 = md.bidPrice1;
     snapshot.bidVolume1 = md.bidVolume1;
     snapshot.askPrice1 = md.askPrice1;
     snapshot.askVolume1 = md.askVolume1;
+    loadDepth(snapshot, md);
     snapshot.upperLimitPrice = md.upperLimitPrice;
     snapshot.lowerLimitPrice = md.lowerLimitPrice;
-    snapshot.updateTime = std::chrono::system_clock::now();
+    snapshot.updateTime = shard.now;
+    // 发布给其他线程（风控等）读取；分片内撮合继续使用本地快照
+    publishedSnapshots_.publish(instrumentId, snapshot);
 
     // 2. 更新合约管理器中的涨跌停价格
     if (instrumentManager_) {
@@ -457,91 +695,108 @@ void MatchingEngine::handleMarketData(const MarketData& md) {
         marketDataUpdateCallback_(instrumentId, md.lastPrice);
     }
 
-    // 4. 遍历该合约的挂单，检查是否可成交
-    auto it = pendingOrders_.find(instrumentId);
-    if (it == pendingOrders_.end() || it->second.empty()) {
+    // 4. 只访问可成交的价格前缀：买单价格从高到低、卖单价格从低到高，
+    //    遇到第一个不可成交的价位即停止，不再逐笔扫描全部挂单
+    auto it = shard.pendingOrders.find(instrumentId);
+    if (it == shard.pendingOrders.end() || it->second.empty()) {
         return;
     }
 
-    auto& orders = it->second;
-    auto orderIt = orders.begin();
-    
-    while (orderIt != orders.end()) {
-        Order& order = *orderIt;
-        
-        // 尝试撮合
-        if (tryMatch(order, snapshot)) {
-            // 成交后移除订单
-            orderSessionMap_.erase(order.clOrdID); orderUserMap_.erase(order.clOrdID);
-            orderIt = orders.erase(orderIt);
-        } else {
-            ++orderIt;
+    auto& book = it->second;
+    auto onCross = [this, &shard, &snapshot](EngineOrder& order, bool& exhausted) {
+        if (!tryMatch(shard, order, snapshot)) {
+            // 未能全部成交说明该订单可成交的各档已被吃完；后续挂单价格不优于它，
+            // 能成交的档位只会更少，停止访问，避免深度耗尽后仍逐笔遍历可成交前缀
+            exhausted = true;
+            return false;
         }
+        // 成交后移除订单
+        releaseOrder(shard, order.orderRef);
+        return true;
+    };
+
+    if (snapshot.hasAsk()) {
+        book.matchBuys(snapshot.askPrice1, onCross);
+    }
+    if (snapshot.hasBid()) {
+        book.matchSells(snapshot.bidPrice1, onCross);
     }
 }
 
-bool MatchingEngine::tryMatch(Order& order, const MarketDataSnapshot& snapshot) {
-    bool canMatch = false;
-    double fillPrice = 0.0;
-    
-    if (order.side == OrderSide::BUY) {
-        canMatch = canMatchBuyOrder(order, snapshot);
-        if (canMatch) {
-            fillPrice = snapshot.askPrice1;  // 买单以卖一价成交
+bool MatchingEngine::tryMatch(Shard& shard, EngineOrder& order, MarketDataSnapshot& snapshot) {
+    fillFromDepth(shard, order, snapshot);
+    return order.leavesQty() == 0;
+}
+
+int64_t MatchingEngine::fillFromDepth(Shard& shard, EngineOrder& order, MarketDataSnapshot& snapshot) {
+    // 买单吃卖盘、卖单吃买盘，从一档开始逐档向外；只改写快照内的消耗量，不分配内存
+    auto& depth = order.getSide() == OrderSide::BUY ? snapshot.askDepth : snapshot.bidDepth;
+    int64_t filled = 0;
+    for (auto& level : depth) {
+        if (order.leavesQty() == 0 || !crossesLevel(order, level)) {
+            break;
         }
-    } else {
-        canMatch = canMatchSellOrder(order, snapshot);
-        if (canMatch) {
-            fillPrice = snapshot.bidPrice1;  // 卖单以买一价成交
+        const int64_t qty = std::min<int64_t>(order.leavesQty(), level.available());
+        if (qty == 0) {
+            continue;  // 该档已被本笔行情内更早的订单吃完
         }
+        level.consumed += static_cast<int32_t>(qty);
+        executeFill(shard, order, level.price, qty);
+        filled += qty;
     }
-    
-    if (canMatch) {
-        executeFill(order, fillPrice, order.leavesQty);
-        return true;
-    }
-    
-    return false;
+    return filled;
+}
+
+void MatchingEngine::expireRemainder(Shard& shard, EngineOrder& order, const SessionID& sessionID,
+                                     const char* reason) {
+    order.setStatus(OrderStatus::CANCELED);
+
+    ExecutionReport report;
+    report.orderID = formatOrderID(order.orderSeq);
+    report.clOrdID = std::string(order.clOrdID());
+    report.orderRef = order.orderRef;
+    report.execID = generateExecID();
+    report.symbol = shard.symbols.name(order.symbolId);
+    report.side = order.getSide();
+    report.orderQty = order.orderQty;
+    report.price = order.price;
+    report.ordType = order.getOrdType();
+    report.ordStatus = OrderStatus::CANCELED;
+    report.cumQty = order.cumQty;
+    report.avgPx = order.avgPx;
+    report.leavesQty = 0;
+    report.text = reason;
+    report.transactTime = shard.now;
+    report.execTransType = ExecTransType::NEW;
+
+    LOG() << "[MatchingEngine] Order " << report.clOrdID << " expired: " << reason
+          << " (cumQty=" << order.cumQty << "/" << order.orderQty << ")";
+    sendExecutionReport(shard, sessionID, report);
 }
 
 bool MatchingEngine::canMatchBuyOrder(const Order& order, const MarketDataSnapshot& snapshot) const {
-    // 买单成交条件：买价 >= CTP卖一价，且卖盘非空
-    if (!snapshot.hasAsk()) {
-        return false;
-    }
-    
-    if (order.ordType == OrderType::MARKET) {
-        // 市价单只要有卖盘就可成交
-        return true;
-    }
-    
-    // 限价单：买价 >= 卖一价
-    return order.price >= snapshot.askPrice1;
+    return canMatchBuy(order.ordType, order.price, snapshot);
 }
 
 bool MatchingEngine::canMatchSellOrder(const Order& order, const MarketDataSnapshot& snapshot) const {
-    // 卖单成交条件：卖价 <= CTP买一价，且买盘非空
-    if (!snapshot.hasBid()) {
-        return false;
-    }
-    
-    if (order.ordType == OrderType::MARKET) {
-        // 市价单只要有买盘就可成交
-        return true;
-    }
-    
-    // 限价单：卖价 <= 买一价
-    return order.price <= snapshot.bidPrice1;
+    return canMatchSell(order.ordType, order.price, snapshot);
+}
+
+bool MatchingEngine::canMatchBuyOrder(const EngineOrder& order, const MarketDataSnapshot& snapshot) const {
+    return canMatchBuy(order.getOrdType(), order.price, snapshot);
 }
 
-void MatchingEngine::executeFill(Order& order, double fillPrice, int64_t fillQty) {
+bool MatchingEngine::canMatchSellOrder(const EngineOrder& order, const MarketDataSnapshot& snapshot) const {
+    return canMatchSell(order.getOrdType(), order.price, snapshot);
+}
+
+void MatchingEngine::executeFill(Shard& shard, EngineOrder& order, double fillPrice, int64_t fillQty) {
     // 计算加权平均成交价（在更新cumQty之前计算）
     int64_t prevCumQty = order.cumQty;
     double prevAvgPx = order.avgPx;
     
     // 更新订单状态
     order.cumQty += fillQty;
-    order.leavesQty = order.orderQty - order.cumQty;
     
     // 计算加权平均成交价
     if (order.cumQty > 0) {
@@ -550,78 +805,99 @@ void MatchingEngine::executeFill(Order& order, double fillPrice, int64_t fillQty
     }
     
     // 更新订单状态
-    if (order.leavesQty == 0) {
-        order.status = OrderStatus::FILLED;
+    if (order.leavesQty() == 0) {
+        order.setStatus(OrderStatus::FILLED);
     } else {
-        order.status = OrderStatus::PARTIALLY_FILLED;
+        order.setStatus(OrderStatus::PARTIALLY_FILLED);
     }
     
-    order.updateTime = std::chrono::system_clock::now();
+    const auto updateTime = shard.now;
     
     // =========================================================================
     // 更新账户和持仓（如果设置了管理器）
     // =========================================================================
-    auto sessionIt = orderSessionMap_.find(order.clOrdID);
-    auto userIt = orderUserMap_.find(order.clOrdID);
-    std::string accountId;
-    if (userIt != orderUserMap_.end()) {
-        accountId = userIt->second;  // 使用真实的用户ID
-    }
-    
     // 注意：持仓和保证金的处理由 SimulationApp::handleFill 统一处理
     // MatchingEngine 只负责撮合，不直接操作持仓
     // 这样可以正确处理开平仓逻辑（买入平空、卖出平多）
     
-    // 发送 ExecutionReport
-    if (sessionIt != orderSessionMap_.end()) {
+    // 发送 ExecutionReport（会话取自订单状态槽位）
+    if (order.orderRef != kNoOrderRef) {
+        const std::string clOrdID(order.clOrdID());
         ExecutionReport report;
-        report.orderID = order.orderID;
-        report.clOrdID = order.clOrdID;
+        report.orderID = formatOrderID(order.orderSeq);
+        report.clOrdID = clOrdID;
+        report.orderRef = order.orderRef;
         report.execID = generateExecID();
-        report.symbol = order.symbol;
-        report.side = order.side;
+        report.symbol = shard.symbols.name(order.symbolId);
+        report.side = order.getSide();
         report.orderQty = order.orderQty;
         report.price = order.price;
-        report.ordType = order.ordType;
-        report.ordStatus = order.status;
+        report.ordType = order.getOrdType();
+        report.ordStatus = order.getStatus();
         report.cumQty = order.cumQty;
         report.avgPx = order.avgPx;
-        report.leavesQty = order.leavesQty;
+        report.leavesQty = order.leavesQty();
         report.lastShares = fillQty;
         report.lastPx = fillPrice;
-        report.transactTime = order.updateTime;
+        report.transactTime = updateTime;
         report.execTransType = ExecTransType::NEW;
         
-        LOG() << "[MatchingEngine] Order " << order.clOrdID << " filled: "
+        LOG() << "[MatchingEngine] Order " << clOrdID << " filled: "
               << fillQty << " @ " << fillPrice
               << " (cumQty=" << order.cumQty << "/" << order.orderQty << ")";
         
-        sendExecutionReport(sessionIt->second, report);
+        sendExecutionReport(shard, orderTable_.at(order.orderRef).sessionID, report);
     }
 }
 
-void MatchingEngine::addToPendingOrders(const Order& order) {
-    pendingOrders_[order.symbol].push_back(order);
-    LOG() << "[MatchingEngine] Order " << order.clOrdID << " added to pending orders for " << order.symbol;
+void MatchingEngine::addToPendingOrders(Shard& shard, const EngineOrder& order) {
+    const std::string& symbol = shard.symbols.name(order.symbolId);
+    auto it = shard.pendingOrders.find(symbol);
+    if (it == shard.pendingOrders.end()) {
+        it = shard.pendingOrders.try_emplace(symbol, symbol, order.symbolId).first;
+    }
+    const OrderHandle handle = it->second.add(order);
+    if (order.orderRef != kNoOrderRef) {
+        if (order.orderRef >= shard.orderLocations.size()) {
+            shard.orderLocations.resize(std::max<size_t>(order.orderRef + 1, shard.orderLocations.size() * 2));
+        }
+        shard.orderLocations[order.orderRef] = OrderLocation{&it->second, handle};
+    }
+    LOG() << "[MatchingEngine] Order " << order.clOrdID() << " added to pending orders for " << symbol;
 }
 
-std::optional<Order> MatchingEngine::removeFromPendingOrders(const std::string& instrumentId, 
-                                                              const std::string& clOrdID) {
-    auto it = pendingOrders_.find(instrumentId);
-    if (it == pendingOrders_.end()) {
+std::optional<Order> MatchingEngine::removeFromPendingOrders(Shard& shard, const CancelRequest& req,
+                                                           const std::string& accountId) {
+    // 按订单号直接定位；订单号可能已过期并被复用，以 clOrdID 校验。
+    // 已给出订单号时不再按 clOrdID 回退查找：订单号失效说明原订单已不在挂单中；
+    // 未给出时只在发起账户自己的订单中按 clOrdID 查找，其它账户同 clOrdID 的订单不受影响
+    const OrderRef ref = req.origOrderRef != kNoOrderRef
+        ? req.origOrderRef
+        : orderTable_.find(accountId, req.origClOrdID);
+    if (ref == kNoOrderRef || ref >= shard.orderLocations.size()) {
         return std::nullopt;
     }
-    
-    auto& orders = it->second;
-    for (auto orderIt = orders.begin(); orderIt != orders.end(); ++orderIt) {
-        if (orderIt->clOrdID == clOrdID) {
-            Order removedOrder = *orderIt;
-            orders.erase(orderIt);
-            return removedOrder;
-        }
+    OrderLocation& location = shard.orderLocations[ref];
+    if (!location.resting()) {
+        return std::nullopt;
     }
-    
-    return std::nullopt;
+    const EngineOrder& record = location.book->at(location.handle);
+    if (record.orderRef != ref || record.clOrdID() != req.origClOrdID) {
+        return std::nullopt;
+    }
+    const OrderLocation found = location;
+    location = OrderLocation{};
+    return found.book->removeByHandle(found.handle);
+}
+
+void MatchingEngine::releaseOrder(Shard& shard, OrderRef ref) {
+    if (ref == kNoOrderRef) {
+        return;
+    }
+    if (ref < shard.orderLocations.size()) {
+        shard.orderLocations[ref] = OrderLocation{};
+    }
+    orderTable_.release(ref);
 }
 
 } // namespace fix40
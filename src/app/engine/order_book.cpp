@@ -10,9 +10,13 @@
 
 namespace fix40 {
 
-OrderBook::OrderBook(const std::string& symbol)
+OrderBook::OrderBook(const std::string& symbol, double priceTick)
     : symbol_(symbol)
 {
+    if (priceTick > 0) {
+        bidLadder_.emplace(priceTick, true);
+        askLadder_.emplace(priceTick, false);
+    }
 }
 
 std::string OrderBook::generateOrderID() {
@@ -54,10 +58,23 @@ std::vector<Trade> OrderBook::addOrder(Order& order) {
         order.status = OrderStatus::REJECTED;
         return {};
     }
+    if (bidLadder_ && order.ordType == OrderType::LIMIT) {
+        if (!bidLadder_->isOnTick(order.price)) {
+            LOG() << "[OrderBook:" << symbol_ << "] Rejected: price " << order.price << " not on tick";
+            order.status = OrderStatus::REJECTED;
+            return {};
+        }
+        const auto& ladder = (order.side == OrderSide::BUY) ? *bidLadder_ : *askLadder_;
+        if (!ladder.fits(order.price)) {
+            LOG() << "[OrderBook:" << symbol_ << "] Rejected: price " << order.price << " outside ladder window";
+            order.status = OrderStatus::REJECTED;
+            return {};
+        }
+    }
     
     // 市价单检查：必须有对手盘
     if (order.ordType == OrderType::MARKET) {
-        bool hasCounterparty = (order.side == OrderSide::BUY) ? !asks_.empty() : !bids_.empty();
+        bool hasCounterparty = (order.side == OrderSide::BUY) ? askOrderCount_ > 0 : bidOrderCount_ > 0;
         if (!hasCounterparty) {
             LOG() << "[OrderBook:" << symbol_ << "] Rejected: market order with no counterparty";
             order.status = OrderStatus::REJECTED;
@@ -90,9 +107,9 @@ std::vector<Trade> OrderBook::addOrder(Order& order) {
     
     // 根据买卖方向撮合
     if (order.side == OrderSide::BUY) {
-        trades = matchBuyOrder(order);
+        trades = withAsks([&](auto& asks) { return matchBuyOrder(asks, order); });
     } else {
-        trades = matchSellOrder(order);
+        trades = withBids([&](auto& bids) { return matchSellOrder(bids, order); });
     }
 
     // 处理剩余数量
@@ -144,13 +161,14 @@ std::vector<Trade> OrderBook::addOrder(Order& order) {
     return trades;
 }
 
-std::vector<Trade> OrderBook::matchBuyOrder(Order& buyOrder) {
+template <typename Levels>
+std::vector<Trade> OrderBook::matchBuyOrder(Levels& asks, Order& buyOrder) {
     std::vector<Trade> trades;
     
     // 遍历卖盘（从最低价开始）
-    auto it = asks_.begin();
-    while (it != asks_.end() && buyOrder.leavesQty > 0) {
-        PriceLevel& level = it->second;
+    auto it = asks.begin();
+    while (it != asks.end() && buyOrder.leavesQty > 0) {
+        Level& level = it->second;
         
         // 检查价格是否可以成交
         // 市价单：不检查价格，直接成交
@@ -160,9 +178,9 @@ std::vector<Trade> OrderBook::matchBuyOrder(Order& buyOrder) {
         }
 
         // 遍历该价位的订单
-        auto orderIt = level.orders.begin();
-        while (orderIt != level.orders.end() && buyOrder.leavesQty > 0) {
-            Order& sellOrder = *orderIt;
+        OrderHandle handle = level.queue.head;
+        while (handle != kInvalidOrderHandle && buyOrder.leavesQty > 0) {
+            Order& sellOrder = pool_.get(handle);
             
             // 计算成交数量
             int64_t matchQty = std::min(buyOrder.leavesQty, sellOrder.leavesQty);
@@ -234,18 +252,20 @@ std::vector<Trade> OrderBook::matchBuyOrder(Order& buyOrder) {
             if (sellOrder.leavesQty == 0) {
                 // 从索引中移除
                 orderIndex_.erase(sellOrder.clOrdID);
-                orderIt = level.orders.erase(orderIt);
+                const OrderHandle next = pool_.unlink(level.queue, handle);
+                pool_.release(handle);
+                handle = next;
                 askOrderCount_--;
             } else {
-                ++orderIt;
+                handle = pool_.next(handle);
             }
             
             level.totalQty -= matchQty;
         }
 
         // 如果该价位已空，移除
-        if (level.orders.empty()) {
-            it = asks_.erase(it);
+        if (level.queue.empty()) {
+            it = asks.erase(it);
         } else {
             ++it;
         }
@@ -254,13 +274,14 @@ std::vector<Trade> OrderBook::matchBuyOrder(Order& buyOrder) {
     return trades;
 }
 
-std::vector<Trade> OrderBook::matchSellOrder(Order& sellOrder) {
+template <typename Levels>
+std::vector<Trade> OrderBook::matchSellOrder(Levels& bids, Order& sellOrder) {
     std::vector<Trade> trades;
     
     // 遍历买盘（从最高价开始）
-    auto it = bids_.begin();
-    while (it != bids_.end() && sellOrder.leavesQty > 0) {
-        PriceLevel& level = it->second;
+    auto it = bids.begin();
+    while (it != bids.end() && sellOrder.leavesQty > 0) {
+        Level& level = it->second;
         
         // 检查价格是否可以成交
         // 市价单：不检查价格，直接成交
@@ -270,9 +291,9 @@ std::vector<Trade> OrderBook::matchSellOrder(Order& sellOrder) {
         }
 
         // 遍历该价位的订单
-        auto orderIt = level.orders.begin();
-        while (orderIt != level.orders.end() && sellOrder.leavesQty > 0) {
-            Order& buyOrder = *orderIt;
+        OrderHandle handle = level.queue.head;
+        while (handle != kInvalidOrderHandle && sellOrder.leavesQty > 0) {
+            Order& buyOrder = pool_.get(handle);
             
             // 计算成交数量
             int64_t matchQty = std::min(sellOrder.leavesQty, buyOrder.leavesQty);
@@ -344,18 +365,20 @@ std::vector<Trade> OrderBook::matchSellOrder(Order& sellOrder) {
             if (buyOrder.leavesQty == 0) {
                 // 从索引中移除
                 orderIndex_.erase(buyOrder.clOrdID);
-                orderIt = level.orders.erase(orderIt);
+                const OrderHandle next = pool_.unlink(level.queue, handle);
+                pool_.release(handle);
+                handle = next;
                 bidOrderCount_--;
             } else {
-                ++orderIt;
+                handle = pool_.next(handle);
             }
             
             level.totalQty -= matchQty;
         }
 
         // 如果该价位已空，移除
-        if (level.orders.empty()) {
-            it = bids_.erase(it);
+        if (level.queue.empty()) {
+            it = bids.erase(it);
         } else {
             ++it;
         }
@@ -364,15 +387,21 @@ std::vector<Trade> OrderBook::matchSellOrder(Order& sellOrder) {
     return trades;
 }
 
-void OrderBook::addToBids(const Order& order) {
-    auto& level = bids_[order.price];
-    if (level.orders.empty()) {
+template <typename Levels>
+void OrderBook::insertOrder(Levels& levels, const Order& order) {
+    auto& level = levels[order.price];
+    if (level.queue.empty()) {
         level.price = order.price;
     }
-    level.orders.push_back(order);
+    const OrderHandle handle = pool_.allocate(order);
+    pool_.pushBack(level.queue, handle);
     level.totalQty += order.leavesQty;
     
-    orderIndex_[order.clOrdID] = {OrderSide::BUY, order.price};
+    orderIndex_[order.clOrdID] = handle;
+}
+
+void OrderBook::addToBids(const Order& order) {
+    withBids([&](auto& bids) { insertOrder(bids, order); });
     bidOrderCount_++;
     
     LOG() << "[OrderBook:" << symbol_ << "] Order " << order.clOrdID 
@@ -380,14 +409,7 @@ void OrderBook::addToBids(const Order& order) {
 }
 
 void OrderBook::addToAsks(const Order& order) {
-    auto& level = asks_[order.price];
-    if (level.orders.empty()) {
-        level.price = order.price;
-    }
-    level.orders.push_back(order);
-    level.totalQty += order.leavesQty;
-    
-    orderIndex_[order.clOrdID] = {OrderSide::SELL, order.price};
+    withAsks([&](auto& asks) { insertOrder(asks, order); });
     askOrderCount_++;
     
     LOG() << "[OrderBook:" << symbol_ << "] Order " << order.clOrdID 
@@ -401,70 +423,39 @@ std::optional<Order> OrderBook::cancelOrder(const std::string& clOrdID) {
         return std::nullopt;
     }
     
-    return removeOrder(clOrdID, indexIt->second.side);
+    return removeOrder(indexIt->second);
 }
 
-std::optional<Order> OrderBook::removeOrder(const std::string& clOrdID, OrderSide side) {
-    auto indexIt = orderIndex_.find(clOrdID);
-    if (indexIt == orderIndex_.end()) {
-        return std::nullopt;
+template <typename Levels>
+Order OrderBook::unlinkFromLevel(Levels& levels, OrderHandle handle) {
+    Order removed = std::move(pool_.get(handle));
+    auto levelIt = levels.find(removed.price);
+    levelIt->second.totalQty -= removed.leavesQty;
+    pool_.unlink(levelIt->second.queue, handle);
+    if (levelIt->second.queue.empty()) {
+        levels.erase(levelIt);
     }
-    
-    double price = indexIt->second.price;
-    
-    if (side == OrderSide::BUY) {
-        auto levelIt = bids_.find(price);
-        if (levelIt != bids_.end()) {
-            auto& orders = levelIt->second.orders;
-            for (auto it = orders.begin(); it != orders.end(); ++it) {
-                if (it->clOrdID == clOrdID) {
-                    Order canceledOrder = *it;
-                    canceledOrder.status = OrderStatus::CANCELED;
-                    canceledOrder.updateTime = std::chrono::system_clock::now();
-                    
-                    levelIt->second.totalQty -= it->leavesQty;
-                    orders.erase(it);
-                    bidOrderCount_--;
-                    
-                    if (orders.empty()) {
-                        bids_.erase(levelIt);
-                    }
-                    
-                    orderIndex_.erase(clOrdID);
-                    
-                    LOG() << "[OrderBook:" << symbol_ << "] Order " << clOrdID << " canceled";
-                    return canceledOrder;
-                }
-            }
-        }
+    pool_.release(handle);
+    return removed;
+}
+
+std::optional<Order> OrderBook::removeOrder(OrderHandle handle) {
+    // 句柄直接定位节点，侵入式链表 O(1) 解链，无需扫描价位队列
+    Order canceledOrder;
+    if (pool_.get(handle).side == OrderSide::BUY) {
+        canceledOrder = withBids([&](auto& bids) { return unlinkFromLevel(bids, handle); });
+        bidOrderCount_--;
     } else {
-        auto levelIt = asks_.find(price);
-        if (levelIt != asks_.end()) {
-            auto& orders = levelIt->second.orders;
-            for (auto it = orders.begin(); it != orders.end(); ++it) {
-                if (it->clOrdID == clOrdID) {
-                    Order canceledOrder = *it;
-                    canceledOrder.status = OrderStatus::CANCELED;
-                    canceledOrder.updateTime = std::chrono::system_clock::now();
-                    
-                    levelIt->second.totalQty -= it->leavesQty;
-                    orders.erase(it);
-                    askOrderCount_--;
-                    
-                    if (orders.empty()) {
-                        asks_.erase(levelIt);
-                    }
-                    
-                    orderIndex_.erase(clOrdID);
-                    
-                    LOG() << "[OrderBook:" << symbol_ << "] Order " << clOrdID << " canceled";
-                    return canceledOrder;
-                }
-            }
-        }
+        canceledOrder = withAsks([&](auto& asks) { return unlinkFromLevel(asks, handle); });
+        askOrderCount_--;
     }
+    orderIndex_.erase(canceledOrder.clOrdID);
+
+    canceledOrder.status = OrderStatus::CANCELED;
+    canceledOrder.updateTime = std::chrono::system_clock::now();
     
-    return std::nullopt;
+    LOG() << "[OrderBook:" << symbol_ << "] Order " << canceledOrder.clOrdID << " canceled";
+    return canceledOrder;
 }
 
 const Order* OrderBook::findOrder(const std::string& clOrdID) const {
@@ -472,105 +463,83 @@ const Order* OrderBook::findOrder(const std::string& clOrdID) const {
     if (indexIt == orderIndex_.end()) {
         return nullptr;
     }
-    
-    double price = indexIt->second.price;
-    OrderSide side = indexIt->second.side;
-    
-    if (side == OrderSide::BUY) {
-        auto levelIt = bids_.find(price);
-        if (levelIt != bids_.end()) {
-            for (const auto& order : levelIt->second.orders) {
-                if (order.clOrdID == clOrdID) {
-                    return &order;
-                }
-            }
-        }
-    } else {
-        auto levelIt = asks_.find(price);
-        if (levelIt != asks_.end()) {
-            for (const auto& order : levelIt->second.orders) {
-                if (order.clOrdID == clOrdID) {
-                    return &order;
-                }
-            }
-        }
-    }
-    
-    return nullptr;
+    return &pool_.get(indexIt->second);
 }
 
 std::optional<double> OrderBook::getBestBid() const {
-    if (bids_.empty()) {
-        return std::nullopt;
-    }
-    return bids_.begin()->first;
+    return withBids([](const auto& bids) -> std::optional<double> {
+        if (bids.empty()) {
+            return std::nullopt;
+        }
+        return bids.begin()->second.price;
+    });
 }
 
 std::optional<double> OrderBook::getBestAsk() const {
-    if (asks_.empty()) {
-        return std::nullopt;
-    }
-    return asks_.begin()->first;
+    return withAsks([](const auto& asks) -> std::optional<double> {
+        if (asks.empty()) {
+            return std::nullopt;
+        }
+        return asks.begin()->second.price;
+    });
 }
 
-std::vector<PriceLevel> OrderBook::getBidLevels(size_t levels) const {
-    std::vector<PriceLevel> result;
-    result.reserve(levels);
-    
-    size_t count = 0;
-    for (const auto& [price, level] : bids_) {
-        if (count >= levels) break;
-        result.push_back(level);
-        count++;
+PriceLevel OrderBook::materialize(const Level& level) const {
+    PriceLevel result(level.price);
+    result.totalQty = level.totalQty;
+    for (OrderHandle h = level.queue.head; h != kInvalidOrderHandle; h = pool_.next(h)) {
+        result.orders.push_back(pool_.get(h));
     }
-    
     return result;
 }
 
-std::vector<PriceLevel> OrderBook::getAskLevels(size_t levels) const {
+template <typename Levels>
+std::vector<PriceLevel> OrderBook::collectLevels(const Levels& book, size_t levels) const {
     std::vector<PriceLevel> result;
     result.reserve(levels);
     
     size_t count = 0;
-    for (const auto& [price, level] : asks_) {
-        if (count >= levels) break;
-        result.push_back(level);
+    for (auto it = book.begin(); it != book.end() && count < levels; ++it) {
+        result.push_back(materialize(it->second));
         count++;
     }
     
     return result;
 }
 
-int64_t OrderBook::calculateMatchableQty(const Order& order) const {
+std::vector<PriceLevel> OrderBook::getBidLevels(size_t levels) const {
+    return withBids([&](const auto& bids) { return collectLevels(bids, levels); });
+}
+
+std::vector<PriceLevel> OrderBook::getAskLevels(size_t levels) const {
+    return withAsks([&](const auto& asks) { return collectLevels(asks, levels); });
+}
+
+template <typename Levels>
+int64_t OrderBook::sumMatchableQty(const Levels& book, const Order& order) const {
     int64_t matchableQty = 0;
-    
-    if (order.side == OrderSide::BUY) {
-        // 买单：遍历卖盘计算可成交数量
-        for (const auto& [askPrice, level] : asks_) {
-            // 市价单不检查价格，限价单检查价格
-            if (order.ordType == OrderType::LIMIT && order.price < askPrice) {
-                break;  // 后面的卖价更高，不可能成交
-            }
-            matchableQty += level.totalQty;
-            if (matchableQty >= order.orderQty) {
-                return order.orderQty;  // 已经足够
-            }
+    for (auto it = book.begin(); it != book.end(); ++it) {
+        const Level& level = it->second;
+        // 市价单不检查价格，限价单检查价格（后面的价位只会更差）
+        if (order.ordType == OrderType::LIMIT &&
+            (order.side == OrderSide::BUY ? order.price < level.price : order.price > level.price)) {
+            break;
         }
-    } else {
-        // 卖单：遍历买盘计算可成交数量
-        for (const auto& [bidPrice, level] : bids_) {
-            // 市价单不检查价格，限价单检查价格
-            if (order.ordType == OrderType::LIMIT && order.price > bidPrice) {
-                break;  // 后面的买价更低，不可能成交
-            }
-            matchableQty += level.totalQty;
-            if (matchableQty >= order.orderQty) {
-                return order.orderQty;  // 已经足够
-            }
+        matchableQty += level.totalQty;
+        if (matchableQty >= order.orderQty) {
+            return order.orderQty;  // 已经足够
         }
     }
-    
     return matchableQty;
 }
 
+int64_t OrderBook::calculateMatchableQty(const Order& order) const {
+    if (order.side == OrderSide::BUY) {
+        // 买单：遍历卖盘计算可成交数量
+        return withAsks([&](const auto& asks) { return sumMatchableQty(asks, order); });
+    }
+    // 卖单：遍历买盘计算可成交数量
+    return withBids([&](const auto& bids) { return sumMatchableQty(bids, order); });
+}
+
 } // namespace fix40
@@ -0,0 +1,81 @@
+/**
+ * @file order_table.cpp
+ * @brief 订单状态表实现
+ */
+
+#include "app/engine/order_table.hpp"
+
+namespace fix40 {
+
+OrderRef OrderTable::allocate(const std::string& clOrdID, const std::string& accountId,
+                              const std::string& symbol, const SessionID& sessionID, uint8_t holders) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+        if (chunkCount_ == kMaxChunks) {
+            return kNoOrderRef;
+        }
+        grow();
+    }
+    const OrderRef ref = free_.back();
+    free_.pop_back();
+
+    OrderEntry& entry = at(ref);
+    entry.clOrdID = clOrdID;
+    entry.accountId = accountId;
+    entry.symbol = symbol;
+    entry.sessionID = sessionID;
+    entry.margin = OrderMarginInfo();
+    entry.holders.store(holders, std::memory_order_relaxed);
+    index_[IndexKey{accountId, clOrdID}] = ref;
+    ++live_;
+    return ref;
+}
+
+void OrderTable::release(OrderRef ref) {
+    OrderEntry& entry = at(ref);
+    if (entry.holders.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(IndexKey{entry.accountId, entry.clOrdID});
+    if (it != index_.end() && it->second == ref) {
+        index_.erase(it);
+    }
+    free_.push_back(ref);
+    --live_;
+}
+
+OrderRef OrderTable::find(const std::string& accountId, const std::string& clOrdID, std::string* symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(IndexKey{accountId, clOrdID});
+    if (it == index_.end()) {
+        return kNoOrderRef;
+    }
+    if (symbol) {
+        *symbol = at(it->second).symbol;
+    }
+    return it->second;
+}
+
+size_t OrderTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_;
+}
+
+size_t OrderTable::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunkCount_ * kChunkSize;
+}
+
+void OrderTable::grow() {
+    const size_t base = chunkCount_ * kChunkSize;
+    chunks_[chunkCount_++] = std::make_unique<OrderEntry[]>(kChunkSize);
+    // 倒序压栈，先分配小号；0 号槽位保留为 kNoOrderRef
+    for (size_t i = kChunkSize; i-- > 0;) {
+        if (base + i != kNoOrderRef) {
+            free_.push_back(static_cast<OrderRef>(base + i));
+        }
+    }
+}
+
+} // namespace fix40
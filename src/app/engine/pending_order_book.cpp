@@ -0,0 +1,96 @@
+/**
+ * @file pending_order_book.cpp
+ * @brief 价格索引挂单簿实现
+ */
+
+#include "app/engine/pending_order_book.hpp"
+
+#include <limits>
+
+namespace fix40 {
+
+double PendingOrderBook::levelPrice(const EngineOrder& order) {
+    if (order.getOrdType() == OrderType::MARKET) {
+        return order.getSide() == OrderSide::BUY ? std::numeric_limits<double>::max()
+                                                 : std::numeric_limits<double>::lowest();
+    }
+    return order.price;
+}
+
+OrderHandle PendingOrderBook::add(const EngineOrder& order) {
+    const double price = levelPrice(order);
+    const OrderHandle handle = pool_.allocate(order);
+    EngineOrder& record = pool_.get(handle);
+    record.symbolId = symbolId_;
+    if (record.longClOrdID) {
+        // 超长 clOrdID 复制到挂单簿自有存储，不再依赖调用方
+        const std::string& owned = longClOrdIDs_[handle] = std::string(order.clOrdID());
+        record.setClOrdID(owned);
+    }
+
+    if (record.getSide() == OrderSide::BUY) {
+        pool_.pushBack(bids_[price], handle);
+    } else {
+        pool_.pushBack(asks_[price], handle);
+    }
+    ++count_;
+
+    // 重复 clOrdID 时索引指向最新订单，键改为引用新节点
+    auto [it, inserted] = index_.try_emplace(record.clOrdID(), handle);
+    if (!inserted) {
+        index_.erase(it);
+        index_.emplace(record.clOrdID(), handle);
+    }
+    return handle;
+}
+
+std::optional<Order> PendingOrderBook::remove(const std::string& clOrdID) {
+    const OrderHandle handle = handleOf(clOrdID);
+    if (handle == kInvalidOrderHandle) {
+        return std::nullopt;
+    }
+    return removeByHandle(handle);
+}
+
+Order PendingOrderBook::removeByHandle(OrderHandle handle) {
+    const EngineOrder& record = pool_.get(handle);
+    Order removed = materialize(record);
+
+    const double price = levelPrice(record);
+    if (record.getSide() == OrderSide::BUY) {
+        auto levelIt = bids_.find(price);
+        pool_.unlink(levelIt->second, handle);
+        if (levelIt->second.empty()) bids_.erase(levelIt);
+    } else {
+        auto levelIt = asks_.find(price);
+        pool_.unlink(levelIt->second, handle);
+        if (levelIt->second.empty()) asks_.erase(levelIt);
+    }
+    releaseNode(handle);
+    return removed;
+}
+
+const EngineOrder* PendingOrderBook::find(const std::string& clOrdID) const {
+    const OrderHandle handle = handleOf(clOrdID);
+    return handle != kInvalidOrderHandle ? &pool_.get(handle) : nullptr;
+}
+
+OrderHandle PendingOrderBook::handleOf(const std::string& clOrdID) const {
+    auto it = index_.find(clOrdID);
+    return it != index_.end() ? it->second : kInvalidOrderHandle;
+}
+
+void PendingOrderBook::releaseNode(OrderHandle handle) {
+    // 重复 clOrdID 时索引可能已指向另一笔仍在簿中的订单，只删除指向本节点的条目
+    auto it = index_.find(pool_.get(handle).clOrdID());
+    if (it != index_.end() && it->second == handle) {
+        index_.erase(it);
+    }
+    --count_;
+    if (pool_.get(handle).longClOrdID) {
+        longClOrdIDs_.erase(handle);
+    }
+    pool_.release(handle);
+}
+
+} // namespace fix40
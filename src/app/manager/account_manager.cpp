@@ -67,6 +67,15 @@ std::optional<Account> AccountManager::getAccount(const std::string& accountId)
     return std::nullopt;
 }
 
+std::optional<double> AccountManager::getAvailable(const std::string& accountId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = accounts_.find(accountId);
+    if (it != accounts_.end()) {
+        return it->second.available;
+    }
+    return std::nullopt;
+}
+
 bool AccountManager::hasAccount(const std::string& accountId) const {
     std::lock_guard<std::mutex> lock(mutex_);
     return accounts_.find(accountId) != accounts_.end();
@@ -211,8 +220,10 @@ bool AccountManager::updatePositionProfit(const std::string& accountId, double p
     account.available += profitDelta;
     account.updateTime = std::chrono::system_clock::now();
     
-    // 持久化
-    persistAccount(account);
+    // 行情驱动的高频更新：只标记为脏，定期批量持久化
+    if (store_) {
+        dirty_.insert(accountId);
+    }
     
     return true;
 }
@@ -246,6 +257,34 @@ bool AccountManager::addCloseProfit(const std::string& accountId, double profit)
 void AccountManager::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     accounts_.clear();
+    dirty_.clear();
+}
+
+// =============================================================================
+// 持久化
+// =============================================================================
+
+size_t AccountManager::flushDirty() {
+    // 与其他资金变动一样在锁内写入，避免旧副本覆盖已落盘的新状态
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!store_) {
+        return 0;
+    }
+    size_t flushed = 0;
+    for (const auto& accountId : dirty_) {
+        auto it = accounts_.find(accountId);
+        if (it != accounts_.end()) {
+            store_->saveAccount(it->second);
+            ++flushed;
+        }
+    }
+    dirty_.clear();
+    return flushed;
+}
+
+size_t AccountManager::dirtyCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirty_.size();
 }
 
 // =============================================================================
@@ -254,6 +293,8 @@ void AccountManager::clear() {
 
 void AccountManager::persistAccount(const Account& account) {
     if (!store_) return;
+    // 完整状态已落盘，不必再等待批量持久化
+    dirty_.erase(account.accountId);
     // 注意：此处为 best-effort 持久化。存储失败时不抛异常，以免影响撮合主流程。
     store_->saveAccount(account);
 }
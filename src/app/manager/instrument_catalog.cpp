@@ -0,0 +1,256 @@
+/**
+ * @file instrument_catalog.cpp
+ * @brief 合约目录缓存实现
+ */
+
+#include "app/manager/instrument_catalog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace fix40 {
+
+namespace {
+
+/// 文件头
+struct CatalogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint32_t recordSize;
+    uint32_t stringBytes;
+    int64_t createdAtNs;
+    uint64_t checksum;
+    char reserved[24];
+};
+static_assert(sizeof(CatalogHeader) == 64, "CatalogHeader layout changed");
+
+/// 定长合约记录；字符串以字符串池中的 偏移 + 长度 引用
+struct CatalogRecord {
+    double priceTick;
+    double marginRate;
+    double upperLimitPrice;
+    double lowerLimitPrice;
+    double preSettlementPrice;
+    int32_t volumeMultiple;
+    uint32_t instrumentIdOffset;
+    uint32_t exchangeIdOffset;
+    uint32_t productIdOffset;
+    uint8_t instrumentIdLength;
+    uint8_t exchangeIdLength;
+    uint8_t productIdLength;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(CatalogRecord) == 64, "CatalogRecord layout changed");
+
+/// 记录中字符串长度上限（u8）
+constexpr size_t kMaxStringLength = 255;
+
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 1469598103934665603ull) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool setError(std::string* error, const std::string& reason) {
+    if (error) {
+        *error = reason;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// 写入
+// =============================================================================
+
+bool InstrumentCatalog::write(const std::string& path, const std::vector<Instrument>& instruments,
+                              std::string* error) {
+    std::vector<CatalogRecord> records(instruments.size());
+    std::string strings;
+
+    // 交易所、品种代码大量重复，字符串池内去重
+    std::unordered_map<std::string, uint32_t> pooled;
+    auto intern = [&strings, &pooled](const std::string& value, uint32_t& offset, uint8_t& length) {
+        auto [it, inserted] = pooled.try_emplace(value, static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            strings.append(value);
+        }
+        offset = it->second;
+        length = static_cast<uint8_t>(value.size());
+    };
+
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        const Instrument& inst = instruments[i];
+        if (inst.instrumentId.size() > kMaxStringLength || inst.exchangeId.size() > kMaxStringLength ||
+            inst.productId.size() > kMaxStringLength) {
+            return setError(error, "identifier too long: " + inst.instrumentId);
+        }
+        CatalogRecord& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        record.priceTick = inst.priceTick;
+        record.marginRate = inst.marginRate;
+        record.upperLimitPrice = inst.upperLimitPrice;
+        record.lowerLimitPrice = inst.lowerLimitPrice;
+        record.preSettlementPrice = inst.preSettlementPrice;
+        record.volumeMultiple = inst.volumeMultiple;
+        intern(inst.instrumentId, record.instrumentIdOffset, record.instrumentIdLength);
+        intern(inst.exchangeId, record.exchangeIdOffset, record.exchangeIdLength);
+        intern(inst.productId, record.productIdOffset, record.productIdLength);
+    }
+
+    const char* recordBytes = reinterpret_cast<const char*>(records.data());
+    const size_t recordsSize = records.size() * sizeof(CatalogRecord);
+
+    CatalogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.count = static_cast<uint32_t>(records.size());
+    header.recordSize = sizeof(CatalogRecord);
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+    header.createdAtNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.checksum = fnv1a(strings.data(), strings.size(), fnv1a(recordBytes, recordsSize));
+
+    // 先写临时文件，完整写入后再替换
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return setError(error, "cannot create " + tmpPath);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(recordBytes, static_cast<std::streamsize>(recordsSize));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        out.flush();
+        if (!out) {
+            std::remove(tmpPath.c_str());
+            return setError(error, "write failed: " + tmpPath);
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return setError(error, "rename failed: " + path);
+    }
+    return true;
+}
+
+// =============================================================================
+// 读取
+// =============================================================================
+
+InstrumentCatalog::~InstrumentCatalog() {
+    close();
+}
+
+bool InstrumentCatalog::fail(const std::string& reason) {
+    close();
+    error_ = reason;
+    return false;
+}
+
+bool InstrumentCatalog::open(const std::string& path) {
+    close();
+    error_.clear();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return fail("cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CatalogHeader))) {
+        ::close(fd);
+        return fail("file too small");
+    }
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return fail("mmap failed");
+    }
+    data_ = static_cast<const char*>(mapped);
+    mappedSize_ = static_cast<size_t>(st.st_size);
+
+    CatalogHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail("bad magic");
+    }
+    if (header.version != kVersion || header.recordSize != sizeof(CatalogRecord)) {
+        return fail("unsupported version " + std::to_string(header.version));
+    }
+    const size_t recordsSize = static_cast<size_t>(header.count) * sizeof(CatalogRecord);
+    if (mappedSize_ != sizeof(CatalogHeader) + recordsSize + header.stringBytes) {
+        return fail("size mismatch");
+    }
+    records_ = data_ + sizeof(CatalogHeader);
+    strings_ = records_ + recordsSize;
+    if (fnv1a(strings_, header.stringBytes, fnv1a(records_, recordsSize)) != header.checksum) {
+        return fail("checksum mismatch");
+    }
+    // 字符串引用越界视为损坏
+    for (size_t i = 0; i < header.count; ++i) {
+        CatalogRecord record;
+        std::memcpy(&record, records_ + i * sizeof(CatalogRecord), sizeof(record));
+        if (static_cast<size_t>(record.instrumentIdOffset) + record.instrumentIdLength > header.stringBytes ||
+            static_cast<size_t>(record.exchangeIdOffset) + record.exchangeIdLength > header.stringBytes ||
+            static_cast<size_t>(record.productIdOffset) + record.productIdLength > header.stringBytes) {
+            return fail("string reference out of range");
+        }
+    }
+
+    count_ = header.count;
+    stringBytes_ = header.stringBytes;
+    createdAtNs_ = header.createdAtNs;
+    return true;
+}
+
+void InstrumentCatalog::close() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), mappedSize_);
+    }
+    data_ = nullptr;
+    mappedSize_ = 0;
+    count_ = 0;
+    records_ = nullptr;
+    strings_ = nullptr;
+    stringBytes_ = 0;
+    createdAtNs_ = 0;
+}
+
+Instrument InstrumentCatalog::instrument(size_t index) const {
+    CatalogRecord record;
+    std::memcpy(&record, records_ + index * sizeof(CatalogRecord), sizeof(record));
+
+    Instrument inst;
+    inst.instrumentId.assign(strings_ + record.instrumentIdOffset, record.instrumentIdLength);
+    inst.exchangeId.assign(strings_ + record.exchangeIdOffset, record.exchangeIdLength);
+    inst.productId.assign(strings_ + record.productIdOffset, record.productIdLength);
+    inst.priceTick = record.priceTick;
+    inst.volumeMultiple = record.volumeMultiple;
+    inst.marginRate = record.marginRate;
+    inst.upperLimitPrice = record.upperLimitPrice;
+    inst.lowerLimitPrice = record.lowerLimitPrice;
+    inst.preSettlementPrice = record.preSettlementPrice;
+    return inst;
+}
+
+std::vector<Instrument> InstrumentCatalog::instruments() const {
+    std::vector<Instrument> result;
+    result.reserve(count_);
+    for (size_t i = 0; i < count_; ++i) {
+        result.push_back(instrument(i));
+    }
+    return result;
+}
+
+} // namespace fix40
@@ -4,167 +4,224 @@
  */
 
 #include "app/manager/instrument_manager.hpp"
+#include "app/manager/instrument_catalog.hpp"
+#include "base/logger.hpp"
+#include <cctype>
+#include <charconv>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
-#include <algorithm>
+#include <string_view>
 
 namespace fix40 {
 
 // =============================================================================
-// 简单JSON解析辅助函数
+// JSON 解析辅助
 // =============================================================================
 
 namespace {
 
 /**
- * @brief 跳过空白字符
+ * @brief 单遍 JSON 解析游标
+ *
+ * 直接在文件缓冲区上顺序解析：键以 string_view 比较（无转义时不复制），
+ * 数字用 std::from_chars 就地转换，每个合约对象解析完即追加到结果中。
+ * 只支持合约配置用到的 JSON 子集，格式错误时抛出 std::runtime_error。
  */
-void skipWhitespace(const std::string& json, size_t& pos) {
-    while (pos < json.size() && std::isspace(json[pos])) {
-        ++pos;
+class JsonCursor {
+public:
+    explicit JsonCursor(std::string_view json) : json_(json) {}
+
+    /// 跳过空白后的下一个字符，到达末尾返回 '\0'
+    char peek() {
+        skipWhitespace();
+        return pos_ < json_.size() ? json_[pos_] : '\0';
     }
-}
 
-/**
- * @brief 解析字符串值
- */
-std::string parseString(const std::string& json, size_t& pos) {
-    if (json[pos] != '"') {
-        throw std::runtime_error("Expected '\"' at position " + std::to_string(pos));
+    /// 下一个字符为 c 时消费并返回 true
+    bool consume(char c) {
+        if (peek() != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
     }
-    ++pos;
-    
-    std::string result;
-    while (pos < json.size() && json[pos] != '"') {
-        if (json[pos] == '\\' && pos + 1 < json.size()) {
-            ++pos;
-            switch (json[pos]) {
-                case '"': result += '"'; break;
-                case '\\': result += '\\'; break;
-                case 'n': result += '\n'; break;
-                case 't': result += '\t'; break;
-                default: result += json[pos]; break;
+
+    /// 消费字符 c，不符时抛出异常
+    void expect(char c) {
+        if (!consume(c)) {
+            throw std::runtime_error(std::string("Expected '") + c + "' at position " + std::to_string(pos_));
+        }
+    }
+
+    /**
+     * @brief 解析字符串
+     * @param scratch 含转义字符时的解码缓冲
+     * @return 字符串内容（指向输入或 scratch）
+     */
+    std::string_view parseString(std::string& scratch) {
+        expect('"');
+        const size_t start = pos_;
+        while (pos_ < json_.size() && json_[pos_] != '"' && json_[pos_] != '\\') {
+            ++pos_;
+        }
+        if (pos_ < json_.size() && json_[pos_] == '"') {
+            return json_.substr(start, pos_++ - start);
+        }
+
+        // 含转义字符：解码到 scratch
+        scratch.assign(json_.data() + start, pos_ - start);
+        while (pos_ < json_.size() && json_[pos_] != '"') {
+            if (json_[pos_] == '\\' && pos_ + 1 < json_.size()) {
+                ++pos_;
+                switch (json_[pos_]) {
+                    case 'n': scratch += '\n'; break;
+                    case 't': scratch += '\t'; break;
+                    default: scratch += json_[pos_]; break;
+                }
+            } else {
+                scratch += json_[pos_];
             }
+            ++pos_;
+        }
+        if (pos_ >= json_.size()) {
+            throw std::runtime_error("Unterminated string");
+        }
+        ++pos_; // skip closing quote
+        return scratch;
+    }
+
+    /// 解析数字
+    double parseNumber() {
+        skipWhitespace();
+        double value = 0.0;
+        const char* begin = json_.data() + pos_;
+        auto [end, ec] = std::from_chars(begin, json_.data() + json_.size(), value);
+        if (ec != std::errc()) {
+            throw std::runtime_error("Invalid number at position " + std::to_string(pos_));
+        }
+        pos_ += static_cast<size_t>(end - begin);
+        return value;
+    }
+
+    /// 跳过任意值（未知字段）
+    void skipValue() {
+        const char c = peek();
+        if (c == '"') {
+            std::string scratch;
+            parseString(scratch);
+        } else if (c == '{' || c == '[') {
+            skipNested();
+        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            parseNumber();
         } else {
-            result += json[pos];
+            // true / false / null
+            while (pos_ < json_.size() && std::isalpha(static_cast<unsigned char>(json_[pos_]))) {
+                ++pos_;
+            }
         }
-        ++pos;
     }
-    
-    if (pos >= json.size()) {
-        throw std::runtime_error("Unterminated string");
+
+private:
+    void skipWhitespace() {
+        while (pos_ < json_.size() && std::isspace(static_cast<unsigned char>(json_[pos_]))) {
+            ++pos_;
+        }
     }
-    ++pos; // skip closing quote
-    return result;
-}
 
-/**
- * @brief 解析数字值
- */
-double parseNumber(const std::string& json, size_t& pos) {
-    size_t start = pos;
-    if (json[pos] == '-') ++pos;
-    while (pos < json.size() && (std::isdigit(json[pos]) || json[pos] == '.')) {
-        ++pos;
+    /// 跳过对象或数组（跳过其中的字符串，避免字符串内的括号干扰计数）
+    void skipNested() {
+        int depth = 0;
+        std::string scratch;
+        do {
+            const char c = peek();
+            if (c == '\0') {
+                throw std::runtime_error("Unterminated object or array");
+            }
+            if (c == '"') {
+                parseString(scratch);
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+            }
+            ++pos_;
+        } while (depth > 0);
     }
-    return std::stod(json.substr(start, pos - start));
-}
+
+    std::string_view json_;
+    size_t pos_ = 0;
+};
 
 /**
  * @brief 解析单个合约对象
  */
-Instrument parseInstrumentObject(const std::string& json, size_t& pos) {
+Instrument parseInstrumentObject(JsonCursor& cursor, std::string& scratch) {
     Instrument inst;
-    
-    skipWhitespace(json, pos);
-    if (json[pos] != '{') {
-        throw std::runtime_error("Expected '{' at position " + std::to_string(pos));
+    cursor.expect('{');
+    if (cursor.consume('}')) {
+        return inst;
     }
-    ++pos;
-    
-    while (pos < json.size()) {
-        skipWhitespace(json, pos);
-        if (json[pos] == '}') {
-            ++pos;
-            break;
-        }
-        
-        if (json[pos] == ',') {
-            ++pos;
-            skipWhitespace(json, pos);
-        }
-        
-        // 解析键
-        std::string key = parseString(json, pos);
-        
-        skipWhitespace(json, pos);
-        if (json[pos] != ':') {
-            throw std::runtime_error("Expected ':' after key");
-        }
-        ++pos;
-        skipWhitespace(json, pos);
-        
-        // 解析值
+    do {
+        const std::string_view key = cursor.parseString(scratch);
+        cursor.expect(':');
         if (key == "instrumentId") {
-            inst.instrumentId = parseString(json, pos);
+            inst.instrumentId = cursor.parseString(scratch);
         } else if (key == "exchangeId") {
-            inst.exchangeId = parseString(json, pos);
+            inst.exchangeId = cursor.parseString(scratch);
         } else if (key == "productId") {
-            inst.productId = parseString(json, pos);
+            inst.productId = cursor.parseString(scratch);
         } else if (key == "priceTick") {
-            inst.priceTick = parseNumber(json, pos);
+            inst.priceTick = cursor.parseNumber();
         } else if (key == "volumeMultiple") {
-            inst.volumeMultiple = static_cast<int>(parseNumber(json, pos));
+            inst.volumeMultiple = static_cast<int>(cursor.parseNumber());
         } else if (key == "marginRate") {
-            inst.marginRate = parseNumber(json, pos);
+            inst.marginRate = cursor.parseNumber();
         } else if (key == "upperLimitPrice") {
-            inst.upperLimitPrice = parseNumber(json, pos);
+            inst.upperLimitPrice = cursor.parseNumber();
         } else if (key == "lowerLimitPrice") {
-            inst.lowerLimitPrice = parseNumber(json, pos);
+            inst.lowerLimitPrice = cursor.parseNumber();
         } else if (key == "preSettlementPrice") {
-            inst.preSettlementPrice = parseNumber(json, pos);
+            inst.preSettlementPrice = cursor.parseNumber();
         } else {
-            // 跳过未知字段
-            if (json[pos] == '"') {
-                parseString(json, pos);
-            } else if (json[pos] == '-' || std::isdigit(json[pos])) {
-                parseNumber(json, pos);
-            }
+            cursor.skipValue();  // 跳过未知字段
         }
-    }
-    
+    } while (cursor.consume(','));
+    cursor.expect('}');
     return inst;
 }
 
 /**
- * @brief 解析合约数组
+ * @brief 解析合约数组，结果追加到 instruments
  */
-std::vector<Instrument> parseInstrumentsArray(const std::string& json, size_t& pos) {
-    std::vector<Instrument> instruments;
-    
-    skipWhitespace(json, pos);
-    if (json[pos] != '[') {
-        throw std::runtime_error("Expected '[' at position " + std::to_string(pos));
+void parseInstrumentsArray(JsonCursor& cursor, std::vector<Instrument>& instruments) {
+    std::string scratch;
+    cursor.expect('[');
+    if (cursor.consume(']')) {
+        return;
     }
-    ++pos;
-    
-    while (pos < json.size()) {
-        skipWhitespace(json, pos);
-        if (json[pos] == ']') {
-            ++pos;
-            break;
-        }
-        
-        if (json[pos] == ',') {
-            ++pos;
-            skipWhitespace(json, pos);
-        }
-        
-        instruments.push_back(parseInstrumentObject(json, pos));
+    do {
+        instruments.push_back(parseInstrumentObject(cursor, scratch));
+    } while (cursor.consume(','));
+    cursor.expect(']');
+}
+
+/**
+ * @brief 一次性读入整个文件
+ */
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
     }
-    
-    return instruments;
+    const std::streamsize size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(content.data(), size));
 }
 
 } // anonymous namespace
@@ -174,215 +231,205 @@ std::vector<Instrument> parseInstrumentsArray(const std::string& json, size_t& p
 // =============================================================================
 
 bool InstrumentManager::loadFromConfig(const std::string& configPath) {
-    // 读取文件内容
-    std::ifstream file(configPath);
-    if (!file.is_open()) {
+    std::string json;
+    if (!readFile(configPath, json)) {
         return false;
     }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string json = buffer.str();
-    
+
+    std::vector<Instrument> instruments;
     try {
-        size_t pos = 0;
-        skipWhitespace(json, pos);
-        
-        if (json[pos] != '{') {
+        JsonCursor cursor(json);
+        std::string scratch;
+        if (!cursor.consume('{')) {
             return false;
         }
-        ++pos;
-        
-        while (pos < json.size()) {
-            skipWhitespace(json, pos);
-            if (json[pos] == '}') {
-                break;
-            }
-            
-            if (json[pos] == ',') {
-                ++pos;
-                skipWhitespace(json, pos);
-            }
-            
-            // 解析键
-            std::string key = parseString(json, pos);
-            
-            skipWhitespace(json, pos);
-            if (json[pos] != ':') {
-                return false;
-            }
-            ++pos;
-            skipWhitespace(json, pos);
-            
-            if (key == "instruments") {
-                auto instruments = parseInstrumentsArray(json, pos);
-                std::lock_guard<std::mutex> lock(mutex_);
-                for (const auto& inst : instruments) {
-                    instruments_[inst.instrumentId] = inst;
-                }
-            } else {
-                // 跳过其他字段 - 简单处理
-                if (json[pos] == '"') {
-                    parseString(json, pos);
-                } else if (json[pos] == '[') {
-                    int depth = 1;
-                    ++pos;
-                    while (pos < json.size() && depth > 0) {
-                        if (json[pos] == '[') ++depth;
-                        else if (json[pos] == ']') --depth;
-                        ++pos;
-                    }
-                } else if (json[pos] == '{') {
-                    int depth = 1;
-                    ++pos;
-                    while (pos < json.size() && depth > 0) {
-                        if (json[pos] == '{') ++depth;
-                        else if (json[pos] == '}') --depth;
-                        ++pos;
-                    }
+        if (!cursor.consume('}')) {
+            do {
+                const std::string key(cursor.parseString(scratch));
+                cursor.expect(':');
+                if (key == "instruments") {
+                    parseInstrumentsArray(cursor, instruments);
+                } else {
+                    cursor.skipValue();  // 跳过其他字段
                 }
-            }
+            } while (cursor.consume(','));
+            cursor.expect('}');
         }
-        
-        return true;
     } catch (const std::exception&) {
         return false;
     }
+
+    // 解析成功后一次性发布
+    std::lock_guard<std::mutex> lock(mutex_);
+    publishLocked(instruments.data(), instruments.size());
+    return true;
+}
+
+bool InstrumentManager::loadFromCatalog(const std::string& catalogPath, std::chrono::seconds maxAge) {
+    InstrumentCatalog catalog;
+    if (!catalog.open(catalogPath)) {
+        LOG() << "[InstrumentManager] Instrument catalog unavailable: " << catalogPath
+              << " (" << catalog.error() << ")";
+        return false;
+    }
+    if (maxAge.count() > 0 && std::chrono::system_clock::now() - catalog.createdAt() > maxAge) {
+        LOG() << "[InstrumentManager] Instrument catalog expired: " << catalogPath;
+        return false;
+    }
+    const std::vector<Instrument> instruments = catalog.instruments();
+    std::lock_guard<std::mutex> lock(mutex_);
+    publishLocked(instruments.data(), instruments.size());
+    return true;
+}
+
+bool InstrumentManager::saveCatalog(const std::string& catalogPath) const {
+    std::vector<Instrument> instruments;
+    const auto table = table_.load();
+    instruments.reserve(table->size());
+    for (const auto& [instrumentId, entry] : table->entries()) {
+        instruments.push_back(entry->current());
+    }
+    std::string error;
+    if (!InstrumentCatalog::write(catalogPath, instruments, &error)) {
+        LOG() << "[InstrumentManager] Failed to write instrument catalog: " << error;
+        return false;
+    }
+    return true;
+}
+
+void InstrumentManager::publishLocked(const Instrument* first, size_t count) {
+    const auto previous = table_.load();
+    table_.store(std::make_shared<const InstrumentTable>(previous.get(), first, count));
+    // 风控参数在写入方随合约表一起发布，下单线程读取时不重建
+    const auto previousParams = riskParams_.load();
+    riskParams_.store(std::make_shared<const RiskParamTable>(previousParams.get(), first, count));
+    searchIndexDirty_.store(true, std::memory_order_release);
 }
 
 void InstrumentManager::addInstrument(const Instrument& instrument) {
     std::lock_guard<std::mutex> lock(mutex_);
-    instruments_[instrument.instrumentId] = instrument;
+    publishLocked(&instrument, 1);
 }
 
 void InstrumentManager::addInstruments(const std::vector<Instrument>& instruments) {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& inst : instruments) {
-        instruments_[inst.instrumentId] = inst;
-    }
+    publishLocked(instruments.data(), instruments.size());
 }
 
-const Instrument* InstrumentManager::getInstrument(const std::string& instrumentId) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = instruments_.find(instrumentId);
-    if (it != instruments_.end()) {
-        return &it->second;
+std::shared_ptr<const Instrument> InstrumentManager::getInstrument(const std::string& instrumentId) const {
+    const auto table = table_.load();
+    const InstrumentEntry* entry = table->find(instrumentId);
+    if (!entry) {
+        return nullptr;
     }
-    return nullptr;
+    // 合并当前价格：条目内的静态信息只保留登记时的涨跌停价、昨结算价
+    return std::make_shared<const Instrument>(entry->current());
 }
 
 std::optional<Instrument> InstrumentManager::getInstrumentCopy(const std::string& instrumentId) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = instruments_.find(instrumentId);
-    if (it != instruments_.end()) {
-        return it->second;
+    const auto table = table_.load();
+    if (const InstrumentEntry* entry = table->find(instrumentId)) {
+        return entry->current();
     }
     return std::nullopt;
 }
 
+std::optional<InstrumentPrices> InstrumentManager::getPrices(const std::string& instrumentId) const {
+    const auto table = table_.load();
+    if (const InstrumentEntry* entry = table->find(instrumentId)) {
+        return entry->prices.load();
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<const InstrumentTable> InstrumentManager::getTable() const {
+    return table_.load();
+}
+
 bool InstrumentManager::hasInstrument(const std::string& instrumentId) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return instruments_.find(instrumentId) != instruments_.end();
+    return table_.load()->find(instrumentId) != nullptr;
 }
 
 std::vector<std::string> InstrumentManager::getAllInstrumentIds() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const auto table = table_.load();
     std::vector<std::string> ids;
-    ids.reserve(instruments_.size());
-    for (const auto& pair : instruments_) {
+    ids.reserve(table->size());
+    for (const auto& pair : table->entries()) {
         ids.push_back(pair.first);
     }
     return ids;
 }
 
 size_t InstrumentManager::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return instruments_.size();
+    return table_.load()->size();
 }
 
 bool InstrumentManager::updateLimitPrices(const std::string& instrumentId,
                                            double upperLimit, double lowerLimit) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = instruments_.find(instrumentId);
-    if (it == instruments_.end()) {
+    const auto table = table_.load();
+    InstrumentEntry* entry = table->find(instrumentId);
+    if (!entry) {
         return false;
     }
-    it->second.updateLimitPrices(upperLimit, lowerLimit);
+    entry->prices.updateLimitPrices(upperLimit, lowerLimit);
     return true;
 }
 
 bool InstrumentManager::updatePreSettlementPrice(const std::string& instrumentId,
                                                   double preSettlementPrice) {
+    // 昨结算价参与市价单保证金计算，与风控参数表在同一把写锁内更新，
+    // 避免与 publishLocked 交错时参数表落后于合约表
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = instruments_.find(instrumentId);
-    if (it == instruments_.end()) {
+    const auto table = table_.load();
+    InstrumentEntry* entry = table->find(instrumentId);
+    if (!entry) {
         return false;
     }
-    it->second.preSettlementPrice = preSettlementPrice;
+    entry->prices.updatePreSettlementPrice(preSettlementPrice);
+    const auto params = riskParams_.load();
+    if (const auto index = params->indexOf(instrumentId)) {
+        riskParams_.store(std::make_shared<const RiskParamTable>(*params, *index, preSettlementPrice));
+    }
     return true;
 }
 
 void InstrumentManager::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    instruments_.clear();
+    table_.store(std::make_shared<const InstrumentTable>());
+    // 清空后重新分配下标
+    riskParams_.store(std::make_shared<const RiskParamTable>());
+    searchIndexDirty_.store(true, std::memory_order_release);
 }
 
-std::vector<std::string> InstrumentManager::searchByPrefix(const std::string& prefix, size_t limit) const {
-    std::vector<std::string> results;
-    
-    if (prefix.empty()) {
-        return results;
+std::shared_ptr<const RiskParamTable> InstrumentManager::getRiskParams() const {
+    return riskParams_.load();
+}
+
+std::shared_ptr<const InstrumentSearchIndex> InstrumentManager::getSearchIndex() const {
+    if (!searchIndexDirty_.load(std::memory_order_acquire)) {
+        return searchIndex_.load();
     }
-    
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    // 收集所有匹配的合约
-    for (const auto& [id, inst] : instruments_) {
-        if (id.size() >= prefix.size() && 
-            id.compare(0, prefix.size(), prefix) == 0) {
-            results.push_back(id);
-        }
+    if (searchIndexDirty_.load(std::memory_order_relaxed)) {
+        searchIndex_.store(std::make_shared<const InstrumentSearchIndex>(table_.load()->materialize()));
+        searchIndexDirty_.store(false, std::memory_order_release);
     }
-    
-    // 按字母排序
-    std::sort(results.begin(), results.end());
-    
-    // 限制返回数量
-    if (results.size() > limit) {
-        results.resize(limit);
+    return searchIndex_.load();
+}
+
+std::vector<std::string> InstrumentManager::searchByPrefix(const std::string& prefix, size_t limit) const {
+    if (prefix.empty()) {
+        return {};
     }
-    
-    return results;
+    return getSearchIndex()->searchByPrefix(prefix, limit);
 }
 
 std::vector<std::string> InstrumentManager::getInstrumentsByProduct(const std::string& productId) const {
-    std::vector<std::string> results;
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    for (const auto& [id, inst] : instruments_) {
-        if (inst.productId == productId) {
-            results.push_back(id);
-        }
-    }
-    
-    std::sort(results.begin(), results.end());
-    return results;
+    return getSearchIndex()->byProduct(productId);
 }
 
 std::vector<std::string> InstrumentManager::getInstrumentsByExchange(const std::string& exchangeId) const {
-    std::vector<std::string> results;
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    for (const auto& [id, inst] : instruments_) {
-        if (inst.exchangeId == exchangeId) {
-            results.push_back(id);
-        }
-    }
-    
-    std::sort(results.begin(), results.end());
-    return results;
+    return getSearchIndex()->byExchange(exchangeId);
 }
 
 } // namespace fix40
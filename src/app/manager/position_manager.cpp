@@ -24,10 +24,16 @@ PositionManager::PositionManager(IStore* store)
         // 启动时从存储恢复持仓状态（用于服务端重启后持仓连续性）。
         auto positions = store_->loadAllPositions();
         std::lock_guard<std::mutex> lock(mutex_);
-        positions_.clear();
         for (const auto& position : positions) {
             if (!position.accountId.empty() && !position.instrumentId.empty()) {
-                positions_[makeKey(position.accountId, position.instrumentId)] = position;
+                const std::string key = makeKey(position.accountId, position.instrumentId);
+                auto it = positions_.find(key);
+                if (it == positions_.end()) {
+                    insertPosition(key, position);
+                } else {
+                    accountProfits_[position.accountId] += position.getTotalProfit() - it->second.getTotalProfit();
+                    it->second = position;
+                }
             }
         }
     }
@@ -52,14 +58,36 @@ std::vector<Position> PositionManager::getPositionsByAccount(const std::string&
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::vector<Position> result;
-    for (const auto& pair : positions_) {
-        if (pair.second.accountId == accountId) {
-            result.push_back(pair.second);
+    auto it = byAccount_.find(accountId);
+    if (it != byAccount_.end()) {
+        result.reserve(it->second.size());
+        for (const Position* pos : it->second) {
+            result.push_back(*pos);
         }
     }
     return result;
 }
 
+bool PositionManager::getPositionQty(const std::string& accountId, const std::string& instrumentId,
+                                     int64_t& longPosition, int64_t& shortPosition) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    longPosition = 0;
+    shortPosition = 0;
+    auto it = byAccount_.find(accountId);
+    if (it == byAccount_.end()) {
+        return false;
+    }
+    // 单个账户的持仓合约数很少，线性查找即可
+    for (const Position* pos : it->second) {
+        if (pos->instrumentId == instrumentId) {
+            longPosition = pos->longPosition;
+            shortPosition = pos->shortPosition;
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<Position> PositionManager::getAllPositions() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -103,13 +131,8 @@ void PositionManager::openPosition(const std::string& accountId,
     
     // 获取或创建持仓
     auto it = positions_.find(key);
-    if (it == positions_.end()) {
-        Position pos(accountId, instrumentId);
-        positions_[key] = pos;
-        it = positions_.find(key);
-    }
-    
-    Position& pos = it->second;
+    Position& pos = (it != positions_.end()) ? it->second
+                                             : insertPosition(key, Position(accountId, instrumentId));
     
     if (side == OrderSide::BUY) {
         // 多头开仓
@@ -156,6 +179,7 @@ double PositionManager::closePosition(const std::string& accountId,
     }
     
     Position& pos = it->second;
+    const double profitBefore = pos.getTotalProfit();
     double profit = 0.0;
     
     if (side == OrderSide::SELL) {
@@ -204,6 +228,7 @@ double PositionManager::closePosition(const std::string& accountId,
         }
     }
     
+    accountProfits_[accountId] += pos.getTotalProfit() - profitBefore;
     pos.updateTime = std::chrono::system_clock::now();
     
     // 持久化
@@ -219,12 +244,40 @@ double PositionManager::closePosition(const std::string& accountId,
 void PositionManager::updateAllProfits(const MarketDataSnapshot& snapshot, int volumeMultiple) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    for (auto& pair : positions_) {
-        if (pair.second.instrumentId == snapshot.instrumentId) {
-            pair.second.updateProfit(snapshot.lastPrice, volumeMultiple);
-            pair.second.updateTime = std::chrono::system_clock::now();
+    auto it = byInstrument_.find(snapshot.instrumentId);
+    if (it == byInstrument_.end()) {
+        return;
+    }
+    const auto now = std::chrono::system_clock::now();
+    for (const auto& entry : it->second) {
+        applyProfit(*entry.position, *entry.accountProfit, snapshot.lastPrice, volumeMultiple);
+        entry.position->updateTime = now;
+    }
+}
+
+size_t PositionManager::markToMarket(const std::string& instrumentId,
+                                     double lastPrice,
+                                     int volumeMultiple,
+                                     std::vector<AccountProfit>& affected) {
+    affected.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = byInstrument_.find(instrumentId);
+    if (it == byInstrument_.end()) {
+        return 0;
+    }
+    const auto now = std::chrono::system_clock::now();
+    for (const auto& entry : it->second) {
+        Position& pos = *entry.position;
+        if (!pos.hasPosition()) {
+            continue;
         }
+        applyProfit(pos, *entry.accountProfit, lastPrice, volumeMultiple);
+        pos.updateTime = now;
+        // 每个账户在同一合约上只有一条持仓，不会重复
+        affected.push_back(AccountProfit{pos.accountId, *entry.accountProfit});
     }
+    return affected.size();
 }
 
 double PositionManager::updateProfit(const std::string& accountId,
@@ -241,7 +294,7 @@ double PositionManager::updateProfit(const std::string& accountId,
     }
     
     Position& pos = it->second;
-    pos.updateProfit(lastPrice, volumeMultiple);
+    applyProfit(pos, accountProfits_[accountId], lastPrice, volumeMultiple);
     pos.updateTime = std::chrono::system_clock::now();
     
     return pos.getTotalProfit();
@@ -250,13 +303,8 @@ double PositionManager::updateProfit(const std::string& accountId,
 double PositionManager::getTotalProfit(const std::string& accountId) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    double total = 0.0;
-    for (const auto& pair : positions_) {
-        if (pair.second.accountId == accountId) {
-            total += pair.second.getTotalProfit();
-        }
-    }
-    return total;
+    auto it = accountProfits_.find(accountId);
+    return it != accountProfits_.end() ? it->second : 0.0;
 }
 
 // =============================================================================
@@ -266,6 +314,9 @@ double PositionManager::getTotalProfit(const std::string& accountId) const {
 void PositionManager::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     positions_.clear();
+    byInstrument_.clear();
+    byAccount_.clear();
+    accountProfits_.clear();
 }
 
 // =============================================================================
@@ -277,6 +328,23 @@ std::string PositionManager::makeKey(const std::string& accountId,
     return accountId + "_" + instrumentId;
 }
 
+Position& PositionManager::insertPosition(const std::string& key, Position position) {
+    Position& pos = positions_.emplace(key, std::move(position)).first->second;
+    double& accountProfit = accountProfits_[pos.accountId];
+    accountProfit += pos.getTotalProfit();
+    // unordered_map 的元素地址在 rehash 后保持不变，可以直接登记指针
+    byInstrument_[pos.instrumentId].push_back(IndexedPosition{&pos, &accountProfit});
+    byAccount_[pos.accountId].push_back(&pos);
+    return pos;
+}
+
+void PositionManager::applyProfit(Position& position, double& accountProfit,
+                                  double lastPrice, int volumeMultiple) {
+    const double before = position.getTotalProfit();
+    position.updateProfit(lastPrice, volumeMultiple);
+    accountProfit += position.getTotalProfit() - before;
+}
+
 void PositionManager::persistPosition(const Position& position) {
     if (!store_) return;
     // 注意：此处为 best-effort 持久化。存储失败时不抛异常，以免影响撮合主流程。
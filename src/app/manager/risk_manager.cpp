@@ -190,4 +190,65 @@ double RiskManager::calculateRequiredMargin(
     return instrument.calculateMargin(price, order.orderQty);
 }
 
+// =============================================================================
+// 快速路径
+// =============================================================================
+
+RiskDecision RiskManager::precheck(const InstrumentRiskParams& params, const RiskCheckInput& input) const {
+    const bool isBuy = input.side == OrderSide::BUY;
+    const bool isLimit = input.ordType == OrderType::LIMIT;
+    const bool isMarket = input.ordType == OrderType::MARKET;
+
+    // 买单平空头、卖单平多头
+    const int64_t closable = isBuy ? input.shortPosition : input.longPosition;
+    const bool isOpen = closable <= 0;
+
+    // 计保证金价格：市价单用涨停价（买）/跌停价（卖），未设置时用昨结算价
+    const double limitPrice = isBuy ? input.upperLimitPrice : input.lowerLimitPrice;
+    const double marketPrice = limitPrice > 0 ? limitPrice : params.preSettlementPrice;
+    const double requiredMargin = params.calculateMargin(isMarket ? marketPrice : input.price, input.orderQty);
+
+    const bool limitsSet = (input.lowerLimitPrice > 0) | (input.upperLimitPrice > 0);
+    const bool priceInRange = (input.price >= input.lowerLimitPrice) & (input.price <= input.upperLimitPrice);
+    const bool priceBad = isLimit & limitsSet & !priceInRange;
+    const bool fundsBad = isOpen & (input.available < requiredMargin);
+    const bool positionBad = !isOpen & (input.orderQty > closable);
+    const bool counterPartyBad = isMarket & !(isBuy ? input.hasAsk : input.hasBid);
+
+    RiskDecision decision;
+    decision.offsetFlag = isOpen ? OffsetFlag::OPEN : OffsetFlag::CLOSE;
+    decision.requiredMargin = isOpen ? requiredMargin : 0.0;
+    decision.reason = priceBad ? RejectReason::PRICE_OUT_OF_LIMIT
+                    : fundsBad ? RejectReason::INSUFFICIENT_FUNDS
+                    : positionBad ? RejectReason::INSUFFICIENT_POSITION
+                    : counterPartyBad ? RejectReason::NO_COUNTER_PARTY
+                    : RejectReason::NONE;
+    return decision;
+}
+
+std::string RiskManager::describeReject(const RiskDecision& decision, const RiskCheckInput& input) const {
+    std::ostringstream oss;
+    switch (decision.reason) {
+        case RejectReason::PRICE_OUT_OF_LIMIT:
+            oss << "Price out of limit: price=" << input.price
+                << ", lower=" << input.lowerLimitPrice
+                << ", upper=" << input.upperLimitPrice;
+            break;
+        case RejectReason::INSUFFICIENT_FUNDS:
+            oss << "Insufficient funds: required=" << decision.requiredMargin
+                << ", available=" << input.available;
+            break;
+        case RejectReason::INSUFFICIENT_POSITION:
+            oss << "Insufficient position: required=" << input.orderQty
+                << ", available=" << (input.side == OrderSide::BUY ? input.shortPosition : input.longPosition);
+            break;
+        case RejectReason::NO_COUNTER_PARTY:
+            oss << "No counter party: no " << (input.side == OrderSide::BUY ? "ask" : "bid") << " available";
+            break;
+        default:
+            break;
+    }
+    return oss.str();
+}
+
 } // namespace fix40
@@ -0,0 +1,373 @@
+/**
+ * @file stress_test.cpp
+ * @brief 全账户压力测试实现
+ */
+
+#include "app/manager/stress_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "base/logger.hpp"
+#include "base/thread_pool.hpp"
+
+namespace fix40 {
+
+namespace {
+
+/// 每个工作线程分到的块数（账户持仓数差异较大时均衡负载）
+constexpr size_t kChunksPerThread = 4;
+
+/**
+ * @brief 估值账户区间 [begin, end)
+ *
+ * equity 为 scenarioCount 长度的暂存区，各块独立持有。
+ */
+void evaluateAccounts(const StressSnapshot& snapshot, const StressGrid& grid,
+                      size_t begin, size_t end, StressAccountResult* results) {
+    const size_t scenarios = grid.scenarioCount();
+    std::vector<double> equity(scenarios);
+
+    for (size_t a = begin; a < end; ++a) {
+        const double base = snapshot.baseEquity[a];
+        std::fill(equity.begin(), equity.end(), base);
+
+        double* out = equity.data();
+        for (uint32_t j = snapshot.positionBegin[a]; j < snapshot.positionBegin[a + 1]; ++j) {
+            const double sensitivity = snapshot.sensitivity[j];
+            const double* shocks = grid.productShocks(snapshot.product[j]);
+            for (size_t s = 0; s < scenarios; ++s) {
+                out[s] += sensitivity * shocks[s];
+            }
+        }
+
+        StressAccountResult& result = results[a];
+        result.accountId = snapshot.accountIds[a];
+        result.equity = base;
+        result.worstEquity = base;
+        if (scenarios > 0) {
+            const size_t worst = static_cast<size_t>(
+                std::min_element(equity.begin(), equity.end()) - equity.begin());
+            result.worstEquity = equity[worst];
+            result.worstScenario = grid.scenarioName(worst);
+        }
+
+        const double margin = snapshot.usedMargin[a];
+        if (result.worstEquity > 0) {
+            result.worstRiskRatio = margin / result.worstEquity;
+        } else {
+            result.worstRiskRatio = margin > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        }
+    }
+}
+
+/// 按持仓数把账户切成至多 chunks 块，返回各块起点（末尾为账户数）
+std::vector<size_t> splitAccounts(const StressSnapshot& snapshot, size_t chunks) {
+    const size_t accounts = snapshot.accountCount();
+    std::vector<size_t> bounds{0};
+    if (accounts == 0) {
+        return bounds;
+    }
+    // 每个账户至少计 1，避免无持仓账户全部落入同一块
+    const size_t totalWork = snapshot.positionCount() + accounts;
+    const size_t target = std::max<size_t>(1, (totalWork + chunks - 1) / chunks);
+    size_t work = 0;
+    for (size_t a = 0; a < accounts; ++a) {
+        work += snapshot.positionBegin[a + 1] - snapshot.positionBegin[a] + 1;
+        if (work >= target && a + 1 < accounts) {
+            bounds.push_back(a + 1);
+            work = 0;
+        }
+    }
+    bounds.push_back(accounts);
+    return bounds;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// StressSnapshotBuilder
+// =============================================================================
+
+void StressSnapshotBuilder::addAccount(const Account& account) {
+    auto [it, inserted] = accountIndex_.try_emplace(account.accountId, accounts_.size());
+    if (inserted) {
+        accounts_.push_back(account);
+    } else {
+        accounts_[it->second] = account;
+    }
+}
+
+void StressSnapshotBuilder::addPosition(const Position& position, const std::string& productId,
+                                        int volumeMultiple, double markPrice, double limitMove) {
+    // 以标记价重新计算浮动盈亏，各账户的基准权益取自同一组价格
+    Position marked = position;
+    marked.updateProfit(markPrice, volumeMultiple);
+
+    PendingPosition pending;
+    pending.accountId = position.accountId;
+    pending.productId = productId;
+    pending.profit = marked.getTotalProfit();
+    pending.sensitivity = static_cast<double>(position.getNetPosition()) * volumeMultiple * limitMove;
+    positions_.push_back(std::move(pending));
+}
+
+StressSnapshot StressSnapshotBuilder::build() const {
+    StressSnapshot snapshot;
+    const size_t accounts = accounts_.size();
+
+    snapshot.accountIds.reserve(accounts);
+    snapshot.baseEquity.reserve(accounts);
+    snapshot.usedMargin.reserve(accounts);
+    for (const Account& account : accounts_) {
+        snapshot.accountIds.push_back(account.accountId);
+        snapshot.baseEquity.push_back(account.balance);
+        snapshot.usedMargin.push_back(account.usedMargin);
+    }
+
+    // 品种按代码排序，结果与登记顺序无关
+    for (const PendingPosition& pending : positions_) {
+        snapshot.productIds.push_back(pending.productId);
+    }
+    std::sort(snapshot.productIds.begin(), snapshot.productIds.end());
+    snapshot.productIds.erase(std::unique(snapshot.productIds.begin(), snapshot.productIds.end()),
+                              snapshot.productIds.end());
+    auto productIndex = [&snapshot](const std::string& productId) {
+        return static_cast<uint32_t>(
+            std::lower_bound(snapshot.productIds.begin(), snapshot.productIds.end(), productId) -
+            snapshot.productIds.begin());
+    };
+
+    // 计数排序：先统计每个账户的持仓数，再按账户填入
+    std::vector<size_t> owner(positions_.size(), accounts);
+    std::vector<uint32_t> counts(accounts + 1, 0);
+    for (size_t i = 0; i < positions_.size(); ++i) {
+        auto it = accountIndex_.find(positions_[i].accountId);
+        if (it == accountIndex_.end()) {
+            continue;
+        }
+        owner[i] = it->second;
+        snapshot.baseEquity[it->second] += positions_[i].profit;
+        if (positions_[i].sensitivity != 0.0) {
+            ++counts[it->second + 1];
+        }
+    }
+    snapshot.positionBegin.resize(accounts + 1);
+    for (size_t a = 0; a < accounts; ++a) {
+        counts[a + 1] += counts[a];
+        snapshot.positionBegin[a + 1] = counts[a + 1];
+    }
+
+    snapshot.product.resize(counts[accounts]);
+    snapshot.sensitivity.resize(counts[accounts]);
+    for (size_t i = 0; i < positions_.size(); ++i) {
+        if (owner[i] == accounts || positions_[i].sensitivity == 0.0) {
+            continue;
+        }
+        const uint32_t slot = counts[owner[i]]++;
+        snapshot.product[slot] = productIndex(positions_[i].productId);
+        snapshot.sensitivity[slot] = positions_[i].sensitivity;
+    }
+    return snapshot;
+}
+
+// =============================================================================
+// StressGrid
+// =============================================================================
+
+StressGrid StressGrid::limitMoves(const std::vector<std::string>& productIds, int steps) {
+    const size_t products = productIds.size();
+    const size_t moves = steps > 0 ? static_cast<size_t>(steps) : 0;
+    const size_t scenarios = 1 + 2 * moves * (1 + products);
+
+    StressGrid grid(products);
+    grid.names_.reserve(scenarios);
+    grid.shocks_.assign(products * scenarios, 0.0);
+
+    auto add = [&grid, scenarios](const std::string& name, size_t product, double shock) {
+        const size_t s = grid.names_.size();
+        grid.names_.push_back(name);
+        if (product == grid.productCount_) {
+            for (size_t p = 0; p < grid.productCount_; ++p) {
+                grid.shocks_[p * scenarios + s] = shock;
+            }
+        } else {
+            grid.shocks_[product * scenarios + s] = shock;
+        }
+    };
+
+    add("base", products, 0.0);
+    for (size_t k = 1; k <= moves; ++k) {
+        add("ALL+" + std::to_string(k), products, static_cast<double>(k));
+        add("ALL-" + std::to_string(k), products, -static_cast<double>(k));
+    }
+    for (size_t p = 0; p < products; ++p) {
+        for (size_t k = 1; k <= moves; ++k) {
+            add(productIds[p] + "+" + std::to_string(k), p, static_cast<double>(k));
+            add(productIds[p] + "-" + std::to_string(k), p, -static_cast<double>(k));
+        }
+    }
+    return grid;
+}
+
+void StressGrid::addScenario(const std::string& name, const std::vector<double>& shocks) {
+    if (shocks.size() != productCount_) {
+        throw std::invalid_argument("scenario " + name + " has " + std::to_string(shocks.size()) +
+                                    " shocks, expected " + std::to_string(productCount_));
+    }
+    // 按品种连续存放：从最后一个品种开始在各自区间末尾插入
+    const size_t scenarios = names_.size();
+    for (size_t p = productCount_; p-- > 0;) {
+        shocks_.insert(shocks_.begin() + static_cast<std::ptrdiff_t>((p + 1) * scenarios), shocks[p]);
+    }
+    names_.push_back(name);
+}
+
+// =============================================================================
+// 结果格式化
+// =============================================================================
+
+std::string format_stress_result(const StressAccountResult& result) {
+    std::ostringstream out;
+    out << "account=" << result.accountId
+        << std::fixed << std::setprecision(2)
+        << " equity=" << result.equity
+        << " worst_equity=" << result.worstEquity
+        << std::setprecision(4)
+        << " worst_risk=" << result.worstRiskRatio
+        << " scenario=" << result.worstScenario;
+    return out.str();
+}
+
+// =============================================================================
+// StressTestEngine
+// =============================================================================
+
+StressTestEngine::StressTestEngine(size_t threads)
+    : threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+StressTestEngine::~StressTestEngine() {
+    stop();
+}
+
+ThreadPool* StressTestEngine::workers() {
+    if (threads_ <= 1) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workers_ && !stopped_) {
+        workers_ = std::make_unique<ThreadPool>(threads_);
+    }
+    return workers_.get();
+}
+
+StressReport StressTestEngine::run(const StressSnapshot& snapshot, const StressGrid& grid) {
+    if (grid.productCount() != snapshot.productIds.size()) {
+        throw std::invalid_argument("stress grid has " + std::to_string(grid.productCount()) +
+                                    " products, snapshot has " +
+                                    std::to_string(snapshot.productIds.size()));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    StressReport report;
+    report.scenarioCount = grid.scenarioCount();
+    report.positionCount = snapshot.positionCount();
+    report.accounts.resize(snapshot.accountCount());
+
+    ThreadPool* pool = workers();
+    const std::vector<size_t> bounds = splitAccounts(snapshot, pool ? threads_ * kChunksPerThread : 1);
+    StressAccountResult* results = report.accounts.data();
+
+    if (!pool || bounds.size() <= 2) {
+        evaluateAccounts(snapshot, grid, 0, snapshot.accountCount(), results);
+    } else {
+        std::vector<std::future<void>> chunks;
+        chunks.reserve(bounds.size() - 1);
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            const size_t begin = bounds[i];
+            const size_t end = bounds[i + 1];
+            chunks.push_back(pool->enqueue([&snapshot, &grid, begin, end, results]() {
+                evaluateAccounts(snapshot, grid, begin, end, results);
+            }));
+        }
+        for (auto& chunk : chunks) {
+            chunk.get();
+        }
+    }
+
+    // 风险最高的账户排在前面
+    std::sort(report.accounts.begin(), report.accounts.end(),
+              [](const StressAccountResult& a, const StressAccountResult& b) {
+                  if (a.worstRiskRatio != b.worstRiskRatio) {
+                      return a.worstRiskRatio > b.worstRiskRatio;
+                  }
+                  if (a.worstEquity != b.worstEquity) {
+                      return a.worstEquity < b.worstEquity;
+                  }
+                  return a.accountId < b.accountId;
+              });
+
+    report.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+bool StressTestEngine::submit(std::shared_ptr<const StressSnapshot> snapshot, int steps, Callback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        LOG() << "[StressTest] Engine stopped, dropping request";
+        return false;
+    }
+    if (!coordinator_) {
+        coordinator_ = std::make_unique<ThreadPool>(1);
+    }
+    coordinator_->enqueue_to(0, [this, snapshot = std::move(snapshot), steps, callback = std::move(callback)]() {
+        StressReport report;
+        try {
+            const StressGrid grid = StressGrid::limitMoves(snapshot->productIds, steps);
+            report = run(*snapshot, grid);
+            LOG() << "[StressTest] " << report.accounts.size() << " accounts, "
+                  << report.positionCount << " positions, " << report.scenarioCount
+                  << " scenarios in " << report.elapsedMs << " ms";
+        } catch (const std::exception& e) {
+            LOG() << "[StressTest] Exception running stress test: " << e.what();
+            report = StressReport();
+            report.error = e.what();
+        }
+        if (!callback) {
+            return;
+        }
+        try {
+            callback(report);
+        } catch (const std::exception& e) {
+            LOG() << "[StressTest] Exception in stress test callback: " << e.what();
+        } catch (...) {
+            LOG() << "[StressTest] Unknown exception in stress test callback";
+        }
+    });
+    return true;
+}
+
+void StressTestEngine::stop() {
+    std::unique_ptr<ThreadPool> coordinator;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        coordinator = std::move(coordinator_);
+    }
+    // 先排空调度线程（排队的任务仍使用工作线程池），再停止工作线程
+    coordinator.reset();
+
+    std::unique_ptr<ThreadPool> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers = std::move(workers_);
+    }
+}
+
+} // namespace fix40
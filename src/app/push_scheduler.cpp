@@ -0,0 +1,115 @@
+/**
+ * @file push_scheduler.cpp
+ * @brief 账户/持仓推送调度器实现
+ */
+
+#include "app/push_scheduler.hpp"
+
+namespace fix40 {
+
+PushScheduler::PushScheduler(std::chrono::milliseconds interval)
+    : interval_(interval)
+{}
+
+void PushScheduler::setInterval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval_ = interval;
+}
+
+std::chrono::milliseconds PushScheduler::interval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(interval_);
+}
+
+bool PushScheduler::requestAccount(const std::string& accountId, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.accountRequests;
+    return request(accounts_[accountId].account, now, stats_.accountPushes, stats_.accountSuppressed);
+}
+
+bool PushScheduler::requestPosition(const std::string& accountId, const std::string& instrumentId,
+                                    Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.positionRequests;
+    return request(accounts_[accountId].positions[instrumentId], now,
+                   stats_.positionPushes, stats_.positionSuppressed);
+}
+
+void PushScheduler::sentAccount(const std::string& accountId, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent(accounts_[accountId].account, now, stats_.accountPushes, stats_.accountSuppressed);
+}
+
+void PushScheduler::sentPosition(const std::string& accountId, const std::string& instrumentId,
+                                 Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent(accounts_[accountId].positions[instrumentId], now, stats_.positionPushes, stats_.positionSuppressed);
+}
+
+void PushScheduler::collectDue(Clock::time_point now,
+                               std::vector<std::string>& accounts,
+                               std::vector<PositionKey>& positions) {
+    accounts.clear();
+    positions.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ == 0) {
+        return;
+    }
+    for (auto& [accountId, slots] : accounts_) {
+        if (slots.account.dirty && due(slots.account, now)) {
+            slots.account.dirty = false;
+            slots.account.lastSent = now;
+            --pending_;
+            ++stats_.accountPushes;
+            accounts.push_back(accountId);
+        }
+        for (auto& [instrumentId, slot] : slots.positions) {
+            if (slot.dirty && due(slot, now)) {
+                slot.dirty = false;
+                slot.lastSent = now;
+                --pending_;
+                ++stats_.positionPushes;
+                positions.emplace_back(accountId, instrumentId);
+            }
+        }
+    }
+}
+
+size_t PushScheduler::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+PushScheduler::Stats PushScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool PushScheduler::request(Slot& slot, Clock::time_point now, uint64_t& pushes, uint64_t& suppressed) {
+    if (!slot.dirty && due(slot, now)) {
+        slot.lastSent = now;
+        slot.sentOnce = true;
+        ++pushes;
+        return true;
+    }
+    if (slot.dirty) {
+        ++suppressed;  // 合并进已在等待的补发
+    } else {
+        slot.dirty = true;
+        ++pending_;
+    }
+    return false;
+}
+
+void PushScheduler::sent(Slot& slot, Clock::time_point now, uint64_t& pushes, uint64_t& suppressed) {
+    if (slot.dirty) {
+        slot.dirty = false;
+        --pending_;
+        ++suppressed;  // 待补发的行情推送被这次推送覆盖
+    }
+    slot.lastSent = now;
+    slot.sentOnce = true;
+    ++pushes;
+}
+
+} // namespace fix40
@@ -14,13 +14,15 @@
 #include "fix/fix_message_builder.hpp"
 #include "fix/fix_tags.hpp"
 #include "base/logger.hpp"
+#include "base/config.hpp"
 #include "storage/store.hpp"
 #include <cstdlib>
 #include <sstream>
 #include <iomanip>
-#include <set>
 #include <optional>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 namespace fix40 {
 
@@ -30,6 +32,25 @@ namespace fix40 {
 
 namespace {
 
+/**
+ * @brief 读取撮合引擎分片数（config.ini [matching_engine] shards，默认 1）
+ */
+size_t configuredEngineShards() {
+    const int shards = Config::instance().get_int("matching_engine", "shards", 1);
+    return shards > 0 ? static_cast<size_t>(shards) : 1;
+}
+
+/**
+ * @brief 读取压力测试工作线程数（config.ini [stress] threads，0 表示 CPU 核数）
+ */
+size_t configuredStressThreads() {
+    const int threads = Config::instance().get_int("stress", "threads", 0);
+    return threads > 0 ? static_cast<size_t>(threads) : 0;
+}
+
+/// U13 冲击档数上限（情景数随档数 × 品种数线性增长）
+constexpr int kMaxShockSteps = 10;
+
 /**
  * @brief 将系统时间转换为 epoch 毫秒时间戳
  */
@@ -37,6 +58,15 @@ int64_t to_epoch_millis(std::chrono::system_clock::time_point tp) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
 }
 
+/**
+ * @brief 按两位小数格式化金额/价格（与 std::fixed + setprecision(2) 输出一致）
+ */
+std::string formatFixed2(double value) {
+    char buf[64];
+    const int len = std::snprintf(buf, sizeof(buf), "%.2f", value);
+    return std::string(buf, len > 0 ? static_cast<size_t>(len) : 0);
+}
+
 /**
  * @brief 解析结果
  */
@@ -177,14 +207,18 @@ CancelRequest parseCancelRequest(const FixMessage& msg, const SessionID& session
 // ============================================================================
 
 SimulationApp::SimulationApp()
-    : store_(nullptr) {
+    : engine_(configuredEngineShards())
+    , store_(nullptr)
+    , stressEngine_(configuredStressThreads()) {
     initializeManagers();
 }
 
 SimulationApp::SimulationApp(IStore* store)
-    : accountManager_(store)
+    : engine_(configuredEngineShards())
+    , accountManager_(store)
     , positionManager_(store)
-    , store_(store) {
+    , store_(store)
+    , stressEngine_(configuredStressThreads()) {
     initializeManagers();
 }
 
@@ -192,30 +226,135 @@ void SimulationApp::initializeManagers() {
     // 撮合引擎只负责撮合与订单状态推进；账户/持仓/风控等业务权威逻辑由 SimulationApp 负责。
     // 撮合引擎仅需要合约信息用于行情驱动撮合相关的辅助更新（如涨跌停价格）。
     engine_.setInstrumentManager(&instrumentManager_);
+
+    // 账户/持仓状态由单一线程持有（0 表示各线程直接访问管理器）
+    setSingleWriterMode(Config::instance().get_int("account", "single_writer", 0) != 0);
+
+    // 行情触发的 U5/U6 按间隔合并推送（0 表示每跳都推送）
+    pushScheduler_.setInterval(std::chrono::milliseconds(
+        std::max(0, Config::instance().get_int("push", "interval_ms", 0))));
+
+    // 行情驱动的浮动盈亏变化按间隔批量持久化
+    profitPersistIntervalMs_ = std::max(0, Config::instance().get_int("storage", "profit_persist_interval_ms", 1000));
+
+    // 行情积压时按合约合并（0 表示关闭）
+    const int conflationThreshold = Config::instance().get_int("matching_engine", "conflation_threshold", 0);
+    engine_.setConflationThreshold(conflationThreshold > 0 ? static_cast<size_t>(conflationThreshold) : 0);
+
+    // 管理员名单只在启动时解析一次：admin_users = alice, bob
+    std::istringstream admins(Config::instance().get("stats", "admin_users", ""));
+    std::string name;
+    while (std::getline(admins, name, ',')) {
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (!name.empty()) {
+            adminUsers_.insert(name);
+        }
+    }
+
+    // 分片模式下可将热门合约固定到指定分片：pinned_instruments = IF2601:0, IC2601:1
+    if (engine_.getShardCount() > 1) {
+        std::istringstream pins(Config::instance().get("matching_engine", "pinned_instruments", ""));
+        std::string entry;
+        while (std::getline(pins, entry, ',')) {
+            const auto colon = entry.find(':');
+            if (colon == std::string::npos) continue;
+            std::string symbol = entry.substr(0, colon);
+            symbol.erase(0, symbol.find_first_not_of(" \t"));
+            symbol.erase(symbol.find_last_not_of(" \t") + 1);
+            const int shard = std::atoi(entry.c_str() + colon + 1);
+            if (!symbol.empty() && shard >= 0) {
+                engine_.pinInstrument(symbol, static_cast<size_t>(shard));
+            }
+        }
+    }
     
-    // 设置 ExecutionReport 回调
+    // 设置 ExecutionReport 回调（终态回报由 applyExecutionReport 释放订单槽位）
     engine_.setExecutionReportCallback(
         [this](const SessionID& sid, const ExecutionReport& rpt) {
             onExecutionReport(sid, rpt);
-        });
+        },
+        true);
     
     // 设置行情更新回调（用于账户价值重算和推送）
     engine_.setMarketDataUpdateCallback(
         [this](const std::string& instrumentId, double lastPrice) {
-            onMarketDataUpdate(instrumentId, lastPrice);
+            runOnAccountThread([this, instrumentId, lastPrice]() {
+                onMarketDataUpdate(instrumentId, lastPrice);
+            });
         });
 }
 
+void SimulationApp::setSingleWriterMode(bool enabled) {
+    if (enabled && !actor_) {
+        actor_ = std::make_unique<AccountActor>([this]() { publishTouchedViews(); });
+    } else if (!enabled && actor_) {
+        actor_->stop();
+        actor_.reset();
+    }
+}
+
 SimulationApp::~SimulationApp() {
     stop();
 }
 
 void SimulationApp::start() {
+    // 输入日志在启动时才打开：重放工具构造 SimulationApp 但不启动，不会截断同名日志
+    const std::string journalPath = Config::instance().get("matching_engine", "journal_path", "");
+    if (!journalPath.empty() && !journal_) {
+        journal_ = std::make_unique<EngineJournal>();
+        if (journal_->open(journalPath, engine_.getShardCount())) {
+            engine_.setJournal(journal_.get());
+        } else {
+            journal_.reset();
+        }
+    }
+    if (actor_) {
+        // 启动前发布已有账户（含从存储恢复的账户）的视图，查询无需等待首次变动
+        runOnAccountThread([this]() {
+            for (const auto& accountId : accountManager_.getAllAccountIds()) {
+                touchAccount(accountId);
+            }
+        });
+        actor_->start();
+    }
     engine_.start();
+
+    const bool timedPersist = store_ && profitPersistIntervalMs_ > 0;
+    if ((pushScheduler_.interval().count() > 0 || timedPersist) && !timerThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            timerStopping_ = false;
+        }
+        timerThread_ = std::thread([this]() { timerLoop(); });
+    }
 }
 
 void SimulationApp::stop() {
     engine_.stop();
+    if (timerThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            timerStopping_ = true;
+        }
+        timerCv_.notify_all();
+        timerThread_.join();
+    }
+    if (pushScheduler_.interval().count() > 0) {
+        const PushScheduler::Stats stats = pushScheduler_.stats();
+        LOG() << "[SimulationApp] Push stats: U5 " << stats.accountPushes << " sent / "
+              << stats.accountSuppressed << " suppressed, U6 " << stats.positionPushes << " sent / "
+              << stats.positionSuppressed << " suppressed";
+    }
+    if (actor_) {
+        actor_->stop();
+    }
+    // 账户线程已停止，不会再有新的压力测试提交
+    stressEngine_.stop();
+    accountManager_.flushDirty();
+    if (journal_) {
+        journal_->flush();
+    }
 }
 
 void SimulationApp::onLogon(const SessionID& sessionID) {
@@ -233,10 +372,13 @@ void SimulationApp::onLogon(const SessionID& sessionID) {
           << " -> User: " << userId;
     
     // 自动开户：如果该用户不存在，初始化一个带初始资金的账户
-    if (!accountManager_.hasAccount(userId)) {
-        LOG() << "[SimulationApp] Initializing new account for user: " << userId;
-        accountManager_.createAccount(userId, 1000000.0);  // 默认 100 万
-    }
+    runOnAccountThread([this, userId]() {
+        if (!accountManager_.hasAccount(userId)) {
+            LOG() << "[SimulationApp] Initializing new account for user: " << userId;
+            accountManager_.createAccount(userId, 1000000.0);  // 默认 100 万
+        }
+        touchAccount(userId);
+    });
     
     engine_.submit(OrderEvent{OrderEventType::SESSION_LOGON, sessionID});
 }
@@ -287,6 +429,14 @@ void SimulationApp::fromApp(const FixMessage& msg, const SessionID& sessionID) {
         // OrderHistoryQueryRequest - 订单历史查询（自定义）
         handleOrderHistoryQuery(msg, sessionID, userId);
     }
+    else if (msgType == "U11") {
+        // SessionStatsRequest - 会话统计查询（自定义）
+        handleSessionStatsQuery(msg, sessionID, userId);
+    }
+    else if (msgType == "U13") {
+        // StressTestRequest - 压力测试（自定义，仅管理员）
+        handleStressTestRequest(msg, sessionID, userId);
+    }
     else {
         // 未知消息类型
         LOG() << "[SimulationApp] Unknown message type: " << msgType;
@@ -347,17 +497,17 @@ void SimulationApp::onExecutionReport(const SessionID& sessionID, const Executio
         }
     }
     
-    // 获取账户ID
-    std::string accountId;
-    {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        auto it = orderAccountMap_.find(report.clOrdID);
-        if (it != orderAccountMap_.end()) {
-            accountId = it->second;
-        } else {
-            accountId = extractAccountId(sessionID);
-        }
-    }
+    // 账户/持仓更新及回报发送在账户线程上执行（保证客户端收到回报时资金已更新）
+    runOnAccountThread([this, sessionID, report]() {
+        applyExecutionReport(sessionID, report);
+    });
+}
+
+void SimulationApp::applyExecutionReport(const SessionID& sessionID, const ExecutionReport& report) {
+    // 获取账户ID：引擎回报携带订单号时直接取槽位，否则（前置拒绝、撤单拒绝）按会话识别
+    const std::string accountId = report.orderRef != kNoOrderRef
+        ? engine_.orderTable().at(report.orderRef).accountId
+        : extractAccountId(sessionID);
     
     // 根据订单状态处理账户和持仓更新
     switch (report.ordStatus) {
@@ -377,15 +527,18 @@ void SimulationApp::onExecutionReport(const SessionID& sessionID, const Executio
             break;
     }
     
-    // 清理已完成订单的映射
-    if (report.ordStatus == OrderStatus::FILLED ||
-        report.ordStatus == OrderStatus::REJECTED ||
-        report.ordStatus == OrderStatus::CANCELED) {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        orderAccountMap_.erase(report.clOrdID);
-        orderMarginInfoMap_.erase(report.clOrdID);
+    // 已完成订单：释放上层对订单槽位的持有（accountId 已复制，之后不再访问槽位）
+    if (report.orderRef != kNoOrderRef &&
+        (report.ordStatus == OrderStatus::FILLED ||
+         report.ordStatus == OrderStatus::REJECTED ||
+         report.ordStatus == OrderStatus::CANCELED)) {
+        engine_.orderTable().release(report.orderRef);
     }
     
+    // 回报发出前发布最新视图：客户端收到回报后立即查询也能看到成交后的资金
+    touchAccount(accountId);
+    publishTouchedViews();
+    
     // 将 ExecutionReport 转换为 FIX 消息
     FixMessage msg = buildExecutionReport(report);
     
@@ -397,12 +550,14 @@ void SimulationApp::onExecutionReport(const SessionID& sessionID, const Executio
 }
 
 void SimulationApp::handleFill(const std::string& accountId, const ExecutionReport& report) {
-    // 获取合约信息
-    const Instrument* instrument = instrumentManager_.getInstrument(report.symbol);
-    if (!instrument) {
+    // 获取合约静态信息（只用到合约乘数、保证金率，直接引用合约表条目，不复制）
+    const auto instruments = instrumentManager_.getTable();
+    const InstrumentEntry* entry = instruments->find(report.symbol);
+    if (!entry) {
         LOG() << "[SimulationApp] handleFill: Instrument not found: " << report.symbol;
         return;
     }
+    const Instrument* instrument = &entry->info;
     
     // 获取持仓信息
     Position position;
@@ -457,13 +612,9 @@ void SimulationApp::handleFill(const std::string& accountId, const ExecutionRepo
         
         // 获取冻结的保证金（使用原始总量计算，避免部分成交累计误差）
         double frozenMargin = 0.0;
-        {
-            std::lock_guard<std::mutex> lock(mapMutex_);
-            auto it = orderMarginInfoMap_.find(report.clOrdID);
-            if (it != orderMarginInfoMap_.end()) {
-                // 使用原始总冻结保证金按比例计算，避免累计误差
-                frozenMargin = it->second.calculateReleaseAmount(openQty);
-            }
+        if (report.orderRef != kNoOrderRef) {
+            // 使用原始总冻结保证金按比例计算，避免累计误差
+            frozenMargin = engine_.orderTable().at(report.orderRef).margin.calculateReleaseAmount(openQty);
         }
         
         // 冻结转占用
@@ -488,20 +639,20 @@ void SimulationApp::handleFill(const std::string& accountId, const ExecutionRepo
     const double totalProfit = positionManager_.getTotalProfit(accountId);
     accountManager_.updatePositionProfit(accountId, totalProfit);
 
+    // 成交推送不限频，同时覆盖尚未补发的行情推送
+    const auto now = PushScheduler::Clock::now();
     pushAccountUpdate(accountId, 2);
+    pushScheduler_.sentAccount(accountId, now);
     pushPositionUpdate(accountId, report.symbol, 2);
+    pushScheduler_.sentPosition(accountId, report.symbol, now);
 }
 
 void SimulationApp::handleReject(const std::string& accountId, const ExecutionReport& report) {
     // 释放全部冻结的保证金（拒绝时释放原始总冻结金额）
     double frozenMargin = 0.0;
-    {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        auto it = orderMarginInfoMap_.find(report.clOrdID);
-        if (it != orderMarginInfoMap_.end()) {
-            // 拒绝时释放全部原始冻结保证金
-            frozenMargin = it->second.originalFrozenMargin;
-        }
+    if (report.orderRef != kNoOrderRef) {
+        // 拒绝时释放全部原始冻结保证金
+        frozenMargin = engine_.orderTable().at(report.orderRef).margin.originalFrozenMargin;
     }
     
     if (frozenMargin > 0) {
@@ -513,13 +664,9 @@ void SimulationApp::handleReject(const std::string& accountId, const ExecutionRe
 void SimulationApp::handleCancel(const std::string& accountId, const ExecutionReport& report) {
     // 释放剩余未释放的冻结保证金（撤单时只释放未成交部分）
     double frozenMargin = 0.0;
-    {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        auto it = orderMarginInfoMap_.find(report.clOrdID);
-        if (it != orderMarginInfoMap_.end()) {
-            // 撤单时释放剩余未释放的冻结保证金
-            frozenMargin = it->second.getRemainingFrozen();
-        }
+    if (report.orderRef != kNoOrderRef) {
+        // 撤单时释放剩余未释放的冻结保证金
+        frozenMargin = engine_.orderTable().at(report.orderRef).margin.getRemainingFrozen();
     }
     
     if (frozenMargin > 0) {
@@ -589,13 +736,20 @@ void SimulationApp::handleNewOrderSingle(const FixMessage& msg, const SessionID&
     
     // 关键：使用从 Session 提取的 userId，而非消息体中的 Account 字段
     // 这是安全路由的核心 - 防止用户伪造账户ID
-    
+    runOnAccountThread([this, order = std::move(order), sessionID, userId]() mutable {
+        processNewOrder(std::move(order), sessionID, userId);
+    });
+}
+
+void SimulationApp::processNewOrder(Order order, const SessionID& sessionID, const std::string& userId) {
     // 确保账户存在
     getOrCreateAccount(userId);
+    touchAccount(userId);
     
-    // 获取合约信息
-    const Instrument* instrument = instrumentManager_.getInstrument(order.symbol);
-    if (!instrument) {
+    // 获取合约风控参数（写入方预先发布的参数表，下单线程不重建、不复制 Instrument）
+    const auto riskParams = instrumentManager_.getRiskParams();
+    const InstrumentRiskParams* params = riskParams ? riskParams->find(order.symbol) : nullptr;
+    if (!params) {
         LOG() << "[SimulationApp] Instrument not found: " << order.symbol;
         ExecutionReport reject;
         reject.clOrdID = order.clOrdID;
@@ -613,47 +767,39 @@ void SimulationApp::handleNewOrderSingle(const FixMessage& msg, const SessionID&
         return;
     }
     
-    // 获取账户和持仓信息
-    auto accountOpt = accountManager_.getAccount(userId);
-    if (!accountOpt) {
+    // 风控输入：只取检查用到的标量
+    RiskCheckInput input;
+    input.side = order.side;
+    input.ordType = order.ordType;
+    input.price = order.price;
+    input.orderQty = order.orderQty;
+    
+    auto available = accountManager_.getAvailable(userId);
+    if (!available) {
         LOG() << "[SimulationApp] Account not found: " << userId;
         return;
     }
+    input.available = *available;
+    positionManager_.getPositionQty(userId, order.symbol, input.longPosition, input.shortPosition);
     
-    Position position;
-    auto posOpt = positionManager_.getPosition(userId, order.symbol);
-    if (posOpt) {
-        position = *posOpt;
-    } else {
-        position.accountId = userId;
-        position.instrumentId = order.symbol;
+    // 涨跌停价与对手盘取自行情快照；尚无行情时使用合约的涨跌停价
+    if (auto snapshot = engine_.getMarketSnapshot(order.symbol)) {
+        input.upperLimitPrice = snapshot->upperLimitPrice;
+        input.lowerLimitPrice = snapshot->lowerLimitPrice;
+        input.hasBid = snapshot->hasBid();
+        input.hasAsk = snapshot->hasAsk();
+    } else if (auto prices = instrumentManager_.getPrices(order.symbol)) {
+        input.upperLimitPrice = prices->upperLimitPrice;
+        input.lowerLimitPrice = prices->lowerLimitPrice;
     }
     
-    // 获取行情快照
-    MarketDataSnapshot snapshot;
-    const MarketDataSnapshot* snapshotPtr = engine_.getMarketSnapshot(order.symbol);
-    if (snapshotPtr) {
-        snapshot = *snapshotPtr;
-    } else {
-        snapshot.instrumentId = order.symbol;
-        snapshot.upperLimitPrice = instrument->upperLimitPrice;
-        snapshot.lowerLimitPrice = instrument->lowerLimitPrice;
-    }
-    
-    // 判断开平标志
-    OffsetFlag offsetFlag = OffsetFlag::OPEN;
-    if (order.side == OrderSide::BUY && position.shortPosition > 0) {
-        offsetFlag = OffsetFlag::CLOSE;
-    } else if (order.side == OrderSide::SELL && position.longPosition > 0) {
-        offsetFlag = OffsetFlag::CLOSE;
-    }
+    // 风控检查（开平标志由持仓推断）；拒绝文本只在真正拒绝时生成
+    const RiskDecision decision = riskManager_.precheck(*params, input);
+    const OffsetFlag offsetFlag = decision.offsetFlag;
     
-    // 风控检查
-    CheckResult checkResult = riskManager_.checkOrder(
-        order, *accountOpt, position, *instrument, snapshot, offsetFlag);
-    
-    if (!checkResult.passed) {
-        LOG() << "[SimulationApp] Risk check failed: " << checkResult.rejectText;
+    if (!decision.passed()) {
+        const std::string rejectText = riskManager_.describeReject(decision, input);
+        LOG() << "[SimulationApp] Risk check failed: " << rejectText;
         ExecutionReport reject;
         reject.clOrdID = order.clOrdID;
         reject.symbol = order.symbol;
@@ -663,16 +809,17 @@ void SimulationApp::handleNewOrderSingle(const FixMessage& msg, const SessionID&
         reject.price = order.price;
         reject.ordStatus = OrderStatus::REJECTED;
         reject.execTransType = ExecTransType::NEW;
-        reject.ordRejReason = static_cast<int>(checkResult.rejectReason);
-        reject.text = checkResult.rejectText;
+        reject.ordRejReason = static_cast<int>(decision.reason);
+        reject.text = rejectText;
         reject.transactTime = std::chrono::system_clock::now();
         onExecutionReport(sessionID, reject);
         return;
     }
     
     // 开仓订单：冻结保证金
+    double requiredMargin = 0.0;
     if (offsetFlag == OffsetFlag::OPEN) {
-        double requiredMargin = riskManager_.calculateRequiredMargin(order, *instrument);
+        requiredMargin = decision.requiredMargin;
         if (!accountManager_.freezeMargin(userId, requiredMargin)) {
             LOG() << "[SimulationApp] Failed to freeze margin: " << requiredMargin;
             ExecutionReport reject;
@@ -690,17 +837,31 @@ void SimulationApp::handleNewOrderSingle(const FixMessage& msg, const SessionID&
             onExecutionReport(sessionID, reject);
             return;
         }
-        
-        {
-            std::lock_guard<std::mutex> lock(mapMutex_);
-            orderMarginInfoMap_[order.clOrdID] = OrderMarginInfo(requiredMargin, order.orderQty);
-        }
     }
     
-    // 记录订单到账户的映射
-    {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        orderAccountMap_[order.clOrdID] = userId;
+    // 分配订单槽位（上层与引擎各持有一份），记录所属账户与冻结保证金
+    order.orderRef = engine_.orderTable().allocate(order.clOrdID, userId, order.symbol, sessionID, 2);
+    if (order.orderRef == kNoOrderRef) {
+        LOG() << "[SimulationApp] Order table full, rejecting " << order.clOrdID;
+        if (requiredMargin > 0) {
+            accountManager_.unfreezeMargin(userId, requiredMargin);
+        }
+        ExecutionReport reject;
+        reject.clOrdID = order.clOrdID;
+        reject.symbol = order.symbol;
+        reject.side = order.side;
+        reject.ordType = order.ordType;
+        reject.orderQty = order.orderQty;
+        reject.price = order.price;
+        reject.ordStatus = OrderStatus::REJECTED;
+        reject.execTransType = ExecTransType::NEW;
+        reject.text = "Order table full";
+        reject.transactTime = std::chrono::system_clock::now();
+        onExecutionReport(sessionID, reject);
+        return;
+    }
+    if (offsetFlag == OffsetFlag::OPEN) {
+        engine_.orderTable().at(order.orderRef).margin = OrderMarginInfo(requiredMargin, order.orderQty);
     }
     
     // 提交到撮合引擎（传入真实的用户ID）
@@ -710,31 +871,28 @@ void SimulationApp::handleNewOrderSingle(const FixMessage& msg, const SessionID&
 void SimulationApp::handleOrderCancelRequest(const FixMessage& msg, const SessionID& sessionID, const std::string& userId) {
     CancelRequest req = parseCancelRequest(msg, sessionID);
     
-    // 安全检查：验证撤单请求是否属于当前用户
-    {
-        std::lock_guard<std::mutex> lock(mapMutex_);
-        auto it = orderAccountMap_.find(req.origClOrdID);
-        if (it == orderAccountMap_.end()) {
-            LOG() << "[SimulationApp] Cancel rejected: order " << req.origClOrdID << " not found";
+    // 订单映射归账户线程所有；与新订单同一队列，保证先报单后撤单的顺序
+    runOnAccountThread([this, req = std::move(req), sessionID, userId]() mutable {
+        // 只在当前用户自己的订单中查找，其它账户同 clOrdID 的订单不可见
+        std::string symbol;
+        req.origOrderRef = engine_.orderTable().find(userId, req.origClOrdID, &symbol);
+        if (req.origOrderRef == kNoOrderRef) {
+            LOG() << "[SimulationApp] Cancel rejected: order " << req.origClOrdID << " not found for " << userId;
             sendBusinessReject(sessionID, "F", "Order not found: " + req.origClOrdID);
             return;
         }
-        if (it->second != userId) {
-            LOG() << "[SimulationApp] Cancel rejected: order " << req.origClOrdID 
-                  << " belongs to " << it->second << ", not " << userId;
-            sendBusinessReject(sessionID, "F", "Not authorized to cancel this order");
-            return;
-        }
-    }
-    
-    engine_.submit(OrderEvent::cancelRequest(req, userId));
+        
+        // 撤单按原订单的合约路由到持有它的分片（不信任请求中的 Symbol），携带原订单号按下标定位挂单
+        req.symbol = symbol;
+        engine_.submit(OrderEvent::cancelRequest(req, userId));
+    });
 }
 
 void SimulationApp::handleBalanceQuery(const FixMessage& msg, const SessionID& sessionID, const std::string& userId) {
     LOG() << "[SimulationApp] Processing balance query for user: " << userId;
     
     // 查询账户数据
-    auto accountOpt = accountManager_.getAccount(userId);
+    auto accountOpt = queryAccount(userId);
     if (!accountOpt) {
         LOG() << "[SimulationApp] Account not found for balance query: " << userId;
         sendBusinessReject(sessionID, "U1", "Account not found");
@@ -798,7 +956,7 @@ void SimulationApp::handlePositionQuery(const FixMessage& msg, const SessionID&
     LOG() << "[SimulationApp] Processing position query for user: " << userId;
     
     // 获取用户的所有持仓
-    auto positions = positionManager_.getPositionsByAccount(userId);
+    auto positions = queryPositions(userId);
     
     // 构造 U4 响应消息 (PositionQueryResponse)
     FixMessage response;
@@ -855,41 +1013,130 @@ void SimulationApp::sendBusinessReject(const SessionID& sessionID, const std::st
 // ============================================================================
 
 void SimulationApp::onMarketDataUpdate(const std::string& instrumentId, double lastPrice) {
-    // 获取合约信息
-    const Instrument* instrument = instrumentManager_.getInstrument(instrumentId);
-    if (!instrument) {
+    // 获取合约静态信息（只用到合约乘数，直接引用合约表条目，不复制）
+    const auto instruments = instrumentManager_.getTable();
+    const InstrumentEntry* entry = instruments->find(instrumentId);
+    if (!entry) {
         return;
     }
+    const Instrument* instrument = &entry->info;
     
-    // 获取该合约的所有持仓
-    auto allPositions = positionManager_.getAllPositions();
-    
-    // 收集受影响的账户
-    std::set<std::string> affectedAccounts;
+    // 只盯市该合约的持仓，账户总盈亏由 PositionManager 增量汇总
+    std::vector<PositionManager::AccountProfit> affected;
+    positionManager_.markToMarket(instrumentId, lastPrice, instrument->volumeMultiple, affected);
     
-    for (const auto& pos : allPositions) {
-        if (pos.instrumentId == instrumentId && pos.hasPosition()) {
-            // 更新持仓浮动盈亏
-            double newProfit = positionManager_.updateProfit(
-                pos.accountId, instrumentId, lastPrice, instrument->volumeMultiple);
-            
-            affectedAccounts.insert(pos.accountId);
-            
-            LOG() << "[SimulationApp] Updated position profit for " << pos.accountId
-                  << " " << instrumentId << " profit=" << newProfit;
-        }
-    }
-    
-    // 更新受影响账户的持仓盈亏总额，并推送给 Client
-    for (const auto& accountId : affectedAccounts) {
-        double totalProfit = positionManager_.getTotalProfit(accountId);
-        accountManager_.updatePositionProfit(accountId, totalProfit);
+    // 更新受影响账户的持仓盈亏总额，并推送给 Client（间隔内的重复推送由调度器合并）
+    const auto now = PushScheduler::Clock::now();
+    for (const auto& account : affected) {
+        accountManager_.updatePositionProfit(account.accountId, account.totalProfit);
+        touchAccount(account.accountId);
         
         // 推送账户更新给 Client（行情变化触发）
-        pushAccountUpdate(accountId, 1);  // 1 = 行情变化
+        if (pushScheduler_.requestAccount(account.accountId, now)) {
+            pushAccountUpdate(account.accountId, 1);  // 1 = 行情变化
+        }
         
         // 同时推送持仓更新（包含最新盈亏）
-        pushPositionUpdate(accountId, instrumentId, 1);  // 1 = 行情变化
+        if (pushScheduler_.requestPosition(account.accountId, instrumentId, now)) {
+            pushPositionUpdate(account.accountId, instrumentId, 1);  // 1 = 行情变化
+        }
+    }
+
+    maybeFlushDirtyAccounts();
+}
+
+void SimulationApp::maybeFlushDirtyAccounts() {
+    const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t last = lastProfitFlushMs_.load(std::memory_order_relaxed);
+    if (nowMs - last < profitPersistIntervalMs_) {
+        return;
+    }
+    if (lastProfitFlushMs_.compare_exchange_strong(last, nowMs, std::memory_order_relaxed)) {
+        accountManager_.flushDirty();
+    }
+}
+
+void SimulationApp::runOnAccountThread(AccountActor::Task task) {
+    if (actor_) {
+        actor_->post(std::move(task));
+    } else {
+        task();
+    }
+}
+
+void SimulationApp::touchAccount(const std::string& accountId) {
+    if (actor_ && !accountId.empty()) {
+        touchedAccounts_.insert(accountId);
+    }
+}
+
+void SimulationApp::publishTouchedViews() {
+    for (const auto& accountId : touchedAccounts_) {
+        auto accountOpt = accountManager_.getAccount(accountId);
+        if (!accountOpt) {
+            continue;
+        }
+        auto view = std::make_shared<AccountView>();
+        view->account = std::move(*accountOpt);
+        view->positions = positionManager_.getPositionsByAccount(accountId);
+        accountViews_.publish(std::move(view));
+    }
+    touchedAccounts_.clear();
+}
+
+std::optional<Account> SimulationApp::queryAccount(const std::string& accountId) const {
+    if (actor_) {
+        if (auto view = accountViews_.get(accountId)) {
+            return view->account;
+        }
+    }
+    // 未开启单写者模式，或账户未经账户线程创建（尚无视图）
+    return accountManager_.getAccount(accountId);
+}
+
+std::vector<Position> SimulationApp::queryPositions(const std::string& accountId) const {
+    if (actor_) {
+        if (auto view = accountViews_.get(accountId)) {
+            return view->positions;
+        }
+    }
+    return positionManager_.getPositionsByAccount(accountId);
+}
+
+void SimulationApp::timerLoop() {
+    const auto pushInterval = pushScheduler_.interval();
+    const bool timedPersist = store_ && profitPersistIntervalMs_ > 0;
+    auto interval = timedPersist ? std::chrono::milliseconds(profitPersistIntervalMs_) : pushInterval;
+    if (pushInterval.count() > 0) {
+        interval = std::min(interval, pushInterval);
+    }
+
+    std::vector<std::string> accounts;
+    std::vector<PushScheduler::PositionKey> positions;
+    std::unique_lock<std::mutex> lock(timerMutex_);
+    while (!timerStopping_) {
+        timerCv_.wait_for(lock, interval, [this]() { return timerStopping_; });
+        lock.unlock();
+        if (pushInterval.count() > 0) {
+            pushScheduler_.collectDue(PushScheduler::Clock::now(), accounts, positions);
+        }
+        if (!accounts.empty() || !positions.empty()) {
+            // 推送读取账户/持仓，在账户线程上执行
+            runOnAccountThread([this, accounts, positions]() {
+                for (const auto& accountId : accounts) {
+                    pushAccountUpdate(accountId, 1);
+                }
+                for (const auto& [accountId, instrumentId] : positions) {
+                    pushPositionUpdate(accountId, instrumentId, 1);
+                }
+            });
+        }
+        if (timedPersist) {
+            // 行情停止后，最后一个间隔内的浮动盈亏也按时落盘
+            runOnAccountThread([this]() { maybeFlushDirtyAccounts(); });
+        }
+        lock.lock();
     }
 }
 
@@ -915,32 +1162,14 @@ void SimulationApp::pushAccountUpdate(const std::string& userId, int reason) {
     msg.set(tags::UpdateType, 1);  // 1 = 账户更新
     msg.set(tags::UpdateReason, reason);
     
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    
-    oss.str(""); oss << account.balance;
-    msg.set(tags::Balance, oss.str());
-    
-    oss.str(""); oss << account.available;
-    msg.set(tags::Available, oss.str());
-    
-    oss.str(""); oss << account.frozenMargin;
-    msg.set(tags::FrozenMargin, oss.str());
-    
-    oss.str(""); oss << account.usedMargin;
-    msg.set(tags::UsedMargin, oss.str());
-    
-    oss.str(""); oss << account.positionProfit;
-    msg.set(tags::PositionProfit, oss.str());
-
-    oss.str(""); oss << account.closeProfit;
-    msg.set(tags::CloseProfit, oss.str());
-
-    oss.str(""); oss << account.getDynamicEquity();
-    msg.set(tags::DynamicEquity, oss.str());
-
-    oss.str(""); oss << account.getRiskRatio();
-    msg.set(tags::RiskRatio, oss.str());
+    msg.set(tags::Balance, formatFixed2(account.balance));
+    msg.set(tags::Available, formatFixed2(account.available));
+    msg.set(tags::FrozenMargin, formatFixed2(account.frozenMargin));
+    msg.set(tags::UsedMargin, formatFixed2(account.usedMargin));
+    msg.set(tags::PositionProfit, formatFixed2(account.positionProfit));
+    msg.set(tags::CloseProfit, formatFixed2(account.closeProfit));
+    msg.set(tags::DynamicEquity, formatFixed2(account.getDynamicEquity()));
+    msg.set(tags::RiskRatio, formatFixed2(account.getRiskRatio()));
 
     // 发送推送
     if (!sessionManager_.sendMessage(*sessionOpt, msg)) {
@@ -971,21 +1200,11 @@ void SimulationApp::pushPositionUpdate(const std::string& userId, const std::str
     msg.set(tags::UpdateReason, reason);
     msg.set(tags::InstrumentID, instrumentId);
     
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    
     msg.set(tags::LongPosition, static_cast<int>(pos.longPosition));
-    
-    oss.str(""); oss << pos.longAvgPrice;
-    msg.set(tags::LongAvgPrice, oss.str());
-    
+    msg.set(tags::LongAvgPrice, formatFixed2(pos.longAvgPrice));
     msg.set(tags::ShortPosition, static_cast<int>(pos.shortPosition));
-    
-    oss.str(""); oss << pos.shortAvgPrice;
-    msg.set(tags::ShortAvgPrice, oss.str());
-    
-    oss.str(""); oss << pos.getTotalProfit();
-    msg.set(tags::PositionProfit, oss.str());
+    msg.set(tags::ShortAvgPrice, formatFixed2(pos.shortAvgPrice));
+    msg.set(tags::PositionProfit, formatFixed2(pos.getTotalProfit()));
     
     // 发送推送
     if (!sessionManager_.sendMessage(*sessionOpt, msg)) {
@@ -994,21 +1213,9 @@ void SimulationApp::pushPositionUpdate(const std::string& userId, const std::str
 }
 
 std::optional<SessionID> SimulationApp::findSessionByUserId(const std::string& userId) const {
-    // 遍历所有 Session，找到 clientCompID == userId 的那个
-    std::optional<SessionID> result;
-    
-    sessionManager_.forEachSession([&](const SessionID& sid, std::shared_ptr<Session> session) {
-        // 已找到则跳过后续遍历
-        if (result.has_value()) {
-            return;
-        }
-        // 使用 Session::get_client_comp_id() 获取真实的客户端标识
-        if (session && session->get_client_comp_id() == userId) {
-            result = sid;
-        }
-    });
-    
-    return result;
+    // 通过 SessionManager 的 clientCompID 二级索引直接定位（O(1)），
+    // 避免每次推送都遍历全部 Session 比对 get_client_comp_id()。
+    return sessionManager_.findSessionIdByClientCompId(userId);
 }
 
 // ============================================================================
@@ -1140,4 +1347,186 @@ void SimulationApp::handleOrderHistoryQuery(const FixMessage& msg, const Session
     }
 }
 
+bool SimulationApp::isAdminUser(const std::string& userId) const {
+    return adminUsers_.count(userId) > 0;
+}
+
+void SimulationApp::handleSessionStatsQuery(const FixMessage& msg, const SessionID& sessionID, const std::string& userId) {
+    const bool isAdmin = isAdminUser(userId);
+
+    std::vector<SessionStatsSnapshot> stats;
+    if (isAdmin) {
+        stats = sessionManager_.collectStats();
+    } else if (auto own = sessionManager_.getSessionStats(sessionID)) {
+        stats.push_back(std::move(*own));
+    }
+
+    std::ostringstream text;
+    for (const auto& s : stats) {
+        text << format_session_stats(s) << "\n";
+    }
+
+    FixMessage response;
+    response.set(tags::MsgType, "U12");
+    if (msg.has(tags::RequestID)) {
+        response.set(tags::RequestID, msg.get_string(tags::RequestID));
+    }
+    response.set(tags::Text, text.str());
+
+    if (!sessionManager_.sendMessage(sessionID, response)) {
+        LOG() << "[SimulationApp] Failed to send session stats response to " << sessionID.to_string();
+    } else {
+        LOG() << "[SimulationApp] Sent session stats: " << stats.size() << " sessions"
+              << (isAdmin ? " (admin)" : "");
+    }
+}
+
+// ============================================================================
+// 压力测试
+// ============================================================================
+
+void SimulationApp::handleStressTestRequest(const FixMessage& msg, const SessionID& sessionID, const std::string& userId) {
+    if (adminUsers_.empty()) {
+        LOG() << "[SimulationApp] Rejecting stress test from " << userId << ": no admin users configured";
+        sendBusinessReject(sessionID, "U13", "Stress test is disabled");
+        return;
+    }
+    if (!isAdminUser(userId)) {
+        LOG() << "[SimulationApp] Rejecting stress test from non-admin user " << userId;
+        sendBusinessReject(sessionID, "U13", "Stress test requires admin privileges");
+        return;
+    }
+
+    int steps = Config::instance().get_int("stress", "default_steps", 3);
+    if (msg.has(tags::ShockSteps)) {
+        try {
+            steps = msg.get_int(tags::ShockSteps);
+        } catch (const std::exception&) {
+            sendBusinessReject(sessionID, "U13", "Invalid ShockSteps");
+            return;
+        }
+    }
+    steps = std::clamp(steps, 1, kMaxShockSteps);
+    const std::string requestId = msg.has(tags::RequestID) ? msg.get_string(tags::RequestID) : "";
+
+    // 每个用户同时只能有一个压力测试在执行，结果发出后才接受下一个
+    {
+        std::lock_guard<std::mutex> lock(stressMutex_);
+        if (!stressInFlight_.insert(userId).second) {
+            LOG() << "[SimulationApp] Rejecting stress test from " << userId << ": previous run still in progress";
+            sendBusinessReject(sessionID, "U13", "Stress test already in progress");
+            return;
+        }
+    }
+
+    // 快照在账户线程上采集（与账户/持仓变更串行），估值交给压力测试引擎
+    runOnAccountThread([this, sessionID, requestId, steps, userId]() {
+        // 提交成功后由回调释放占位；快照采集抛出异常或引擎已停止时在这里释放
+        struct InFlightGuard {
+            SimulationApp* app;
+            const std::string& userId;
+            bool submitted = false;
+            ~InFlightGuard() {
+                if (!submitted) {
+                    app->releaseStressInFlight(userId);
+                }
+            }
+        } guard{this, userId};
+
+        auto snapshot = std::make_shared<const StressSnapshot>(captureStressSnapshot());
+        guard.submitted = stressEngine_.submit(std::move(snapshot), steps,
+            [this, sessionID, requestId, steps, userId](const StressReport& report) {
+                // 先释放再发送：发送抛出异常时占位也不会残留
+                releaseStressInFlight(userId);
+                if (!report.error.empty()) {
+                    sendBusinessReject(sessionID, "U13", "Stress test failed: " + report.error);
+                    return;
+                }
+                sendStressTestResponse(sessionID, requestId, steps, report);
+            });
+        if (!guard.submitted) {
+            sendBusinessReject(sessionID, "U13", "Stress test engine stopped");
+        }
+    });
+}
+
+void SimulationApp::releaseStressInFlight(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(stressMutex_);
+    stressInFlight_.erase(userId);
+}
+
+void SimulationApp::sendStressTestResponse(const SessionID& sessionID, const std::string& requestId,
+                                           int steps, const StressReport& report) {
+    std::ostringstream text;
+    text << "accounts=" << report.accounts.size()
+         << " positions=" << report.positionCount
+         << " scenarios=" << report.scenarioCount
+         << " elapsed_ms=" << std::fixed << std::setprecision(3) << report.elapsedMs << "\n";
+    for (const auto& result : report.accounts) {
+        text << format_stress_result(result) << "\n";
+    }
+
+    FixMessage response;
+    response.set(tags::MsgType, "U14");
+    if (!requestId.empty()) {
+        response.set(tags::RequestID, requestId);
+    }
+    response.set(tags::ShockSteps, steps);
+    response.set(tags::ResultCount, static_cast<int>(report.accounts.size()));
+    response.set(tags::Text, text.str());
+
+    if (!sessionManager_.sendMessage(sessionID, response)) {
+        LOG() << "[SimulationApp] Failed to send stress test response to " << sessionID.to_string();
+    }
+}
+
+StressSnapshot SimulationApp::captureStressSnapshot() const {
+    const double defaultLimitPct = Config::instance().get_double("stress", "default_limit_pct", 0.1);
+    StressSnapshotBuilder builder;
+
+    for (const auto& accountId : accountManager_.getAllAccountIds()) {
+        if (auto account = accountManager_.getAccount(accountId)) {
+            builder.addAccount(*account);
+        }
+    }
+
+    // 静态信息直接引用合约表条目；价格由下方行情快照 / getPrices() 取当前值
+    const auto instruments = instrumentManager_.getTable();
+    for (const auto& position : positionManager_.getAllPositions()) {
+        if (!position.hasPosition()) {
+            continue;
+        }
+        const InstrumentEntry* entry = instruments->find(position.instrumentId);
+        const Instrument* instrument = entry ? &entry->info : nullptr;
+        const int volumeMultiple = instrument ? instrument->volumeMultiple : 1;
+        const std::string& productId = instrument && !instrument->productId.empty()
+            ? instrument->productId : position.instrumentId;
+
+        double mark = 0.0;
+        double upper = 0.0;
+        double lower = 0.0;
+        if (auto snapshot = engine_.getMarketSnapshot(position.instrumentId)) {
+            mark = snapshot->lastPrice;
+            upper = snapshot->upperLimitPrice;
+            lower = snapshot->lowerLimitPrice;
+        }
+        if (auto prices = instrumentManager_.getPrices(position.instrumentId)) {
+            if (mark <= 0) {
+                mark = prices->preSettlementPrice;
+            }
+            if (upper <= 0 || lower <= 0) {
+                upper = prices->upperLimitPrice;
+                lower = prices->lowerLimitPrice;
+            }
+        }
+        if (mark <= 0) {
+            mark = position.longPosition > 0 ? position.longAvgPrice : position.shortAvgPrice;
+        }
+        const double limitMove = (upper > lower && lower > 0) ? (upper - lower) / 2 : mark * defaultLimitPct;
+
+        builder.addPosition(position, productId, volumeMultiple, mark, limitMove);
+    }
+    return builder.build();
+}
+
 } // namespace fix40
@@ -64,6 +64,18 @@ void ClientApp::fromApp(const FixMessage& msg, const SessionID& sessionID) {
         std::string text = msg.has(tags::Text) ? msg.get_string(tags::Text) : "Unknown error";
         state_->setLastError(text);
         state_->addMessage("业务拒绝: " + text);
+        // 被拒绝的是报单时（如服务端限流），结束本地订单的待确认状态
+        if (msg.has(tags::ClOrdID)) {
+            const std::string clOrdID = msg.get_string(tags::ClOrdID);
+            for (auto order : state_->getOrders()) {
+                if (order.clOrdID == clOrdID && order.state == OrderState::PENDING_NEW) {
+                    order.state = OrderState::REJECTED;
+                    order.text = text;
+                    state_->updateOrder(clOrdID, order);
+                    break;
+                }
+            }
+        }
     } else {
         LOG() << "[ClientApp] Unknown message type: " << msgType;
     }
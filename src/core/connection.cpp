@@ -81,6 +81,7 @@ void Connection::handle_read() {
         while (frame_decoder_.next_message(raw_msg)) {
             FixMessage fix_msg = session_->codec_.decode(raw_msg);
             LOG() << "<<< RECV (" << fd_ << "): " << raw_msg;
+            session_->stats().on_bytes_in(raw_msg.size());
             session_->on_message_received(fix_msg);
         }
     } catch (const std::exception& e) {
@@ -126,6 +127,14 @@ void Connection::send(std::string_view data) {
     });
 }
 
+void Connection::send(std::string&& data) {
+    if (is_closed_) return;
+
+    dispatch([this, data = std::move(data)]() {
+        do_send(data);
+    });
+}
+
 void Connection::do_send(const std::string& data) {
     if (is_closed_) return;
 
@@ -0,0 +1,174 @@
+/**
+ * @file rate_limiter.cpp
+ * @brief 入站消息令牌桶限流实现
+ */
+
+#include "fix/rate_limiter.hpp"
+#include "base/config.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace fix40 {
+
+ThrottleClass classify_msg_type(const std::string& msg_type) {
+    if (msg_type == "D" || msg_type == "G") {
+        return ThrottleClass::ORDER;
+    }
+    if (msg_type == "F") {
+        return ThrottleClass::CANCEL;
+    }
+    if (msg_type == "U1" || msg_type == "U3" || msg_type == "U7" || msg_type == "U9" ||
+        msg_type == "U11" || msg_type == "U13") {
+        return ThrottleClass::QUERY;
+    }
+    return ThrottleClass::OTHER;
+}
+
+const char* throttle_class_name(ThrottleClass cls) {
+    switch (cls) {
+        case ThrottleClass::ORDER: return "order";
+        case ThrottleClass::QUERY: return "query";
+        case ThrottleClass::OTHER: return "other";
+        case ThrottleClass::CANCEL: return "cancel";
+    }
+    return "other";
+}
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(rate > 0.0 ? rate : 0.0)
+    , burst_(burst > 0.0 ? burst : (rate > 0.0 ? rate : 0.0))
+    , tokens_(burst_) {}
+
+bool TokenBucket::try_consume(Clock::time_point now) {
+    if (rate_ <= 0.0) {
+        return true;
+    }
+    if (!started_) {
+        started_ = true;
+        last_ = now;
+    } else if (now > last_) {
+        const double elapsed = std::chrono::duration<double>(now - last_).count();
+        tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+        last_ = now;
+    }
+    if (tokens_ >= 1.0) {
+        tokens_ -= 1.0;
+        return true;
+    }
+    return false;
+}
+
+void TokenBucket::refund() {
+    if (rate_ > 0.0) {
+        tokens_ = std::min(burst_, tokens_ + 1.0);
+    }
+}
+
+// ============================================================================
+// ThrottleConfig
+// ============================================================================
+
+ThrottleConfig ThrottleConfig::fromConfig() {
+    auto& config = Config::instance();
+    ThrottleConfig result;
+    result.enabled = config.get_int("throttle", "enabled", 0) != 0;
+
+    for (size_t i = 0; i < kThrottleClassCount; ++i) {
+        const std::string name = throttle_class_name(static_cast<ThrottleClass>(i));
+        result.session.rate[i] = config.get_double("throttle", "session_" + name + "_rate", 0.0);
+        result.session.burst[i] = config.get_double("throttle", "session_" + name + "_burst", 0.0);
+        result.account.rate[i] = config.get_double("throttle", "account_" + name + "_rate", 0.0);
+        result.account.burst[i] = config.get_double("throttle", "account_" + name + "_burst", 0.0);
+    }
+    return result;
+}
+
+// ============================================================================
+// SessionThrottle
+// ============================================================================
+
+SessionThrottle::SessionThrottle(const ThrottleLimits& limits) {
+    for (size_t i = 0; i < kThrottleClassCount; ++i) {
+        buckets_[i] = TokenBucket(limits.rate[i], limits.burst[i]);
+    }
+}
+
+ThrottleStats SessionThrottle::stats() const {
+    ThrottleStats s;
+    s.admitted = admitted_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kThrottleClassCount; ++i) {
+        s.sessionHits[i] = sessionHits_[i].load(std::memory_order_relaxed);
+        s.accountHits[i] = accountHits_[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+// ============================================================================
+// RateLimiter
+// ============================================================================
+
+RateLimiter::RateLimiter(ThrottleConfig config)
+    : config_(std::move(config)) {}
+
+std::unique_ptr<SessionThrottle> RateLimiter::createSessionThrottle() const {
+    return std::make_unique<SessionThrottle>(config_.session);
+}
+
+ThrottleResult RateLimiter::admit(SessionThrottle& session, const std::string& accountId, ThrottleClass cls) {
+    const size_t idx = static_cast<size_t>(cls);
+    const auto now = TokenBucket::Clock::now();
+
+    // 1. 会话级
+    auto& sessionBucket = session.buckets_[idx];
+    if (!sessionBucket.try_consume(now)) {
+        session.sessionHits_[idx].fetch_add(1, std::memory_order_relaxed);
+        sessionHits_[idx].fetch_add(1, std::memory_order_relaxed);
+        return ThrottleResult::SESSION_LIMITED;
+    }
+
+    // 2. 账户级（同一账户的多个会话共享）
+    if (!accountId.empty() && accountLimited(idx)) {
+        auto& shard = accountShards_[std::hash<std::string>()(accountId) % kShardCount];
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.buckets.find(accountId);
+            if (it == shard.buckets.end()) {
+                std::array<TokenBucket, kThrottleClassCount> buckets;
+                for (size_t i = 0; i < kThrottleClassCount; ++i) {
+                    buckets[i] = TokenBucket(config_.account.rate[i], config_.account.burst[i]);
+                }
+                it = shard.buckets.emplace(accountId, buckets).first;
+            }
+            ok = it->second[idx].try_consume(now);
+        }
+        if (!ok) {
+            // 账户级拒绝时归还会话级令牌，避免被拒消息重复计入会话额度
+            sessionBucket.refund();
+            session.accountHits_[idx].fetch_add(1, std::memory_order_relaxed);
+            accountHits_[idx].fetch_add(1, std::memory_order_relaxed);
+            return ThrottleResult::ACCOUNT_LIMITED;
+        }
+    }
+
+    session.admitted_.fetch_add(1, std::memory_order_relaxed);
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return ThrottleResult::ADMITTED;
+}
+
+ThrottleStats RateLimiter::stats() const {
+    ThrottleStats s;
+    s.admitted = admitted_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kThrottleClassCount; ++i) {
+        s.sessionHits[i] = sessionHits_[i].load(std::memory_order_relaxed);
+        s.accountHits[i] = accountHits_[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+} // namespace fix40
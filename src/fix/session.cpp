@@ -80,6 +80,7 @@ private:
     const std::unordered_map<std::string, MessageHandler> messageHandlers_; ///< 消息处理器映射
     
     std::string awaitingTestReqId_;  ///< 等待响应的 TestReqID
+    std::chrono::steady_clock::time_point testReqSentTime_; ///< TestRequest 发送时间（用于统计心跳往返时延）
     std::chrono::steady_clock::time_point logout_initiation_time_; ///< 登出发起时间
     bool logout_initiated_ = false;  ///< 是否已发起登出
 
@@ -232,6 +233,61 @@ void Session::send_app_message(FixMessage& msg) {
     send(msg);
 }
 
+void Session::set_rate_limiter(std::shared_ptr<RateLimiter> limiter) {
+    std::lock_guard<std::recursive_mutex> lock(state_mutex_);
+    rate_limiter_ = std::move(limiter);
+    throttle_ = rate_limiter_ ? rate_limiter_->createSessionThrottle() : nullptr;
+}
+
+bool Session::admit_inbound(const FixMessage& msg) {
+    std::lock_guard<std::recursive_mutex> lock(state_mutex_);
+    if (!rate_limiter_ || !throttle_) return true;
+
+    const std::string msg_type = msg.get_string(tags::MsgType);
+    const ThrottleClass cls = classify_msg_type(msg_type);
+    const ThrottleResult result = rate_limiter_->admit(*throttle_, clientCompID_, cls);
+    if (result == ThrottleResult::ADMITTED) {
+        return true;
+    }
+
+    const char* scope = (result == ThrottleResult::SESSION_LIMITED) ? "session" : "account";
+    LOG() << "[Session] Throttled MsgType=" << msg_type << " (" << throttle_class_name(cls)
+          << ", " << scope << " limit) from " << get_session_id().to_string();
+    const int ref_seq_num = msg.has(tags::MsgSeqNum) ? msg.get_int(tags::MsgSeqNum) : 0;
+    auto reject = create_business_reject_message(
+        senderCompID, targetCompID, 0, msg_type,
+        std::string("Throttled: ") + scope + " " + throttle_class_name(cls) + " rate limit exceeded",
+        ref_seq_num);
+    // 报单/撤单回带订单标识，客户端据此确认哪一笔请求被丢弃
+    if (msg.has(tags::ClOrdID)) {
+        reject.set(tags::ClOrdID, msg.get_string(tags::ClOrdID));
+    }
+    if (msg.has(tags::OrigClOrdID)) {
+        reject.set(tags::OrigClOrdID, msg.get_string(tags::OrigClOrdID));
+    }
+    send(reject);
+    return false;
+}
+
+ThrottleStats Session::get_throttle_stats() const {
+    // throttle_ 只在 set_rate_limiter() 中（start 之前）赋值，计数器为原子变量
+    return throttle_ ? throttle_->stats() : ThrottleStats{};
+}
+
+SessionStatsSnapshot Session::get_stats_snapshot() const {
+    SessionStatsSnapshot snapshot;
+    snapshot.sessionId = get_session_id().to_string();
+    snapshot.clientCompID = clientCompID_;
+    stats_.fill(snapshot);
+    snapshot.throttle = get_throttle_stats();
+    return snapshot;
+}
+
+void Session::send_business_reject(const std::string& ref_msg_type, const std::string& reason) {
+    auto reject = create_business_reject_message(senderCompID, targetCompID, 0, ref_msg_type, reason);
+    send(reject);
+}
+
 void Session::start() {
     std::lock_guard<std::recursive_mutex> lock(state_mutex_);
     running_ = true;
@@ -271,6 +327,7 @@ void Session::on_message_received(const FixMessage& msg) {
     if (!running_) return;
 
     update_last_recv_time();
+    stats_.on_message_in();
 
     const int msg_seq_num = msg.get_int(tags::MsgSeqNum);
     const std::string msg_type = msg.get_string(tags::MsgType);
@@ -302,6 +359,7 @@ void Session::on_message_received(const FixMessage& msg) {
         // - 暂存“未来序列号”的消息，等待缺失补齐或 GapFill 推进序列号后再按序投递。
         LOG() << "Sequence number gap detected. Expected: " << recvSeqNum
               << ", Got: " << msg_seq_num << ". Sending ResendRequest and buffering message.";
+        stats_.on_gap();
 
         const int end_seq_no = msg_seq_num - 1;
         const int begin_seq_no = std::max(recvSeqNum, last_resend_request_end_ + 1);
@@ -399,32 +457,58 @@ void Session::send(FixMessage& msg) {
     std::string raw_msg = codec_.encode(msg);
     
     // 持久化消息（用于断线恢复时重传）
-    if (store_) {
-        StoredMessage stored_msg;
-        stored_msg.seqNum = seq_num;
-        stored_msg.senderCompID = senderCompID;
-        stored_msg.targetCompID = targetCompID;
-        stored_msg.msgType = msg.get_string(tags::MsgType);
-        stored_msg.rawMessage = raw_msg;
-        stored_msg.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-        
-        if (!store_->saveMessage(stored_msg)) {
-            LOG() << "Warning: Failed to persist message with SeqNum=" << seq_num;
-        }
-        
-        // 保存会话状态
-        save_session_state();
+    persist_outbound(seq_num, msg.get_string(tags::MsgType), raw_msg);
+    
+    internal_send(std::move(raw_msg));
+}
+
+void Session::send_prepared(const FixCodec::EncodedBody& body) {
+    std::lock_guard<std::recursive_mutex> lock(state_mutex_);
+    int seq_num = sendSeqNum++;
+
+    FixMessage header;
+    header.set(tags::SenderCompID, senderCompID);
+    header.set(tags::TargetCompID, targetCompID);
+    header.set(tags::MsgSeqNum, seq_num);
+
+    std::string raw_msg = codec_.encode_prepared(header, body);
+
+    persist_outbound(seq_num, body.msgType, raw_msg);
+
+    internal_send(std::move(raw_msg));
+}
+
+void Session::persist_outbound(int seq_num, const std::string& msg_type, const std::string& raw_msg) {
+    if (!store_) return;
+
+    StoredMessage stored_msg;
+    stored_msg.seqNum = seq_num;
+    stored_msg.senderCompID = senderCompID;
+    stored_msg.targetCompID = targetCompID;
+    stored_msg.msgType = msg_type;
+    stored_msg.rawMessage = raw_msg;
+    stored_msg.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (!store_->saveMessage(stored_msg)) {
+        LOG() << "Warning: Failed to persist message with SeqNum=" << seq_num;
     }
     
-    internal_send(raw_msg);
+    // 保存会话状态
+    save_session_state();
 }
 
 void Session::internal_send(const std::string& raw_msg) {
-    LOG() << ">>> SEND (" << (connection_.lock() ? std::to_string(connection_.lock()->fd()) : "N/A") << "): " << raw_msg;
+    internal_send(std::string(raw_msg));
+}
 
-    if (auto conn = connection_.lock()) {
-        conn->send(raw_msg);
+void Session::internal_send(std::string&& raw_msg) {
+    auto conn = connection_.lock();
+    LOG() << ">>> SEND (" << (conn ? std::to_string(conn->fd()) : "N/A") << "): " << raw_msg;
+
+    if (conn) {
+        stats_.on_message_out(raw_msg.size());
+        conn->send(std::move(raw_msg));
         update_last_send_time();
     }
 }
@@ -471,15 +555,22 @@ int Session::get_max_heart_bt_int() const { return maxHeartBtInt_; }
 
 // ... [其它辅助函数的实现]
 
-void Session::schedule_timer_tasks(TimingWheel* wheel) {
+void Session::schedule_timer_tasks(TimingWheel* wheel, bool wheel_on_bound_thread) {
     if (!wheel || !running_) return;
 
     timing_wheel_ = wheel;
     std::weak_ptr<Session> weak_self = shared_from_this();
 
     // 使用周期性任务，一次注册永久生效，直到被取消
-    timer_task_id_ = wheel->add_periodic_task(1000, [weak_self]() {
+    timer_task_id_ = wheel->add_periodic_task(1000, [weak_self, wheel_on_bound_thread]() {
         if (auto self = weak_self.lock()) {
+            if (wheel_on_bound_thread) {
+                // 时间轮本身由绑定线程驱动，已处于正确的线程
+                if (self->is_running()) {
+                    self->on_timer_check();
+                }
+                return;
+            }
             if (auto conn = self->connection_.lock()) {
                 // 将定时任务派发到连接绑定的工作线程执行
                 conn->dispatch([self]() {
@@ -710,9 +801,15 @@ void EstablishedState::onMessageReceived(Session& context, const FixMessage& msg
             }
         }
     } else {
+        // 业务消息：先做入站限流，超限消息已回 BusinessReject，不再交给应用层
+        if (!context.admit_inbound(msg)) {
+            return;
+        }
+
         // 业务消息，委托给应用层处理
         Application* app = context.get_application();
         if (app) {
+            const auto app_start = std::chrono::steady_clock::now();
             try {
                 app->fromApp(msg, context.get_session_id());
             } catch (const std::exception& e) {
@@ -721,6 +818,7 @@ void EstablishedState::onMessageReceived(Session& context, const FixMessage& msg
             } catch (...) {
                 LOG() << "Application::fromApp threw unknown exception";
             }
+            context.stats().record_app_latency(msg_type, std::chrono::steady_clock::now() - app_start);
         } else {
             LOG() << "Received business message (MsgType=" << msg_type 
                   << ") but no Application is set. Message ignored.";
@@ -759,6 +857,7 @@ void EstablishedState::onTimerCheck(Session& context) {
     // 发送一个 TestRequest。
     if (seconds_since_recv >= static_cast<long>(hb_interval * 1.2) && awaitingTestReqId_.empty()) {
         awaitingTestReqId_ = "TestReq_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+        testReqSentTime_ = now;
         context.send_test_request(awaitingTestReqId_);
     }
 }
@@ -770,9 +869,10 @@ void EstablishedState::onLogoutRequest(Session& context, const std::string& reas
     context.changeState(std::make_unique<LogoutSentState>(reason));
 }
 
-void EstablishedState::handleHeartbeat(Session&, const FixMessage& msg) {
+void EstablishedState::handleHeartbeat(Session& context, const FixMessage& msg) {
     if (msg.has(tags::TestReqID)) {
-        if (msg.get_string(tags::TestReqID) == awaitingTestReqId_) {
+        if (!awaitingTestReqId_.empty() && msg.get_string(tags::TestReqID) == awaitingTestReqId_) {
+            context.stats().record_heartbeat_rtt(std::chrono::steady_clock::now() - testReqSentTime_);
             awaitingTestReqId_.clear();
         }
     }
@@ -802,6 +902,7 @@ void EstablishedState::handleResendRequest(Session& context, const FixMessage& m
     int end_seq_no = msg.get_int(tags::EndSeqNo);
     
     LOG() << "Received ResendRequest: BeginSeqNo=" << begin_seq_no << ", EndSeqNo=" << end_seq_no;
+    context.stats().on_resend_request_received();
     
     IStore* store = context.get_store();
     if (!store) {
@@ -867,7 +968,9 @@ void EstablishedState::handleResendRequest(Session& context, const FixMessage& m
             std::string raw_msg = context.codec_.encode(resend_msg);
             // 直接发送，不更新序列号
             if (auto conn = context.get_connection().lock()) {
-                conn->send(raw_msg);
+                context.stats().on_message_resent();
+                context.stats().on_message_out(raw_msg.size());
+                conn->send(std::move(raw_msg));
             }
         }
         
@@ -953,6 +1056,7 @@ void LogoutSentState::onLogoutRequest([[maybe_unused]] Session& context, [[maybe
 void Session::send_resend_request(int begin_seq_no, int end_seq_no) {
     auto rr_msg = create_resend_request_message(senderCompID, targetCompID, 0, begin_seq_no, end_seq_no);
     send(rr_msg);
+    stats_.on_resend_request_sent();
     LOG() << "Sent ResendRequest: BeginSeqNo=" << begin_seq_no << ", EndSeqNo=" << end_seq_no;
 }
 
@@ -965,6 +1069,7 @@ void Session::send_sequence_reset_gap_fill(int seq_num, int new_seq_no) {
     // 直接编码发送，不递增序列号（因为这是重传流程的一部分）
     std::string raw_msg = codec_.encode(sr_msg);
     internal_send(raw_msg);
+    stats_.on_gap_fill_sent();
     
     LOG() << "Sent SequenceReset-GapFill: SeqNum=" << seq_num << ", NewSeqNo=" << new_seq_no;
 }
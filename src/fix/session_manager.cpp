@@ -6,8 +6,37 @@
 #include "fix/session_manager.hpp"
 #include "base/logger.hpp"
 
+#include <algorithm>
+
 namespace fix40 {
 
+SessionManager::SessionShard& SessionManager::shardFor(const SessionID& sessionID) const {
+    return shards_[SessionIDHash()(sessionID) & (kShardCount - 1)];
+}
+
+SessionManager::ClientIndexShard& SessionManager::clientShardFor(const std::string& clientCompID) const {
+    return clientShards_[std::hash<std::string>()(clientCompID) & (kShardCount - 1)];
+}
+
+void SessionManager::indexClient(const std::string& clientCompID, const SessionID& sessionID,
+                                 const Session* session) {
+    if (clientCompID.empty()) return;
+    auto& shard = clientShardFor(clientCompID);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.index[clientCompID] = ClientIndexShard::Entry{sessionID, session};
+}
+
+void SessionManager::unindexClient(const std::string& clientCompID, const Session* session) {
+    if (clientCompID.empty()) return;
+    auto& shard = clientShardFor(clientCompID);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(clientCompID);
+    // 同一用户重新登录后索引可能已指向新会话（SessionID 相同），按会话对象比较，不能误删
+    if (it != shard.index.end() && it->second.session == session) {
+        shard.index.erase(it);
+    }
+}
+
 void SessionManager::registerSession(std::shared_ptr<Session> session) {
     if (!session) {
         LOG() << "[SessionManager] Cannot register null session";
@@ -15,39 +44,95 @@ void SessionManager::registerSession(std::shared_ptr<Session> session) {
     }
     
     SessionID sessionID = session->get_session_id();
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto [it, inserted] = sessions_.emplace(sessionID, session);
-    
+    const std::string clientCompID = session->get_client_comp_id();
+    std::string replacedClientCompID;
+    std::shared_ptr<Session> replaced;
+    bool inserted = false;
+
+    {
+        auto& shard = shardFor(sessionID);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto [it, ok] = shard.sessions.emplace(sessionID, session);
+        inserted = ok;
+        if (!inserted) {
+            // 替换旧会话
+            if (it->second) {
+                replacedClientCompID = it->second->get_client_comp_id();
+            }
+            replaced = std::move(it->second);
+            it->second = session;
+        }
+    }
+
     if (inserted) {
+        sessionCount_.fetch_add(1, std::memory_order_relaxed);
         LOG() << "[SessionManager] Registered session: " << sessionID.to_string();
     } else {
-        // 替换旧会话
-        it->second = session;
+        if (replacedClientCompID != clientCompID) {
+            unindexClient(replacedClientCompID, replaced.get());
+        }
         LOG() << "[SessionManager] Replaced session: " << sessionID.to_string();
     }
+
+    indexClient(clientCompID, sessionID, session.get());
 }
 
-bool SessionManager::unregisterSession(const SessionID& sessionID) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = sessions_.find(sessionID);
-    if (it != sessions_.end()) {
-        sessions_.erase(it);
-        LOG() << "[SessionManager] Unregistered session: " << sessionID.to_string();
-        return true;
+bool SessionManager::unregisterSession(const SessionID& sessionID, const Session* expected) {
+    std::shared_ptr<Session> removed;
+    {
+        auto& shard = shardFor(sessionID);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.sessions.find(sessionID);
+        if (it == shard.sessions.end()) {
+            return false;
+        }
+        if (expected && it->second.get() != expected) {
+            // 已被同一 SessionID 的新会话替换
+            return false;
+        }
+        removed = std::move(it->second);
+        shard.sessions.erase(it);
+    }
+
+    sessionCount_.fetch_sub(1, std::memory_order_relaxed);
+    if (removed) {
+        unindexClient(removed->get_client_comp_id(), removed.get());
     }
-    return false;
+    LOG() << "[SessionManager] Unregistered session: " << sessionID.to_string();
+    return true;
 }
 
 std::shared_ptr<Session> SessionManager::findSession(const SessionID& sessionID) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = sessions_.find(sessionID);
-    if (it != sessions_.end()) {
+    auto& shard = shardFor(sessionID);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.sessions.find(sessionID);
+    if (it != shard.sessions.end()) {
         return it->second;
     }
     return nullptr;
 }
 
+std::optional<SessionID> SessionManager::findSessionIdByClientCompId(const std::string& clientCompID) const {
+    if (clientCompID.empty()) {
+        return std::nullopt;
+    }
+    auto& shard = clientShardFor(clientCompID);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(clientCompID);
+    if (it != shard.index.end()) {
+        return it->second.sessionID;
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<Session> SessionManager::findSessionByClientCompId(const std::string& clientCompID) const {
+    auto sessionID = findSessionIdByClientCompId(clientCompID);
+    if (!sessionID) {
+        return nullptr;
+    }
+    return findSession(*sessionID);
+}
+
 bool SessionManager::sendMessage(const SessionID& sessionID, FixMessage& msg) {
     std::shared_ptr<Session> session = findSession(sessionID);
     if (!session) {
@@ -71,23 +156,76 @@ bool SessionManager::sendMessage(const SessionID& sessionID, FixMessage& msg) {
     }
 }
 
+bool SessionManager::sendPrepared(const std::shared_ptr<Session>& session,
+                                  const FixCodec::EncodedBody& body) {
+    if (!session || !session->is_running()) {
+        return false;
+    }
+    try {
+        session->send_prepared(body);
+        return true;
+    } catch (const std::exception& e) {
+        LOG() << "[SessionManager] Exception broadcasting message: " << e.what();
+        return false;
+    }
+}
+
+size_t SessionManager::broadcast(const std::vector<SessionID>& targets, const FixMessage& msg) {
+    if (targets.empty()) return 0;
+
+    const FixCodec codec;
+    const FixCodec::EncodedBody body = codec.encode_body(msg);
+
+    size_t sent = 0;
+    for (const auto& sessionID : targets) {
+        if (sendPrepared(findSession(sessionID), body)) {
+            ++sent;
+        }
+    }
+    return sent;
+}
+
+size_t SessionManager::broadcastAll(const FixMessage& msg) {
+    std::vector<std::shared_ptr<Session>> recipients;
+    recipients.reserve(getSessionCount());
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [id, session] : shard.sessions) {
+            recipients.push_back(session);
+        }
+    }
+    if (recipients.empty()) return 0;
+
+    const FixCodec codec;
+    const FixCodec::EncodedBody body = codec.encode_body(msg);
+
+    // 解锁后逐个发送，避免持有分片锁期间进入 Session 锁
+    size_t sent = 0;
+    for (const auto& session : recipients) {
+        if (sendPrepared(session, body)) {
+            ++sent;
+        }
+    }
+    return sent;
+}
+
 size_t SessionManager::getSessionCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return sessions_.size();
+    return sessionCount_.load(std::memory_order_relaxed);
 }
 
 bool SessionManager::hasSession(const SessionID& sessionID) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return sessions_.find(sessionID) != sessions_.end();
+    auto& shard = shardFor(sessionID);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.sessions.find(sessionID) != shard.sessions.end();
 }
 
 void SessionManager::forEachSession(
     std::function<void(const SessionID&, std::shared_ptr<Session>)> callback) const {
     std::vector<std::pair<SessionID, std::shared_ptr<Session>>> snapshot;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        snapshot.reserve(sessions_.size());
-        for (const auto& [id, session] : sessions_) {
+    snapshot.reserve(getSessionCount());
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [id, session] : shard.sessions) {
             snapshot.push_back({id, session});
         }
     }
@@ -99,4 +237,27 @@ void SessionManager::forEachSession(
     }
 }
 
+std::vector<SessionStatsSnapshot> SessionManager::collectStats() const {
+    std::vector<SessionStatsSnapshot> result;
+    result.reserve(getSessionCount());
+    forEachSession([&result](const SessionID&, std::shared_ptr<Session> session) {
+        if (session) {
+            result.push_back(session->get_stats_snapshot());
+        }
+    });
+    std::sort(result.begin(), result.end(),
+              [](const SessionStatsSnapshot& a, const SessionStatsSnapshot& b) {
+                  return a.sessionId < b.sessionId;
+              });
+    return result;
+}
+
+std::optional<SessionStatsSnapshot> SessionManager::getSessionStats(const SessionID& sessionID) const {
+    auto session = findSession(sessionID);
+    if (!session) {
+        return std::nullopt;
+    }
+    return session->get_stats_snapshot();
+}
+
 } // namespace fix40
@@ -0,0 +1,110 @@
+/**
+ * @file session_stats.cpp
+ * @brief FIX 会话运行统计实现
+ */
+
+#include "fix/session_stats.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace fix40 {
+
+namespace {
+
+uint64_t to_nanos(SessionStatistics::Clock::duration d) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+}
+
+void append_histogram(std::ostringstream& oss, const std::string& name, const HistogramSnapshot& h) {
+    oss << ' ' << name << "_count=" << h.count;
+    if (h.count == 0) return;
+    oss << ' ' << name << "_us={p50:" << h.p50 / 1000
+        << ",p90:" << h.p90 / 1000
+        << ",p99:" << h.p99 / 1000
+        << ",p999:" << h.p999 / 1000
+        << ",max:" << h.max / 1000
+        << ",mean:" << h.mean / 1000 << '}';
+}
+
+/// MsgType 在 kAppMsgTypes 中的下标，未列出的类型返回 "other" 桶
+size_t app_bucket(const std::string& msg_type) {
+    constexpr size_t kOther = SessionStatistics::kAppMsgTypes.size() - 1;
+    for (size_t i = 0; i < kOther; ++i) {
+        if (std::strcmp(msg_type.c_str(), SessionStatistics::kAppMsgTypes[i]) == 0) {
+            return i;
+        }
+    }
+    return kOther;
+}
+
+} // namespace
+
+SessionStatistics::~SessionStatistics() {
+    for (auto& slot : appLatency_) {
+        delete slot.load(std::memory_order_relaxed);
+    }
+}
+
+void SessionStatistics::record_heartbeat_rtt(Clock::duration rtt) {
+    heartbeatRtt_.record(to_nanos(rtt));
+}
+
+void SessionStatistics::record_app_latency(const std::string& msg_type, Clock::duration elapsed) {
+    auto& slot = appLatency_[app_bucket(msg_type)];
+    LatencyHistogram* hist = slot.load(std::memory_order_acquire);
+    if (!hist) {
+        // 首次使用：安装失败说明其它线程已安装，使用其结果
+        auto* created = new LatencyHistogram();
+        if (slot.compare_exchange_strong(hist, created, std::memory_order_acq_rel)) {
+            hist = created;
+        } else {
+            delete created;
+        }
+    }
+    hist->record(to_nanos(elapsed));
+}
+
+void SessionStatistics::fill(SessionStatsSnapshot& out) const {
+    out.msgsIn = msgsIn_.load(std::memory_order_relaxed);
+    out.msgsOut = msgsOut_.load(std::memory_order_relaxed);
+    out.bytesIn = bytesIn_.load(std::memory_order_relaxed);
+    out.bytesOut = bytesOut_.load(std::memory_order_relaxed);
+    out.gapEvents = gapEvents_.load(std::memory_order_relaxed);
+    out.resendRequestsSent = resendRequestsSent_.load(std::memory_order_relaxed);
+    out.resendRequestsReceived = resendRequestsReceived_.load(std::memory_order_relaxed);
+    out.messagesResent = messagesResent_.load(std::memory_order_relaxed);
+    out.gapFillsSent = gapFillsSent_.load(std::memory_order_relaxed);
+    out.heartbeatRtt = heartbeatRtt_.snapshot();
+
+    out.appLatency.clear();
+    for (size_t i = 0; i < appLatency_.size(); ++i) {
+        if (const LatencyHistogram* hist = appLatency_[i].load(std::memory_order_acquire)) {
+            out.appLatency.emplace_back(kAppMsgTypes[i], hist->snapshot());
+        }
+    }
+}
+
+std::string format_session_stats(const SessionStatsSnapshot& stats) {
+    std::ostringstream oss;
+    oss << "session=" << stats.sessionId
+        << " client=" << stats.clientCompID
+        << " msgs_in=" << stats.msgsIn
+        << " msgs_out=" << stats.msgsOut
+        << " bytes_in=" << stats.bytesIn
+        << " bytes_out=" << stats.bytesOut
+        << " gaps=" << stats.gapEvents
+        << " rr_sent=" << stats.resendRequestsSent
+        << " rr_recv=" << stats.resendRequestsReceived
+        << " resent=" << stats.messagesResent
+        << " gapfill_sent=" << stats.gapFillsSent
+        << " throttled=" << stats.throttle.totalHits();
+    append_histogram(oss, "hb_rtt", stats.heartbeatRtt);
+    for (const auto& [msgType, hist] : stats.appLatency) {
+        append_histogram(oss, "app_" + msgType, hist);
+    }
+    return oss.str();
+}
+
+} // namespace fix40
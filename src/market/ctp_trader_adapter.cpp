@@ -96,12 +96,15 @@ void CtpTraderSpi::OnRspQryInstrument(CThostFtdcInstrumentField* pInstrument,
         // 这里使用一个合理的默认值
         inst.marginRate = 0.10;  // 默认 10%
         
-        // 添加到管理器
-        adapter_->instrumentManager_->addInstrument(inst);
+        // 分批发布（合约表整体替换，逐条添加会反复复制整张表）
+        adapter_->pendingInstruments_.add(*adapter_->instrumentManager_, std::move(inst));
         adapter_->queriedCount_++;
     }
 
     if (bIsLast) {
+        if (adapter_->instrumentManager_) {
+            adapter_->pendingInstruments_.flush(*adapter_->instrumentManager_);
+        }
         LOG() << "[CTP Trader] 合约查询完成, 共 " << adapter_->queriedCount_.load() << " 个合约";
         adapter_->queryComplete_ = true;
         adapter_->queryCv_.notify_all();
@@ -229,6 +232,7 @@ bool CtpTraderAdapter::queryInstruments(const std::string& exchangeId) {
 
     queriedCount_ = 0;
     queryComplete_ = false;
+    pendingInstruments_.clear();
     state_ = CtpTraderState::QUERYING;
 
     int ret = api_->ReqQryInstrument(&req, ++requestId_);
@@ -237,10 +241,21 @@ bool CtpTraderAdapter::queryInstruments(const std::string& exchangeId) {
 }
 
 bool CtpTraderAdapter::waitForQueryComplete(int timeoutSeconds) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return queryCv_.wait_for(lock, std::chrono::seconds(timeoutSeconds), [this] {
-        return queryComplete_.load() || !running_.load();
-    }) && queryComplete_.load();
+    bool complete;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        complete = queryCv_.wait_for(lock, std::chrono::seconds(timeoutSeconds), [this] {
+            return queryComplete_.load() || !running_.load();
+        }) && queryComplete_.load();
+    }
+
+    // 超时未收到最后一条回报：发布已收到的部分，不丢弃
+    if (!complete && instrumentManager_) {
+        const size_t flushed = pendingInstruments_.flush(*instrumentManager_);
+        LOG() << "[CTP Trader] 合约查询超时, 已收到 " << queriedCount_.load()
+              << " 个合约 (本次补发 " << flushed << " 个)";
+    }
+    return complete;
 }
 
 std::string CtpTraderAdapter::getTradingDay() const {
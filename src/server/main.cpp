@@ -4,7 +4,7 @@
  *
  * 启动流程：
  * 1. 加载配置文件（config.ini 和 simnow.ini）
- * 2. 连接 CTP 交易前置，查询合约列表
+ * 2. 加载合约：合约目录缓存未过期时直接使用，否则连接 CTP 交易前置查询合约列表并写入缓存
  * 3. 连接 CTP 行情前置，订阅行情
  * 4. 启动 FIX 服务器，等待客户端连接
  * 5. 行情驱动撮合和账户价值更新
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <map>
 
@@ -100,6 +101,58 @@ void addFallbackInstruments(fix40::InstrumentManager& instrumentMgr) {
     instrumentMgr.addInstrument(fix40::Instrument("IH2601", "CFFEX", "IH", 0.2, 300, 0.12));
 }
 
+/**
+ * @brief 从二进制合约目录加载合约（[instruments] catalog_path）
+ *
+ * 盘中重启时目录未过期则直接使用，跳过 CTP 合约查询。
+ *
+ * @return 已从目录加载返回 true
+ */
+bool loadCachedInstruments(fix40::InstrumentManager& instrumentMgr) {
+    const std::string path = fix40::Config::instance().get("instruments", "catalog_path", "");
+    if (path.empty()) {
+        return false;
+    }
+    const int maxAgeSec = fix40::Config::instance().get_int("instruments", "catalog_max_age_sec", 43200);
+    if (!instrumentMgr.loadFromCatalog(path, std::chrono::seconds(maxAgeSec))) {
+        return false;
+    }
+    LOG() << "Loaded " << instrumentMgr.size() << " instruments from catalog " << path;
+    return true;
+}
+
+/**
+ * @brief 合约加载成功后写入二进制合约目录，供下次启动使用
+ */
+void saveInstrumentCatalog(const fix40::InstrumentManager& instrumentMgr) {
+    const std::string path = fix40::Config::instance().get("instruments", "catalog_path", "");
+    if (path.empty() || instrumentMgr.size() == 0) {
+        return;
+    }
+    if (instrumentMgr.saveCatalog(path)) {
+        LOG() << "Instrument catalog written to " << path;
+    }
+}
+
+/**
+ * @brief 从 JSON 合约文件加载合约（[instruments] json_path），成功后写入合约目录
+ *
+ * @return 已从 JSON 加载返回 true
+ */
+bool loadJsonInstruments(fix40::InstrumentManager& instrumentMgr) {
+    const std::string path = fix40::Config::instance().get("instruments", "json_path", "");
+    if (path.empty()) {
+        return false;
+    }
+    if (!instrumentMgr.loadFromConfig(path) || instrumentMgr.size() == 0) {
+        LOG() << "Warning: Failed to load instruments from " << path;
+        return false;
+    }
+    LOG() << "Loaded " << instrumentMgr.size() << " instruments from " << path;
+    saveInstrumentCatalog(instrumentMgr);
+    return true;
+}
+
 #ifdef ENABLE_CTP
 /**
  * @brief 行情转发线程函数
@@ -237,9 +290,12 @@ int main(int argc, char* argv[]) {
         std::string simnowPath = simnowPathArg.empty()
             ? findConfigFile("simnow.ini", argv[0])
             : simnowPathArg;
+        const bool cachedInstruments = loadCachedInstruments(instrumentMgr);
         if (simnowPath.empty()) {
-            LOG() << "Warning: simnow.ini not found, using fallback test instruments";
-            addFallbackInstruments(instrumentMgr);
+            if (!cachedInstruments && !loadJsonInstruments(instrumentMgr)) {
+                LOG() << "Warning: simnow.ini not found, using fallback test instruments";
+                addFallbackInstruments(instrumentMgr);
+            }
         } else {
             LOG() << "SimNow config loaded from " << simnowPath;
             auto simnowConfig = parseIniFile(simnowPath);
@@ -247,7 +303,7 @@ int main(int argc, char* argv[]) {
             // -----------------------------------------------------------------
             // 4.1 连接交易前置，查询合约列表
             // -----------------------------------------------------------------
-            if (!simnowConfig["td_front"].empty()) {
+            if (!cachedInstruments && !simnowConfig["td_front"].empty()) {
                 fix40::CtpTraderConfig traderConfig;
                 traderConfig.traderFront = simnowConfig["td_front"];
                 traderConfig.brokerId = simnowConfig["broker_id"];
@@ -276,6 +332,7 @@ int main(int argc, char* argv[]) {
                         traderAdapter.queryInstruments();
                         if (traderAdapter.waitForQueryComplete(CTP_INSTRUMENT_QUERY_TIMEOUT_SEC)) {
                             LOG() << "Loaded " << instrumentMgr.size() << " instruments from CTP";
+                            saveInstrumentCatalog(instrumentMgr);
                         } else {
                             LOG() << "Warning: Instrument query timeout (loaded " 
                                   << instrumentMgr.size() << " instruments so far)";
@@ -291,7 +348,7 @@ int main(int argc, char* argv[]) {
             }
             
             // 如果没有查询到合约，使用回退
-            if (instrumentMgr.size() == 0) {
+            if (instrumentMgr.size() == 0 && !loadJsonInstruments(instrumentMgr)) {
                 LOG() << "Warning: No instruments loaded from CTP";
                 addFallbackInstruments(instrumentMgr);
             }
@@ -348,11 +405,13 @@ int main(int argc, char* argv[]) {
             }
         }
 #else
-        // 非 CTP 模式：使用测试合约
-        LOG() << "CTP disabled, using test instruments";
-        addFallbackInstruments(instrumentMgr);
-        instrumentMgr.addInstrument(fix40::Instrument("AAPL", "NASDAQ", "AAPL", 0.01, 1, 1.0));
-        instrumentMgr.addInstrument(fix40::Instrument("TSLA", "NASDAQ", "TSLA", 0.01, 1, 1.0));
+        // 非 CTP 模式：优先使用合约目录 / JSON 合约文件，都没有时使用测试合约
+        if (!loadCachedInstruments(instrumentMgr) && !loadJsonInstruments(instrumentMgr)) {
+            LOG() << "CTP disabled, using test instruments";
+            addFallbackInstruments(instrumentMgr);
+            instrumentMgr.addInstrument(fix40::Instrument("AAPL", "NASDAQ", "AAPL", 0.01, 1, 1.0));
+            instrumentMgr.addInstrument(fix40::Instrument("TSLA", "NASDAQ", "TSLA", 0.01, 1, 1.0));
+        }
 #endif
 
         LOG() << "Registered " << instrumentMgr.size() << " instruments";
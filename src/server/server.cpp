@@ -8,6 +8,7 @@
 #include "base/logger.hpp"
 #include <iostream>
 #include <csignal>
+#include <algorithm>
 
 #include <signal.h>
 #include <unistd.h>
@@ -22,6 +23,7 @@
 #include "base/timing_wheel.hpp"
 #include "core/connection.hpp"
 #include "fix/session.hpp"
+#include "fix/rate_limiter.hpp"
 #include "fix/application.hpp"
 #include "app/simulation_app.hpp"
 
@@ -128,10 +130,24 @@ FixServer::FixServer(int port, int num_threads, Application* app)
     auto& config = Config::instance();
     worker_pool_ = std::make_unique<ThreadPool>(num_threads > 0 ? num_threads : std::thread::hardware_concurrency());
     reactor_ = std::make_unique<Reactor>();
-    timing_wheel_ = std::make_unique<TimingWheel>(
-        config.get_int("timing_wheel", "slots", 60),
-        config.get_int("timing_wheel", "tick_interval_ms", 1000)
-    );
+
+    // 每个工作线程持有独立的时间轮，由该线程自己 tick：
+    // 连接绑定线程上的定时任务直接在本线程触发，时间轮锁不跨线程竞争。
+    const int wheel_slots = config.get_int("timing_wheel", "slots", 64);
+    const int tick_interval_ms = config.get_int("timing_wheel", "tick_interval_ms", 100);
+    const size_t wheel_capacity =
+        static_cast<size_t>(std::max(0, config.get_int("timing_wheel", "initial_capacity", 1024)));
+    for (size_t i = 0; i < worker_pool_->get_thread_count(); ++i) {
+        timing_wheels_.push_back(
+            std::make_unique<TimingWheel>(wheel_slots, tick_interval_ms, wheel_capacity));
+    }
+
+    // 入站限流：所有会话共享一个限流器（账户级令牌桶需要跨会话共享）
+    ThrottleConfig throttle_config = ThrottleConfig::fromConfig();
+    if (throttle_config.enabled) {
+        rate_limiter_ = std::make_shared<RateLimiter>(std::move(throttle_config));
+        LOG() << "Inbound throttling enabled";
+    }
 
     // self-pipe: 用于将 SIGINT/SIGTERM 从信号处理器安全地转发到 Reactor 线程
     int pipefd[2] = {-1, -1};
@@ -148,13 +164,17 @@ FixServer::FixServer(int port, int num_threads, Application* app)
     signal_write_fd_ = signal_pipe_[1];
 
     // 设置驱动时钟轮的主定时器
-    reactor_->add_timer(config.get_int("timing_wheel", "tick_interval_ms", 1000), [this]([[maybe_unused]] int timer_fd) {
+    // Reactor 线程只负责节拍，把 tick 派发给各工作线程执行
+    reactor_->add_timer(tick_interval_ms, [this]([[maybe_unused]] int timer_fd) {
 #ifdef __linux__
         // Linux 上需要清空 timerfd
         uint64_t expirations;
         read(timer_fd, &expirations, sizeof(expirations));
 #endif
-        this->timing_wheel_->tick();
+        for (size_t i = 0; i < timing_wheels_.size(); ++i) {
+            TimingWheel* wheel = timing_wheels_[i].get();
+            worker_pool_->enqueue_to(i, [wheel]() { wheel->tick(); });
+        }
     });
 
     listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
@@ -322,6 +342,7 @@ void FixServer::on_new_connection(int fd) {
         worker_pool_.get(), thread_index
     );
     session->set_connection(connection);
+    session->set_rate_limiter(rate_limiter_);
 
     // 设置应用层处理器
     if (application_) {
@@ -341,7 +362,8 @@ void FixServer::on_new_connection(int fd) {
     }
 
     session->start();
-    session->schedule_timer_tasks(timing_wheel_.get());
+    // 使用连接绑定线程的时间轮：定时检查直接在绑定线程执行，无需再次派发
+    session->schedule_timer_tasks(timing_wheels_[thread_index].get(), true);
 
     // Reactor 只负责检测事件，然后派发到绑定的工作线程处理
     std::weak_ptr<Connection> weak_conn = connection;
@@ -363,7 +385,7 @@ void FixServer::on_connection_close(int fd) {
             if (auto* simApp = dynamic_cast<SimulationApp*>(application_)) {
                 auto session = it->second->session();
                 if (session) {
-                    simApp->getSessionManager().unregisterSession(session->get_session_id());
+                    simApp->getSessionManager().unregisterSession(session->get_session_id(), session.get());
                 }
             }
         }
@@ -0,0 +1,79 @@
+/**
+ * @file replay_main.cpp
+ * @brief 撮合引擎输入日志重放工具
+ *
+ * 用法：
+ * @code
+ * fix_replay <journal> [--paced] [--speed N] [--no-verify] [--config config.ini]
+ * @endcode
+ * - 默认尽可能快地重放并逐字节比对 ExecutionReport，可作为吞吐基准
+ * - --paced 按记录时刻的间隔重放，--speed 调整倍速
+ * - --no-verify 只测吞吐，不比对回报
+ *
+ * 退出码：0 全部一致，1 存在不一致，2 日志无法读取或参数错误
+ */
+
+#include "app/journal_replay.hpp"
+#include "base/config.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    using namespace fix40;
+
+    std::string journalPath;
+    std::string configPath = "config.ini";
+    ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--paced") {
+            options.paced = true;
+        } else if (arg == "--speed" && i + 1 < argc) {
+            options.speed = std::atof(argv[++i]);
+        } else if (arg == "--no-verify") {
+            options.verify = false;
+        } else if (arg == "--config" && i + 1 < argc) {
+            configPath = argv[++i];
+        } else if (journalPath.empty() && arg.rfind("--", 0) != 0) {
+            journalPath = arg;
+        } else {
+            journalPath.clear();
+            break;
+        }
+    }
+    if (journalPath.empty() || options.speed <= 0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <journal> [--paced] [--speed N] [--no-verify] [--config config.ini]" << std::endl;
+        return 2;
+    }
+
+    // 分片数等引擎参数需与录制时一致
+    if (std::filesystem::exists(configPath)) {
+        Config::instance().load(configPath);
+    }
+
+    const ReplayResult result = replayJournal(journalPath, options);
+
+    std::cout << "Market data:   " << result.marketData << "\n"
+              << "Order events:  " << result.orderEvents << "\n"
+              << "Reports:       " << result.replayedReports << " replayed / "
+              << result.recordedReports << " recorded\n"
+              << "Elapsed:       " << result.elapsedSeconds << " s\n"
+              << "Throughput:    " << result.inputsPerSecond() << " inputs/s" << std::endl;
+
+    if (!result.error.empty()) {
+        std::cerr << "Journal error: " << result.error << std::endl;
+        return 2;
+    }
+    if (result.mismatches > 0) {
+        std::cerr << "Mismatches:    " << result.mismatches << "\n"
+                  << "First:         " << result.firstMismatch << std::endl;
+        return 1;
+    }
+    if (options.verify) {
+        std::cout << "All execution reports identical" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include "../catch2/catch.hpp"
+#include "app/account_actor.hpp"
+#include "app/simulation_app.hpp"
+#include "fix/fix_tags.hpp"
+#include "market/market_data.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace fix40;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Predicate>
+bool waitFor(Predicate pred, std::chrono::milliseconds timeout = 2000ms) {
+    auto start = std::chrono::steady_clock::now();
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() - start > timeout) {
+            return false;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    return true;
+}
+
+std::shared_ptr<const AccountView> makeView(const std::string& accountId, double balance) {
+    auto view = std::make_shared<AccountView>();
+    view->account = Account(accountId, balance);
+    return view;
+}
+
+} // namespace
+
+TEST_CASE("AccountViewTable - publish and replace views", "[account_actor]") {
+    AccountViewTable table;
+    REQUIRE(table.get("user001") == nullptr);
+
+    table.publish(makeView("user001", 100.0));
+    table.publish(makeView("user002", 200.0));
+    auto held = table.get("user001");
+    REQUIRE(held->account.balance == 100.0);
+
+    table.publish(makeView("user001", 150.0));
+    REQUIRE(table.get("user001")->account.balance == 150.0);
+    REQUIRE(table.size() == 2);
+    // 旧视图不可变，持有者不受替换影响
+    REQUIRE(held->account.balance == 100.0);
+}
+
+TEST_CASE("AccountViewTable - concurrent readers see each account's latest views in order", "[account_actor]") {
+    AccountViewTable table;
+    const std::vector<std::string> accounts{"user001", "user002", "user003"};
+    constexpr int kRounds = 5000;
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> monotonic{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            std::vector<double> last(accounts.size(), 0.0);
+            while (!done.load(std::memory_order_acquire)) {
+                // 交替读取不同账户，覆盖槽位缓存未命中的路径
+                for (size_t a = 0; a < accounts.size(); ++a) {
+                    if (auto view = table.get(accounts[a])) {
+                        if (view->account.balance < last[a]) {
+                            monotonic = false;
+                        }
+                        last[a] = view->account.balance;
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 1; i <= kRounds; ++i) {
+        for (const auto& accountId : accounts) {
+            table.publish(makeView(accountId, i));
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(monotonic);
+    REQUIRE(table.size() == accounts.size());
+    for (const auto& accountId : accounts) {
+        REQUIRE(table.get(accountId)->account.balance == kRounds);
+    }
+}
+
+TEST_CASE("AccountActor - runs tasks serially in post order", "[account_actor]") {
+    std::atomic<int> afterTask{0};
+    AccountActor actor([&]() { ++afterTask; });
+
+    SECTION("not started: runs inline") {
+        int value = 0;
+        actor.post([&]() { value = 1; });
+        REQUIRE(value == 1);
+        REQUIRE(afterTask == 1);
+    }
+
+    SECTION("started: single thread, ordered, nested posts run immediately") {
+        actor.start();
+        std::vector<int> order;
+        std::atomic<int> concurrent{0};
+        bool overlapped = false;
+        std::set<std::thread::id> threads;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < 500; ++i) {
+                    actor.post([&, p, i]() {
+                        if (++concurrent != 1) overlapped = true;
+                        threads.insert(std::this_thread::get_id());
+                        if (p == 0) order.push_back(i);
+                        --concurrent;
+                    });
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+
+        int nested = 0;
+        actor.post([&]() {
+            actor.post([&]() { nested = 1; });
+            // 嵌套投递在当前任务内完成
+            nested = nested == 1 ? 2 : -1;
+        });
+        actor.stop();
+
+        REQUIRE_FALSE(overlapped);
+        REQUIRE(threads.size() == 1);
+        REQUIRE(order.size() == 500);
+        for (int i = 0; i < 500; ++i) {
+            REQUIRE(order[i] == i);
+        }
+        REQUIRE(nested == 2);
+        REQUIRE(actor.processedCount() == 2001);
+        REQUIRE(afterTask == 2001);
+    }
+}
+
+TEST_CASE("AccountActor - a throwing task does not stop the actor", "[account_actor]") {
+    std::atomic<int> afterTask{0};
+    AccountActor actor([&]() { ++afterTask; });
+
+    SECTION("not started: the caller is not left marked as inside a task") {
+        actor.post([]() { throw std::runtime_error("task failed"); });
+        int value = 0;
+        actor.post([&]() { value = 1; });
+        REQUIRE(value == 1);
+        // 第二个任务走完整执行路径（而不是被当作嵌套投递直接执行）
+        REQUIRE(actor.processedCount() == 2);
+        REQUIRE(afterTask == 2);
+    }
+
+    SECTION("started: the writer thread keeps running") {
+        actor.start();
+        actor.post([]() { throw std::runtime_error("task failed"); });
+        actor.post([]() { throw 42; });
+        std::atomic<int> value{0};
+        actor.post([&]() { value = 1; });
+        actor.stop();
+        REQUIRE(value == 1);
+        REQUIRE(actor.processedCount() == 3);
+        REQUIRE(afterTask == 3);
+    }
+}
+
+TEST_CASE("AccountActor - tasks posted concurrently with stop() are never lost", "[account_actor]") {
+    constexpr int kProducers = 4;
+    constexpr int kTasks = 200;
+    for (int round = 0; round < 50; ++round) {
+        AccountActor actor;
+        std::atomic<int> executed{0};
+        actor.start();
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&]() {
+                for (int i = 0; i < kTasks; ++i) {
+                    actor.post([&]() { executed.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        actor.stop();
+        for (auto& t : producers) t.join();
+
+        REQUIRE(executed == kProducers * kTasks);
+        REQUIRE(actor.processedCount() == kProducers * kTasks);
+    }
+}
+
+TEST_CASE("SimulationApp - single writer mode serves queries from published views",
+          "[account_actor][application]") {
+    SimulationApp app;
+    app.setSingleWriterMode(true);
+    REQUIRE(app.isSingleWriterMode());
+
+    Instrument inst("TEST", "TESTEX", "T", 1.0, 1, 0.1);
+    app.getInstrumentManager().addInstrument(inst);
+
+    auto session = std::make_shared<Session>("SERVER", "CLIENT1", 30, []() {});
+    session->set_client_comp_id("CLIENT1");
+    app.getSessionManager().registerSession(session);
+    const SessionID sid = session->get_session_id();
+
+    app.start();
+    app.onLogon(sid);
+    REQUIRE(waitFor([&]() { return app.getAccountViews().get("CLIENT1") != nullptr; }));
+    REQUIRE(app.getAccountViews().get("CLIENT1")->account.balance == 1000000.0);
+
+    MarketData md;
+    md.setInstrumentID("TEST");
+    md.lastPrice = 100.0;
+    md.bidPrice1 = 99.0;
+    md.bidVolume1 = 10;
+    md.askPrice1 = 100.0;
+    md.askVolume1 = 10;
+    md.upperLimitPrice = 200.0;
+    md.lowerLimitPrice = 50.0;
+    app.getMatchingEngine().submitMarketData(md);
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST").has_value(); }));
+
+    FixMessage order;
+    order.set(tags::MsgType, "D");
+    order.set(tags::ClOrdID, "ACTOR-001");
+    order.set(tags::Symbol, "TEST");
+    order.set(tags::Side, "1");
+    order.set(tags::OrderQty, "2");
+    order.set(tags::OrdType, "2");
+    order.set(tags::Price, "100");
+    app.fromApp(order, sid);
+
+    REQUIRE(waitFor([&]() {
+        auto view = app.getAccountViews().get("CLIENT1");
+        return view && view->positions.size() == 1 && view->positions[0].longPosition == 2;
+    }));
+    app.stop();
+
+    auto view = app.getAccountViews().get("CLIENT1");
+    auto account = app.getAccountManager().getAccount("CLIENT1");
+    REQUIRE(account.has_value());
+    REQUIRE(view->account == *account);
+    REQUIRE(view->account.usedMargin == Approx(20.0));
+    REQUIRE(view->positions[0].longAvgPrice == Approx(100.0));
+}
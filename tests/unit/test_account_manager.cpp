@@ -53,6 +53,7 @@ TEST_CASE("AccountManager 使用 Store 时会加载并持久化账户", "[accoun
         REQUIRE(mgr.freezeMargin("user001", 100000.0));
         REQUIRE(mgr.confirmMargin("user001", 100000.0, 90000.0));
         REQUIRE(mgr.updatePositionProfit("user001", 1234.0));
+        REQUIRE(mgr.flushDirty() == 1);
 
         auto from_store = store.loadAccount("user001");
         REQUIRE(from_store.has_value());
@@ -62,6 +63,28 @@ TEST_CASE("AccountManager 使用 Store 时会加载并持久化账户", "[accoun
         REQUIRE(*from_store == *in_mem);
     }
 
+    SECTION("浮动盈亏更新只标记脏，flushDirty 时批量写入") {
+        AccountManager mgr(&store);
+        mgr.createAccount("user003", 1000000.0);
+
+        for (int i = 1; i <= 10; ++i) {
+            REQUIRE(mgr.updatePositionProfit("user003", 100.0 * i));
+        }
+        REQUIRE(mgr.dirtyCount() == 1);
+        REQUIRE(store.loadAccount("user003")->positionProfit == 0.0);
+
+        REQUIRE(mgr.flushDirty() == 1);
+        REQUIRE(mgr.dirtyCount() == 0);
+        REQUIRE(store.loadAccount("user003")->positionProfit == Approx(1000.0));
+        REQUIRE(mgr.flushDirty() == 0);
+
+        // 资金变动立即落盘，并带上尚未持久化的浮动盈亏
+        REQUIRE(mgr.updatePositionProfit("user003", 2000.0));
+        REQUIRE(mgr.freezeMargin("user003", 500.0));
+        REQUIRE(mgr.dirtyCount() == 0);
+        REQUIRE(store.loadAccount("user003")->positionProfit == Approx(2000.0));
+    }
+
     SECTION("新实例可从同一 Store 读取最新状态") {
         {
             AccountManager mgr(&store);
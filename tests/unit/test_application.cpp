@@ -8,6 +8,10 @@
 #include "app/engine/matching_engine.hpp"
 #include "app/model/order.hpp"
 #include "market/market_data.hpp"
+#include "storage/sqlite_store.hpp"
+
+#include <chrono>
+#include <thread>
 
 using namespace fix40;
 
@@ -1083,3 +1087,24 @@ TEST_CASE("SimulationApp - OrderMarginInfo 边界情况", "[application][margin]
         REQUIRE(info.getRemainingFrozen() == 0.0);
     }
 }
+
+TEST_CASE("SimulationApp - 浮动盈亏无需新行情也按间隔落盘", "[application][storage]") {
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    SimulationApp app(&store);
+    app.getAccountManager().createAccount("user001", 1000000.0);
+
+    // 最后一笔行情带来的浮动盈亏只标记脏，之后不再有行情
+    REQUIRE(app.getAccountManager().updatePositionProfit("user001", 1234.0));
+    REQUIRE(store.loadAccount("user001")->positionProfit == 0.0);
+
+    app.start();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (store.loadAccount("user001")->positionProfit == 0.0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    REQUIRE(store.loadAccount("user001")->positionProfit == Approx(1234.0));
+    REQUIRE(app.getAccountManager().dirtyCount() == 0);
+    app.stop();
+}
@@ -0,0 +1,179 @@
+#include "../catch2/catch.hpp"
+#include "app/engine/engine_journal.hpp"
+#include "app/engine/matching_engine.hpp"
+#include "app/journal_replay.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace fix40;
+
+namespace {
+
+Order makeJournalOrder(const std::string& clOrdID, OrderSide side, double price, int64_t qty,
+                       TimeInForce tif = TimeInForce::DAY) {
+    Order order;
+    order.clOrdID = clOrdID;
+    order.symbol = "IF2601";
+    order.side = side;
+    order.ordType = OrderType::LIMIT;
+    order.timeInForce = tif;
+    order.price = price;
+    order.orderQty = qty;
+    order.leavesQty = qty;
+    order.sessionID = SessionID("SERVER", "USER001");
+    return order;
+}
+
+MarketData makeJournalTick(double bid, double ask, int32_t volume) {
+    MarketData md;
+    md.setInstrumentID("IF2601");
+    md.lastPrice = (bid + ask) / 2;
+    md.bidPrice1 = bid;
+    md.bidVolume1 = volume;
+    md.askPrice1 = ask;
+    md.askVolume1 = volume;
+    md.askPrice2 = ask + 0.2;
+    md.askVolume2 = volume;
+    return md;
+}
+
+} // namespace
+
+TEST_CASE("EngineJournal - records round-trip", "[engine_journal]") {
+    std::stringstream stream;
+    EngineJournal journal;
+    journal.attach(stream, 2);
+
+    const auto t0 = std::chrono::system_clock::time_point(std::chrono::nanoseconds(1'700'000'000'123'456'789));
+    const MarketData md = makeJournalTick(99.0, 100.0, 5);
+    journal.recordMarketData(1, t0, md);
+
+    const Order order = makeJournalOrder("J1", OrderSide::SELL, 98.5, 3, TimeInForce::IOC);
+    journal.recordOrderEvent(0, t0 + std::chrono::microseconds(1), OrderEvent::newOrder(order, "USER001"));
+
+    CancelRequest cancel;
+    cancel.clOrdID = "J2";
+    cancel.origClOrdID = "J1";
+    cancel.symbol = "IF2601";
+    cancel.sessionID = order.sessionID;
+    journal.recordOrderEvent(0, t0, OrderEvent::cancelRequest(cancel, "USER001"));
+
+    ExecutionReport report;
+    report.orderID = "ORD-0000000001";
+    report.clOrdID = "J1";
+    report.execID = "EXEC-0000000001";
+    report.symbol = "IF2601";
+    report.ordStatus = OrderStatus::NEW;
+    report.transactTime = t0;
+    journal.recordExecutionReport(0, t0, order.sessionID, report);
+    REQUIRE(journal.recordCount() == 4);
+
+    EngineJournalReader reader;
+    REQUIRE(reader.attach(stream));
+    REQUIRE(reader.shardCount() == 2);
+
+    JournalRecord record;
+    REQUIRE(reader.next(record));
+    REQUIRE(record.kind == JournalRecordKind::MARKET_DATA);
+    REQUIRE(record.shard == 1);
+    REQUIRE(record.time() == t0);
+    REQUIRE(std::memcmp(&record.marketData, &md, sizeof(MarketData)) == 0);
+
+    REQUIRE(reader.next(record));
+    REQUIRE(record.kind == JournalRecordKind::ORDER_EVENT);
+    REQUIRE(record.event.type == OrderEventType::NEW_ORDER);
+    REQUIRE(record.event.userId == "USER001");
+    const Order* decoded = record.event.getOrder();
+    REQUIRE(decoded != nullptr);
+    REQUIRE(decoded->clOrdID == "J1");
+    REQUIRE(decoded->side == OrderSide::SELL);
+    REQUIRE(decoded->timeInForce == TimeInForce::IOC);
+    REQUIRE(decoded->price == 98.5);
+    REQUIRE(decoded->orderQty == 3);
+    REQUIRE(decoded->sessionID == order.sessionID);
+
+    REQUIRE(reader.next(record));
+    REQUIRE(record.event.type == OrderEventType::CANCEL_REQUEST);
+    REQUIRE(record.event.getCancelRequest()->origClOrdID == "J1");
+
+    REQUIRE(reader.next(record));
+    REQUIRE(record.kind == JournalRecordKind::EXECUTION_REPORT);
+    REQUIRE(record.sessionID == order.sessionID);
+    REQUIRE(record.reportBody.find("11=J1") != std::string::npos);
+
+    REQUIRE_FALSE(reader.next(record));
+    REQUIRE(reader.error().empty());
+}
+
+TEST_CASE("EngineJournal - rejects foreign files", "[engine_journal]") {
+    std::stringstream stream("not a journal at all");
+    EngineJournalReader reader;
+    REQUIRE_FALSE(reader.attach(stream));
+    REQUIRE_FALSE(reader.error().empty());
+}
+
+TEST_CASE("EngineJournal - live run replays to identical reports", "[engine_journal][replay]") {
+    std::stringstream stream;
+    EngineJournal journal;
+
+    {
+        MatchingEngine engine;
+        journal.attach(stream, engine.getShardCount());
+        engine.setJournal(&journal);
+
+        std::atomic<int> reports{0};
+        engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport&) { ++reports; });
+        engine.start();
+
+        engine.submitMarketData(makeJournalTick(99.0, 100.0, 2));
+        engine.submit(OrderEvent::newOrder(makeJournalOrder("R1", OrderSide::BUY, 100.2, 3), "USER001"));
+        engine.submit(OrderEvent::newOrder(makeJournalOrder("R2", OrderSide::BUY, 99.5, 1), "USER001"));
+        engine.submit(OrderEvent::newOrder(makeJournalOrder("R3", OrderSide::SELL, 98.0, 5, TimeInForce::IOC),
+                                           "USER001"));
+
+        auto waitFor = [&](int count) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (reports.load() < count && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        };
+        // R1 两档成交 2 笔，R2 确认，R3 成交 1 笔 + 剩余撤销
+        waitFor(5);
+        // 新行情触发 R2 成交
+        engine.submitMarketData(makeJournalTick(99.2, 99.4, 10));
+        waitFor(6);
+        engine.stop();
+        REQUIRE(reports.load() == 6);
+    }
+    journal.flush();
+
+    const std::string recorded = stream.str();
+    std::stringstream in(recorded);
+    const ReplayResult result = replayJournal(in);
+    REQUIRE(result.error.empty());
+    REQUIRE(result.marketData == 2);
+    REQUIRE(result.orderEvents == 3);
+    REQUIRE(result.recordedReports == 6);
+    REQUIRE(result.replayedReports == 6);
+    REQUIRE(result.mismatches == 0);
+    REQUIRE(result.ok());
+    // 重放的订单不携带订单号，由引擎分配；全部终结后槽位应全部回收
+    REQUIRE(result.liveOrders == 0);
+
+    SECTION("tampered report is detected") {
+        std::string tampered = recorded;
+        const size_t pos = tampered.find("11=R3");
+        REQUIRE(pos != std::string::npos);
+        tampered[pos + 4] = '9';
+        std::stringstream bad(tampered);
+        const ReplayResult mismatch = replayJournal(bad);
+        REQUIRE_FALSE(mismatch.ok());
+        REQUIRE(mismatch.mismatches >= 1);
+        REQUIRE(mismatch.firstMismatch.find("body differs") != std::string::npos);
+    }
+}
@@ -67,3 +67,43 @@ TEST_CASE("FixMessage field access", "[codec]") {
     // 访问不存在的字段应该抛异常
     REQUIRE_THROWS_AS(msg.get_string(tags::Text), std::runtime_error);
 }
+
+TEST_CASE("FixCodec encode_prepared matches encode", "[codec]") {
+    FixCodec codec;
+
+    FixMessage msg;
+    msg.set(tags::MsgType, "U5");
+    msg.set(tags::SenderCompID, "SERVER");
+    msg.set(tags::TargetCompID, "USER001");
+    msg.set(tags::MsgSeqNum, 7);
+    msg.set(tags::Account, "USER001");
+    msg.set(tags::Text, "notice");
+
+    FixCodec::EncodedBody body = codec.encode_body(msg);
+    REQUIRE(body.msgType == "U5");
+
+    FixMessage header;
+    header.set(tags::SenderCompID, "SERVER");
+    header.set(tags::TargetCompID, "USER001");
+    header.set(tags::MsgSeqNum, 7);
+    std::string prepared = codec.encode_prepared(header, body);
+    std::string full = codec.encode(msg);
+
+    // SendingTime 可能跨秒，解码后逐字段比较（decode 同时校验 CheckSum 与 BodyLength）
+    FixMessage a = codec.decode(prepared);
+    FixMessage b = codec.decode(full);
+    REQUIRE(a.get_fields().size() == b.get_fields().size());
+    for (const auto& [tag, value] : b.get_fields()) {
+        if (tag == tags::SendingTime || tag == tags::CheckSum) continue;
+        REQUIRE(a.get_string(tag) == value);
+    }
+
+    // 同一消息体可复用于不同接收方
+    FixMessage header2;
+    header2.set(tags::SenderCompID, "SERVER");
+    header2.set(tags::TargetCompID, "USER002");
+    header2.set(tags::MsgSeqNum, 3);
+    FixMessage c = codec.decode(codec.encode_prepared(header2, body));
+    REQUIRE(c.get_string(tags::TargetCompID) == "USER002");
+    REQUIRE(c.get_string(tags::Text) == "notice");
+}
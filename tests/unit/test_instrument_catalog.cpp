@@ -0,0 +1,120 @@
+#include "../catch2/catch.hpp"
+#include "app/manager/instrument_catalog.hpp"
+#include "app/manager/instrument_manager.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace fix40;
+
+namespace {
+
+std::string catalogPath(const std::string& name) {
+    return "/tmp/test_instrument_catalog_" + name + "_" +
+           std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".bin";
+}
+
+std::vector<Instrument> sampleInstruments() {
+    Instrument a("IF2601", "CFFEX", "IF", 0.2, 300, 0.12);
+    a.upperLimitPrice = 4400.0;
+    a.lowerLimitPrice = 3600.0;
+    a.preSettlementPrice = 4000.0;
+    Instrument b("IC2601", "CFFEX", "IC", 0.2, 200, 0.14);
+    Instrument c("rb2605", "SHFE", "rb", 1.0, 10, 0.09);
+    return {a, b, c};
+}
+
+} // namespace
+
+TEST_CASE("InstrumentCatalog - 写入后映射读取", "[instrument_catalog]") {
+    const std::string path = catalogPath("roundtrip");
+    const auto instruments = sampleInstruments();
+
+    const auto before = std::chrono::system_clock::now();
+    REQUIRE(InstrumentCatalog::write(path, instruments));
+    REQUIRE_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    InstrumentCatalog catalog;
+    REQUIRE(catalog.open(path));
+    REQUIRE(catalog.size() == instruments.size());
+    REQUIRE(catalog.createdAt() >= before - std::chrono::seconds(1));
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        REQUIRE(catalog.instrument(i) == instruments[i]);
+    }
+    REQUIRE(catalog.instruments() == instruments);
+
+    catalog.close();
+    REQUIRE_FALSE(catalog.isOpen());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("InstrumentCatalog - 拒绝损坏或不兼容的文件", "[instrument_catalog]") {
+    const std::string path = catalogPath("corrupt");
+    REQUIRE(InstrumentCatalog::write(path, sampleInstruments()));
+    const auto size = std::filesystem::file_size(path);
+    InstrumentCatalog catalog;
+
+    SECTION("不存在") {
+        REQUIRE_FALSE(catalog.open(path + ".missing"));
+        REQUIRE_FALSE(catalog.error().empty());
+    }
+
+    SECTION("截断") {
+        std::filesystem::resize_file(path, size - 1);
+        REQUIRE_FALSE(catalog.open(path));
+        REQUIRE(catalog.error() == "size mismatch");
+    }
+
+    SECTION("内容被改写") {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(size - 2));
+        file.put('#');
+        file.close();
+        REQUIRE_FALSE(catalog.open(path));
+        REQUIRE(catalog.error() == "checksum mismatch");
+    }
+
+    SECTION("版本不符") {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(InstrumentCatalog::kMagic));
+        const uint32_t version = InstrumentCatalog::kVersion + 1;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        file.close();
+        REQUIRE_FALSE(catalog.open(path));
+        REQUIRE(catalog.error().rfind("unsupported version", 0) == 0);
+    }
+
+    REQUIRE_FALSE(catalog.isOpen());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("InstrumentManager - 合约目录保存与加载", "[instrument_catalog][instrument_manager]") {
+    const std::string path = catalogPath("manager");
+
+    InstrumentManager source;
+    source.addInstruments(sampleInstruments());
+    // 写入当前价格
+    source.updateLimitPrices("IC2601", 6600.0, 5400.0);
+    REQUIRE(source.saveCatalog(path));
+
+    InstrumentManager restored;
+    REQUIRE(restored.loadFromCatalog(path));
+    REQUIRE(restored.size() == 3);
+    REQUIRE(restored.getInstrumentCopy("IF2601") == source.getInstrumentCopy("IF2601"));
+    REQUIRE(restored.getPrices("IC2601")->upperLimitPrice == 6600.0);
+    REQUIRE(restored.getInstrument("rb2605")->exchangeId == "SHFE");
+    REQUIRE(restored.searchByPrefix("I") == std::vector<std::string>{"IC2601", "IF2601"});
+
+    SECTION("超过有效期不加载") {
+        InstrumentManager stale;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        REQUIRE_FALSE(stale.loadFromCatalog(path, std::chrono::seconds(1)));
+        REQUIRE(stale.size() == 0);
+        REQUIRE(stale.loadFromCatalog(path, std::chrono::seconds(60)));
+    }
+
+    std::filesystem::remove(path);
+}
@@ -6,7 +6,10 @@
  */
 
 #include "../catch2/catch.hpp"
+#include "app/manager/instrument_batch.hpp"
 #include "app/manager/instrument_manager.hpp"
+#include <atomic>
+#include <thread>
 #include <fstream>
 #include <cstdio>
 #include <random>
@@ -70,7 +73,7 @@ TEST_CASE("InstrumentManager addInstrument 添加单个合约", "[instrument_man
     REQUIRE(mgr.size() == 1);
     REQUIRE(mgr.hasInstrument("IF2601"));
     
-    const Instrument* retrieved = mgr.getInstrument("IF2601");
+    auto retrieved = mgr.getInstrument("IF2601");
     REQUIRE(retrieved != nullptr);
     REQUIRE(retrieved->instrumentId == "IF2601");
     REQUIRE(retrieved->exchangeId == "CFFEX");
@@ -101,13 +104,13 @@ TEST_CASE("InstrumentManager getInstrument 查询合约", "[instrument_manager][
     mgr.addInstrument(inst);
     
     SECTION("查询存在的合约") {
-        const Instrument* retrieved = mgr.getInstrument("IF2601");
+        auto retrieved = mgr.getInstrument("IF2601");
         REQUIRE(retrieved != nullptr);
         REQUIRE(retrieved->instrumentId == "IF2601");
     }
     
     SECTION("查询不存在的合约") {
-        const Instrument* retrieved = mgr.getInstrument("UNKNOWN");
+        auto retrieved = mgr.getInstrument("UNKNOWN");
         REQUIRE(retrieved == nullptr);
     }
 }
@@ -164,7 +167,13 @@ TEST_CASE("InstrumentManager updateLimitPrices 更新涨跌停价格", "[instrum
         bool result = mgr.updateLimitPrices("IF2601", 4400.0, 3600.0);
         REQUIRE(result == true);
         
-        const Instrument* retrieved = mgr.getInstrument("IF2601");
+        auto prices = mgr.getPrices("IF2601");
+        REQUIRE(prices.has_value());
+        REQUIRE(prices->upperLimitPrice == 4400.0);
+        REQUIRE(prices->lowerLimitPrice == 3600.0);
+        REQUIRE(mgr.getInstrumentCopy("IF2601")->upperLimitPrice == 4400.0);
+        
+        auto retrieved = mgr.getInstrument("IF2601");
         REQUIRE(retrieved->upperLimitPrice == 4400.0);
         REQUIRE(retrieved->lowerLimitPrice == 3600.0);
     }
@@ -185,8 +194,34 @@ TEST_CASE("InstrumentManager updatePreSettlementPrice 更新昨结算价", "[ins
         bool result = mgr.updatePreSettlementPrice("IF2601", 4000.0);
         REQUIRE(result == true);
         
-        const Instrument* retrieved = mgr.getInstrument("IF2601");
+        auto retrieved = mgr.getInstrument("IF2601");
         REQUIRE(retrieved->preSettlementPrice == 4000.0);
+        REQUIRE(mgr.getPrices("IF2601")->preSettlementPrice == 4000.0);
+        REQUIRE(mgr.getInstrumentCopy("IF2601")->preSettlementPrice == 4000.0);
+        REQUIRE(mgr.getRiskParams()->find("IF2601")->preSettlementPrice == 4000.0);
+    }
+
+    SECTION("风控参数表在写入时发布，已取得的表不变") {
+        const auto before = mgr.getRiskParams();
+        const auto index = before->indexOf("IF2601");
+        REQUIRE(index.has_value());
+
+        mgr.updatePreSettlementPrice("IF2601", 4000.0);
+        const auto after = mgr.getRiskParams();
+        REQUIRE(after != before);
+        REQUIRE(before->find("IF2601")->preSettlementPrice == 0.0);
+        REQUIRE(after->find("IF2601")->preSettlementPrice == 4000.0);
+        REQUIRE(after->indexOf("IF2601") == index);
+
+        // 新增合约沿用已有下标，昨结算价更新不丢失
+        mgr.addInstrument(Instrument("IC2601", "CFFEX", "IC", 0.2, 200, 0.12));
+        const auto added = mgr.getRiskParams();
+        REQUIRE(added->size() == 2);
+        REQUIRE(added->indexOf("IF2601") == index);
+        REQUIRE(added->find("IF2601")->preSettlementPrice == 4000.0);
+        REQUIRE(added->find("IC2601")->volumeMultiple == 200);
+        // 没有写入时读取不会重建
+        REQUIRE(mgr.getRiskParams() == added);
     }
     
     SECTION("更新不存在的合约") {
@@ -242,13 +277,13 @@ TEST_CASE("InstrumentManager loadFromConfig 从配置文件加载", "[instrument
         REQUIRE(result == true);
         REQUIRE(mgr.size() == 2);
         
-        const Instrument* inst1 = mgr.getInstrument("IF2601");
+        auto inst1 = mgr.getInstrument("IF2601");
         REQUIRE(inst1 != nullptr);
         REQUIRE(inst1->exchangeId == "CFFEX");
         REQUIRE(inst1->volumeMultiple == 300);
         REQUIRE(inst1->marginRate == Approx(0.12));
         
-        const Instrument* inst2 = mgr.getInstrument("IC2601");
+        auto inst2 = mgr.getInstrument("IC2601");
         REQUIRE(inst2 != nullptr);
         REQUIRE(inst2->volumeMultiple == 200);
         
@@ -283,7 +318,7 @@ TEST_CASE("InstrumentManager loadFromConfig 从配置文件加载", "[instrument
         
         REQUIRE(result == true);
         
-        const Instrument* inst = mgr.getInstrument("IF2601");
+        auto inst = mgr.getInstrument("IF2601");
         REQUIRE(inst != nullptr);
         REQUIRE(inst->upperLimitPrice == 4400.0);
         REQUIRE(inst->lowerLimitPrice == 3600.0);
@@ -305,6 +340,201 @@ TEST_CASE("InstrumentManager 覆盖已存在的合约", "[instrument_manager][un
     
     REQUIRE(mgr.size() == 1);  // 仍然只有一个合约
     
-    const Instrument* retrieved = mgr.getInstrument("IF2601");
+    auto retrieved = mgr.getInstrument("IF2601");
     REQUIRE(retrieved->marginRate == Approx(0.15));  // 应该是新的值
 }
+
+TEST_CASE("InstrumentManager 检索索引 - 前缀/品种/交易所", "[instrument_manager][unit]") {
+    InstrumentManager mgr;
+    mgr.addInstruments({
+        Instrument("IF2603", "CFFEX", "IF", 0.2, 300, 0.12),
+        Instrument("IF2601", "CFFEX", "IF", 0.2, 300, 0.12),
+        Instrument("IC2601", "CFFEX", "IC", 0.2, 200, 0.12),
+        Instrument("I2601", "DCE", "I", 0.5, 100, 0.1),
+        Instrument("IF2602", "CFFEX", "IF", 0.2, 300, 0.12),
+    });
+
+    SECTION("前缀搜索按字母排序并截断") {
+        REQUIRE(mgr.searchByPrefix("IF") == std::vector<std::string>{"IF2601", "IF2602", "IF2603"});
+        REQUIRE(mgr.searchByPrefix("IF", 2) == std::vector<std::string>{"IF2601", "IF2602"});
+        REQUIRE(mgr.searchByPrefix("I") ==
+                std::vector<std::string>{"I2601", "IC2601", "IF2601", "IF2602", "IF2603"});
+        REQUIRE(mgr.searchByPrefix("IF2601") == std::vector<std::string>{"IF2601"});
+        REQUIRE(mgr.searchByPrefix("IF26010").empty());
+        REQUIRE(mgr.searchByPrefix("ZZ").empty());
+        REQUIRE(mgr.searchByPrefix("").empty());
+    }
+
+    SECTION("品种和交易所二级索引") {
+        REQUIRE(mgr.getInstrumentsByProduct("IF") ==
+                std::vector<std::string>{"IF2601", "IF2602", "IF2603"});
+        REQUIRE(mgr.getInstrumentsByExchange("DCE") == std::vector<std::string>{"I2601"});
+        REQUIRE(mgr.getInstrumentsByExchange("CFFEX").size() == 4);
+        REQUIRE(mgr.getInstrumentsByProduct("RB").empty());
+    }
+
+    SECTION("合约集合变化后索引重建，旧索引不受影响") {
+        auto before = mgr.getSearchIndex();
+        REQUIRE(mgr.getSearchIndex() == before);  // 未变化时复用
+
+        mgr.addInstrument(Instrument("IF2600", "CFFEX", "IF", 0.2, 300, 0.12));
+        REQUIRE(mgr.searchByPrefix("IF", 1) == std::vector<std::string>{"IF2600"});
+        REQUIRE(mgr.getInstrumentsByProduct("IF").size() == 4);
+        REQUIRE(before->byProduct("IF").size() == 3);
+
+        mgr.clear();
+        REQUIRE(mgr.searchByPrefix("IF").empty());
+        REQUIRE(mgr.getInstrumentsByExchange("CFFEX").empty());
+    }
+}
+
+TEST_CASE("InstrumentManager 合约表整体替换，已取得的合约信息不失效", "[instrument_manager][unit]") {
+    InstrumentManager mgr;
+    mgr.addInstrument(Instrument("IF2601", "CFFEX", "IF", 0.2, 300, 0.12));
+    mgr.addInstrument(Instrument("IC2601", "CFFEX", "IC", 0.2, 200, 0.12));
+    mgr.updateLimitPrices("IC2601", 6600.0, 5400.0);
+
+    auto held = mgr.getInstrument("IF2601");
+    auto table = mgr.getTable();
+
+    // 覆盖 IF2601：新条目，价格随新合约信息重置；IC2601 沿用原条目及其价格
+    Instrument replaced("IF2601", "CFFEX", "IF", 0.2, 300, 0.15);
+    mgr.addInstrument(replaced);
+    REQUIRE(mgr.getInstrument("IF2601")->marginRate == Approx(0.15));
+    REQUIRE(mgr.getPrices("IC2601")->upperLimitPrice == 6600.0);
+    REQUIRE(mgr.getTable() != table);
+
+    mgr.clear();
+    REQUIRE(mgr.getInstrument("IF2601") == nullptr);
+    // 旧表与从中取得的合约信息仍然有效
+    REQUIRE(held->marginRate == Approx(0.12));
+    REQUIRE(table->size() == 2);
+    REQUIRE(table->find("IC2601")->prices.load().lowerLimitPrice == 5400.0);
+}
+
+TEST_CASE("InstrumentManager 并发更新价格时读取到一致的涨跌停价", "[instrument_manager][unit]") {
+    InstrumentManager mgr;
+    mgr.addInstrument(Instrument("IF2601", "CFFEX", "IF", 0.2, 300, 0.12));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int i = 1; i <= 20000; ++i) {
+            // 涨停价恒为跌停价的两倍
+            mgr.updateLimitPrices("IF2601", 2.0 * i, 1.0 * i);
+            if (i % 100 == 0) {
+                mgr.updatePreSettlementPrice("IF2601", 1.5 * i);
+            }
+        }
+        done = true;
+    });
+
+    bool consistent = true;
+    while (!done) {
+        const InstrumentPrices prices = *mgr.getPrices("IF2601");
+        if (prices.upperLimitPrice != 2.0 * prices.lowerLimitPrice) {
+            consistent = false;
+        }
+    }
+    writer.join();
+
+    REQUIRE(consistent);
+    const InstrumentPrices last = *mgr.getPrices("IF2601");
+    REQUIRE(last.upperLimitPrice == 40000.0);
+    REQUIRE(last.preSettlementPrice == 30000.0);
+}
+
+TEST_CASE("InstrumentBatchLoader 分批发布，查询超时时补发已收到的合约", "[instrument_manager][unit]") {
+    InstrumentManager mgr;
+    InstrumentBatchLoader loader(2);
+
+    // 模拟 CTP 逐条回调：每攒满 2 个发布一次
+    loader.add(mgr, Instrument("IF2601", "CFFEX", "IF", 0.2, 300, 0.12));
+    REQUIRE(mgr.size() == 0);
+    loader.add(mgr, Instrument("IF2602", "CFFEX", "IF", 0.2, 300, 0.12));
+    REQUIRE(mgr.size() == 2);
+    loader.add(mgr, Instrument("IC2601", "CFFEX", "IC", 0.2, 200, 0.12));
+    REQUIRE(mgr.size() == 2);
+    REQUIRE(loader.pendingCount() == 1);
+
+    // 超时：最后一条回报未到，剩余部分仍然发布
+    REQUIRE(loader.flush(mgr) == 1);
+    REQUIRE(mgr.size() == 3);
+    REQUIRE(mgr.hasInstrument("IC2601"));
+    REQUIRE(loader.flush(mgr) == 0);
+
+    // 新一轮查询丢弃上一轮未发布的缓存
+    loader.add(mgr, Instrument("IH2601", "CFFEX", "IH", 0.2, 300, 0.12));
+    loader.clear();
+    REQUIRE(loader.flush(mgr) == 0);
+    REQUIRE_FALSE(mgr.hasInstrument("IH2601"));
+}
+
+namespace {
+
+/// 生成 count 个期权/期货合约（规模接近 CTP 全量合约）
+std::vector<Instrument> makeBulkInstruments(size_t count) {
+    std::vector<Instrument> instruments;
+    instruments.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Instrument inst("IO26" + std::to_string(10000 + i) + "-C-" + std::to_string(3000 + i % 500),
+                        i % 2 ? "CFFEX" : "SHFE", "IO" + std::to_string(i % 40),
+                        0.2, static_cast<int>(100 + i % 3 * 100), 0.12);
+        inst.upperLimitPrice = 4400.0 + i % 7;
+        inst.lowerLimitPrice = 3600.0 - i % 7;
+        inst.preSettlementPrice = 4000.0;
+        instruments.push_back(inst);
+    }
+    return instruments;
+}
+
+std::string toInstrumentsJson(const std::vector<Instrument>& instruments) {
+    std::ostringstream oss;
+    oss << std::setprecision(17) << "{\n  \"instruments\": [\n";
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        const Instrument& inst = instruments[i];
+        oss << "    {\"instrumentId\": \"" << inst.instrumentId << "\", "
+            << "\"exchangeId\": \"" << inst.exchangeId << "\", "
+            << "\"productId\": \"" << inst.productId << "\", "
+            << "\"priceTick\": " << inst.priceTick << ", "
+            << "\"volumeMultiple\": " << inst.volumeMultiple << ", "
+            << "\"marginRate\": " << inst.marginRate << ", "
+            << "\"upperLimitPrice\": " << inst.upperLimitPrice << ", "
+            << "\"lowerLimitPrice\": " << inst.lowerLimitPrice << ", "
+            << "\"preSettlementPrice\": " << inst.preSettlementPrice << "}"
+            << (i + 1 < instruments.size() ? ",\n" : "\n");
+    }
+    oss << "  ]\n}\n";
+    return oss.str();
+}
+
+template<typename Fn>
+double elapsedMs(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+/**
+ * 基准：启动时加载 2 万个合约的耗时（JSON 文本 vs 二进制合约目录）。默认不运行，使用 `unit_tests "[.benchmark]"` 执行。
+ */
+TEST_CASE("InstrumentManager 基准 - 启动加载合约", "[instrument_manager][.benchmark]") {
+    const auto instruments = makeBulkInstruments(20000);
+    const std::string jsonFile = createTempConfigFile(toInstrumentsJson(instruments));
+
+    InstrumentManager fromJson;
+    const double jsonMs = elapsedMs([&]() { REQUIRE(fromJson.loadFromConfig(jsonFile)); });
+    REQUIRE(fromJson.size() == instruments.size());
+
+    const std::string catalogFile = jsonFile + ".catalog";
+    REQUIRE(fromJson.saveCatalog(catalogFile));
+    InstrumentManager fromCatalog;
+    const double catalogMs = elapsedMs([&]() { REQUIRE(fromCatalog.loadFromCatalog(catalogFile)); });
+    REQUIRE(fromCatalog.size() == instruments.size());
+    REQUIRE(fromCatalog.getInstrumentCopy(instruments[7].instrumentId) == instruments[7]);
+    WARN("JSON: " << jsonMs << " ms, catalog: " << catalogMs << " ms");
+
+    removeTempFile(jsonFile);
+    removeTempFile(catalogFile);
+}
@@ -18,6 +18,13 @@
 #include "app/model/order.hpp"
 #include "market/market_data.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 using namespace fix40;
 
 // =============================================================================
@@ -395,3 +402,329 @@ TEST_CASE("Property 4: 市价单撮合正确性", "[matching_engine][property]")
         });
 }
 
+// =============================================================================
+// 分片模式
+// =============================================================================
+
+TEST_CASE("MatchingEngine - 分片路由与单订单回报有序", "[matching_engine][shard]") {
+    MatchingEngine engine(4);
+    REQUIRE(engine.getShardCount() == 4);
+
+    engine.pinInstrument("IF2601", 3);
+    REQUIRE(engine.shardFor("IF2601") == 3);
+    REQUIRE(engine.shardFor("IC2601") < 4);
+
+    std::mutex mutex;
+    std::map<std::string, std::vector<OrderStatus>> statuses;
+    engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport& rpt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        statuses[rpt.clOrdID].push_back(rpt.ordStatus);
+    });
+    engine.start();
+
+    const std::vector<std::string> symbols = {"IF2601", "IC2601", "IH2601", "cu2601", "au2601", "rb2601"};
+    SessionID sid("SERVER", "USER001");
+    for (const auto& symbol : symbols) {
+        for (int i = 0; i < 10; ++i) {
+            Order order = makeTestLimitOrder(symbol + "-" + std::to_string(i), OrderSide::BUY, 100.0, 1, symbol);
+            order.sessionID = sid;
+            engine.submit(OrderEvent::newOrder(order, "USER001"));
+        }
+    }
+
+    auto waitFor = [&](size_t expectedReports) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                size_t total = 0;
+                for (const auto& [id, s] : statuses) total += s.size();
+                if (total >= expectedReports) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    };
+    REQUIRE(waitFor(symbols.size() * 10));
+    REQUIRE(engine.getTotalPendingOrderCount() == symbols.size() * 10);
+
+    // 每个合约的行情只路由到其所属分片，触发该合约的全部挂单成交
+    for (const auto& symbol : symbols) {
+        MarketData md;
+        md.setInstrumentID(symbol.c_str());
+        md.bidPrice1 = 99.0;
+        md.bidVolume1 = 10;
+        md.askPrice1 = 100.0;
+        md.askVolume1 = 10;
+        md.lastPrice = 100.0;
+        engine.submitMarketData(md);
+    }
+    REQUIRE(waitFor(symbols.size() * 20));
+    engine.stop();
+
+    REQUIRE(engine.getTotalPendingOrderCount() == 0);
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(statuses.size() == symbols.size() * 10);
+    for (const auto& [clOrdID, s] : statuses) {
+        REQUIRE(s == std::vector<OrderStatus>{OrderStatus::NEW, OrderStatus::FILLED});
+    }
+}
+
+TEST_CASE("MatchingEngine - 统一唤醒与批量处理行情/订单", "[matching_engine][batch]") {
+    MatchingEngine engine;
+
+    std::mutex mutex;
+    std::vector<double> lastPrices;
+    std::vector<ExecutionReport> reports;
+    engine.setMarketDataUpdateCallback([&](const std::string&, double lastPrice) {
+        std::lock_guard<std::mutex> lock(mutex);
+        lastPrices.push_back(lastPrice);
+    });
+    engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport& rpt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(rpt);
+    });
+    engine.start();
+
+    auto waitUntil = [&](auto&& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (done()) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+
+    // 仅有行情、没有任何订单流量时，行情同样被唤醒并按序全部处理
+    const int kTicks = 3 * 64 + 7;
+    for (int i = 1; i <= kTicks; ++i) {
+        MarketData md;
+        md.setInstrumentID("TEST");
+        md.bidPrice1 = 99.0;
+        md.bidVolume1 = 10;
+        md.askPrice1 = 100.0 + i;
+        md.askVolume1 = 10;
+        md.lastPrice = 100.0 + i;
+        engine.submitMarketData(md);
+    }
+    REQUIRE(waitUntil([&] { return lastPrices.size() == static_cast<size_t>(kTicks); }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < kTicks; ++i) {
+            REQUIRE(lastPrices[i] == 100.0 + i + 1);
+        }
+    }
+
+    // 先提交的行情先于随后提交的订单生效
+    MarketData md;
+    md.setInstrumentID("TEST");
+    md.bidPrice1 = 99.0;
+    md.bidVolume1 = 10;
+    md.askPrice1 = 100.0;
+    md.askVolume1 = 10;
+    md.lastPrice = 100.0;
+    engine.submitMarketData(md);
+    Order order = makeTestLimitOrder("BATCH-1", OrderSide::BUY, 100.0, 1, "TEST");
+    order.sessionID = SessionID("SERVER", "USER001");
+    engine.submit(OrderEvent::newOrder(order, "USER001"));
+
+    REQUIRE(waitUntil([&] { return !reports.empty(); }));
+    engine.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(reports.size() == 1);
+    REQUIRE(reports[0].ordStatus == OrderStatus::FILLED);
+    REQUIRE(reports[0].lastPx == 100.0);
+}
+
+TEST_CASE("MatchingEngine - 积压时按合约合并行情", "[matching_engine][conflation]") {
+    MatchingEngine engine;
+    engine.setConflationThreshold(100);
+
+    std::mutex mutex;
+    std::map<std::string, std::vector<double>> seen;
+    engine.setMarketDataUpdateCallback([&](const std::string& instrumentId, double lastPrice) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen[instrumentId].push_back(lastPrice);
+    });
+
+    // 引擎启动前灌入积压行情
+    const int kTicksPerInstrument = 250;
+    for (int i = 1; i <= kTicksPerInstrument; ++i) {
+        for (const char* symbol : {"IF2601", "IC2601"}) {
+            MarketData md;
+            md.setInstrumentID(symbol);
+            md.lastPrice = 1000.0 + i;
+            md.bidPrice1 = 999.0 + i;
+            md.bidVolume1 = 1;
+            md.askPrice1 = 1001.0 + i;
+            md.askVolume1 = 1;
+            md.volume = i;
+            engine.submitMarketData(md);
+        }
+    }
+    engine.start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    bool done = false;
+    while (!done && std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = seen["IF2601"].size() > 0 && seen["IC2601"].size() > 0 &&
+                   seen["IF2601"].back() == 1000.0 + kTicksPerInstrument &&
+                   seen["IC2601"].back() == 1000.0 + kTicksPerInstrument;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    REQUIRE(done);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t processed = seen["IF2601"].size() + seen["IC2601"].size();
+    REQUIRE(processed < static_cast<size_t>(2 * kTicksPerInstrument));
+    REQUIRE(engine.getConflatedTickCount() == 2 * kTicksPerInstrument - processed);
+    // 合并后仍按时间顺序推进
+    for (const auto& [symbol, prices] : seen) {
+        REQUIRE(std::is_sorted(prices.begin(), prices.end()));
+    }
+
+    const auto snapshot = engine.getMarketSnapshot("IF2601");
+    REQUIRE(snapshot.has_value());
+    REQUIRE(snapshot->askPrice1 == 1001.0 + kTicksPerInstrument);
+}
+
+// =============================================================================
+// 五档深度成交
+// =============================================================================
+
+TEST_CASE("MatchingEngine - 按五档深度逐档成交", "[matching_engine][depth]") {
+    MatchingEngine engine;
+
+    std::mutex mutex;
+    std::vector<ExecutionReport> reports;
+    engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport& rpt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(rpt);
+    });
+
+    // 卖盘：100.0 x 3, 100.2 x 2, 100.4 x 5；买盘：99.8 x 4
+    MarketData md;
+    md.setInstrumentID("IF2601");
+    md.lastPrice = 100.0;
+    md.askPrice1 = 100.0;
+    md.askVolume1 = 3;
+    md.askPrice2 = 100.2;
+    md.askVolume2 = 2;
+    md.askPrice3 = 100.4;
+    md.askVolume3 = 5;
+    md.bidPrice1 = 99.8;
+    md.bidVolume1 = 4;
+    engine.submitMarketData(md);
+
+    const SessionID sid("SERVER", "USER001");
+    auto submit = [&](Order order) {
+        order.sessionID = sid;
+        engine.submit(OrderEvent::newOrder(order, "USER001"));
+    };
+    auto waitForReports = [&](size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (reports.size() >= count) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+
+    SECTION("跨档成交，剩余部分挂单") {
+        // 限价 100.2 只能吃到前两档共 5 手，剩余 2 手挂单
+        submit(makeTestLimitOrder("D1", OrderSide::BUY, 100.2, 7));
+        engine.start();
+        REQUIRE(waitForReports(2));
+        engine.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].lastPx == 100.0);
+        REQUIRE(reports[0].lastShares == 3);
+        REQUIRE(reports[1].lastPx == 100.2);
+        REQUIRE(reports[1].lastShares == 2);
+        REQUIRE(reports[1].ordStatus == OrderStatus::PARTIALLY_FILLED);
+        REQUIRE(reports[1].leavesQty == 2);
+        REQUIRE(reports[1].avgPx == Approx((100.0 * 3 + 100.2 * 2) / 5));
+        REQUIRE(engine.getTotalPendingOrderCount() == 1);
+    }
+
+    SECTION("同一笔行情内已消耗的量不再重复使用") {
+        submit(makeTestLimitOrder("D1", OrderSide::BUY, 100.0, 2));
+        submit(makeTestLimitOrder("D2", OrderSide::BUY, 100.0, 2));
+        engine.start();
+        REQUIRE(waitForReports(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        engine.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].clOrdID == "D1");
+        REQUIRE(reports[0].ordStatus == OrderStatus::FILLED);
+        // 卖一只剩 1 手，D2 部分成交后挂单
+        REQUIRE(reports[1].clOrdID == "D2");
+        REQUIRE(reports[1].lastShares == 1);
+        REQUIRE(reports[1].ordStatus == OrderStatus::PARTIALLY_FILLED);
+        REQUIRE(engine.getTotalPendingOrderCount() == 1);
+    }
+
+    SECTION("IOC 剩余部分撤销") {
+        Order order = makeTestLimitOrder("D1", OrderSide::SELL, 99.0, 6);
+        order.timeInForce = TimeInForce::IOC;
+        submit(order);
+        engine.start();
+        REQUIRE(waitForReports(2));
+        engine.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].lastShares == 4);
+        REQUIRE(reports[1].ordStatus == OrderStatus::CANCELED);
+        REQUIRE(reports[1].cumQty == 4);
+        REQUIRE(reports[1].leavesQty == 0);
+        REQUIRE(engine.getTotalPendingOrderCount() == 0);
+    }
+
+    SECTION("FOK 五档不足时整单撤销") {
+        Order order = makeTestLimitOrder("D1", OrderSide::BUY, 100.4, 11);
+        order.timeInForce = TimeInForce::FOK;
+        submit(order);
+        engine.start();
+        REQUIRE(waitForReports(1));
+        engine.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].ordStatus == OrderStatus::CANCELED);
+        REQUIRE(reports[0].cumQty == 0);
+    }
+
+    SECTION("新行情到达后挂单继续按深度成交") {
+        submit(makeTestLimitOrder("D1", OrderSide::BUY, 100.0, 5));
+        engine.start();
+        REQUIRE(waitForReports(1));
+
+        md.askVolume1 = 10;
+        engine.submitMarketData(md);
+        REQUIRE(waitForReports(2));
+        engine.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].lastShares == 3);
+        REQUIRE(reports[1].lastShares == 2);
+        REQUIRE(reports[1].ordStatus == OrderStatus::FILLED);
+        REQUIRE(engine.getTotalPendingOrderCount() == 0);
+    }
+}
@@ -226,6 +226,33 @@ TEST_CASE("OrderBook - Cancel order", "[order_book]") {
     REQUIRE(book.empty());
 }
 
+TEST_CASE("OrderBook - Cancel from middle of a deep price level", "[order_book]") {
+    OrderBook book("TEST");
+    
+    for (int i = 0; i < 1000; ++i) {
+        Order order = createOrder("BUY" + std::to_string(i), OrderSide::BUY, 100.0, 1);
+        book.addOrder(order);
+    }
+    
+    auto canceled = book.cancelOrder("BUY500");
+    REQUIRE(canceled.has_value());
+    REQUIRE(book.getBidOrderCount() == 999);
+    REQUIRE(book.findOrder("BUY500") == nullptr);
+    
+    auto levels = book.getBidLevels(1);
+    REQUIRE(levels.size() == 1);
+    REQUIRE(levels[0].totalQty == 999);
+    REQUIRE(levels[0].orders.size() == 999);
+    REQUIRE(levels[0].orders.front().clOrdID == "BUY0");
+    
+    // 撤单后时间优先不变：卖单依次吃掉 BUY0..BUY499、BUY501
+    Order sellOrder = createOrder("SELL001", OrderSide::SELL, 100.0, 501);
+    auto trades = book.addOrder(sellOrder);
+    REQUIRE(trades.size() == 501);
+    REQUIRE(trades.back().buyClOrdID == "BUY501");
+    REQUIRE(book.findOrder("BUY502") != nullptr);
+}
+
 TEST_CASE("OrderBook - Cancel non-existent order", "[order_book]") {
     OrderBook book("TEST");
     
@@ -871,3 +898,80 @@ TEST_CASE("OrderBook - IOC sell order sweeps multiple price levels", "[order_boo
     REQUIRE(sellOrder.cumQty == 12);
     REQUIRE(sellOrder.status == OrderStatus::FILLED);
 }
+
+// ============================================================================
+// 整数价位阶梯
+// ============================================================================
+
+TEST_CASE("PriceLadder - best-first iteration and re-centering", "[order_book][tick_ladder]") {
+    struct Slot { int value = 0; };
+    PriceLadder<Slot> bids(0.5, true);
+    PriceLadder<Slot> asks(0.5, false);
+
+    for (double price : {100.0, 99.5, 101.0}) {
+        bids[price].value = 1;
+        asks[price].value = 1;
+    }
+    REQUIRE(bids.size() == 3);
+    REQUIRE(bids.begin()->first == 101.0);
+    REQUIRE(asks.begin()->first == 99.5);
+
+    std::vector<double> order;
+    for (auto it = bids.begin(); it != bids.end(); ++it) order.push_back(it->first);
+    REQUIRE(order == std::vector<double>{101.0, 100.0, 99.5});
+
+    // 远离当前窗口的价格触发扩容/重新居中，已有价位保持不变
+    const size_t window = asks.windowSize();
+    asks[100.0 + 0.5 * window].value = 2;
+    REQUIRE(asks.windowSize() > window);
+    REQUIRE(asks.size() == 4);
+    REQUIRE(asks.find(99.5) != asks.end());
+    REQUIRE(asks.find(100.25) == asks.end());
+
+    auto it = asks.erase(asks.begin());
+    REQUIRE(it->first == 100.0);
+    REQUIRE(asks.begin()->first == 100.0);
+
+    REQUIRE(bids.isOnTick(100.5));
+    REQUIRE_FALSE(bids.isOnTick(100.3));
+    REQUIRE_FALSE(bids.fits(1e9));
+}
+
+TEST_CASE("OrderBook - tick ladder matches like the map book", "[order_book][tick_ladder]") {
+    OrderBook book("TEST", 0.5);
+    REQUIRE(book.usesTickLadder());
+
+    Order sell1 = createOrder("SELL001", OrderSide::SELL, 101.0, 5);
+    Order sell2 = createOrder("SELL002", OrderSide::SELL, 100.5, 5);
+    Order sell3 = createOrder("SELL003", OrderSide::SELL, 100.5, 5);
+    Order buy1 = createOrder("BUY001", OrderSide::BUY, 99.0, 5);
+    book.addOrder(sell1);
+    book.addOrder(sell2);
+    book.addOrder(sell3);
+    book.addOrder(buy1);
+
+    REQUIRE(book.getBestAsk() == 100.5);
+    REQUIRE(book.getBestBid() == 99.0);
+    auto askLevels = book.getAskLevels();
+    REQUIRE(askLevels.size() == 2);
+    REQUIRE(askLevels[0].totalQty == 10);
+    REQUIRE(askLevels[1].price == 101.0);
+
+    Order offTick = createOrder("BUY002", OrderSide::BUY, 100.3, 1);
+    book.addOrder(offTick);
+    REQUIRE(offTick.status == OrderStatus::REJECTED);
+
+    // FOK 预检查与逐档撮合
+    Order fok = createOrderWithTIF("BUY003", OrderSide::BUY, 101.0, 12, TimeInForce::FOK);
+    auto trades = book.addOrder(fok);
+    REQUIRE(trades.size() == 3);
+    REQUIRE(trades[0].sellClOrdID == "SELL002");
+    REQUIRE(trades[1].sellClOrdID == "SELL003");
+    REQUIRE(trades[2].price == 101.0);
+    REQUIRE(fok.status == OrderStatus::FILLED);
+
+    REQUIRE(book.cancelOrder("SELL001").has_value());
+    REQUIRE(book.cancelOrder("BUY001").has_value());
+    REQUIRE(book.empty());
+    REQUIRE_FALSE(book.getBestAsk().has_value());
+}
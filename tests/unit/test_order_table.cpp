@@ -0,0 +1,266 @@
+#include "../catch2/catch.hpp"
+#include "app/engine/matching_engine.hpp"
+#include "app/engine/order_table.hpp"
+#include "market/market_data.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace fix40;
+using namespace std::chrono_literals;
+
+namespace {
+
+Order makeLimitOrder(const std::string& clOrdID, OrderSide side, double price, int64_t qty) {
+    Order order;
+    order.clOrdID = clOrdID;
+    order.symbol = "IF2601";
+    order.side = side;
+    order.ordType = OrderType::LIMIT;
+    order.price = price;
+    order.orderQty = qty;
+    order.leavesQty = qty;
+    return order;
+}
+
+} // namespace
+
+TEST_CASE("OrderTable - dense refs, shared ownership and reuse", "[order_table]") {
+    OrderTable table;
+    const SessionID sid("SERVER", "USER001");
+
+    const OrderRef a = table.allocate("A", "user001", "IF2601", sid, 2);
+    const OrderRef b = table.allocate("B", "user002", "IF2601", sid, 1);
+    REQUIRE(a != kNoOrderRef);
+    REQUIRE(b == a + 1);
+    REQUIRE(table.size() == 2);
+    REQUIRE(table.at(a).sessionID == sid);
+
+    std::string symbol;
+    REQUIRE(table.find("user001", "A", &symbol) == a);
+    REQUIRE(symbol == "IF2601");
+    REQUIRE(table.find("user001", "C") == kNoOrderRef);
+
+    // 两个持有者都释放后才回收
+    table.release(a);
+    REQUIRE(table.find("user001", "A") == a);
+    table.release(a);
+    REQUIRE(table.find("user001", "A") == kNoOrderRef);
+    REQUIRE(table.size() == 1);
+
+    // 回收的槽位被复用，保证金信息被重置
+    table.at(b).margin = OrderMarginInfo(100.0, 10);
+    table.release(b);
+    const OrderRef c = table.allocate("C", "user003", "IF2601", sid, 1);
+    REQUIRE((c == a || c == b));
+    REQUIRE(table.at(c).margin.originalFrozenMargin == 0.0);
+    REQUIRE(table.at(c).accountId == "user003");
+
+    SECTION("重复 clOrdID：索引指向最新订单，旧订单释放不影响新订单") {
+        const OrderRef first = table.allocate("DUP", "user001", "IF2601", sid, 1);
+        const OrderRef second = table.allocate("DUP", "user001", "IF2601", sid, 1);
+        REQUIRE(table.find("user001", "DUP") == second);
+        table.release(first);
+        REQUIRE(table.find("user001", "DUP") == second);
+    }
+
+    SECTION("不同账户使用同一 clOrdID：各自只能找到自己的订单") {
+        const OrderRef mine = table.allocate("SAME", "user001", "IF2601", sid, 1);
+        const OrderRef theirs = table.allocate("SAME", "user002", "IF2602", sid, 1);
+        REQUIRE(table.find("user001", "SAME", &symbol) == mine);
+        REQUIRE(symbol == "IF2601");
+        REQUIRE(table.find("user002", "SAME", &symbol) == theirs);
+        REQUIRE(symbol == "IF2602");
+        REQUIRE(table.find("user003", "SAME") == kNoOrderRef);
+
+        // 后分配的订单回收后，先分配的订单仍可找到
+        table.release(theirs);
+        REQUIRE(table.find("user002", "SAME") == kNoOrderRef);
+        REQUIRE(table.find("user001", "SAME") == mine);
+    }
+}
+
+TEST_CASE("MatchingEngine - reports carry the order ref and slots are reclaimed",
+          "[order_table][matching_engine]") {
+    MatchingEngine engine;
+    std::mutex mutex;
+    std::vector<ExecutionReport> reports;
+    engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport& rpt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(rpt);
+    });
+    engine.start();
+
+    auto waitFor = [&](size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (reports.size() >= count) return true;
+            }
+            std::this_thread::sleep_for(5ms);
+        }
+        return false;
+    };
+
+    const SessionID sid("SERVER", "USER001");
+    OrderTable& table = engine.orderTable();
+
+    // 上层预先分配的订单号（上层 + 引擎两个持有者）
+    Order resting = makeLimitOrder("REST-1", OrderSide::BUY, 99.0, 2);
+    resting.orderRef = table.allocate(resting.clOrdID, "USER001", "IF2601", sid, 2);
+    engine.submit(OrderEvent::newOrder(resting, "USER001"));
+
+    // 未携带订单号的订单由引擎自行分配
+    engine.submit(OrderEvent::newOrder(makeLimitOrder("REST-2", OrderSide::BUY, 98.0, 1), "USER001"));
+    REQUIRE(waitFor(2));
+    OrderRef engineRef = kNoOrderRef;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports[0].orderRef == resting.orderRef);
+        REQUIRE(reports[1].orderRef != kNoOrderRef);
+        REQUIRE(reports[1].orderRef != resting.orderRef);
+        engineRef = reports[1].orderRef;
+    }
+    REQUIRE(table.at(engineRef).accountId == "USER001");
+
+    SECTION("按订单号撤单；撤单回报携带原订单号") {
+        CancelRequest cancel;
+        cancel.clOrdID = "CXL-1";
+        cancel.origClOrdID = "REST-1";
+        cancel.origOrderRef = resting.orderRef;
+        cancel.symbol = "IF2601";
+        engine.submit(OrderEvent::cancelRequest(cancel, "USER001"));
+        REQUIRE(waitFor(3));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            REQUIRE(reports[2].ordStatus == OrderStatus::CANCELED);
+            REQUIRE(reports[2].orderRef == resting.orderRef);
+        }
+        REQUIRE(engine.getPendingOrders("IF2601")->size() == 1);
+
+        // 引擎已释放，上层释放后槽位回收
+        REQUIRE(table.find("USER001", "REST-1") == resting.orderRef);
+        table.release(resting.orderRef);
+        REQUIRE(table.find("USER001", "REST-1") == kNoOrderRef);
+    }
+
+    SECTION("订单号与 clOrdID 不符时拒绝撤单，不退回按 clOrdID 查找") {
+        CancelRequest cancel;
+        cancel.clOrdID = "CXL-2";
+        cancel.origClOrdID = "REST-2";
+        cancel.origOrderRef = resting.orderRef;
+        cancel.symbol = "IF2601";
+        engine.submit(OrderEvent::cancelRequest(cancel, "USER001"));
+        REQUIRE(waitFor(3));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            REQUIRE(reports[2].ordStatus == OrderStatus::REJECTED);
+            REQUIRE(reports[2].origClOrdID == "REST-2");
+        }
+        REQUIRE(engine.getPendingOrders("IF2601")->size() == 2);
+        REQUIRE(table.find("USER001", "REST-2") == engineRef);
+    }
+
+    SECTION("未携带订单号时按 clOrdID 撤单只作用于本账户的订单") {
+        CancelRequest cancel;
+        cancel.clOrdID = "CXL-3";
+        cancel.origClOrdID = "REST-2";
+        cancel.symbol = "IF2601";
+        engine.submit(OrderEvent::cancelRequest(cancel, "USER002"));
+        REQUIRE(waitFor(3));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            REQUIRE(reports[2].ordStatus == OrderStatus::REJECTED);
+        }
+        REQUIRE(engine.getPendingOrders("IF2601")->find("REST-2") != nullptr);
+
+        engine.submit(OrderEvent::cancelRequest(cancel, "USER001"));
+        REQUIRE(waitFor(4));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            REQUIRE(reports[3].ordStatus == OrderStatus::CANCELED);
+            REQUIRE(reports[3].orderRef == engineRef);
+        }
+        REQUIRE(table.find("USER001", "REST-2") == kNoOrderRef);
+    }
+
+    SECTION("成交后引擎释放自己分配的槽位") {
+        MarketData md;
+        md.setInstrumentID("IF2601");
+        md.lastPrice = 97.0;
+        md.bidPrice1 = 96.0;
+        md.bidVolume1 = 10;
+        md.askPrice1 = 97.0;
+        md.askVolume1 = 10;
+        engine.submitMarketData(md);
+        REQUIRE(waitFor(4));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 2; i < 4; ++i) {
+                REQUIRE(reports[i].ordStatus == OrderStatus::FILLED);
+                REQUIRE(reports[i].orderRef != kNoOrderRef);
+            }
+        }
+        REQUIRE(table.find("USER001", "REST-2") == kNoOrderRef);
+        // 上层持有的订单在上层释放前仍可访问
+        REQUIRE(table.find("USER001", "REST-1") == resting.orderRef);
+        table.release(resting.orderRef);
+        REQUIRE(table.size() == 0);
+    }
+
+    engine.stop();
+}
+
+TEST_CASE("MatchingEngine - engine-allocated slots count the releasing callback as a holder",
+          "[order_table][matching_engine]") {
+    MatchingEngine engine;
+    OrderTable& table = engine.orderTable();
+    std::mutex mutex;
+    std::vector<ExecutionReport> reports;
+    // 与 SimulationApp 一致：回调释放终态订单的槽位
+    engine.setExecutionReportCallback([&](const SessionID&, const ExecutionReport& rpt) {
+        if (rpt.ordStatus == OrderStatus::FILLED || rpt.ordStatus == OrderStatus::CANCELED ||
+            rpt.ordStatus == OrderStatus::REJECTED) {
+            table.release(rpt.orderRef);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(rpt);
+    }, true);
+    engine.start();
+
+    auto waitFor = [&](size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (reports.size() >= count) return true;
+            }
+            std::this_thread::sleep_for(5ms);
+        }
+        return false;
+    };
+
+    engine.submit(OrderEvent::newOrder(makeLimitOrder("OWN-1", OrderSide::BUY, 98.0, 1), "USER001"));
+    REQUIRE(waitFor(1));
+    const OrderRef ref = table.find("USER001", "OWN-1");
+    REQUIRE(ref != kNoOrderRef);
+    REQUIRE(table.at(ref).holders.load() == 2);
+
+    CancelRequest cancel;
+    cancel.clOrdID = "CXL-OWN-1";
+    cancel.origClOrdID = "OWN-1";
+    cancel.symbol = "IF2601";
+    engine.submit(OrderEvent::cancelRequest(cancel, "USER001"));
+    REQUIRE(waitFor(2));
+    engine.stop();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(reports[1].ordStatus == OrderStatus::CANCELED);
+    }
+    REQUIRE(table.size() == 0);
+    REQUIRE(table.at(ref).holders.load() == 0);
+}
@@ -0,0 +1,249 @@
+#include "../catch2/catch.hpp"
+#include "app/engine/order_pool.hpp"
+#include "app/engine/pending_order_book.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace fix40;
+
+namespace {
+
+EngineOrder makePending(const std::string& clOrdID, OrderSide side, double price, int64_t qty = 1) {
+    Order order;
+    order.clOrdID = clOrdID;
+    order.symbol = "TEST";
+    order.side = side;
+    order.ordType = OrderType::LIMIT;
+    order.price = price;
+    order.orderQty = qty;
+    order.leavesQty = qty;
+    order.status = OrderStatus::NEW;
+    return EngineOrder::fromOrder(order, 0, 1);
+}
+
+} // namespace
+
+TEST_CASE("PendingOrderBook - add, find and remove", "[pending_order_book]") {
+    PendingOrderBook book;
+    REQUIRE(book.empty());
+
+    book.add(makePending("B1", OrderSide::BUY, 100.0));
+    book.add(makePending("B2", OrderSide::BUY, 100.0));
+    book.add(makePending("S1", OrderSide::SELL, 101.0));
+
+    REQUIRE(book.size() == 3);
+    REQUIRE(book.bidLevelCount() == 1);
+    REQUIRE(book.askLevelCount() == 1);
+    REQUIRE(book.find("B2") != nullptr);
+    REQUIRE(book.find("B2")->price == 100.0);
+
+    auto removed = book.remove("B1");
+    REQUIRE(removed.has_value());
+    REQUIRE(removed->clOrdID == "B1");
+    REQUIRE(book.find("B1") == nullptr);
+    REQUIRE(book.bidLevelCount() == 1);
+
+    REQUIRE(book.remove("B2").has_value());
+    REQUIRE(book.bidLevelCount() == 0);
+    REQUIRE_FALSE(book.remove("B2").has_value());
+    REQUIRE(book.size() == 1);
+}
+
+TEST_CASE("PendingOrderBook - buys visited best price first, FIFO within price", "[pending_order_book]") {
+    PendingOrderBook book;
+    book.add(makePending("B99", OrderSide::BUY, 99.0));
+    book.add(makePending("B101a", OrderSide::BUY, 101.0));
+    book.add(makePending("B100", OrderSide::BUY, 100.0));
+    book.add(makePending("B101b", OrderSide::BUY, 101.0));
+
+    std::vector<std::string> visited;
+    size_t n = book.matchBuys(100.0, [&](EngineOrder& o, bool&) {
+        visited.emplace_back(o.clOrdID());
+        return true;
+    });
+
+    REQUIRE(n == 3);
+    REQUIRE(visited == std::vector<std::string>{"B101a", "B101b", "B100"});
+    REQUIRE(book.size() == 1);
+    REQUIRE(book.find("B99") != nullptr);
+}
+
+TEST_CASE("PendingOrderBook - sells stop at first non-crossing price", "[pending_order_book]") {
+    PendingOrderBook book;
+    for (int i = 0; i < 1000; ++i) {
+        book.add(makePending("S" + std::to_string(i), OrderSide::SELL, 200.0 + i));
+    }
+    book.add(makePending("S_cross", OrderSide::SELL, 150.0));
+
+    std::vector<std::string> visited;
+    size_t n = book.matchSells(150.0, [&](EngineOrder& o, bool&) {
+        visited.emplace_back(o.clOrdID());
+        return true;
+    });
+
+    REQUIRE(n == 1);
+    REQUIRE(visited == std::vector<std::string>{"S_cross"});
+    REQUIRE(book.size() == 1000);
+}
+
+TEST_CASE("PendingOrderBook - callback stops the walk once liquidity is exhausted", "[pending_order_book]") {
+    PendingOrderBook book;
+    for (int i = 0; i < 1000; ++i) {
+        book.add(makePending("B" + std::to_string(i), OrderSide::BUY, 200.0 - (i % 10)));
+    }
+
+    // 第 3 笔订单后对手方流动性耗尽，其余可成交挂单不再访问
+    std::vector<std::string> visited;
+    size_t n = book.matchBuys(100.0, [&](EngineOrder& o, bool& exhausted) {
+        visited.emplace_back(o.clOrdID());
+        exhausted = visited.size() == 3;
+        return visited.size() < 3;
+    });
+
+    REQUIRE(n == 3);
+    REQUIRE(visited == std::vector<std::string>{"B0", "B10", "B20"});
+    REQUIRE(book.size() == 998);
+    REQUIRE(book.find("B20") != nullptr);
+}
+
+TEST_CASE("PendingOrderBook - callback may keep an order resting", "[pending_order_book]") {
+    PendingOrderBook book;
+    book.add(makePending("B1", OrderSide::BUY, 100.0));
+    book.add(makePending("B2", OrderSide::BUY, 100.0));
+
+    book.matchBuys(100.0, [](EngineOrder& o, bool&) { return o.clOrdID() == "B2"; });
+
+    REQUIRE(book.size() == 1);
+    REQUIRE(book.find("B1") != nullptr);
+    REQUIRE(book.bidLevelCount() == 1);
+    REQUIRE(book.remove("B1").has_value());
+    REQUIRE(book.empty());
+}
+
+TEST_CASE("PendingOrderBook - remove by handle keeps FIFO of neighbours", "[pending_order_book]") {
+    PendingOrderBook book;
+    book.add(makePending("B1", OrderSide::BUY, 100.0));
+    book.add(makePending("B2", OrderSide::BUY, 100.0));
+    book.add(makePending("B3", OrderSide::BUY, 100.0));
+
+    const OrderHandle handle = book.handleOf("B2");
+    REQUIRE(handle != kInvalidOrderHandle);
+    REQUIRE(book.handleOf("NONE") == kInvalidOrderHandle);
+    REQUIRE(book.removeByHandle(handle).clOrdID == "B2");
+
+    std::vector<std::string> visited;
+    book.forEach([&](const EngineOrder& o) { visited.emplace_back(o.clOrdID()); });
+    REQUIRE(visited == std::vector<std::string>{"B1", "B3"});
+}
+
+TEST_CASE("PendingOrderBook - duplicate clOrdID keeps both orders resting", "[pending_order_book]") {
+    PendingOrderBook book;
+    const OrderHandle first = book.add(makePending("DUP", OrderSide::BUY, 100.0));
+    const OrderHandle second = book.add(makePending("DUP", OrderSide::BUY, 99.0));
+    REQUIRE(book.size() == 2);
+    REQUIRE(book.handleOf("DUP") == second);
+
+    SECTION("older order fills first") {
+        // 只有 100 价位可成交：移出旧订单后索引仍指向新订单
+        REQUIRE(book.matchBuys(100.0, [](EngineOrder&, bool&) { return true; }) == 1);
+        REQUIRE(book.size() == 1);
+        REQUIRE_FALSE(book.empty());
+        REQUIRE(book.handleOf("DUP") == second);
+        REQUIRE(book.matchBuys(99.0, [](EngineOrder&, bool&) { return true; }) == 1);
+        REQUIRE(book.empty());
+    }
+
+    SECTION("newer order removed first") {
+        REQUIRE(book.removeByHandle(second).price == 99.0);
+        REQUIRE(book.size() == 1);
+        REQUIRE_FALSE(book.empty());
+        REQUIRE(book.bidLevelCount() == 1);
+        REQUIRE(book.removeByHandle(first).price == 100.0);
+        REQUIRE(book.empty());
+        REQUIRE(book.handleOf("DUP") == kInvalidOrderHandle);
+    }
+}
+
+TEST_CASE("OrderPool - intrusive queue and slot reuse", "[pending_order_book][order_pool]") {
+    OrderPool<int> pool;
+    OrderQueue queue;
+
+    const OrderHandle a = pool.allocate(1);
+    const OrderHandle b = pool.allocate(2);
+    const OrderHandle c = pool.allocate(3);
+    pool.pushBack(queue, a);
+    pool.pushBack(queue, b);
+    pool.pushBack(queue, c);
+    REQUIRE(queue.count == 3);
+
+    REQUIRE(pool.unlink(queue, b) == c);
+    REQUIRE(pool.next(a) == c);
+    pool.release(b);
+    REQUIRE(pool.size() == 2);
+
+    // 释放的节点优先复用，容量不增长
+    const size_t capacity = pool.capacity();
+    REQUIRE(pool.allocate(4) == b);
+    REQUIRE(pool.capacity() == capacity);
+
+    pool.unlink(queue, a);
+    pool.unlink(queue, c);
+    REQUIRE(queue.empty());
+    REQUIRE(queue.head == kInvalidOrderHandle);
+    REQUIRE(queue.tail == kInvalidOrderHandle);
+
+    // 扩容不移动已有节点
+    int* stable = &pool.get(c);
+    pool.reserve(OrderPool<int>::kChunkSize * 4);
+    REQUIRE(&pool.get(c) == stable);
+    REQUIRE(pool.get(c) == 3);
+}
+
+TEST_CASE("EngineOrder - compact record layout and materialization", "[pending_order_book][engine_order]") {
+    // 链接 + 撮合热字段位于第一条缓存行，标识位于第二条
+    STATIC_REQUIRE(OrderPool<EngineOrder>::nodeSize() == 128);
+    STATIC_REQUIRE(2 * sizeof(OrderHandle) + offsetof(EngineOrder, longClOrdID) <= 64);
+
+    SymbolTable symbols;
+    const uint32_t id = symbols.intern("IF2601");
+    REQUIRE(symbols.intern("IF2601") == id);
+    REQUIRE(symbols.intern("IC2601") != id);
+    REQUIRE(symbols.name(id) == "IF2601");
+
+    PendingOrderBook book("IF2601", id);
+    EngineOrder record = makePending("B1", OrderSide::BUY, 4000.0, 5);
+    record.orderSeq = 42;
+    book.add(record);
+
+    auto removed = book.remove("B1");
+    REQUIRE(removed.has_value());
+    REQUIRE(removed->symbol == "IF2601");
+    REQUIRE(removed->orderID == "ORD-0000000042");
+    REQUIRE(removed->side == OrderSide::BUY);
+    REQUIRE(removed->price == 4000.0);
+    REQUIRE(removed->leavesQty == 5);
+}
+
+TEST_CASE("PendingOrderBook - clOrdID longer than inline buffer", "[pending_order_book][engine_order]") {
+    const std::string longId(EngineOrder::kClOrdIDCapacity + 10, 'X');
+    PendingOrderBook book;
+    {
+        Order order;
+        order.clOrdID = longId;
+        order.side = OrderSide::SELL;
+        order.ordType = OrderType::LIMIT;
+        order.price = 10.0;
+        order.orderQty = 1;
+        book.add(EngineOrder::fromOrder(order, 0, 1));
+    }  // 来源 Order 已析构，挂单簿须持有自己的副本
+
+    const EngineOrder* found = book.find(longId);
+    REQUIRE(found != nullptr);
+    REQUIRE(found->clOrdID() == longId);
+
+    size_t matched = book.matchSells(10.0, [&](EngineOrder& o, bool&) { return o.clOrdID() == longId; });
+    REQUIRE(matched == 1);
+    REQUIRE(book.empty());
+}
@@ -269,6 +269,53 @@ TEST_CASE("PositionManager getTotalProfit 获取账户总盈亏", "[position_man
     REQUIRE(total == Approx(50000.0));
 }
 
+TEST_CASE("PositionManager markToMarket 按合约盯市并汇总账户盈亏", "[position_manager][unit]") {
+    PositionManager mgr;
+    
+    mgr.openPosition("user001", "IF2601", OrderSide::BUY, 2, 4000.0, 240000.0);
+    mgr.openPosition("user001", "IC2601", OrderSide::SELL, 1, 6000.0, 120000.0);
+    mgr.openPosition("user002", "IF2601", OrderSide::SELL, 1, 4100.0, 123000.0);
+    mgr.openPosition("user003", "IC2601", OrderSide::BUY, 1, 6000.0, 120000.0);
+    mgr.updateProfit("user001", "IC2601", 5900.0, 200);  // +20000
+    
+    std::vector<PositionManager::AccountProfit> affected;
+    REQUIRE(mgr.markToMarket("IF2601", 4050.0, 300, affected) == 2);
+    REQUIRE(affected.size() == 2);
+    for (const auto& account : affected) {
+        if (account.accountId == "user001") {
+            // 30000 (IF2601) + 20000 (IC2601)
+            REQUIRE(account.totalProfit == Approx(50000.0));
+        } else {
+            REQUIRE(account.accountId == "user002");
+            REQUIRE(account.totalProfit == Approx(15000.0));
+        }
+    }
+    REQUIRE(mgr.getTotalProfit("user001") == Approx(50000.0));
+    REQUIRE(mgr.getTotalProfit("user003") == 0.0);
+    
+    SECTION("平仓后汇总随持仓变化") {
+        mgr.closePosition("user001", "IF2601", OrderSide::SELL, 1, 4050.0, 300);
+        REQUIRE(mgr.getTotalProfit("user001") == Approx(35000.0));
+        mgr.closePosition("user001", "IF2601", OrderSide::SELL, 1, 4050.0, 300);
+        REQUIRE(mgr.getTotalProfit("user001") == Approx(20000.0));
+        
+        // 已平仓的持仓不再计入盯市结果
+        REQUIRE(mgr.markToMarket("IF2601", 4000.0, 300, affected) == 1);
+        REQUIRE(affected[0].accountId == "user002");
+    }
+    
+    SECTION("无持仓的合约") {
+        REQUIRE(mgr.markToMarket("AU2602", 500.0, 1000, affected) == 0);
+        REQUIRE(affected.empty());
+    }
+    
+    SECTION("clear 清空汇总") {
+        mgr.clear();
+        REQUIRE(mgr.getTotalProfit("user001") == 0.0);
+        REQUIRE(mgr.markToMarket("IF2601", 4050.0, 300, affected) == 0);
+    }
+}
+
 TEST_CASE("PositionManager getPositionsByAccount 获取账户所有持仓", "[position_manager][unit]") {
     PositionManager mgr;
     
@@ -0,0 +1,87 @@
+#include "../catch2/catch.hpp"
+#include "base/published_ptr.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace fix40;
+
+namespace {
+
+/// 两个字段恒相等，读到不一致说明看到了半写入的对象
+struct Pair {
+    int a;
+    int b;
+};
+
+} // namespace
+
+TEST_CASE("PublishedPtr - store and load", "[published_ptr]") {
+    PublishedPtr<Pair> ptr(std::make_shared<const Pair>(Pair{1, 1}));
+    const uint64_t v1 = ptr.version();
+
+    auto first = ptr.load();
+    REQUIRE(first->a == 1);
+    // 版本未变化时返回同一对象
+    REQUIRE(ptr.load() == first);
+
+    ptr.store(std::make_shared<const Pair>(Pair{2, 2}));
+    REQUIRE(ptr.version() == v1 + 1);
+    REQUIRE(ptr.load()->a == 2);
+    // 已取得的旧对象仍然有效
+    REQUIRE(first->a == 1);
+
+    ptr.store(nullptr);
+    REQUIRE(ptr.load() == nullptr);
+}
+
+TEST_CASE("PublishedPtr - instances of the same type share one thread cache slot", "[published_ptr]") {
+    PublishedPtr<Pair> x(std::make_shared<const Pair>(Pair{1, 1}));
+    PublishedPtr<Pair> y(std::make_shared<const Pair>(Pair{2, 2}));
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(x.load()->a == 1);
+        REQUIRE(y.load()->a == 2);
+    }
+
+    // 实例销毁后同地址构造的新实例不会读到残留缓存
+    auto make = [](int value) {
+        return std::make_unique<PublishedPtr<Pair>>(std::make_shared<const Pair>(Pair{value, value}));
+    };
+    auto z = make(3);
+    REQUIRE(z->load()->a == 3);
+    z.reset();
+    z = make(4);
+    REQUIRE(z->load()->a == 4);
+}
+
+TEST_CASE("PublishedPtr - readers see complete, monotonically newer objects", "[published_ptr]") {
+    PublishedPtr<Pair> ptr(std::make_shared<const Pair>(Pair{0, 0}));
+    constexpr int kVersions = 20000;
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            int last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const auto value = ptr.load();
+                if (value->a != value->b || value->a < last) {
+                    consistent = false;
+                }
+                last = value->a;
+            }
+        });
+    }
+    for (int i = 1; i <= kVersions; ++i) {
+        ptr.store(std::make_shared<const Pair>(Pair{i, i}));
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(consistent);
+    REQUIRE(ptr.load()->a == kVersions);
+}
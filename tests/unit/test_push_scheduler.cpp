@@ -0,0 +1,96 @@
+#include "../catch2/catch.hpp"
+#include "app/push_scheduler.hpp"
+
+using namespace fix40;
+using namespace std::chrono_literals;
+
+TEST_CASE("PushScheduler - interval 0 pushes every request", "[push_scheduler]") {
+    PushScheduler scheduler;
+    const auto t0 = PushScheduler::Clock::now();
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(scheduler.requestAccount("user001", t0));
+        REQUIRE(scheduler.requestPosition("user001", "IF2601", t0));
+    }
+    const auto stats = scheduler.stats();
+    REQUIRE(stats.accountPushes == 5);
+    REQUIRE(stats.positionPushes == 5);
+    REQUIRE(stats.accountSuppressed == 0);
+    REQUIRE(scheduler.pendingCount() == 0);
+}
+
+TEST_CASE("PushScheduler - conflates market pushes within the interval", "[push_scheduler]") {
+    PushScheduler scheduler(100ms);
+    const auto t0 = PushScheduler::Clock::now();
+    std::vector<std::string> accounts;
+    std::vector<PushScheduler::PositionKey> positions;
+
+    // 首次请求立即推送，间隔内的后续请求合并为一次补发
+    REQUIRE(scheduler.requestAccount("user001", t0));
+    REQUIRE(scheduler.requestPosition("user001", "IF2601", t0));
+    REQUIRE(scheduler.requestPosition("user001", "IC2601", t0));
+    for (int i = 1; i <= 4; ++i) {
+        REQUIRE_FALSE(scheduler.requestAccount("user001", t0 + i * 10ms));
+        REQUIRE_FALSE(scheduler.requestPosition("user001", "IF2601", t0 + i * 10ms));
+    }
+    REQUIRE(scheduler.pendingCount() == 2);
+
+    scheduler.collectDue(t0 + 50ms, accounts, positions);
+    REQUIRE(accounts.empty());
+    REQUIRE(positions.empty());
+
+    scheduler.collectDue(t0 + 100ms, accounts, positions);
+    REQUIRE(accounts == std::vector<std::string>{"user001"});
+    REQUIRE(positions.size() == 1);
+    REQUIRE(positions[0] == PushScheduler::PositionKey{"user001", "IF2601"});
+    REQUIRE(scheduler.pendingCount() == 0);
+
+    auto stats = scheduler.stats();
+    REQUIRE(stats.accountRequests == 5);
+    REQUIRE(stats.accountPushes == 2);
+    REQUIRE(stats.accountSuppressed == 3);
+    REQUIRE(stats.positionRequests == 6);
+    REQUIRE(stats.positionPushes == 3);
+    REQUIRE(stats.positionSuppressed == 3);
+
+    SECTION("补发后重新计时") {
+        REQUIRE_FALSE(scheduler.requestAccount("user001", t0 + 150ms));
+        REQUIRE_FALSE(scheduler.requestAccount("user001", t0 + 200ms));
+        scheduler.collectDue(t0 + 200ms, accounts, positions);
+        REQUIRE(accounts.size() == 1);
+    }
+
+    SECTION("无变化时不补发") {
+        scheduler.collectDue(t0 + 500ms, accounts, positions);
+        REQUIRE(accounts.empty());
+        REQUIRE(positions.empty());
+        REQUIRE(scheduler.requestAccount("user001", t0 + 500ms));
+    }
+}
+
+TEST_CASE("PushScheduler - fill pushes are immediate and absorb pending updates", "[push_scheduler]") {
+    PushScheduler scheduler(100ms);
+    const auto t0 = PushScheduler::Clock::now();
+    std::vector<std::string> accounts;
+    std::vector<PushScheduler::PositionKey> positions;
+
+    REQUIRE(scheduler.requestAccount("user001", t0));
+    REQUIRE_FALSE(scheduler.requestAccount("user001", t0 + 10ms));
+    REQUIRE(scheduler.pendingCount() == 1);
+
+    // 成交推送已携带最新值，待补发的行情推送不再需要
+    scheduler.sentAccount("user001", t0 + 20ms);
+    scheduler.sentPosition("user001", "IF2601", t0 + 20ms);
+    REQUIRE(scheduler.pendingCount() == 0);
+
+    // 成交推送也重新开始间隔
+    REQUIRE_FALSE(scheduler.requestPosition("user001", "IF2601", t0 + 60ms));
+    scheduler.collectDue(t0 + 110ms, accounts, positions);
+    REQUIRE(positions.empty());
+    scheduler.collectDue(t0 + 120ms, accounts, positions);
+    REQUIRE(positions.size() == 1);
+
+    const auto stats = scheduler.stats();
+    REQUIRE(stats.accountPushes == 2);
+    REQUIRE(stats.accountSuppressed == 1);
+    REQUIRE(stats.positionPushes == 2);
+}
@@ -0,0 +1,151 @@
+#include "../catch2/catch.hpp"
+#include "fix/rate_limiter.hpp"
+#include "fix/fix_codec.hpp"
+#include "fix/fix_tags.hpp"
+#include "fix/session.hpp"
+#include "storage/sqlite_store.hpp"
+
+#include <chrono>
+
+using namespace fix40;
+
+TEST_CASE("classify_msg_type groups message types", "[rate_limiter]") {
+    REQUIRE(classify_msg_type("D") == ThrottleClass::ORDER);
+    REQUIRE(classify_msg_type("G") == ThrottleClass::ORDER);
+    REQUIRE(classify_msg_type("F") == ThrottleClass::CANCEL);
+    REQUIRE(classify_msg_type("U1") == ThrottleClass::QUERY);
+    REQUIRE(classify_msg_type("U9") == ThrottleClass::QUERY);
+    REQUIRE(classify_msg_type("X") == ThrottleClass::OTHER);
+}
+
+TEST_CASE("TokenBucket burst and refill", "[rate_limiter]") {
+    using Clock = TokenBucket::Clock;
+    TokenBucket bucket(10.0, 3.0);  // 10/s，容量 3
+    auto t0 = Clock::now();
+
+    REQUIRE(bucket.try_consume(t0));
+    REQUIRE(bucket.try_consume(t0));
+    REQUIRE(bucket.try_consume(t0));
+    REQUIRE_FALSE(bucket.try_consume(t0));
+
+    // 100ms 补充 1 个令牌
+    REQUIRE(bucket.try_consume(t0 + std::chrono::milliseconds(100)));
+    REQUIRE_FALSE(bucket.try_consume(t0 + std::chrono::milliseconds(100)));
+
+    // 长时间空闲也不会超过容量
+    auto t1 = t0 + std::chrono::seconds(10);
+    int admitted = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (bucket.try_consume(t1)) ++admitted;
+    }
+    REQUIRE(admitted == 3);
+}
+
+TEST_CASE("TokenBucket with zero rate is unlimited", "[rate_limiter]") {
+    TokenBucket bucket(0.0, 0.0);
+    auto now = TokenBucket::Clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(bucket.try_consume(now));
+    }
+    REQUIRE_FALSE(bucket.limited());
+}
+
+TEST_CASE("RateLimiter enforces session and account limits", "[rate_limiter]") {
+    ThrottleConfig config;
+    config.enabled = true;
+    config.session.rate[0] = 1.0;    // order: 1/s
+    config.session.burst[0] = 5.0;
+    config.account.rate[0] = 1.0;
+    config.account.burst[0] = 8.0;   // 同一账户两个会话共享 8 个
+
+    RateLimiter limiter(config);
+    auto s1 = limiter.createSessionThrottle();
+    auto s2 = limiter.createSessionThrottle();
+
+    SECTION("Session limit hit first") {
+        int admitted = 0;
+        for (int i = 0; i < 7; ++i) {
+            if (limiter.admit(*s1, "USER001", ThrottleClass::ORDER) == ThrottleResult::ADMITTED) {
+                ++admitted;
+            }
+        }
+        REQUIRE(admitted == 5);
+        REQUIRE(s1->stats().sessionHits[0] == 2);
+        REQUIRE(limiter.stats().totalHits() == 2);
+    }
+
+    SECTION("Account limit shared across sessions") {
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(limiter.admit(*s1, "USER001", ThrottleClass::ORDER) == ThrottleResult::ADMITTED);
+        }
+        int admitted = 0;
+        ThrottleResult last = ThrottleResult::ADMITTED;
+        for (int i = 0; i < 5; ++i) {
+            last = limiter.admit(*s2, "USER001", ThrottleClass::ORDER);
+            if (last == ThrottleResult::ADMITTED) ++admitted;
+        }
+        REQUIRE(admitted == 3);
+        REQUIRE(last == ThrottleResult::ACCOUNT_LIMITED);
+        REQUIRE(s2->stats().accountHits[0] == 2);
+        REQUIRE(limiter.stats().admitted == 8);
+    }
+
+    SECTION("Other classes unaffected") {
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(limiter.admit(*s1, "USER001", ThrottleClass::QUERY) == ThrottleResult::ADMITTED);
+        }
+    }
+}
+
+TEST_CASE("Session admit_inbound applies rate limiter", "[rate_limiter]") {
+    ThrottleConfig config;
+    config.enabled = true;
+    config.session.rate[0] = 1.0;
+    config.session.burst[0] = 2.0;
+    auto limiter = std::make_shared<RateLimiter>(config);
+
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    auto session = std::make_shared<Session>("SERVER", "USER001", 30, [](){}, &store);
+    session->set_client_comp_id("USER001");
+
+    int seqNum = 0;
+    auto inbound = [&](const std::string& msgType, const std::string& clOrdID = "") {
+        FixMessage msg;
+        msg.set(tags::MsgType, msgType);
+        msg.set(tags::MsgSeqNum, ++seqNum);
+        if (!clOrdID.empty()) {
+            msg.set(tags::ClOrdID, clOrdID);
+        }
+        return msg;
+    };
+
+    // 未设置限流器时始终放行
+    REQUIRE(session->admit_inbound(inbound("D", "ORD-0")));
+
+    session->set_rate_limiter(limiter);
+    session->start();
+    REQUIRE(session->admit_inbound(inbound("D", "ORD-1")));
+    REQUIRE(session->admit_inbound(inbound("D", "ORD-2")));
+    REQUIRE_FALSE(session->admit_inbound(inbound("D", "ORD-3")));
+    const int throttledSeqNum = seqNum;
+    REQUIRE(session->admit_inbound(inbound("U1")));
+
+    // 被限流的报单收到 BusinessReject，携带原消息序列号与 ClOrdID
+    auto messages = store.loadMessages("SERVER", "USER001", 1, 100);
+    REQUIRE(messages.size() == 1);
+    FixCodec codec;
+    FixMessage reject = codec.decode(messages.front().rawMessage);
+    REQUIRE(reject.get_string(tags::MsgType) == "j");
+    REQUIRE(reject.get_int(tags::RefSeqNum) == throttledSeqNum);
+    REQUIRE(reject.get_string(tags::ClOrdID) == "ORD-3");
+
+    // 报单额度耗尽后撤单不受影响
+    REQUIRE_FALSE(session->admit_inbound(inbound("G", "ORD-4")));
+    REQUIRE(session->admit_inbound(inbound("F", "CXL-1")));
+
+    ThrottleStats stats = session->get_throttle_stats();
+    REQUIRE(stats.sessionHits[0] == 2);
+    REQUIRE(stats.totalHits() == 2);
+    session->stop();
+}
@@ -9,7 +9,9 @@
 #include <rapidcheck.h>
 #include <rapidcheck/catch.h>
 #include "app/manager/risk_manager.hpp"
+#include <chrono>
 #include <cmath>
+#include <vector>
 
 using namespace fix40;
 
@@ -825,3 +827,174 @@ TEST_CASE("RiskManager 属性测试 - 持仓检查", "[risk_manager][property]")
             RC_ASSERT(result.passed);
         });
 }
+
+// =============================================================================
+// 快速路径
+// =============================================================================
+
+namespace {
+
+/// 由订单、账户、持仓、合约、行情构造快速检查输入（与 SimulationApp 下单路径一致）
+RiskCheckInput makeCheckInput(const Order& order, const Account& account, const Position& position,
+                              const Instrument& inst, const MarketDataSnapshot& snapshot) {
+    RiskCheckInput input;
+    input.side = order.side;
+    input.ordType = order.ordType;
+    input.price = order.price;
+    input.orderQty = order.orderQty;
+    input.available = account.available;
+    input.longPosition = position.longPosition;
+    input.shortPosition = position.shortPosition;
+    input.upperLimitPrice = inst.upperLimitPrice;
+    input.lowerLimitPrice = inst.lowerLimitPrice;
+    input.hasBid = snapshot.hasBid();
+    input.hasAsk = snapshot.hasAsk();
+    return input;
+}
+
+/// 由持仓推断开平标志（买单有空头持仓、卖单有多头持仓时为平仓）
+OffsetFlag inferOffset(const Order& order, const Position& position) {
+    const int64_t closable = order.side == OrderSide::BUY ? position.shortPosition : position.longPosition;
+    return closable > 0 ? OffsetFlag::CLOSE : OffsetFlag::OPEN;
+}
+
+} // namespace
+
+TEST_CASE("RiskManager 快速检查与 checkOrder 结果一致", "[risk_manager][property]") {
+
+    rc::prop("拒绝原因、拒绝文本、开平标志与所需保证金一致",
+        []() {
+            RiskManager riskMgr;
+
+            const auto side = *rc::gen::element(OrderSide::BUY, OrderSide::SELL);
+            const auto ordType = *rc::gen::element(OrderType::LIMIT, OrderType::MARKET);
+            const auto lowerInt = *rc::gen::inRange(0, 4000);
+            const auto upperInt = lowerInt + *rc::gen::inRange(0, 1000);
+            const auto priceInt = *rc::gen::inRange(1, 6000);
+            const auto qty = *rc::gen::inRange(1, 50);
+
+            Instrument inst("TEST", "CFFEX", "T", 0.2, 300, 0.12);
+            inst.updateLimitPrices(upperInt, lowerInt);
+            inst.preSettlementPrice = *rc::gen::inRange(0, 5000);
+
+            Order order = createTestOrder("TEST", side, ordType,
+                                          ordType == OrderType::MARKET ? 0.0 : priceInt, qty);
+
+            Account account("test", 0.0);
+            account.available = *rc::gen::inRange(0, 20000000);
+
+            Position position("test", "TEST");
+            position.longPosition = *rc::gen::inRange(0, 30);
+            position.shortPosition = *rc::gen::inRange(0, 30);
+
+            MarketDataSnapshot snapshot("TEST");
+            if (*rc::gen::arbitrary<bool>()) {
+                snapshot.bidPrice1 = 3999.0;
+                snapshot.bidVolume1 = 10;
+            }
+            if (*rc::gen::arbitrary<bool>()) {
+                snapshot.askPrice1 = 4001.0;
+                snapshot.askVolume1 = 10;
+            }
+
+            const OffsetFlag offset = inferOffset(order, position);
+            const CheckResult expected = riskMgr.checkOrder(order, account, position, inst, snapshot, offset);
+
+            const RiskCheckInput input = makeCheckInput(order, account, position, inst, snapshot);
+            const RiskDecision decision = riskMgr.precheck(InstrumentRiskParams::fromInstrument(inst), input);
+
+            RC_ASSERT(decision.reason == expected.rejectReason);
+            RC_ASSERT(decision.passed() == expected.passed);
+            RC_ASSERT(decision.offsetFlag == offset);
+            RC_ASSERT(riskMgr.describeReject(decision, input) == expected.rejectText);
+            if (offset == OffsetFlag::OPEN) {
+                RC_ASSERT(decision.requiredMargin == riskMgr.calculateRequiredMargin(order, inst));
+            }
+        });
+}
+
+TEST_CASE("RiskParamTable 按登记顺序分配稳定下标", "[risk_manager][unit]") {
+    std::unordered_map<std::string, Instrument> instruments;
+    instruments.emplace("IF2601", createTestInstrument("IF2601"));
+    RiskParamTable first(nullptr, instruments);
+    REQUIRE(first.size() == 1);
+    REQUIRE(first.indexOf("IF2601") == 0u);
+
+    instruments.emplace("IC2601", createTestInstrument("IC2601", 0.2, 200, 0.14));
+    instruments["IF2601"].marginRate = 0.15;
+    RiskParamTable second(&first, instruments);
+    REQUIRE(second.size() == 2);
+    REQUIRE(second.indexOf("IF2601") == 0u);
+    REQUIRE(second.indexOf("IC2601") == 1u);
+    REQUIRE(second.at(0).marginRate == 0.15);
+    REQUIRE(second.find("IC2601")->volumeMultiple == 200);
+    REQUIRE(second.find("IH2601") == nullptr);
+    // 旧表不可变
+    REQUIRE(first.at(0).marginRate == 0.12);
+}
+
+/**
+ * 基准：下单风控每秒检查次数。默认不运行，使用 `unit_tests "[.benchmark]"` 执行。
+ *
+ * 旧路径每笔订单复制 Account / Position / Instrument 并调用 checkOrder；
+ * 快速路径只组装标量输入并调用 precheck。
+ */
+TEST_CASE("RiskManager 基准 - 每秒检查次数", "[risk_manager][.benchmark]") {
+    RiskManager riskMgr;
+    const Instrument inst = createTestInstrument();
+    const InstrumentRiskParams params = InstrumentRiskParams::fromInstrument(inst);
+    const MarketDataSnapshot snapshot = createTestSnapshot();
+    Account account("user001", 1000000.0);
+    Position position("user001", "IF2601");
+    position.longPosition = 5;
+
+    // 开仓、平仓、价格超限、资金不足、市价单混合
+    std::vector<Order> orders;
+    for (int i = 0; i < 1024; ++i) {
+        const OrderSide side = (i % 2) ? OrderSide::BUY : OrderSide::SELL;
+        const OrderType type = (i % 7 == 0) ? OrderType::MARKET : OrderType::LIMIT;
+        const double price = type == OrderType::MARKET ? 0.0 : 3700.0 + (i % 600);
+        orders.push_back(createTestOrder("IF2601", side, type, price, 1 + i % 10));
+    }
+
+    constexpr int kIterations = 2000000;
+    using Clock = std::chrono::steady_clock;
+    size_t rejected = 0;
+
+    auto start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        const Order& order = orders[i & 1023];
+        const Account accountCopy = account;
+        const Position positionCopy = position;
+        const Instrument instCopy = inst;
+        const CheckResult result = riskMgr.checkOrder(order, accountCopy, positionCopy, instCopy, snapshot,
+                                                      inferOffset(order, positionCopy));
+        rejected += result.passed ? 0 : 1;
+    }
+    const double legacySeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        const Order& order = orders[i & 1023];
+        RiskCheckInput input;
+        input.side = order.side;
+        input.ordType = order.ordType;
+        input.price = order.price;
+        input.orderQty = order.orderQty;
+        input.available = account.available;
+        input.longPosition = position.longPosition;
+        input.shortPosition = position.shortPosition;
+        input.upperLimitPrice = inst.upperLimitPrice;
+        input.lowerLimitPrice = inst.lowerLimitPrice;
+        input.hasBid = snapshot.hasBid();
+        input.hasAsk = snapshot.hasAsk();
+        const RiskDecision decision = riskMgr.precheck(params, input);
+        rejected -= decision.passed() ? 0 : 1;
+    }
+    const double fastSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // 两条路径的拒绝数相同
+    REQUIRE(rejected == 0);
+    WARN("checkOrder: " << static_cast<uint64_t>(kIterations / legacySeconds) << " checks/s, "
+         << "precheck: " << static_cast<uint64_t>(kIterations / fastSeconds) << " checks/s");
+}
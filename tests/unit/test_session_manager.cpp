@@ -2,6 +2,8 @@
 #include "fix/session_manager.hpp"
 #include "fix/session.hpp"
 
+#include <thread>
+
 using namespace fix40;
 
 TEST_CASE("SessionManager - Basic operations", "[session_manager]") {
@@ -142,6 +144,125 @@ TEST_CASE("SessionManager - sendMessage", "[session_manager]") {
     }
 }
 
+TEST_CASE("SessionManager - clientCompID index", "[session_manager]") {
+    SessionManager manager;
+
+    SECTION("Lookup by clientCompID after register") {
+        auto session = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+        session->set_client_comp_id("USER001");
+        manager.registerSession(session);
+
+        auto sid = manager.findSessionIdByClientCompId("USER001");
+        REQUIRE(sid.has_value());
+        REQUIRE(*sid == SessionID("SERVER", "USER001"));
+        REQUIRE(manager.findSessionByClientCompId("USER001").get() == session.get());
+        REQUIRE_FALSE(manager.findSessionIdByClientCompId("USER002").has_value());
+        REQUIRE_FALSE(manager.findSessionIdByClientCompId("").has_value());
+    }
+
+    SECTION("Index removed on unregister") {
+        auto session = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+        session->set_client_comp_id("USER001");
+        manager.registerSession(session);
+        REQUIRE(manager.unregisterSession(SessionID("SERVER", "USER001")));
+
+        REQUIRE_FALSE(manager.findSessionIdByClientCompId("USER001").has_value());
+        REQUIRE(manager.findSessionByClientCompId("USER001") == nullptr);
+    }
+
+    SECTION("Old connection closing after reconnect keeps the new session") {
+        auto oldSession = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+        oldSession->set_client_comp_id("USER001");
+        manager.registerSession(oldSession);
+
+        // 重连：SessionID 相同的新会话替换旧会话，随后旧连接才关闭
+        auto newSession = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+        newSession->set_client_comp_id("USER001");
+        manager.registerSession(newSession);
+        REQUIRE_FALSE(manager.unregisterSession(oldSession->get_session_id(), oldSession.get()));
+
+        REQUIRE(manager.findSession(SessionID("SERVER", "USER001")).get() == newSession.get());
+        REQUIRE(manager.findSessionByClientCompId("USER001").get() == newSession.get());
+        REQUIRE(manager.unregisterSession(newSession->get_session_id(), newSession.get()));
+        REQUIRE_FALSE(manager.findSessionIdByClientCompId("USER001").has_value());
+    }
+
+    SECTION("Close racing re-register never drops the live index entry") {
+        for (int round = 0; round < 200; ++round) {
+            auto oldSession = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+            oldSession->set_client_comp_id("USER001");
+            manager.registerSession(oldSession);
+            auto newSession = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+            newSession->set_client_comp_id("USER001");
+
+            std::thread closer([&]() {
+                manager.unregisterSession(oldSession->get_session_id(), oldSession.get());
+            });
+            manager.registerSession(newSession);
+            closer.join();
+
+            REQUIRE(manager.findSession(SessionID("SERVER", "USER001")).get() == newSession.get());
+            REQUIRE(manager.findSessionByClientCompId("USER001").get() == newSession.get());
+            manager.unregisterSession(newSession->get_session_id(), newSession.get());
+        }
+    }
+
+    SECTION("Sessions without clientCompID are not indexed") {
+        auto session = std::make_shared<Session>("CLIENT", "SERVER", 30, [](){});
+        manager.registerSession(session);
+        REQUIRE(manager.getSessionCount() == 1);
+        REQUIRE_FALSE(manager.findSessionIdByClientCompId("CLIENT").has_value());
+    }
+
+    SECTION("Many sessions across shards") {
+        std::vector<std::shared_ptr<Session>> sessions;
+        for (int i = 0; i < 200; ++i) {
+            std::string user = "USER" + std::to_string(i);
+            auto session = std::make_shared<Session>("SERVER", user, 30, [](){});
+            session->set_client_comp_id(user);
+            manager.registerSession(session);
+            sessions.push_back(session);
+        }
+        REQUIRE(manager.getSessionCount() == 200);
+
+        for (int i = 0; i < 200; ++i) {
+            std::string user = "USER" + std::to_string(i);
+            REQUIRE(manager.findSessionByClientCompId(user).get() == sessions[i].get());
+        }
+
+        int visited = 0;
+        manager.forEachSession([&](const SessionID&, std::shared_ptr<Session>) { ++visited; });
+        REQUIRE(visited == 200);
+    }
+}
+
+TEST_CASE("SessionManager - broadcast", "[session_manager]") {
+    SessionManager manager;
+
+    FixMessage notice;
+    notice.set(tags::MsgType, "j");
+    notice.set(tags::Text, "System notice");
+
+    SECTION("Broadcast skips missing and non-running sessions") {
+        auto running = std::make_shared<Session>("SERVER", "USER001", 30, [](){});
+        auto idle = std::make_shared<Session>("SERVER", "USER002", 30, [](){});
+        running->start();
+        manager.registerSession(running);
+        manager.registerSession(idle);
+
+        REQUIRE(manager.broadcastAll(notice) == 1);
+        REQUIRE(manager.broadcast({SessionID("SERVER", "USER001"),
+                                   SessionID("SERVER", "USER002"),
+                                   SessionID("SERVER", "NOBODY")}, notice) == 1);
+        running->stop();
+    }
+
+    SECTION("Broadcast to empty manager") {
+        REQUIRE(manager.broadcastAll(notice) == 0);
+        REQUIRE(manager.broadcast({}, notice) == 0);
+    }
+}
+
 TEST_CASE("SessionIDHash", "[session_manager]") {
     SessionIDHash hasher;
     
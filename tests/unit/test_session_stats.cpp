@@ -0,0 +1,145 @@
+#include "../catch2/catch.hpp"
+
+#include "base/latency_histogram.hpp"
+#include "fix/session.hpp"
+#include "fix/session_manager.hpp"
+#include "fix/session_stats.hpp"
+#include "fix/fix_messages.hpp"
+#include "fix/fix_tags.hpp"
+
+#include <chrono>
+
+using namespace fix40;
+
+namespace {
+
+class NoopApp : public Application {
+public:
+    void onLogon(const SessionID&) override {}
+    void onLogout(const SessionID&) override {}
+    void fromApp(const FixMessage&, const SessionID&) override {}
+};
+
+FixMessage make_business(const std::string& msg_type, int seq_num) {
+    FixMessage msg;
+    msg.set(tags::MsgType, msg_type);
+    msg.set(tags::MsgSeqNum, seq_num);
+    return msg;
+}
+
+} // namespace
+
+TEST_CASE("LatencyHistogram - bucket layout", "[session_stats]") {
+    SECTION("Small values map one-to-one") {
+        for (uint64_t v = 0; v < 8; ++v) {
+            REQUIRE(LatencyHistogram::bucket_index(v) == v);
+            REQUIRE(LatencyHistogram::bucket_upper_bound(v) == v);
+        }
+    }
+
+    SECTION("Upper bound stays within 12.5% of the value") {
+        for (uint64_t v : {8ULL, 15ULL, 100ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+            const size_t idx = LatencyHistogram::bucket_index(v);
+            const uint64_t upper = LatencyHistogram::bucket_upper_bound(idx);
+            REQUIRE(upper >= v);
+            REQUIRE(static_cast<double>(upper - v) <= 0.125 * static_cast<double>(v));
+        }
+    }
+
+    SECTION("Huge values clamp to the last bucket") {
+        REQUIRE(LatencyHistogram::bucket_index(UINT64_MAX) == LatencyHistogram::kBucketCount - 1);
+    }
+}
+
+TEST_CASE("LatencyHistogram - percentiles", "[session_stats]") {
+    LatencyHistogram hist;
+    REQUIRE(hist.snapshot().count == 0);
+
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        hist.record(v * 1000);
+    }
+    auto s = hist.snapshot();
+    REQUIRE(s.count == 1000);
+    REQUIRE(s.min == 1000);
+    REQUIRE(s.max == 1000000);
+    REQUIRE(s.mean == 500500);
+    REQUIRE(s.p50 >= 500000);
+    REQUIRE(s.p50 <= 500000 * 1.125);
+    REQUIRE(s.p99 >= 990000);
+    REQUIRE(s.p999 <= s.max);
+}
+
+TEST_CASE("SessionStatistics - counters and formatting", "[session_stats]") {
+    SessionStatistics stats;
+    stats.on_message_in();
+    stats.on_bytes_in(120);
+    stats.on_message_out(80);
+    stats.on_gap();
+    stats.record_heartbeat_rtt(std::chrono::microseconds(250));
+    stats.record_app_latency("D", std::chrono::microseconds(40));
+    stats.record_app_latency("D", std::chrono::microseconds(60));
+    stats.record_app_latency("U1", std::chrono::microseconds(10));
+
+    SessionStatsSnapshot snapshot;
+    snapshot.sessionId = "SERVER-USER001";
+    snapshot.clientCompID = "USER001";
+    stats.fill(snapshot);
+
+    REQUIRE(snapshot.msgsIn == 1);
+    REQUIRE(snapshot.bytesIn == 120);
+    REQUIRE(snapshot.msgsOut == 1);
+    REQUIRE(snapshot.bytesOut == 80);
+    REQUIRE(snapshot.gapEvents == 1);
+    REQUIRE(snapshot.heartbeatRtt.count == 1);
+    REQUIRE(snapshot.appLatency.size() == 2);
+    REQUIRE(snapshot.appLatency[0].first == "D");
+    REQUIRE(snapshot.appLatency[0].second.count == 2);
+
+    const std::string line = format_session_stats(snapshot);
+    REQUIRE(line.find("session=SERVER-USER001") != std::string::npos);
+    REQUIRE(line.find("gaps=1") != std::string::npos);
+    REQUIRE(line.find("app_D_count=2") != std::string::npos);
+    REQUIRE(line.find("hb_rtt_count=1") != std::string::npos);
+}
+
+TEST_CASE("SessionStatistics - unknown MsgTypes share one bucket", "[session_stats]") {
+    SessionStatistics stats;
+    for (int i = 0; i < 1000; ++i) {
+        stats.record_app_latency("X" + std::to_string(i), std::chrono::microseconds(5));
+    }
+    stats.record_app_latency("U13", std::chrono::microseconds(5));
+
+    SessionStatsSnapshot snapshot;
+    stats.fill(snapshot);
+    REQUIRE(snapshot.appLatency.size() == 2);
+    REQUIRE(snapshot.appLatency[0].first == "U13");
+    REQUIRE(snapshot.appLatency[1].first == "other");
+    REQUIRE(snapshot.appLatency[1].second.count == 1000);
+}
+
+TEST_CASE("Session - stats track inbound messages, gaps and app latency", "[session_stats][session]") {
+    NoopApp app;
+    auto session = std::make_shared<Session>("SERVER", "PENDING", 30, nullptr, nullptr);
+    session->set_application(&app);
+    session->start();
+
+    session->on_message_received(create_logon_message("USER001", "SERVER", 1, 30, false));
+    session->on_message_received(make_business("U5", 3));  // gap：缺 Seq=2
+    session->on_message_received(make_business("U5", 2));
+
+    auto snapshot = session->get_stats_snapshot();
+    REQUIRE(snapshot.clientCompID == "USER001");
+    REQUIRE(snapshot.msgsIn == 3);
+    REQUIRE(snapshot.gapEvents == 1);
+    REQUIRE(snapshot.resendRequestsSent == 1);
+    REQUIRE(snapshot.appLatency.size() == 1);
+    REQUIRE(snapshot.appLatency[0].first == "other");  // U5 不在单独统计的列表中
+    REQUIRE(snapshot.appLatency[0].second.count == 2);
+
+    SessionManager manager;
+    manager.registerSession(session);
+    auto all = manager.collectStats();
+    REQUIRE(all.size() == 1);
+    REQUIRE(all[0].msgsIn == 3);
+    REQUIRE(manager.getSessionStats(session->get_session_id()).has_value());
+}
@@ -1,10 +1,15 @@
 #include "../catch2/catch.hpp"
 #include "app/simulation_app.hpp"
+#include "base/config.hpp"
 #include "fix/fix_tags.hpp"
 #include "market/market_data.hpp"
 #include "storage/sqlite_store.hpp"
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <thread>
+#include <utility>
 
 using namespace fix40;
 using namespace std::chrono_literals;
@@ -23,6 +28,39 @@ bool waitFor(Predicate pred, std::chrono::milliseconds timeout = 1000ms) {
     return true;
 }
 
+// 临时写入配置文件并加载到全局 Config；restore() 或析构时加载空配置并删除文件，
+// 断言提前失败时也不会把配置泄漏给后续测试
+class ScopedConfig {
+public:
+    ScopedConfig(std::string path, const std::string& content)
+        : path_(std::move(path)) {
+        std::ofstream(path_) << content;
+        loaded_ = Config::instance().load(path_);
+    }
+
+    ~ScopedConfig() { restore(); }
+
+    ScopedConfig(const ScopedConfig&) = delete;
+    ScopedConfig& operator=(const ScopedConfig&) = delete;
+
+    bool loaded() const { return loaded_; }
+
+    void restore() {
+        if (restored_) {
+            return;
+        }
+        restored_ = true;
+        std::ofstream(path_).close();
+        Config::instance().load(path_);
+        std::remove(path_.c_str());
+    }
+
+private:
+    std::string path_;
+    bool loaded_ = false;
+    bool restored_ = false;
+};
+
 } // namespace
 
 TEST_CASE("SimulationApp - order/trade persistence", "[application][storage]") {
@@ -55,7 +93,7 @@ TEST_CASE("SimulationApp - order/trade persistence", "[application][storage]") {
     md.lowerLimitPrice = 50.0;
 
     app.getMatchingEngine().submitMarketData(md);
-    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST") != nullptr; }));
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST").has_value(); }));
 
     // 发送一个可立即成交的限价买单（买价 >= 卖一价）
     FixMessage order;
@@ -118,7 +156,7 @@ TEST_CASE("SimulationApp - rejected order persists status without orderID", "[ap
     md.lowerLimitPrice = 50.0;
 
     app.getMatchingEngine().submitMarketData(md);
-    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST") != nullptr; }));
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST").has_value(); }));
 
     // 发送一个超出涨停价的限价单，触发风险拒绝（不进入撮合引擎，因此不会生成 orderID）
     FixMessage order;
@@ -144,3 +182,151 @@ TEST_CASE("SimulationApp - rejected order persists status without orderID", "[ap
 
     app.stop();
 }
+
+TEST_CASE("SimulationApp - sharded cancel routes by the order's instrument, not the request Symbol",
+          "[application][shard]") {
+    // 4 个分片：TEST 固定在 0 号分片，WRONG 固定在 1 号分片
+    ScopedConfig config("test_sharded_cancel.ini",
+                        "[matching_engine]\nshards = 4\npinned_instruments = TEST:0, WRONG:1\n");
+    REQUIRE(config.loaded());
+
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    SimulationApp app(&store);
+    // 构造完成后恢复空配置，不影响其它测试
+    config.restore();
+
+    REQUIRE(app.getMatchingEngine().getShardCount() == 4);
+    REQUIRE(app.getMatchingEngine().shardFor("TEST") != app.getMatchingEngine().shardFor("WRONG"));
+    app.getInstrumentManager().addInstrument(Instrument("TEST", "TESTEX", "T", 1.0, 1, 0.1));
+
+    auto session = std::make_shared<Session>("SERVER", "CLIENT1", 30, []() {});
+    session->set_client_comp_id("CLIENT1");
+    app.getSessionManager().registerSession(session);
+    SessionID sid = session->get_session_id();
+    app.start();
+
+    MarketData md;
+    md.setInstrumentID("TEST");
+    md.lastPrice = 100.0;
+    md.bidPrice1 = 99.0;
+    md.bidVolume1 = 10;
+    md.askPrice1 = 100.0;
+    md.askVolume1 = 10;
+    md.upperLimitPrice = 200.0;
+    md.lowerLimitPrice = 50.0;
+    app.getMatchingEngine().submitMarketData(md);
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST").has_value(); }));
+
+    // 低于卖一价的限价买单挂单
+    auto submitOrder = [&](const std::string& clOrdID) {
+        FixMessage order;
+        order.set(tags::MsgType, "D");
+        order.set(tags::ClOrdID, clOrdID);
+        order.set(tags::Symbol, "TEST");
+        order.set(tags::Side, "1");
+        order.set(tags::OrderQty, "1");
+        order.set(tags::OrdType, "2");
+        order.set(tags::Price, "90");
+        app.fromApp(order, sid);
+    };
+    submitOrder("ORD-SHARD-001");
+    submitOrder("ORD-SHARD-002");
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getTotalPendingOrderCount() == 2; }));
+
+    // Symbol 指向其它分片的合约，或缺失
+    FixMessage wrongSymbol;
+    wrongSymbol.set(tags::MsgType, "F");
+    wrongSymbol.set(tags::ClOrdID, "CXL-SHARD-001");
+    wrongSymbol.set(tags::OrigClOrdID, "ORD-SHARD-001");
+    wrongSymbol.set(tags::Symbol, "WRONG");
+    app.fromApp(wrongSymbol, sid);
+
+    FixMessage noSymbol;
+    noSymbol.set(tags::MsgType, "F");
+    noSymbol.set(tags::ClOrdID, "CXL-SHARD-002");
+    noSymbol.set(tags::OrigClOrdID, "ORD-SHARD-002");
+    app.fromApp(noSymbol, sid);
+
+    // 两笔撤单都路由到 TEST 所在分片并撤销成功，槽位随终态回报回收
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getTotalPendingOrderCount() == 0; }));
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().orderTable().size() == 0; }));
+
+    app.stop();
+}
+
+TEST_CASE("SimulationApp - accounts reusing one ClOrdID each cancel their own order",
+          "[application][order_table]") {
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    SimulationApp app(&store);
+    app.getInstrumentManager().addInstrument(Instrument("TEST", "TESTEX", "T", 1.0, 1, 0.1));
+
+    auto sessionA = std::make_shared<Session>("SERVER", "CLIENT1", 30, []() {});
+    sessionA->set_client_comp_id("CLIENT1");
+    app.getSessionManager().registerSession(sessionA);
+    auto sessionB = std::make_shared<Session>("SERVER", "CLIENT2", 30, []() {});
+    sessionB->set_client_comp_id("CLIENT2");
+    app.getSessionManager().registerSession(sessionB);
+    const SessionID sidA = sessionA->get_session_id();
+    const SessionID sidB = sessionB->get_session_id();
+    app.start();
+
+    MarketData md;
+    md.setInstrumentID("TEST");
+    md.lastPrice = 100.0;
+    md.bidPrice1 = 99.0;
+    md.bidVolume1 = 10;
+    md.askPrice1 = 100.0;
+    md.askVolume1 = 10;
+    md.upperLimitPrice = 200.0;
+    md.lowerLimitPrice = 50.0;
+    app.getMatchingEngine().submitMarketData(md);
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getMarketSnapshot("TEST").has_value(); }));
+
+    auto submitOrder = [&](const SessionID& sid) {
+        FixMessage order;
+        order.set(tags::MsgType, "D");
+        order.set(tags::ClOrdID, "ORD-SAME");
+        order.set(tags::Symbol, "TEST");
+        order.set(tags::Side, "1");
+        order.set(tags::OrderQty, "1");
+        order.set(tags::OrdType, "2");
+        order.set(tags::Price, "90");
+        app.fromApp(order, sid);
+    };
+    auto cancelOrder = [&](const SessionID& sid, const std::string& clOrdID) {
+        FixMessage cancel;
+        cancel.set(tags::MsgType, "F");
+        cancel.set(tags::ClOrdID, clOrdID);
+        cancel.set(tags::OrigClOrdID, "ORD-SAME");
+        cancel.set(tags::Symbol, "TEST");
+        app.fromApp(cancel, sid);
+    };
+
+    // A 先挂单，B 随后以同一 ClOrdID 挂单
+    submitOrder(sidA);
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getTotalPendingOrderCount() == 1; }));
+    submitOrder(sidB);
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getTotalPendingOrderCount() == 2; }));
+
+    const OrderTable& table = app.getMatchingEngine().orderTable();
+    const OrderRef refA = table.find("CLIENT1", "ORD-SAME");
+    const OrderRef refB = table.find("CLIENT2", "ORD-SAME");
+    REQUIRE(refA != kNoOrderRef);
+    REQUIRE(refB != kNoOrderRef);
+    REQUIRE(refA != refB);
+
+    // A 撤单只撤掉自己的订单
+    cancelOrder(sidA, "CXL-A");
+    REQUIRE(waitFor([&]() { return table.find("CLIENT1", "ORD-SAME") == kNoOrderRef; }));
+    REQUIRE(app.getMatchingEngine().getTotalPendingOrderCount() == 1);
+    REQUIRE(table.find("CLIENT2", "ORD-SAME") == refB);
+
+    // B 的订单仍可被 B 撤销
+    cancelOrder(sidB, "CXL-B");
+    REQUIRE(waitFor([&]() { return app.getMatchingEngine().getTotalPendingOrderCount() == 0; }));
+    REQUIRE(waitFor([&]() { return table.size() == 0; }));
+
+    app.stop();
+}
@@ -0,0 +1,114 @@
+#include "../catch2/catch.hpp"
+#include "app/engine/snapshot_table.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace fix40;
+
+namespace {
+
+MarketDataSnapshot makeSnapshot(double base, int32_t volume) {
+    MarketDataSnapshot snapshot("IF2601");
+    snapshot.lastPrice = base;
+    snapshot.bidPrice1 = base;
+    snapshot.askPrice1 = base;
+    snapshot.bidVolume1 = volume;
+    snapshot.askVolume1 = volume;
+    snapshot.upperLimitPrice = base;
+    snapshot.lowerLimitPrice = base;
+    for (size_t i = 0; i < MarketDataSnapshot::kDepthLevels; ++i) {
+        snapshot.bidDepth[i] = {base, volume, 0};
+        snapshot.askDepth[i] = {base, volume, 0};
+    }
+    return snapshot;
+}
+
+} // namespace
+
+TEST_CASE("SnapshotTable - publish and read", "[snapshot_table]") {
+    SnapshotTable table(4);
+    MarketDataSnapshot out;
+
+    SECTION("unknown instrument") {
+        REQUIRE_FALSE(table.read("IF2601", out));
+    }
+
+    SECTION("reserved but never published") {
+        REQUIRE(table.reserve("IF2601"));
+        REQUIRE(table.size() == 1);
+        REQUIRE_FALSE(table.read("IF2601", out));
+    }
+
+    SECTION("round-trip") {
+        MarketDataSnapshot snapshot = makeSnapshot(4000.0, 7);
+        snapshot.askDepth[2] = {4001.4, 3, 2};
+        snapshot.updateTime = std::chrono::system_clock::time_point(std::chrono::seconds(1'700'000'000));
+        REQUIRE(table.publish("IF2601", snapshot));
+
+        REQUIRE(table.read("IF2601", out));
+        REQUIRE(out.instrumentId == "IF2601");
+        REQUIRE(out.lastPrice == 4000.0);
+        REQUIRE(out.bidVolume1 == 7);
+        REQUIRE(out.askDepth[2].price == 4001.4);
+        REQUIRE(out.askDepth[2].volume == 3);
+        REQUIRE(out.askDepth[2].consumed == 0);
+        REQUIRE(out.updateTime == snapshot.updateTime);
+
+        REQUIRE(table.publish("IF2601", makeSnapshot(4002.0, 1)));
+        REQUIRE(table.read("IF2601", out));
+        REQUIRE(out.lastPrice == 4002.0);
+        REQUIRE(table.size() == 1);
+    }
+
+    SECTION("capacity exhausted") {
+        REQUIRE(table.reserve("A"));
+        REQUIRE(table.reserve("B"));
+        REQUIRE(table.reserve("C"));
+        REQUIRE(table.reserve("D"));
+        REQUIRE(table.reserve("A"));
+        REQUIRE_FALSE(table.publish("E", makeSnapshot(1.0, 1)));
+        REQUIRE_FALSE(table.read("E", out));
+        REQUIRE(table.size() == 4);
+    }
+
+    SECTION("over-long instrument id") {
+        REQUIRE_FALSE(table.reserve(std::string(SnapshotTable::kMaxKeyLength + 1, 'X')));
+    }
+}
+
+TEST_CASE("SnapshotTable - readers never see torn snapshots", "[snapshot_table]") {
+    SnapshotTable table(2);
+    REQUIRE(table.reserve("IF2601"));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; i <= 200000; ++i) {
+            table.publish("IF2601", makeSnapshot(static_cast<double>(i), i));
+        }
+        done = true;
+    });
+
+    int torn = 0;
+    int reads = 0;
+    MarketDataSnapshot out;
+    while (!done.load()) {
+        if (!table.read("IF2601", out)) continue;
+        ++reads;
+        const double base = out.lastPrice;
+        bool consistent = out.bidPrice1 == base && out.askPrice1 == base &&
+                          out.bidVolume1 == static_cast<int32_t>(base) &&
+                          out.upperLimitPrice == base && out.lowerLimitPrice == base;
+        for (size_t i = 0; i < MarketDataSnapshot::kDepthLevels; ++i) {
+            consistent = consistent && out.bidDepth[i].price == base && out.askDepth[i].volume == out.bidVolume1;
+        }
+        if (!consistent) ++torn;
+    }
+    writer.join();
+
+    REQUIRE(torn == 0);
+    REQUIRE(table.read("IF2601", out));
+    REQUIRE(out.lastPrice == 200000.0);
+    INFO("consistent reads: " << reads);
+}
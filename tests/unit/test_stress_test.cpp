@@ -0,0 +1,321 @@
+#include "../catch2/catch.hpp"
+#include "app/manager/stress_test.hpp"
+#include "app/simulation_app.hpp"
+#include "base/config.hpp"
+#include "fix/fix_codec.hpp"
+#include "fix/fix_tags.hpp"
+#include "storage/sqlite_store.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace fix40;
+
+namespace {
+
+Position makePosition(const std::string& accountId, const std::string& instrumentId,
+                      int64_t longQty, double longAvg, int64_t shortQty, double shortAvg) {
+    Position position(accountId, instrumentId);
+    position.longPosition = longQty;
+    position.longAvgPrice = longAvg;
+    position.shortPosition = shortQty;
+    position.shortAvgPrice = shortAvg;
+    return position;
+}
+
+Account makeAccount(const std::string& accountId, double balance, double usedMargin) {
+    Account account(accountId, balance);
+    account.usedMargin = usedMargin;
+    return account;
+}
+
+/// 随机生成 accounts 个账户，每个账户至多 maxPositions 笔持仓
+StressSnapshot makeRandomSnapshot(size_t accounts, int maxPositions, int products, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> positionCount(0, maxPositions);
+    std::uniform_int_distribution<int> productPick(0, products - 1);
+    std::uniform_int_distribution<int> qty(0, 20);
+    std::uniform_real_distribution<double> price(3000.0, 5000.0);
+
+    StressSnapshotBuilder builder;
+    for (size_t a = 0; a < accounts; ++a) {
+        const std::string accountId = "ACC" + std::to_string(a);
+        builder.addAccount(makeAccount(accountId, 1000000.0, 200000.0));
+        const int count = positionCount(rng);
+        for (int i = 0; i < count; ++i) {
+            const std::string product = "P" + std::to_string(productPick(rng));
+            const double mark = price(rng);
+            builder.addPosition(makePosition(accountId, product + "01", qty(rng), price(rng), qty(rng), price(rng)),
+                                product, 10, mark, mark * 0.05);
+        }
+    }
+    return builder.build();
+}
+
+// 临时写入配置文件并加载到全局 Config；restore() 或析构时加载空配置并删除文件，
+// 断言提前失败时也不会把配置泄漏给后续测试
+class ScopedConfig {
+public:
+    ScopedConfig(std::string path, const std::string& content)
+        : path_(std::move(path)) {
+        std::ofstream(path_) << content;
+        loaded_ = Config::instance().load(path_);
+    }
+
+    ~ScopedConfig() { restore(); }
+
+    ScopedConfig(const ScopedConfig&) = delete;
+    ScopedConfig& operator=(const ScopedConfig&) = delete;
+
+    bool loaded() const { return loaded_; }
+
+    void restore() {
+        if (restored_) {
+            return;
+        }
+        restored_ = true;
+        std::ofstream(path_).close();
+        Config::instance().load(path_);
+        std::remove(path_.c_str());
+    }
+
+private:
+    std::string path_;
+    bool loaded_ = false;
+    bool restored_ = false;
+};
+
+} // namespace
+
+TEST_CASE("StressGrid - 涨跌停冲击网格", "[stress_test]") {
+    const StressGrid grid = StressGrid::limitMoves({"IF", "rb"}, 2);
+    REQUIRE(grid.productCount() == 2);
+    REQUIRE(grid.scenarioCount() == 1 + 2 * 2 * (1 + 2));
+
+    REQUIRE(grid.scenarioName(0) == "base");
+    REQUIRE(grid.shock(0, 0) == 0.0);
+    REQUIRE(grid.shock(1, 0) == 0.0);
+
+    // ALL-2 两个品种同时下跌两个涨跌停
+    REQUIRE(grid.scenarioName(4) == "ALL-2");
+    REQUIRE(grid.shock(0, 4) == -2.0);
+    REQUIRE(grid.shock(1, 4) == -2.0);
+
+    // rb+1 只冲击 rb
+    REQUIRE(grid.scenarioName(9) == "rb+1");
+    REQUIRE(grid.shock(0, 9) == 0.0);
+    REQUIRE(grid.shock(1, 9) == 1.0);
+
+    SECTION("逐个追加情景") {
+        StressGrid custom(2);
+        custom.addScenario("a", {1.0, 2.0});
+        custom.addScenario("b", {3.0, 4.0});
+        REQUIRE(custom.scenarioCount() == 2);
+        REQUIRE(custom.productShocks(0)[1] == 3.0);
+        REQUIRE(custom.productShocks(1)[0] == 2.0);
+        REQUIRE(custom.productShocks(1)[1] == 4.0);
+        REQUIRE_THROWS_AS(custom.addScenario("bad", {1.0}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("StressTestEngine - 最差情景权益", "[stress_test]") {
+    StressSnapshotBuilder builder;
+    builder.addAccount(makeAccount("A", 1000000.0, 100000.0));
+    builder.addAccount(makeAccount("B", 100000.0, 80000.0));
+    builder.addAccount(makeAccount("C", 50000.0, 0.0));
+
+    // A：IF 多 2 手（浮盈 60000），rb 空 1 手（浮亏 1000）
+    builder.addPosition(makePosition("A", "IF2601", 2, 4000.0, 0, 0.0), "IF", 300, 4100.0, 400.0);
+    builder.addPosition(makePosition("A", "rb2605", 0, 0.0, 1, 3500.0), "rb", 10, 3600.0, 350.0);
+    // B：IF 空 1 手
+    builder.addPosition(makePosition("B", "IF2601", 0, 0.0, 1, 4100.0), "IF", 300, 4100.0, 400.0);
+    // 无账户的持仓被丢弃
+    builder.addPosition(makePosition("D", "IF2601", 5, 4000.0, 0, 0.0), "IF", 300, 4100.0, 400.0);
+
+    const StressSnapshot snapshot = builder.build();
+    REQUIRE(snapshot.accountCount() == 3);
+    REQUIRE(snapshot.positionCount() == 3);
+    REQUIRE(snapshot.productIds == std::vector<std::string>{"IF", "rb"});
+    REQUIRE(snapshot.positionBegin == std::vector<uint32_t>{0, 2, 3, 3});
+    REQUIRE(snapshot.baseEquity[0] == Approx(1059000.0));
+
+    StressTestEngine engine(1);
+    const StressReport report = engine.run(snapshot, StressGrid::limitMoves(snapshot.productIds, 2));
+    REQUIRE(report.scenarioCount == 13);
+    REQUIRE(report.positionCount == 3);
+    REQUIRE(report.accounts.size() == 3);
+
+    // B 在上涨两个涨跌停时穿仓，排在最前
+    const auto& b = report.accounts[0];
+    REQUIRE(b.accountId == "B");
+    REQUIRE(b.equity == Approx(100000.0));
+    REQUIRE(b.worstEquity == Approx(-140000.0));
+    REQUIRE(std::isinf(b.worstRiskRatio));
+    REQUIRE(b.worstScenario == "ALL+2");
+
+    // A 的 rb 空头对冲了部分全市场下跌，最差情景是 IF 单独下跌
+    const auto& a = report.accounts[1];
+    REQUIRE(a.accountId == "A");
+    REQUIRE(a.equity == Approx(1059000.0));
+    REQUIRE(a.worstEquity == Approx(579000.0));
+    REQUIRE(a.worstRiskRatio == Approx(100000.0 / 579000.0));
+    REQUIRE(a.worstScenario == "IF-2");
+
+    const auto& c = report.accounts[2];
+    REQUIRE(c.accountId == "C");
+    REQUIRE(c.worstEquity == Approx(50000.0));
+    REQUIRE(c.worstRiskRatio == 0.0);
+    REQUIRE(c.worstScenario == "base");
+
+    REQUIRE(format_stress_result(a) ==
+            "account=A equity=1059000.00 worst_equity=579000.00 worst_risk=0.1727 scenario=IF-2");
+
+    REQUIRE_THROWS_AS(engine.run(snapshot, StressGrid::limitMoves({"IF"}, 1)), std::invalid_argument);
+}
+
+TEST_CASE("StressTestEngine - 并行结果与单线程一致", "[stress_test]") {
+    const StressSnapshot snapshot = makeRandomSnapshot(2000, 8, 12, 42);
+    const StressGrid grid = StressGrid::limitMoves(snapshot.productIds, 3);
+
+    StressTestEngine serial(1);
+    StressTestEngine parallel(4);
+    const StressReport expected = serial.run(snapshot, grid);
+    const StressReport actual = parallel.run(snapshot, grid);
+
+    REQUIRE(actual.accounts.size() == expected.accounts.size());
+    for (size_t i = 0; i < expected.accounts.size(); ++i) {
+        REQUIRE(actual.accounts[i].accountId == expected.accounts[i].accountId);
+        REQUIRE(actual.accounts[i].worstEquity == expected.accounts[i].worstEquity);
+        REQUIRE(actual.accounts[i].worstScenario == expected.accounts[i].worstScenario);
+    }
+}
+
+TEST_CASE("StressTestEngine - 异步提交", "[stress_test]") {
+    auto snapshot = std::make_shared<const StressSnapshot>(makeRandomSnapshot(50, 4, 3, 7));
+    StressTestEngine engine(2);
+
+    std::promise<StressReport> done;
+    engine.submit(snapshot, 2, [&done](const StressReport& report) { done.set_value(report); });
+    auto future = done.get_future();
+    REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+    const StressReport report = future.get();
+    REQUIRE(report.accounts.size() == 50);
+    REQUIRE(report.scenarioCount == 1 + 2 * 2 * (1 + snapshot->productIds.size()));
+
+    // 停止后提交的任务被丢弃
+    engine.stop();
+    bool called = false;
+    REQUIRE_FALSE(engine.submit(snapshot, 1, [&called](const StressReport&) { called = true; }));
+    REQUIRE_FALSE(called);
+}
+
+TEST_CASE("StressTestEngine - 回调抛出异常时调度线程继续运行", "[stress_test]") {
+    auto snapshot = std::make_shared<const StressSnapshot>(makeRandomSnapshot(5, 2, 2, 11));
+    StressTestEngine engine(2);
+
+    std::promise<void> thrown;
+    REQUIRE(engine.submit(snapshot, 1, [&thrown](const StressReport&) {
+        thrown.set_value();
+        throw std::runtime_error("callback failed");
+    }));
+    auto thrownFuture = thrown.get_future();
+    REQUIRE(thrownFuture.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+    std::promise<StressReport> done;
+    REQUIRE(engine.submit(snapshot, 1, [&done](const StressReport& report) { done.set_value(report); }));
+    auto future = done.get_future();
+    REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    REQUIRE(future.get().error.empty());
+}
+
+TEST_CASE("SimulationApp - 非管理员的压力测试请求被拒绝 (U13)", "[stress_test][application]") {
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    SimulationApp app(&store);
+
+    auto session = std::make_shared<Session>("SERVER", "CLIENT1", 30, nullptr, &store);
+    session->set_client_comp_id("CLIENT1");
+    app.getSessionManager().registerSession(session);
+    SessionID sid = session->get_session_id();
+    session->start();
+
+    FixMessage req;
+    req.set(tags::MsgType, "U13");
+    req.set(tags::RequestID, "STRESS-1");
+    req.set(tags::ShockSteps, 2);
+    app.fromApp(req, sid);
+
+    FixCodec codec;
+    bool rejected = false;
+    for (const auto& m : store.loadMessages("SERVER", "CLIENT1", 1, 100)) {
+        FixMessage decoded = codec.decode(m.rawMessage);
+        REQUIRE(decoded.get_string(tags::MsgType) != "U14");
+        if (decoded.get_string(tags::MsgType) == "j") {
+            // 默认配置未列出管理员，压力测试整体关闭
+            REQUIRE(decoded.get_string(tags::Text) == "Stress test is disabled");
+            rejected = true;
+        }
+    }
+    REQUIRE(rejected);
+}
+
+TEST_CASE("SimulationApp - 引擎已停止时拒绝压力测试且不占住用户", "[stress_test][application]") {
+    ScopedConfig config("test_stress_stopped.ini", "[stats]\nadmin_users = CLIENT1\n");
+    REQUIRE(config.loaded());
+
+    SqliteStore store(":memory:");
+    REQUIRE(store.isOpen());
+    SimulationApp app(&store);
+    // 构造完成后恢复空配置，不影响其它测试
+    config.restore();
+
+    auto session = std::make_shared<Session>("SERVER", "CLIENT1", 30, nullptr, &store);
+    session->set_client_comp_id("CLIENT1");
+    app.getSessionManager().registerSession(session);
+    SessionID sid = session->get_session_id();
+    session->start();
+    app.stop();
+
+    for (const char* requestId : {"STRESS-1", "STRESS-2"}) {
+        FixMessage req;
+        req.set(tags::MsgType, "U13");
+        req.set(tags::RequestID, requestId);
+        app.fromApp(req, sid);
+    }
+
+    FixCodec codec;
+    std::vector<std::string> rejects;
+    for (const auto& m : store.loadMessages("SERVER", "CLIENT1", 1, 100)) {
+        FixMessage decoded = codec.decode(m.rawMessage);
+        if (decoded.get_string(tags::MsgType) == "j") {
+            rejects.push_back(decoded.get_string(tags::Text));
+        }
+    }
+    // 第一次请求被丢弃后占位已释放，第二次不会被当作“仍在执行”
+    REQUIRE(rejects == std::vector<std::string>{"Stress test engine stopped", "Stress test engine stopped"});
+}
+
+/**
+ * 基准：1 万个账户、每个账户至多 20 笔持仓、30 个品种、5 档冲击（311 个情景），单线程 vs 全部核。
+ * 默认不运行，使用 `unit_tests "[.benchmark]"` 执行。
+ */
+TEST_CASE("StressTestEngine 基准 - 全账户情景估值", "[stress_test][.benchmark]") {
+    const StressSnapshot snapshot = makeRandomSnapshot(10000, 20, 30, 1);
+    const StressGrid grid = StressGrid::limitMoves(snapshot.productIds, 5);
+
+    StressTestEngine serial(1);
+    StressTestEngine parallel(0);
+    const StressReport one = serial.run(snapshot, grid);
+    const StressReport all = parallel.run(snapshot, grid);
+    REQUIRE(one.accounts.size() == all.accounts.size());
+    WARN(snapshot.positionCount() << " positions x " << grid.scenarioCount() << " scenarios: 1 thread "
+         << one.elapsedMs << " ms, " << parallel.threadCount() << " threads " << all.elapsedMs << " ms");
+}
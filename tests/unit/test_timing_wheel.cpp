@@ -256,3 +256,77 @@ TEST_CASE("TimingWheel extremely short delay", "[timing_wheel]") {
     wheel.tick();
     REQUIRE(counter == 1);
 }
+
+TEST_CASE("TimingWheel multi-level cascade fires on exact tick", "[timing_wheel]") {
+    TimingWheel wheel(4, 10);  // 每级 4 个槽：覆盖 4 / 16 / 64 / 256 个 tick
+    std::vector<int> fired_at(300, 0);
+    int current = 0;
+
+    for (int ticks : {1, 3, 4, 5, 15, 16, 17, 63, 64, 65, 200, 255}) {
+        wheel.add_task(ticks * 10, [&fired_at, &current, ticks]() {
+            fired_at[ticks] = current;
+        });
+    }
+
+    for (current = 1; current <= 256; ++current) {
+        wheel.tick();
+    }
+
+    for (int ticks : {1, 3, 4, 5, 15, 16, 17, 63, 64, 65, 200, 255}) {
+        REQUIRE(fired_at[ticks] == ticks);
+    }
+    REQUIRE(wheel.active_count() == 0);
+}
+
+TEST_CASE("TimingWheel delay beyond top level is re-cascaded", "[timing_wheel]") {
+    TimingWheel wheel(2, 1);  // 2^4 = 16 个 tick 的覆盖范围
+    int fired_at = 0;
+    int current = 0;
+
+    wheel.add_task(40, [&fired_at, &current]() { fired_at = current; });
+
+    for (current = 1; current <= 50; ++current) {
+        wheel.tick();
+    }
+    REQUIRE(fired_at == 40);
+}
+
+TEST_CASE("TimingWheel stale id does not cancel reused node", "[timing_wheel]") {
+    TimingWheel wheel(10, 100);
+    std::atomic<int> counter{0};
+
+    TimerTaskId first = wheel.add_task(100, [&counter]() { counter++; });
+    wheel.tick();
+    REQUIRE(counter == 1);
+
+    // 节点被回收后复用，旧 ID 应已失效
+    TimerTaskId second = wheel.add_task(100, [&counter]() { counter += 10; });
+    REQUIRE(second != first);
+    wheel.cancel_task(first);
+    wheel.tick();
+    REQUIRE(counter == 11);
+}
+
+TEST_CASE("TimingWheel sub-second periodic tasks reuse pooled nodes", "[timing_wheel]") {
+    TimingWheel wheel(64, 10, 1024);  // 10ms 精度
+    std::atomic<int> counter{0};
+    std::vector<TimerTaskId> ids;
+
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(wheel.add_periodic_task(50, [&counter]() { counter++; }));
+    }
+    REQUIRE(wheel.active_count() == 1000);
+
+    for (int i = 0; i < 10; ++i) {
+        wheel.tick();
+    }
+    REQUIRE(counter == 2000);
+
+    for (auto id : ids) {
+        wheel.cancel_task(id);
+    }
+    REQUIRE(wheel.active_count() == 0);
+
+    wheel.tick();
+    REQUIRE(counter == 2000);
+}